@@ -0,0 +1,113 @@
+#include "BenchmarkHarness.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+BenchmarkRunner::BenchmarkRunner(int repetitions, const std::string& filter)
+    : repetitions_(repetitions > 0 ? repetitions : 1), filter_(filter) {
+}
+
+bool BenchmarkRunner::isSelected(const std::string& group, const std::string& name) const {
+    return filter_.empty() || (group + "/" + name).find(filter_) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& group, const std::string& name,
+                          const std::map<std::string, double>& params,
+                          uint64_t operations, const std::function<void()>& body) {
+    std::string fullName = group + "/" + name;
+    if (!isSelected(group, name)) {
+        return;
+    }
+    if (operations == 0) {
+        return;
+    }
+
+    // 预热一轮，不计入结果
+    body();
+
+    std::vector<double> samples;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    for (int i = 0; i < repetitions_; ++i) {
+        uint64_t allocBefore = g_allocationCount.load(std::memory_order_relaxed);
+        uint64_t bytesBefore = g_allocatedBytes.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+
+        body();
+
+        auto end = std::chrono::steady_clock::now();
+        allocations += g_allocationCount.load(std::memory_order_relaxed) - allocBefore;
+        bytes += g_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        samples.push_back(ns / operations);
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.group = group;
+    result.name = name;
+    result.params = params;
+    result.operations = operations;
+    result.repetitions = repetitions_;
+    result.nsPerOpMedian = samples[samples.size() / 2];
+    result.nsPerOpMin = samples.front();
+    result.nsPerOpMax = samples.back();
+    result.opsPerSecond = result.nsPerOpMedian > 0.0 ? 1e9 / result.nsPerOpMedian : 0.0;
+    result.allocsPerOp = static_cast<double>(allocations) / (operations * repetitions_);
+    result.bytesPerOp = static_cast<double>(bytes) / (operations * repetitions_);
+    results_.push_back(result);
+
+    std::cout << std::left << std::setw(48) << fullName
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << result.nsPerOpMedian << " ns/op"
+              << std::setw(16) << std::setprecision(0) << result.opsPerSecond << " ops/s"
+              << std::setw(10) << std::setprecision(2) << result.allocsPerOp << " allocs/op"
+              << std::endl;
+}
+
+bool BenchmarkRunner::writeJson(const std::string& filePath) const {
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    std::stringstream timeStr;
+    timeStr << std::put_time(std::localtime(&now_time_t), "%Y-%m-%d %H:%M:%S");
+
+    nlohmann::json root;
+    root["timestamp"] = timeStr.str();
+    root["hardware_concurrency"] = std::thread::hardware_concurrency();
+    root["repetitions"] = repetitions_;
+
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& result : results_) {
+        nlohmann::json item;
+        item["group"] = result.group;
+        item["name"] = result.name;
+        item["params"] = result.params;
+        item["operations"] = result.operations;
+        item["ns_per_op_median"] = result.nsPerOpMedian;
+        item["ns_per_op_min"] = result.nsPerOpMin;
+        item["ns_per_op_max"] = result.nsPerOpMax;
+        item["ops_per_second"] = result.opsPerSecond;
+        item["allocs_per_op"] = result.allocsPerOp;
+        item["bytes_per_op"] = result.bytesPerOp;
+        benchmarks.push_back(item);
+    }
+    root["benchmarks"] = benchmarks;
+
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open benchmark output file: " << filePath << std::endl;
+        return false;
+    }
+
+    file << root.dump(2) << std::endl;
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 堆分配统计（由BenchmarkMain.cpp中替换的全局operator new维护）
+extern std::atomic<uint64_t> g_allocationCount;
+extern std::atomic<uint64_t> g_allocatedBytes;
+
+// 单项基准测试结果
+struct BenchmarkResult {
+    std::string group;                       // 测试分组
+    std::string name;                        // 测试名称
+    std::map<std::string, double> params;    // 测试参数，如生产者数量、处理器数量
+    uint64_t operations;                     // 每轮操作次数
+    int repetitions;                         // 计时轮数（不含预热）
+    double nsPerOpMedian;                    // 每次操作耗时中位数（纳秒）
+    double nsPerOpMin;                       // 每次操作耗时最小值（纳秒）
+    double nsPerOpMax;                       // 每次操作耗时最大值（纳秒）
+    double opsPerSecond;                     // 按中位数计算的吞吐量
+    double allocsPerOp;                      // 每次操作的堆分配次数
+    double bytesPerOp;                       // 每次操作的堆分配字节数
+};
+
+// 内置基准测试框架
+// 每项测试先预热一轮，再计时若干轮，取每次操作耗时的中位数，结果可输出为JSON。
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(int repetitions = 5, const std::string& filter = "");
+
+    // 运行一项测试，body每次调用执行operations次操作
+    void run(const std::string& group, const std::string& name,
+             const std::map<std::string, double>& params,
+             uint64_t operations, const std::function<void()>& body);
+
+    // 测试是否被过滤条件选中
+    bool isSelected(const std::string& group, const std::string& name) const;
+
+    // 获取所有测试结果
+    const std::vector<BenchmarkResult>& getResults() const { return results_; }
+
+    // 将结果写入JSON文件
+    bool writeJson(const std::string& filePath) const;
+
+private:
+    int repetitions_;
+    std::string filter_;
+    std::vector<BenchmarkResult> results_;
+};
+
+// 防止编译器优化掉基准测试中未使用的结果
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#ifdef _MSC_VER
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+// 各组基准测试
+void runQueueBenchmarks(BenchmarkRunner& runner);
+void runDispatchBenchmarks(BenchmarkRunner& runner);
+void runMarketDataBenchmarks(BenchmarkRunner& runner);
+void runRiskBenchmarks(BenchmarkRunner& runner);
+void runTradeBenchmarks(BenchmarkRunner& runner);
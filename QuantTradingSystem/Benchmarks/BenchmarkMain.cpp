@@ -0,0 +1,116 @@
+#include "BenchmarkHarness.h"
+#include "LoadGenerator.h"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+// 替换全局operator new，统计堆分配次数和字节数
+std::atomic<uint64_t> g_allocationCount(0);
+std::atomic<uint64_t> g_allocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* p = std::malloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// 用法:
+//   Benchmarks [--out 结果文件] [--filter 名称片段] [--repetitions 轮数]
+//   Benchmarks --load [--out 结果文件] [--instruments n] [--arrival poisson|bursty]
+//              [--start-rate n] [--ramp x] [--step-sec n] [--p99-us n] [--max-depth n] [--work-ns n]
+int main(int argc, char* argv[]) {
+    std::string outputFile;
+    std::string filter;
+    int repetitions = 5;
+    bool loadTest = false;
+    LoadTestConfig loadConfig;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--load") {
+            loadTest = true;
+        } else if (arg == "--out" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (arg == "--repetitions" && hasValue) {
+            repetitions = std::atoi(argv[++i]);
+        } else if (arg == "--instruments" && hasValue) {
+            loadConfig.instrumentCount = std::atoi(argv[++i]);
+        } else if (arg == "--arrival" && hasValue) {
+            loadConfig.arrivalMode = std::string(argv[++i]) == "bursty" ?
+                                     SyntheticArrivalMode::BURSTY : SyntheticArrivalMode::POISSON;
+        } else if (arg == "--start-rate" && hasValue) {
+            loadConfig.startRate = std::atof(argv[++i]);
+        } else if (arg == "--ramp" && hasValue) {
+            loadConfig.rampFactor = std::atof(argv[++i]);
+        } else if (arg == "--step-sec" && hasValue) {
+            loadConfig.stepSeconds = std::atoi(argv[++i]);
+        } else if (arg == "--p99-us" && hasValue) {
+            loadConfig.p99ThresholdUs = std::atof(argv[++i]);
+        } else if (arg == "--max-depth" && hasValue) {
+            loadConfig.depthThreshold = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--work-ns" && hasValue) {
+            loadConfig.handlerWorkNs = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--out file] [--filter name] [--repetitions n]" << std::endl
+                      << "       " << argv[0]
+                      << " --load [--out file] [--instruments n] [--arrival poisson|bursty]"
+                      << " [--start-rate n] [--ramp x] [--step-sec n] [--p99-us n]"
+                      << " [--max-depth n] [--work-ns n]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (loadTest) {
+        if (!outputFile.empty()) {
+            loadConfig.outputFile = outputFile;
+        }
+        if (loadConfig.rampFactor <= 1.0 || loadConfig.startRate <= 0.0 || loadConfig.stepSeconds <= 0) {
+            std::cerr << "Invalid load test parameters" << std::endl;
+            return 1;
+        }
+
+        std::vector<LoadStepResult> results;
+        runLoadTest(loadConfig, results);
+        std::cout << "Results written to " << loadConfig.outputFile << std::endl;
+        return 0;
+    }
+
+    if (outputFile.empty()) {
+        outputFile = "benchmark_results.json";
+    }
+
+    BenchmarkRunner runner(repetitions, filter);
+
+    runQueueBenchmarks(runner);
+    runDispatchBenchmarks(runner);
+    runMarketDataBenchmarks(runner);
+    runRiskBenchmarks(runner);
+    runTradeBenchmarks(runner);
+
+    if (!runner.writeJson(outputFile)) {
+        return 1;
+    }
+
+    std::cout << "Results written to " << outputFile << std::endl;
+    return 0;
+}
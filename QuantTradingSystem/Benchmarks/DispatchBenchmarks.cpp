@@ -0,0 +1,134 @@
+#include "BenchmarkHarness.h"
+#include "EventManager.h"
+#include "MarketData/MarketDataService.h"
+#include "Utils/timer/TimerWheel.h"
+#include <memory>
+#include <string>
+
+namespace {
+
+// 每批事件数，与EventManager单次处理的上限一致
+const size_t BATCH_SIZE = 1000;
+const int BATCHES = 100;
+
+// 空处理器，只计数
+class CountingHandler : public EventHandler {
+public:
+    explicit CountingHandler(const std::string& name) : EventHandler(name), count_(0) {}
+
+    void handleEvent(const std::shared_ptr<Event>& /*event*/) override {
+        ++count_;
+    }
+
+    uint64_t getCount() const { return count_; }
+
+private:
+    uint64_t count_;
+};
+
+MarketDataField makeField() {
+    MarketDataField field;
+    field.symbol = "rb2410";
+    field.exchange = "SHFE";
+    field.tradingDay = "20240801";
+    field.updateTime = "09:30:00";
+    field.lastPrice = 3500.0;
+    field.volume = 1000;
+    return field;
+}
+
+// 同一个事件反复入队和分发，只测量队列和分发本身的开销
+void benchmarkHandlers(BenchmarkRunner& runner, int handlerCount) {
+    EventManager eventManager;
+    for (int i = 0; i < handlerCount; ++i) {
+        eventManager.registerHandlerForType(
+            EventType::MARKET_DATA,
+            std::make_shared<CountingHandler>("BenchHandler" + std::to_string(i)));
+    }
+
+    std::shared_ptr<Event> event = MarketDataService::convertToEvent(makeField());
+
+    runner.run("event_manager", "dispatch_" + std::to_string(handlerCount) + "_handlers",
+               {{"handlers", handlerCount}}, BATCH_SIZE * BATCHES,
+               [&eventManager, &event]() {
+        for (int b = 0; b < BATCHES; ++b) {
+            for (size_t i = 0; i < BATCH_SIZE; ++i) {
+                eventManager.addEvent(event);
+            }
+            eventManager.processEvents();
+        }
+    });
+}
+
+// 每个行情创建新事件，统计每个事件从转换到分发完成的分配次数
+void benchmarkEventAllocation(BenchmarkRunner& runner) {
+    EventManager eventManager;
+    eventManager.registerHandlerForType(EventType::MARKET_DATA,
+                                        std::make_shared<CountingHandler>("BenchHandler0"));
+
+    MarketDataField field = makeField();
+
+    runner.run("event_manager", "convert_enqueue_dispatch", {{"handlers", 1}},
+               BATCH_SIZE * BATCHES, [&eventManager, &field]() {
+        for (int b = 0; b < BATCHES; ++b) {
+            for (size_t i = 0; i < BATCH_SIZE; ++i) {
+                eventManager.addEvent(MarketDataService::convertToEvent(field));
+            }
+            eventManager.processEvents();
+        }
+    });
+}
+
+const int64_t NS_PER_MS = 1000000;
+const size_t TIMER_OPS = 100000;
+
+// 已有outstanding个挂起定时器（如逐笔订单超时）时，登记并取消一个2秒超时的开销
+void benchmarkTimerScheduleCancel(BenchmarkRunner& runner, size_t outstanding) {
+    TimerWheel wheel(NS_PER_MS);
+    uint64_t seed = 1;
+    for (size_t i = 0; i < outstanding; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        wheel.schedule(static_cast<int64_t>((seed >> 33) % 600000) * NS_PER_MS, i);
+    }
+
+    runner.run("timer_wheel", "schedule_cancel", {{"outstanding", static_cast<double>(outstanding)}},
+               TIMER_OPS, [&wheel]() {
+        for (size_t i = 0; i < TIMER_OPS; ++i) {
+            TimerWheel::TimerId id = wheel.schedule(wheel.currentNs() + 2000 * NS_PER_MS, i);
+            doNotOptimize(id);
+            wheel.cancel(id);
+        }
+    });
+}
+
+// 登记分布在1秒内的定时器，再按1毫秒步长推进时钟至全部到期，统计每个定时器的登记加触发开销
+void benchmarkTimerFire(BenchmarkRunner& runner) {
+    TimerWheel wheel(NS_PER_MS);
+    std::vector<TimerWheel::Expired> expired;
+    expired.reserve(TIMER_OPS);
+
+    runner.run("timer_wheel", "schedule_fire", {{"span_ms", 1000}}, TIMER_OPS, [&wheel, &expired]() {
+        int64_t start = wheel.currentNs();
+        for (size_t i = 0; i < TIMER_OPS; ++i) {
+            wheel.schedule(start + static_cast<int64_t>(i * 7919 % 1000 + 1) * NS_PER_MS, i);
+        }
+        expired.clear();
+        for (int64_t ms = 1; ms <= 1000; ++ms) {
+            wheel.advance(start + ms * NS_PER_MS, expired);
+        }
+        doNotOptimize(expired.size());
+    });
+}
+
+} // namespace
+
+void runDispatchBenchmarks(BenchmarkRunner& runner) {
+    for (int handlers : {1, 2, 4, 8, 16, 32, 64}) {
+        benchmarkHandlers(runner, handlers);
+    }
+    benchmarkEventAllocation(runner);
+    for (size_t outstanding : {static_cast<size_t>(0), static_cast<size_t>(1000000)}) {
+        benchmarkTimerScheduleCancel(runner, outstanding);
+    }
+    benchmarkTimerFire(runner);
+}
@@ -0,0 +1,204 @@
+#include "LoadGenerator.h"
+#include "EventManager.h"
+#include "MarketData/MarketDataService.h"
+#include "Utils/metrics/LatencyHistogram.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+// 统计行情从CTP回调到分发完成的延迟，可选模拟策略计算耗时
+class LoadProbeHandler : public EventHandler {
+public:
+    explicit LoadProbeHandler(double workNs)
+        : EventHandler("LoadProbeHandler"), workNs_(static_cast<int64_t>(workNs)),
+          histogram_(nullptr), processed_(0) {}
+
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (workNs_ > 0) {
+            int64_t until = latencyNow() + workNs_;
+            while (latencyNow() < until) {
+            }
+        }
+
+        const LatencyTrace& trace = event->getTrace();
+        LatencyHistogram* histogram = histogram_.load(std::memory_order_acquire);
+        if (histogram && trace.has(LatencyStage::CTP_CALLBACK)) {
+            histogram->record(latencyNow() - trace.get(LatencyStage::CTP_CALLBACK));
+        }
+        processed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 切换到新的直方图，开始新一级统计
+    void setHistogram(LatencyHistogram* histogram) {
+        histogram_.store(histogram, std::memory_order_release);
+    }
+
+    uint64_t getProcessed() const { return processed_.load(std::memory_order_relaxed); }
+
+private:
+    int64_t workNs_;
+    std::atomic<LatencyHistogram*> histogram_;
+    std::atomic<uint64_t> processed_;
+};
+
+void writeResults(const LoadTestConfig& config, const std::vector<LoadStepResult>& results,
+                  double saturationRate) {
+    nlohmann::json root;
+    root["instrument_count"] = config.instrumentCount;
+    root["arrival"] = config.arrivalMode == SyntheticArrivalMode::BURSTY ? "bursty" : "poisson";
+    root["p99_threshold_us"] = config.p99ThresholdUs;
+    root["depth_threshold"] = config.depthThreshold;
+    root["handler_work_ns"] = config.handlerWorkNs;
+    root["saturation_rate"] = saturationRate;
+
+    nlohmann::json steps = nlohmann::json::array();
+    for (const auto& result : results) {
+        nlohmann::json item;
+        item["target_rate"] = result.targetRate;
+        item["generated_rate"] = result.generatedRate;
+        item["processed_rate"] = result.processedRate;
+        item["p50_us"] = result.p50Us;
+        item["p99_us"] = result.p99Us;
+        item["p999_us"] = result.p999Us;
+        item["max_us"] = result.maxUs;
+        item["max_queue_depth"] = result.maxQueueDepth;
+        item["saturated"] = result.saturated;
+        item["reason"] = result.reason;
+        steps.push_back(item);
+    }
+    root["steps"] = steps;
+
+    std::ofstream file(config.outputFile);
+    if (file.is_open()) {
+        file << root.dump(2) << std::endl;
+    } else {
+        std::cerr << "Failed to open load test output file: " << config.outputFile << std::endl;
+    }
+}
+
+} // namespace
+
+double runLoadTest(const LoadTestConfig& config, std::vector<LoadStepResult>& results) {
+    // EventManager的无锁队列容量为10000，节点池循环复用，深度阈值必须明显小于容量
+    const size_t depthLimit = std::min<size_t>(config.depthThreshold, 8000);
+
+    auto eventManager = std::make_shared<EventManager>();
+    auto probe = std::make_shared<LoadProbeHandler>(config.handlerWorkNs);
+    eventManager->registerHandlerForType(EventType::MARKET_DATA, probe);
+    eventManager->start();
+
+    MarketDataService service(eventManager);
+    if (!service.init("SYNTHETIC", "")) {
+        std::cerr << "Failed to create synthetic market data feed" << std::endl;
+        return 0.0;
+    }
+
+    auto feed = std::dynamic_pointer_cast<SyntheticMarketDataFeed>(service.getFeed());
+    SyntheticFeedConfig feedConfig;
+    feedConfig.instrumentCount = config.instrumentCount;
+    feedConfig.arrivalMode = config.arrivalMode;
+    feedConfig.ticksPerSecond = 0.0;
+    feed->setConfig(feedConfig);
+
+    if (!service.start()) {
+        std::cerr << "Failed to start synthetic market data feed" << std::endl;
+        return 0.0;
+    }
+
+    std::cout << std::left << std::setw(14) << "target/s"
+              << std::right << std::setw(14) << "generated/s"
+              << std::setw(14) << "processed/s"
+              << std::setw(10) << "p50us"
+              << std::setw(10) << "p99us"
+              << std::setw(10) << "p99.9us"
+              << std::setw(12) << "maxus"
+              << std::setw(10) << "depth" << "  status" << std::endl;
+
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+    double saturationRate = 0.0;
+
+    for (double rate = config.startRate; rate <= config.maxRate; rate *= config.rampFactor) {
+        histograms.push_back(std::make_unique<LatencyHistogram>());
+        LatencyHistogram* histogram = histograms.back().get();
+
+        probe->setHistogram(histogram);
+        feed->setTicksPerSecond(rate);
+
+        uint64_t generatedBefore = feed->getGeneratedCount();
+        uint64_t processedBefore = probe->getProcessed();
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::seconds(config.stepSeconds);
+
+        // 每毫秒采样一次队列深度，超过阈值立即结束本级
+        size_t maxDepth = 0;
+        while (std::chrono::steady_clock::now() < end) {
+            maxDepth = std::max(maxDepth, eventManager->getEventQueueSize());
+            if (maxDepth > depthLimit) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        LoadStepResult result;
+        result.targetRate = rate;
+        result.generatedRate = (feed->getGeneratedCount() - generatedBefore) / seconds;
+        result.processedRate = (probe->getProcessed() - processedBefore) / seconds;
+        result.p50Us = histogram->getPercentile(50.0) / 1000.0;
+        result.p99Us = histogram->getPercentile(99.0) / 1000.0;
+        result.p999Us = histogram->getPercentile(99.9) / 1000.0;
+        result.maxUs = histogram->getMax() / 1000.0;
+        result.maxQueueDepth = maxDepth;
+        result.saturated = true;
+
+        if (maxDepth > depthLimit) {
+            result.reason = "queue_depth";
+        } else if (result.p99Us > config.p99ThresholdUs) {
+            result.reason = "p99_latency";
+        } else if (result.generatedRate < rate * 0.9) {
+            // 生成线程自身跟不上，测到的是压测工具的上限
+            result.reason = "generator_limited";
+        } else {
+            result.saturated = false;
+            saturationRate = rate;
+        }
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(14) << std::fixed << std::setprecision(0) << rate
+                  << std::right << std::setw(14) << result.generatedRate
+                  << std::setw(14) << result.processedRate
+                  << std::setw(10) << std::setprecision(1) << result.p50Us
+                  << std::setw(10) << result.p99Us
+                  << std::setw(10) << result.p999Us
+                  << std::setw(12) << result.maxUs
+                  << std::setw(10) << maxDepth
+                  << "  " << (result.saturated ? result.reason : "ok") << std::endl;
+
+        if (result.saturated) {
+            break;
+        }
+    }
+
+    // 停止生成并等待队列排空
+    feed->setTicksPerSecond(0.0);
+    while (!eventManager->isEventQueueEmpty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    probe->setHistogram(nullptr);
+
+    service.stop();
+    eventManager->stop();
+
+    std::cout << "Saturation point: " << std::fixed << std::setprecision(0) << saturationRate
+              << " ticks/s across " << config.instrumentCount << " instruments" << std::endl;
+
+    writeResults(config, results, saturationRate);
+    return saturationRate;
+}
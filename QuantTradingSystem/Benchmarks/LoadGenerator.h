@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MarketData/SyntheticMarketDataFeed.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 压力测试配置
+struct LoadTestConfig {
+    int instrumentCount;              // 模拟合约数量
+    SyntheticArrivalMode arrivalMode; // 到达模式
+    double startRate;                 // 起始行情速率（笔/秒）
+    double rampFactor;                // 每一级速率的倍数
+    double maxRate;                   // 速率上限
+    int stepSeconds;                  // 每一级持续时间（秒）
+    double p99ThresholdUs;            // p99延迟阈值（微秒）
+    size_t depthThreshold;            // 事件队列深度阈值
+    double handlerWorkNs;             // 每笔行情在处理器中模拟的计算耗时（纳秒）
+    std::string outputFile;           // 结果文件
+
+    LoadTestConfig()
+        : instrumentCount(50), arrivalMode(SyntheticArrivalMode::POISSON),
+          startRate(1000.0), rampFactor(1.5), maxRate(2000000.0), stepSeconds(3),
+          p99ThresholdUs(1000.0), depthThreshold(5000), handlerWorkNs(0.0),
+          outputFile("load_results.json") {}
+};
+
+// 单级压测结果
+struct LoadStepResult {
+    double targetRate;        // 目标速率
+    double generatedRate;     // 实际生成速率
+    double processedRate;     // 实际处理速率
+    double p50Us;             // 回调到分发完成延迟的中位数（微秒）
+    double p99Us;
+    double p999Us;
+    double maxUs;
+    size_t maxQueueDepth;     // 本级最大事件队列深度
+    bool saturated;           // 是否达到饱和
+    std::string reason;       // 饱和原因
+};
+
+// 逐级提高模拟行情速率，直到p99延迟或队列深度超过阈值，输出饱和点
+// 返回最后一个未饱和级别的速率，结果写入config.outputFile
+double runLoadTest(const LoadTestConfig& config, std::vector<LoadStepResult>& results);
@@ -0,0 +1,86 @@
+#include "BenchmarkHarness.h"
+#include "MarketData/CTPMarketDataFeed.h"
+#include "MarketData/MarketDataService.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t TICKS = 200000;
+
+// 直接调用CTP行情回调，不连接前置
+class BenchMarketDataFeed : public CTPMarketDataFeed {
+public:
+    void feed(CThostFtdcDepthMarketDataField* data) {
+        OnRtnDepthMarketData(data);
+    }
+};
+
+void fillDepthMarketData(CThostFtdcDepthMarketDataField& data) {
+    std::memset(&data, 0, sizeof(data));
+    std::strncpy(data.InstrumentID, "rb2410", sizeof(data.InstrumentID) - 1);
+    std::strncpy(data.ExchangeID, "SHFE", sizeof(data.ExchangeID) - 1);
+    std::strncpy(data.TradingDay, "20240801", sizeof(data.TradingDay) - 1);
+    std::strncpy(data.UpdateTime, "09:30:00", sizeof(data.UpdateTime) - 1);
+    data.UpdateMillisec = 500;
+    data.LastPrice = 3500.0;
+    data.OpenPrice = 3480.0;
+    data.HighestPrice = 3520.0;
+    data.LowestPrice = 3470.0;
+    data.PreClosePrice = 3490.0;
+    data.UpperLimitPrice = 3700.0;
+    data.LowerLimitPrice = 3300.0;
+    data.Volume = 123456;
+    data.Turnover = 4.3e9;
+    data.OpenInterest = 654321.0;
+    data.BidPrice1 = 3499.0;
+    data.BidVolume1 = 10;
+    data.AskPrice1 = 3501.0;
+    data.AskVolume1 = 12;
+}
+
+// CTP行情结构转换为MarketDataField（经由OnRtnDepthMarketData回调）
+void benchmarkCtpConvert(BenchmarkRunner& runner) {
+    CThostFtdcDepthMarketDataField depth;
+    fillDepthMarketData(depth);
+
+    BenchMarketDataFeed feed;
+    double lastPrice = 0.0;
+    feed.SetMarketDataCallback([&lastPrice](const MarketDataField& field) {
+        lastPrice = field.lastPrice;
+    });
+
+    runner.run("market_data", "ctp_convert_market_data", {}, TICKS, [&feed, &depth, &lastPrice]() {
+        for (uint64_t i = 0; i < TICKS; ++i) {
+            feed.feed(&depth);
+        }
+        doNotOptimize(lastPrice);
+    });
+}
+
+// MarketDataField转换为MarketDataEvent
+void benchmarkConvertToEvent(BenchmarkRunner& runner) {
+    CThostFtdcDepthMarketDataField depth;
+    fillDepthMarketData(depth);
+
+    // 使用CTP回调产生的行情，保证字段与实盘一致
+    BenchMarketDataFeed feed;
+    MarketDataField field;
+    feed.SetMarketDataCallback([&field](const MarketDataField& data) {
+        field = data;
+    });
+    feed.feed(&depth);
+
+    runner.run("market_data", "convert_to_event", {}, TICKS, [&field]() {
+        for (uint64_t i = 0; i < TICKS; ++i) {
+            auto event = MarketDataService::convertToEvent(field);
+            doNotOptimize(event);
+        }
+    });
+}
+
+} // namespace
+
+void runMarketDataBenchmarks(BenchmarkRunner& runner) {
+    benchmarkCtpConvert(runner);
+    benchmarkConvertToEvent(runner);
+}
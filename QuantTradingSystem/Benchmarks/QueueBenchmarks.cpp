@@ -0,0 +1,102 @@
+#include "BenchmarkHarness.h"
+#include "Utils/LockFreeQueue.h"
+#include "Utils/logger/AsyncLogger.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t QUEUE_CAPACITY = 65536;
+
+// LockFreeQueue的节点池循环复用，队列中的元素数必须小于容量。
+// 多生产者测试按轮进行，每轮最多写入半个容量，消费者取完后再开始下一轮。
+const uint64_t ROUND_SIZE = QUEUE_CAPACITY / 2;
+const int ROUNDS = 32;
+
+typedef Utils::LockFreeQueue<uint64_t, QUEUE_CAPACITY> BenchQueue;
+
+// 单线程push后立即pop的往返开销
+void benchmarkPushPop(BenchmarkRunner& runner, BenchQueue& queue) {
+    const uint64_t operations = 1000000;
+    runner.run("lock_free_queue", "push_pop_single_thread", {}, operations, [&queue, operations]() {
+        uint64_t value = 0;
+        for (uint64_t i = 0; i < operations; ++i) {
+            queue.push(i);
+            queue.pop(value);
+        }
+        doNotOptimize(value);
+    });
+}
+
+// 多个生产者并发写入，一个消费者读取
+void benchmarkProducers(BenchmarkRunner& runner, BenchQueue& queue, int producers) {
+    const uint64_t perProducer = ROUND_SIZE / producers;
+    const uint64_t perRound = perProducer * producers;
+
+    runner.run("lock_free_queue", "mpsc_" + std::to_string(producers) + "_producers",
+               {{"producers", producers}}, perRound * ROUNDS,
+               [&queue, producers, perProducer, perRound]() {
+        std::atomic<int> round(0);
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, &round, p, perProducer]() {
+                for (int r = 0; r < ROUNDS; ++r) {
+                    while (round.load(std::memory_order_acquire) != r) {
+                        std::this_thread::yield();
+                    }
+                    uint64_t base = static_cast<uint64_t>(p) * perProducer;
+                    for (uint64_t i = 0; i < perProducer; ++i) {
+                        queue.push(base + i);
+                    }
+                }
+            });
+        }
+
+        uint64_t value = 0;
+        for (int r = 0; r < ROUNDS; ++r) {
+            uint64_t received = 0;
+            while (received < perRound) {
+                if (queue.pop(value)) {
+                    ++received;
+                }
+            }
+            round.store(r + 1, std::memory_order_release);
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        doNotOptimize(value);
+    });
+}
+
+// 日志前端：调用线程记录时间戳、调用点和参数，写入本线程的日志环。
+// 环容量足够容纳全部轮次的记录，测得的是调用方开销而不是后台写文件的吞吐
+void benchmarkAsyncLogger(BenchmarkRunner& runner) {
+    const uint64_t operations = 100000;
+    QuantTrading::AsyncLogger::getInstance().init("benchmark_logs", "bench", QuantTrading::LogLevel::INFO,
+                                                  64 * 1024 * 1024, 2, 64 * 1024 * 1024);
+
+    runner.run("async_logger", "log_int_double", {}, operations, [operations]() {
+        for (uint64_t i = 0; i < operations; ++i) {
+            LOG_INFO("order {} price {}", i, 3856.5);
+        }
+    });
+
+    QuantTrading::AsyncLogger::getInstance().stop();
+}
+
+} // namespace
+
+void runQueueBenchmarks(BenchmarkRunner& runner) {
+    // 节点池较大，放在堆上
+    auto queue = std::make_unique<BenchQueue>();
+
+    benchmarkPushPop(runner, *queue);
+    for (int producers : {1, 2, 4, 8}) {
+        benchmarkProducers(runner, *queue, producers);
+    }
+    benchmarkAsyncLogger(runner);
+}
@@ -0,0 +1,230 @@
+#include "BenchmarkHarness.h"
+#include "EventManager.h"
+#include "Handlers/RiskHandler.h"
+#include "Risk/PnlEngine.h"
+#include "Risk/RateLimiter.h"
+#include "Risk/RiskEngine.h"
+#include "Risk/ScenarioRiskEngine.h"
+#include "Utils/latency/LatencyTrace.h"
+#include "Utils/metrics/LatencyHistogram.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint64_t ORDERS = 1000000;
+const int INSTRUMENTS = 500;
+const int STRATEGIES = 16;
+
+// 预先登记合约和策略，生成待检查订单，部分合约带有持仓
+void prepareEngine(RiskEngine& engine, std::vector<RiskOrder>& orders) {
+    for (int i = 0; i < INSTRUMENTS; ++i) {
+        std::string symbol = "SYN" + std::to_string(i);
+        engine.internInstrument(symbol);
+        engine.setContractMultiplier(symbol, 10.0);
+        if (i % 3 == 0) {
+            engine.setPosition(symbol, (i % 2 == 0) ? 5 : -5, 3500.0);
+        }
+    }
+    for (int i = 0; i < STRATEGIES; ++i) {
+        engine.internStrategy("Strategy" + std::to_string(i));
+    }
+
+    orders.resize(4096);
+    for (size_t i = 0; i < orders.size(); ++i) {
+        orders[i].instrument = static_cast<int>((i * 7919) % INSTRUMENTS);
+        orders[i].strategy = static_cast<int>(i % STRATEGIES);
+        orders[i].buy = (i % 2) == 0;
+        orders[i].volume = 1 + static_cast<int64_t>(i % 5);
+        orders[i].price = 3500.0 + static_cast<double>(i % 20);
+    }
+}
+
+// 引擎限额检查本身的吞吐
+void benchmarkEngineCheck(BenchmarkRunner& runner) {
+    RiskLimits limits;
+    limits.maxTotalPosition = 100000;
+    RiskEngine engine(limits);
+    std::vector<RiskOrder> orders;
+    prepareEngine(engine, orders);
+
+    runner.run("risk", "engine_check", {{"instruments", INSTRUMENTS}}, ORDERS, [&engine, &orders]() {
+        uint32_t result = 0;
+        for (uint64_t i = 0; i < ORDERS; ++i) {
+            result |= engine.check(orders[i & (orders.size() - 1)]);
+        }
+        doNotOptimize(result);
+    });
+
+    // 逐笔计时，输出单笔检查延迟分布（含两次取时间戳的开销）
+    if (!runner.isSelected("risk", "engine_check")) {
+        return;
+    }
+    LatencyHistogram histogram;
+    for (uint64_t i = 0; i < ORDERS; ++i) {
+        int64_t start = latencyNow();
+        uint32_t result = engine.check(orders[i & (orders.size() - 1)]);
+        histogram.record(latencyNow() - start);
+        doNotOptimize(result);
+    }
+    std::cout << "  risk engine_check per-order latency: p50=" << histogram.getPercentile(50.0)
+              << "ns p99=" << histogram.getPercentile(99.0)
+              << "ns p99.9=" << histogram.getPercentile(99.9)
+              << "ns max=" << histogram.getMax() << "ns" << std::endl;
+}
+
+// 检查、登记挂单、成交回报的完整状态维护开销
+void benchmarkEngineLifecycle(BenchmarkRunner& runner) {
+    RiskLimits limits;
+    limits.maxTotalPosition = 100000000;
+    limits.maxPositionPerInstrument = 100000000;
+    limits.maxPositionPerStrategy = 100000000;
+    limits.maxTotalNotional = 1e18;
+    limits.maxNotionalPerInstrument = 1e18;
+    RiskEngine engine(limits);
+    std::vector<RiskOrder> orders;
+    prepareEngine(engine, orders);
+
+    std::vector<std::string> orderIds(orders.size());
+    std::vector<TradeData> trades(orders.size());
+    for (size_t i = 0; i < orders.size(); ++i) {
+        orderIds[i] = "order" + std::to_string(i);
+        trades[i].orderId = orderIds[i];
+        trades[i].symbol = "SYN" + std::to_string(orders[i].instrument);
+        trades[i].direction = orders[i].buy ? OrderDirection::BUY : OrderDirection::SELL;
+        trades[i].price = orders[i].price;
+        trades[i].volume = static_cast<int>(orders[i].volume);
+    }
+
+    const uint64_t operations = ORDERS / 10;
+    runner.run("risk", "engine_check_reserve_fill", {{"instruments", INSTRUMENTS}}, operations,
+               [&engine, &orders, &orderIds, &trades, operations]() {
+        uint32_t result = 0;
+        for (uint64_t i = 0; i < operations; ++i) {
+            size_t slot = i & (orders.size() - 1);
+            result |= engine.check(orders[slot]);
+            engine.reserve(orderIds[slot], orders[slot]);
+            engine.onTrade(trades[slot]);
+        }
+        doNotOptimize(result);
+    });
+}
+
+// RiskManager处理新报订单事件：引擎检查加规则链
+void benchmarkRiskManager(BenchmarkRunner& runner) {
+    auto eventManager = std::make_shared<EventManager>();
+    RiskLimits limits;
+    limits.maxOpenOrdersPerInstrument = 1000000000;
+    limits.maxOpenOrdersPerStrategy = 1000000000;
+    RiskManager riskManager(eventManager, std::make_shared<RiskEngine>(limits));
+    riskManager.addRule(std::make_shared<PositionLimitRule>(1000000, 1000000));
+
+    // 同一订单编号反复提交，引擎只登记一次，避免挂单量累积
+    OrderData data;
+    data.orderId = "bench";
+    data.symbol = "rb2410";
+    data.direction = OrderDirection::BUY;
+    data.type = OrderType::LIMIT;
+    data.status = OrderStatus::SUBMITTED;
+    data.price = 3500.0;
+    data.volume = 1;
+    data.tradedVolume = 0;
+    data.strategyId = "Strategy0";
+    std::shared_ptr<Event> event = std::make_shared<OrderEvent>(data);
+
+    const uint64_t operations = ORDERS / 10;
+    runner.run("risk", "risk_manager_order_event", {}, operations, [&riskManager, &event, operations]() {
+        for (uint64_t i = 0; i < operations; ++i) {
+            riskManager.handleEvent(event);
+        }
+    });
+}
+
+// 分层限速：策略、合约、账户、交易所四级令牌同时申请
+void benchmarkRateLimiter(BenchmarkRunner& runner) {
+    OrderRateLimitConfig config;
+    config.strategy = RateLimit(1e9, 1e9);
+    config.instrument = RateLimit(1e9, 1e9);
+    config.account = RateLimit(1e9, 1e9);
+    config.exchanges["SYN"] = RateLimit(1e9, 1e9);
+    OrderRateLimiter limiter(config);
+    for (int i = 0; i < INSTRUMENTS; ++i) {
+        limiter.setInstrumentExchange(i, "SYN");
+    }
+
+    runner.run("risk", "rate_limiter_acquire_order", {}, ORDERS, [&limiter]() {
+        uint32_t result = 0;
+        int64_t now = latencyNow();
+        for (uint64_t i = 0; i < ORDERS; ++i) {
+            result |= limiter.acquireOrder(static_cast<int>(i % INSTRUMENTS), static_cast<int>(i % STRATEGIES),
+                                           now + static_cast<int64_t>(i));
+        }
+        doNotOptimize(result);
+    });
+}
+
+// 组合情景重估：账户和各策略持仓在全部情景下的一次完整重估（含持仓表构建）
+void benchmarkScenarioRevalue(BenchmarkRunner& runner) {
+    const int instruments = 2000;
+    RiskLimits limits;
+    limits.maxTotalPosition = 100000000;
+    limits.maxPositionPerInstrument = 100000000;
+    limits.maxPositionPerStrategy = 100000000;
+    limits.maxTotalNotional = 1e18;
+    limits.maxNotionalPerInstrument = 1e18;
+    auto riskEngine = std::make_shared<RiskEngine>(limits);
+    auto pnlEngine = std::make_shared<PnlEngine>();
+
+    // 每个合约由两个策略各持有一部分仓位
+    for (int i = 0; i < instruments; ++i) {
+        std::string symbol = "SYN" + std::to_string(i);
+        int instrument = pnlEngine->internInstrument(symbol);
+        pnlEngine->onTick(instrument, 3500.0 + i);
+        pnlEngine->setPriceLimits(instrument, (3500.0 + i) * 1.07, (3500.0 + i) * 0.93);
+
+        for (int leg = 0; leg < 2; ++leg) {
+            TradeData trade;
+            trade.orderId = "order" + std::to_string(i) + "_" + std::to_string(leg);
+            trade.symbol = symbol;
+            trade.direction = (i + leg) % 2 == 0 ? OrderDirection::BUY : OrderDirection::SELL;
+            trade.price = 3500.0 + i;
+            trade.volume = 1 + (i % 5);
+
+            OrderData data;
+            data.orderId = trade.orderId;
+            data.symbol = symbol;
+            data.direction = trade.direction;
+            data.price = trade.price;
+            data.volume = trade.volume;
+            data.strategyId = "Strategy" + std::to_string((i + leg) % STRATEGIES);
+            RiskOrder order;
+            riskEngine->makeOrder(data, order);
+            riskEngine->reserve(trade.orderId, order);
+            riskEngine->onTrade(trade);
+            pnlEngine->onTrade(trade);
+        }
+    }
+
+    ScenarioRiskConfig config;
+    ScenarioRiskEngine scenarioEngine(config, pnlEngine, riskEngine, nullptr);
+
+    const uint64_t operations = 200;
+    runner.run("risk", "scenario_revalue", {{"instruments", instruments}, {"scenarios", static_cast<double>(config.scenarios.size())}},
+               operations, [&scenarioEngine, operations]() {
+        for (uint64_t i = 0; i < operations; ++i) {
+            scenarioEngine.revalue();
+        }
+    });
+}
+
+} // namespace
+
+void runRiskBenchmarks(BenchmarkRunner& runner) {
+    benchmarkEngineCheck(runner);
+    benchmarkEngineLifecycle(runner);
+    benchmarkRiskManager(runner);
+    benchmarkRateLimiter(runner);
+    benchmarkScenarioRevalue(runner);
+}
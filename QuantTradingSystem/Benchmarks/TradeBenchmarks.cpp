@@ -0,0 +1,126 @@
+#include "BenchmarkHarness.h"
+#include "Trade/OrderGateway.h"
+#include "Trade/SimTradeFeed.h"
+#include "Utils/metrics/LatencyHistogram.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const uint64_t SIM_ORDERS = 100000;
+
+// 模拟交易所报单到成交回报的往返吞吐：报单全部按对手盘即时成交，等待所有成交回报
+void benchmarkSimRoundTrip(BenchmarkRunner& runner) {
+    if (!runner.isSelected("trade", "sim_round_trip")) {
+        return;
+    }
+
+    SimTradeFeed feed;
+    std::atomic<uint64_t> trades(0);
+    feed.SetTradeCallback([&trades](const trade::TradeData&) {
+        trades.fetch_add(1, std::memory_order_relaxed);
+    });
+    feed.Connect();
+    feed.Login("bench", "");
+
+    MarketDataField quote;
+    quote.symbol = "SYN0";
+    quote.lastPrice = 3500.0;
+    quote.volume = 0;
+    quote.bidPrice[0] = 3499.0;
+    quote.bidVolume[0] = 1000000000;
+    quote.askPrice[0] = 3500.0;
+    quote.askVolume[0] = 1000000000;
+    feed.onMarketData(quote);
+
+    trade::OrderData order = trade::OrderData();
+    order.symbol = "SYN0";
+    order.offset = trade::OrderOffset::Open;
+    order.priceType = trade::OrderPriceType::Limit;
+    order.volume = 1;
+
+    runner.run("trade", "sim_round_trip", {{"orders", static_cast<double>(SIM_ORDERS)}}, SIM_ORDERS,
+               [&feed, &trades, &order]() {
+        uint64_t target = trades.load(std::memory_order_relaxed) + SIM_ORDERS;
+        for (uint64_t i = 0; i < SIM_ORDERS; ++i) {
+            bool buy = (i & 1) == 0;
+            order.direction = buy ? trade::OrderDirection::Buy : trade::OrderDirection::Sell;
+            order.price = buy ? 3500.0 : 3499.0;
+            doNotOptimize(feed.PlaceOrder(order));
+        }
+        while (trades.load(std::memory_order_relaxed) < target) {
+            std::this_thread::yield();
+        }
+    });
+
+    feed.Disconnect();
+}
+
+// 经报单网关提交并发送的吞吐，及调用方的单笔提交耗时（入队即返回，不等待交易接口）
+void benchmarkGatewaySubmit(BenchmarkRunner& runner) {
+    if (!runner.isSelected("trade", "gateway_submit")) {
+        return;
+    }
+
+    auto feed = std::make_shared<SimTradeFeed>();
+    feed->Connect();
+    feed->Login("bench", "");
+
+    std::atomic<uint64_t> sent(0);
+    OrderGateway gateway(feed, OrderGatewayConfig());
+    gateway.setCallbacks([&sent](const GatewayRequest&, const std::string&) {
+        sent.fetch_add(1, std::memory_order_relaxed);
+    }, nullptr);
+    gateway.start();
+
+    trade::OrderData order = trade::OrderData();
+    order.symbol = "SYN0";
+    order.direction = trade::OrderDirection::Buy;
+    order.offset = trade::OrderOffset::Open;
+    order.priceType = trade::OrderPriceType::Limit;
+    order.price = 3000.0;
+    order.volume = 1;
+
+    // 每轮提交后等待网关发完，避免队列满时的等待计入下一轮
+    const uint64_t operations = 512;
+    runner.run("trade", "gateway_submit", {{"ring", static_cast<double>(OrderGateway::RING_CAPACITY)}}, operations,
+               [&gateway, &sent, &order, operations]() {
+        uint64_t target = sent.load(std::memory_order_relaxed) + operations;
+        for (uint64_t i = 0; i < operations; ++i) {
+            doNotOptimize(gateway.submitOrder(order, nullptr, LatencyTrace()));
+        }
+        while (sent.load(std::memory_order_relaxed) < target) {
+            std::this_thread::yield();
+        }
+    });
+
+    LatencyHistogram histogram;
+    for (int round = 0; round < 200; ++round) {
+        uint64_t target = sent.load(std::memory_order_relaxed) + operations;
+        for (uint64_t i = 0; i < operations; ++i) {
+            int64_t start = latencyNow();
+            ClientOrderHandle handle = gateway.submitOrder(order, nullptr, LatencyTrace());
+            histogram.record(latencyNow() - start);
+            doNotOptimize(handle);
+        }
+        while (sent.load(std::memory_order_relaxed) < target) {
+            std::this_thread::yield();
+        }
+    }
+    std::cout << "  trade gateway_submit caller latency: p50=" << histogram.getPercentile(50.0)
+              << "ns p99=" << histogram.getPercentile(99.0)
+              << "ns p99.9=" << histogram.getPercentile(99.9)
+              << "ns max=" << histogram.getMax() << "ns" << std::endl;
+
+    gateway.stop();
+    feed->Disconnect();
+}
+
+} // namespace
+
+void runTradeBenchmarks(BenchmarkRunner& runner) {
+    benchmarkSimRoundTrip(runner);
+    benchmarkGatewaySubmit(runner);
+}
@@ -0,0 +1,166 @@
+#include "Utils/logger/LogBinaryFormat.h"
+#include "Utils/logger/LogLineFormatter.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace QuantTrading;
+
+namespace {
+
+// 输出缓冲超过此大小时写出
+const size_t OUTPUT_LIMIT = 1024 * 1024;
+
+// 文件中定义的调用点
+struct DecodedSite {
+    LogLevel level;
+    int line;
+    std::string file;
+    std::string function;
+    std::string format;
+    bool defined;
+
+    DecodedSite() : level(LogLevel::INFO), line(0), defined(false) {}
+};
+
+// 解码一个二进制日志文件，文本行写入out；文件末尾不完整（进程中途退出）时解码到最后一条完整记录
+bool decodeFile(const std::string& path, std::ostream& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!LogBinary::checkFileHeader(data.data(), data.size())) {
+        std::cerr << path << ": not a binary log file or unsupported version" << std::endl;
+        return false;
+    }
+
+    std::vector<DecodedSite> sites;
+    LogLineFormatter formatter;
+    std::string args;
+    std::string message;
+    std::string text;
+    int64_t timestampNs = 0;
+    uint64_t records = 0;
+
+    const char* begin = data.data();
+    const char* p = begin + LogBinary::FILE_HEADER_SIZE;
+    const char* end = begin + data.size();
+    while (p < end) {
+        const char* entry = p;
+        uint64_t siteId;
+        if (!LogBinary::getVarint(p, end, siteId)) {
+            std::cerr << path << ": truncated at offset " << (entry - begin) << std::endl;
+            break;
+        }
+
+        // 调用点定义
+        if (siteId == 0) {
+            uint64_t id;
+            uint64_t line;
+            DecodedSite site;
+            if (!LogBinary::getVarint(p, end, id) || p >= end) {
+                std::cerr << path << ": truncated at offset " << (entry - begin) << std::endl;
+                break;
+            }
+            site.level = static_cast<LogLevel>(*p++);
+            if (!LogBinary::getVarint(p, end, line) ||
+                !LogBinary::getString(p, end, site.file) ||
+                !LogBinary::getString(p, end, site.function) ||
+                !LogBinary::getString(p, end, site.format)) {
+                std::cerr << path << ": truncated at offset " << (entry - begin) << std::endl;
+                break;
+            }
+            site.line = static_cast<int>(line);
+            site.defined = true;
+            if (sites.size() <= id) {
+                sites.resize(static_cast<size_t>(id) + 1);
+            }
+            sites[static_cast<size_t>(id)] = site;
+            continue;
+        }
+
+        // 日志记录
+        uint64_t delta;
+        uint64_t size;
+        if (!LogBinary::getVarint(p, end, delta) || !LogBinary::getVarint(p, end, size) ||
+            size > static_cast<uint64_t>(end - p)) {
+            std::cerr << path << ": truncated at offset " << (entry - begin) << std::endl;
+            break;
+        }
+        const char* packed = p;
+        p += size;
+        timestampNs += LogBinary::unzigzag(delta);
+
+        if (siteId >= sites.size() || !sites[static_cast<size_t>(siteId)].defined) {
+            std::cerr << path << ": record at offset " << (entry - begin)
+                      << " refers to undefined site " << siteId << std::endl;
+            continue;
+        }
+        const DecodedSite& site = sites[static_cast<size_t>(siteId)];
+
+        args.clear();
+        message.clear();
+        if (!LogBinary::expandArgs(args, packed, p)) {
+            std::cerr << path << ": malformed arguments at offset " << (entry - begin) << std::endl;
+        }
+        formatLogMessage(message, site.format.c_str(), args.data(), args.data() + args.size());
+        formatter.append(text, site.level, site.file.c_str(), site.line, site.function.c_str(),
+                         timestampNs, message);
+        ++records;
+
+        if (text.size() >= OUTPUT_LIMIT) {
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            text.clear();
+        }
+    }
+
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    std::cerr << path << ": " << records << " records" << std::endl;
+    return true;
+}
+
+} // namespace
+
+// 二进制日志解码工具，把AsyncLogger的.qlog文件还原为与文本模式相同的日志行
+// 用法:
+//   LogDecoder 日志文件... [--out 输出文件]
+// 多个文件按给出的顺序解码；未指定输出文件时写到标准输出
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    std::string outputFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        std::cerr << "Usage: LogDecoder <file.qlog>... [--out output.log]" << std::endl;
+        return 1;
+    }
+
+    std::ofstream output;
+    if (!outputFile.empty()) {
+        output.open(outputFile);
+        if (!output) {
+            std::cerr << "Cannot open " << outputFile << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputFile.empty() ? std::cout : output;
+
+    bool ok = true;
+    for (const auto& file : files) {
+        ok = decodeFile(file, out) && ok;
+    }
+    return ok ? 0 : 1;
+}
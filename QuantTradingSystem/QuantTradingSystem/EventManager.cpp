@@ -1,13 +1,32 @@
 #include "EventManager.h"
+#include "Utils/latency/LatencyTracer.h"
+#include "Utils/logger/AsyncLogger.h"
 #include <algorithm>
-#include <iostream>
 #include <ctime>
 
-EventManager::EventManager() : running_(false) {
+EventManager::EventManager()
+    : queueDepth_(0), signalQueueDepth_(0), running_(false), timerWake_(false) {
+    auto& registry = MetricsRegistry::getInstance();
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        eventCounters_[i] = &registry.getCounter(
+            std::string("events.") + getEventTypeName(static_cast<EventType>(i)));
+    }
+    queueFullRetries_ = &registry.getCounter("event_queue.full_retries");
+    
+    registry.registerProbe("event_queue.depth", [this]() {
+        return static_cast<int64_t>(getEventQueueSize());
+    });
+    registry.registerProbe("signal_queue.depth", [this]() {
+        return static_cast<int64_t>(getSignalQueueSize());
+    });
 }
 
 EventManager::~EventManager() {
     stop();
+    
+    auto& registry = MetricsRegistry::getInstance();
+    registry.unregisterProbe("event_queue.depth");
+    registry.unregisterProbe("signal_queue.depth");
 }
 
 void EventManager::start() {
@@ -48,6 +67,11 @@ void EventManager::stop() {
         while (eventQueue_.pop(event)) {
             // 清空队列
         }
+        while (signalQueue_.pop(event)) {
+            // 清空信号通道
+        }
+        queueDepth_ = 0;
+        signalQueueDepth_ = 0;
     }
 }
 
@@ -55,7 +79,7 @@ void EventManager::registerHandler(std::shared_ptr<EventHandler> handler) {
     if (!handler) return;
     
     std::lock_guard<std::mutex> lock(eventMutex_);
-    handlers_.push_back(handler);
+    handlers_.push_back(makeHandlerEntry(handler));
 }
 
 void EventManager::unregisterHandler(std::shared_ptr<EventHandler> handler) {
@@ -66,8 +90,8 @@ void EventManager::unregisterHandler(std::shared_ptr<EventHandler> handler) {
         std::remove_if(
             handlers_.begin(), 
             handlers_.end(),
-            [&handler](const std::shared_ptr<EventHandler>& h) { 
-                return h == handler; 
+            [&handler](const HandlerEntry& entry) { 
+                return entry.handler == handler; 
             }
         ),
         handlers_.end()
@@ -80,8 +104,8 @@ void EventManager::unregisterHandler(std::shared_ptr<EventHandler> handler) {
             std::remove_if(
                 typeHandlerList.begin(), 
                 typeHandlerList.end(),
-                [&handler](const std::shared_ptr<EventHandler>& h) { 
-                    return h == handler; 
+                [&handler](const HandlerEntry& entry) { 
+                    return entry.handler == handler; 
                 }
             ),
             typeHandlerList.end()
@@ -97,59 +121,135 @@ void EventManager::processEvents() {
     while (eventBuffer_.size() < MAX_BUFFER_SIZE && eventQueue_.pop(event)) {
         eventBuffer_.push_back(event);
     }
+    queueDepth_.fetch_sub(static_cast<int64_t>(eventBuffer_.size()), std::memory_order_relaxed);
+    
+    // 信号通道优先：每处理一个普通事件前先清空信号通道，
+    // 保证处理行情过程中产生的信号不必排在整批行情之后
+    drainSignalQueue();
     
     for (auto& event : eventBuffer_) {
-        // 检查是否有针对该事件类型的处理器
-        EventType type = event->getType();
-        
-        // 首先使用特定类型的处理器
-        {
-            std::lock_guard<std::mutex> lock(eventMutex_);
-            auto it = typeHandlers_.find(type);
-            if (it != typeHandlers_.end()) {
-                for (auto& handler : it->second) {
-                    try {
-                        handler->handleEvent(event);
-                    } catch (const std::exception& e) {
-                        std::cerr << "Error handling event in " << handler->getName() 
-                                 << ": " << e.what() << std::endl;
-                    }
-                }
+        dispatchEvent(event);
+        drainSignalQueue();
+    }
+}
+
+void EventManager::drainSignalQueue() {
+    std::shared_ptr<Event> event;
+    while (signalQueue_.pop(event)) {
+        signalQueueDepth_.fetch_sub(1, std::memory_order_relaxed);
+        dispatchEvent(event);
+    }
+}
+
+void EventManager::dispatchEvent(const std::shared_ptr<Event>& event) {
+    // 检查是否有针对该事件类型的处理器
+    EventType type = event->getType();
+    
+    event->getTrace().stamp(type == EventType::STRATEGY_SIGNAL ?
+                            LatencyStage::SIGNAL_DEQUEUE : LatencyStage::DEQUEUE);
+    
+    eventCounters_[static_cast<size_t>(type)]->add();
+    
+    // 首先使用特定类型的处理器
+    {
+        std::lock_guard<std::mutex> lock(eventMutex_);
+        auto it = typeHandlers_.find(type);
+        if (it != typeHandlers_.end()) {
+            for (auto& entry : it->second) {
+                invokeHandler(entry, event);
             }
         }
-        
-        // 然后使用通用处理器
-        {
-            std::lock_guard<std::mutex> lock(eventMutex_);
-            for (auto& handler : handlers_) {
-                try {
-                    handler->handleEvent(event);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error handling event in " << handler->getName() 
-                             << ": " << e.what() << std::endl;
-                }
-            }
+    }
+    
+    // 然后使用通用处理器
+    {
+        std::lock_guard<std::mutex> lock(eventMutex_);
+        for (auto& entry : handlers_) {
+            invokeHandler(entry, event);
         }
     }
+    
+    // 行情事件处理完成，记录从回调到策略处理完成的各阶段耗时
+    if (type == EventType::MARKET_DATA) {
+        LatencyTracer::getInstance().record(event->getTrace(), LatencyStage::CONVERT,
+                                            LatencyStage::STRATEGY_EXIT);
+    }
+}
+
+void EventManager::invokeHandler(const HandlerEntry& entry, const std::shared_ptr<Event>& event) {
+    int64_t start = latencyNow();
+    
+    try {
+        entry.handler->handleEvent(event);
+    } catch (const std::exception& e) {
+        entry.exceptions->add();
+        LOG_ERROR("Error handling event in " + entry.handler->getName() + ": " + e.what());
+    }
+    
+    entry.execTime->record(latencyNow() - start);
+}
+
+EventManager::HandlerEntry EventManager::makeHandlerEntry(const std::shared_ptr<EventHandler>& handler) {
+    auto& registry = MetricsRegistry::getInstance();
+    const std::string prefix = "handler." + handler->getName();
+    
+    HandlerEntry entry;
+    entry.handler = handler;
+    entry.execTime = &registry.getHistogram(prefix + ".exec_ns");
+    entry.exceptions = &registry.getCounter(prefix + ".exceptions");
+    return entry;
 }
 
 void EventManager::addEvent(std::shared_ptr<Event> event) {
     if (!event) return;
     
+    event->getTrace().stamp(event->getType() == EventType::STRATEGY_SIGNAL ?
+                            LatencyStage::SIGNAL_ENQUEUE : LatencyStage::ENQUEUE);
+    
     // 使用无锁队列的push操作
     while (!eventQueue_.push(event)) {
         // 如果队列满，等待一小段时间后重试
+        queueFullRetries_->add();
+        std::this_thread::yield();
+    }
+    queueDepth_.fetch_add(1, std::memory_order_relaxed);
+    
+    eventCondition_.notify_one();
+}
+
+void EventManager::addSignalEvent(std::shared_ptr<Event> event) {
+    if (!event) return;
+    
+    event->getTrace().stamp(LatencyStage::SIGNAL_ENQUEUE);
+    
+    while (!signalQueue_.push(event)) {
+        queueFullRetries_->add();
         std::this_thread::yield();
     }
+    signalQueueDepth_.fetch_add(1, std::memory_order_relaxed);
     
     eventCondition_.notify_one();
 }
 
+void EventManager::setTimerService(std::shared_ptr<TimerService> timerService) {
+    if (timerService) {
+        // 不持有eventMutex_：定时器可能在处理器内（分发线程持有eventMutex_时）登记，
+        // 与addEvent一样无锁通知，错过的通知由等待上限兜底
+        timerService->setWakeup([this]() {
+            timerWake_.store(true, std::memory_order_release);
+            eventCondition_.notify_one();
+        });
+    }
+    
+    std::lock_guard<std::mutex> lock(eventMutex_);
+    timerService_ = timerService;
+}
+
 void EventManager::registerHandlerForType(EventType type, std::shared_ptr<EventHandler> handler) {
     if (!handler) return;
     
     std::lock_guard<std::mutex> lock(eventMutex_);
-    typeHandlers_[type].push_back(handler);
+    typeHandlers_[type].push_back(makeHandlerEntry(handler));
 }
 
 void EventManager::unregisterHandlerForType(EventType type, std::shared_ptr<EventHandler> handler) {
@@ -163,8 +263,8 @@ void EventManager::unregisterHandlerForType(EventType type, std::shared_ptr<Even
             std::remove_if(
                 typeHandlerList.begin(), 
                 typeHandlerList.end(),
-                [&handler](const std::shared_ptr<EventHandler>& h) { 
-                    return h == handler; 
+                [&handler](const HandlerEntry& entry) { 
+                    return entry.handler == handler; 
                 }
             ),
             typeHandlerList.end()
@@ -173,22 +273,52 @@ void EventManager::unregisterHandlerForType(EventType type, std::shared_ptr<Even
 }
 
 bool EventManager::isEventQueueEmpty() const {
-    return eventQueue_.empty();
+    return eventQueue_.empty() && signalQueue_.empty();
 }
 
 size_t EventManager::getEventQueueSize() const {
-    return eventQueue_.size();
+    // 出队计数可能先于入队计数生效，短暂为负时按0处理
+    int64_t depth = queueDepth_.load(std::memory_order_relaxed);
+    return depth > 0 ? static_cast<size_t>(depth) : 0;
+}
+
+size_t EventManager::getSignalQueueSize() const {
+    int64_t depth = signalQueueDepth_.load(std::memory_order_relaxed);
+    return depth > 0 ? static_cast<size_t>(depth) : 0;
 }
 
 void EventManager::eventProcessingThread() {
     while (running_) {
         std::unique_lock<std::mutex> lock(eventMutex_);
-        eventCondition_.wait(lock, [this]() { 
-            return !eventQueue_.empty() || !running_; 
-        });
+        auto ready = [this]() { 
+            return !eventQueue_.empty() || !signalQueue_.empty() ||
+                   timerWake_.load(std::memory_order_acquire) || !running_; 
+        };
+        
+        // 实时时钟的定时器服务：最多等到最早到期时间
+        std::shared_ptr<TimerService> timers = timerService_;
+        if (timers && timers->isManualClock()) {
+            timers.reset();
+        }
+        if (timers) {
+            int64_t deadline = std::min(timers->nextExpiryNs(), latencyNow() + MAX_TIMER_WAIT_NS);
+            eventCondition_.wait_until(lock,
+                std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)), ready);
+        } else {
+            eventCondition_.wait(lock, ready);
+        }
+        timerWake_.store(false, std::memory_order_relaxed);
         
         if (!running_) break;
         
+        // 处理器分发时会再次获取eventMutex_，这里必须先释放
+        lock.unlock();
+        
+        // 到期定时器的事件先入队，随本轮一起处理
+        if (timers) {
+            timers->advance(latencyNow());
+        }
+        
         // 处理事件
         processEvents();
     }
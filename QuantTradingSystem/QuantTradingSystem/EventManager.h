@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -11,6 +12,8 @@
 #include "Handlers/EventHandler.h"
 #include "Events/AllEvents.h"
 #include "Utils/LockFreeQueue.h"
+#include "Utils/metrics/MetricsRegistry.h"
+#include "Utils/timer/TimerService.h"
 
 class EventManager {
 public:
@@ -34,6 +37,9 @@ public:
     
     // 添加事件
     void addEvent(std::shared_ptr<Event> event);
+    
+    // 添加信号事件（信号专用通道，优先于通用队列中的事件处理）
+    void addSignalEvent(std::shared_ptr<Event> event);
 
     // 按事件类型注册处理器
     void registerHandlerForType(EventType type, std::shared_ptr<EventHandler> handler);
@@ -47,16 +53,43 @@ public:
     // 获取事件队列大小
     size_t getEventQueueSize() const;
     
+    // 获取信号通道大小
+    size_t getSignalQueueSize() const;
+    
+    // 设置定时器服务（在start之前调用）：到期事件进入事件队列；
+    // 实时时钟下由分发线程按最早到期时间等待并推进，手动时钟下由回放推进
+    void setTimerService(std::shared_ptr<TimerService> timerService);
+    
 private:
+    // 处理器及其指标（注册时从指标中心取出，分发时不再查找）
+    struct HandlerEntry {
+        std::shared_ptr<EventHandler> handler;
+        MetricHistogram* execTime;
+        MetricCounter* exceptions;
+    };
+    
     // 所有事件处理器
-    std::vector<std::shared_ptr<EventHandler>> handlers_;
+    std::vector<HandlerEntry> handlers_;
     
     // 按事件类型分类的处理器
-    std::unordered_map<EventType, std::vector<std::shared_ptr<EventHandler>>> typeHandlers_;
+    std::unordered_map<EventType, std::vector<HandlerEntry>> typeHandlers_;
     
     // 使用无锁队列
     Utils::LockFreeQueue<std::shared_ptr<Event>, 10000> eventQueue_;
     
+    // 信号专用通道
+    Utils::LockFreeQueue<std::shared_ptr<Event>, 1000> signalQueue_;
+    
+    // 队列深度，入队和出队时维护，读取为O(1)
+    std::atomic<int64_t> queueDepth_;
+    std::atomic<int64_t> signalQueueDepth_;
+    
+    // 各类型事件的分发计数
+    std::array<MetricCounter*, EVENT_TYPE_COUNT> eventCounters_;
+    
+    // 队列满时的重试次数
+    MetricCounter* queueFullRetries_;
+    
     // 互斥锁和条件变量，用于同步事件处理
     mutable std::mutex eventMutex_;
     std::condition_variable eventCondition_;
@@ -64,12 +97,31 @@ private:
     // 控制事件处理线程的标志
     std::atomic<bool> running_;
     
+    // 定时器服务及其唤醒标志（登记了更早到期的定时器）
+    std::shared_ptr<TimerService> timerService_;
+    std::atomic<bool> timerWake_;
+    
+    // 没有事件时分发线程的最长等待时间，兜底无锁通知在等待前一刻发出而被错过的情况
+    static constexpr int64_t MAX_TIMER_WAIT_NS = 100000000;
+    
     // 事件处理线程
     std::thread eventThread_;
     
     // 事件处理线程函数
     void eventProcessingThread();
     
+    // 将单个事件分发给处理器
+    void dispatchEvent(const std::shared_ptr<Event>& event);
+    
+    // 调用单个处理器，统计耗时和异常
+    void invokeHandler(const HandlerEntry& entry, const std::shared_ptr<Event>& event);
+    
+    // 创建处理器条目
+    static HandlerEntry makeHandlerEntry(const std::shared_ptr<EventHandler>& handler);
+    
+    // 处理信号专用通道中的所有事件
+    void drainSignalQueue();
+    
     // 临时事件缓冲区，用于批量处理事件
     std::vector<std::shared_ptr<Event>> eventBuffer_;
     static const size_t MAX_BUFFER_SIZE = 1000;
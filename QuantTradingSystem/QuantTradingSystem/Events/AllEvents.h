@@ -9,4 +9,5 @@
 #include "AccountEvent.h"
 #include "RiskEvent.h"
 #include "StrategySignalEvent.h"
+#include "TimerEvent.h"
 #include "SystemEvent.h" 
\ No newline at end of file
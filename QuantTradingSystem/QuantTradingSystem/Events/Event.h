@@ -2,6 +2,7 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include "../Utils/latency/LatencyTrace.h"
 
 // 事件类型枚举
 enum class EventType {
@@ -12,9 +13,29 @@ enum class EventType {
     ACCOUNT,        // 账户事件
     RISK_CONTROL,   // 风控事件
     STRATEGY_SIGNAL,// 策略信号事件
+    TIMER,          // 定时器事件
     SYSTEM          // 系统事件
 };
 
+// 事件类型数量
+const size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::SYSTEM) + 1;
+
+// 获取事件类型名称
+inline const char* getEventTypeName(EventType type) {
+    switch (type) {
+        case EventType::MARKET_DATA:     return "market_data";
+        case EventType::ORDER:           return "order";
+        case EventType::TRADE:           return "trade";
+        case EventType::POSITION:        return "position";
+        case EventType::ACCOUNT:         return "account";
+        case EventType::RISK_CONTROL:    return "risk_control";
+        case EventType::STRATEGY_SIGNAL: return "strategy_signal";
+        case EventType::TIMER:           return "timer";
+        case EventType::SYSTEM:          return "system";
+        default:                         return "unknown";
+    }
+}
+
 // 事件基类
 class Event {
 public:
@@ -29,12 +50,20 @@ public:
     // 获取事件时间戳
     std::chrono::system_clock::time_point getTimestamp() const { return timestamp_; }
     
+    // 获取链路延迟打点记录
+    LatencyTrace& getTrace() { return trace_; }
+    const LatencyTrace& getTrace() const { return trace_; }
+    
+    // 继承上游事件的打点记录
+    void setTrace(const LatencyTrace& trace) { trace_ = trace; }
+    
     // 获取事件描述
     virtual std::string toString() const = 0;
     
 private:
     EventType type_;
     std::chrono::system_clock::time_point timestamp_;
+    LatencyTrace trace_;
 };
 
 // 事件指针类型
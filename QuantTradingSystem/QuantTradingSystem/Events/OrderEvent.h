@@ -39,6 +39,7 @@ struct OrderData {
     int volume;                 // 数量
     int tradedVolume;           // 已成交数量
     std::string strategyId;     // 策略ID
+    std::string parentOrderId;  // 执行算法母单编号，只有子单填写
     std::string createTime;     // 创建时间
     std::string updateTime;     // 更新时间
 };
@@ -24,6 +24,14 @@ struct PositionData {
     std::string updateTime;       // 更新时间
 };
 
+// 持仓均价：数据带均价时直接使用，否则按开仓成本和合约乘数折算
+inline double getPositionAvgPrice(const PositionData& data, double multiplier) {
+    if (data.avgPrice > 0.0 || data.position <= 0 || multiplier <= 0.0) {
+        return data.avgPrice;
+    }
+    return data.openCost / (data.position * multiplier);
+}
+
 // 持仓事件
 class PositionEvent : public Event {
 public:
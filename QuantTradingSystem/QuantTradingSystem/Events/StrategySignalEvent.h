@@ -1,6 +1,7 @@
 #pragma once
 #include "Event.h"
 #include "OrderEvent.h"
+#include <cstdint>
 #include <string>
 #include <sstream>
 
@@ -12,6 +13,26 @@ enum class SignalType {
     CLOSE_SHORT    // 平空
 };
 
+// 执行算法类型
+enum class ExecAlgoType {
+    NONE,       // 不拆单，直接按信号价格报一笔限价单
+    TWAP,       // 在执行时长内按时间均匀拆单
+    POV,        // 按行情成交量增量的固定比例跟量拆单（VWAP式执行）
+    ICEBERG     // 冰山单：每次只显示displayVolume手，成交后补单
+};
+
+// 执行算法参数
+struct ExecAlgoParams {
+    ExecAlgoType type;
+    int64_t durationMs;          // TWAP的执行时长；POV和ICEBERG的最长执行时间，0为不限
+    int sliceCount;              // TWAP的子单数，0为每秒一笔
+    double participationRate;    // POV的成交量参与率
+    int displayVolume;           // ICEBERG每次显示的数量
+
+    ExecAlgoParams()
+        : type(ExecAlgoType::NONE), durationMs(0), sliceCount(0), participationRate(0.1), displayVolume(1) {}
+};
+
 // 策略信号数据结构
 struct StrategySignalData {
     std::string strategyId;     // 策略ID
@@ -23,6 +44,7 @@ struct StrategySignalData {
     double takeProfit;          // 止盈价
     std::string signalTime;     // 信号时间
     std::string comment;        // 信号备注
+    ExecAlgoParams execAlgo;    // 执行算法，默认不拆单
 };
 
 // 策略信号事件
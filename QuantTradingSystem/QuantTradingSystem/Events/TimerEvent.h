@@ -0,0 +1,41 @@
+#pragma once
+#include "Event.h"
+#include <cstdint>
+#include <string>
+#include <sstream>
+
+// 定时器事件数据结构
+struct TimerEventData {
+    uint64_t timerId;     // 定时器编号，取消时使用
+    std::string owner;    // 登记者（策略ID），空为系统定时器
+    uint64_t tag;         // 登记时的用户数据
+    int64_t deadlineNs;   // 到期时间（按时间轮刻度取整，与定时器服务时钟同源）
+    int64_t firedNs;      // 实际触发时的时钟
+    bool periodic;        // 周期定时器，触发后继续有效
+
+    TimerEventData()
+        : timerId(0), tag(0), deadlineNs(0), firedNs(0), periodic(false) {}
+};
+
+// 定时器事件
+class TimerEvent : public Event {
+public:
+    TimerEvent(const TimerEventData& data)
+        : Event(EventType::TIMER), data_(data) {}
+
+    const TimerEventData& getData() const { return data_; }
+
+    std::string toString() const override {
+        std::stringstream ss;
+        ss << "TimerEvent: Id: " << data_.timerId
+           << " Owner: " << data_.owner
+           << " Tag: " << data_.tag
+           << " Deadline: " << data_.deadlineNs
+           << " Fired: " << data_.firedNs
+           << (data_.periodic ? " Periodic" : "");
+        return ss.str();
+    }
+
+private:
+    TimerEventData data_;
+};
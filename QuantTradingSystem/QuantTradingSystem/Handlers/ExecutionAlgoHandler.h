@@ -0,0 +1,25 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Trade/ExecutionAlgoEngine.h"
+#include <memory>
+
+// 执行算法行情处理器
+// 把行情送入执行算法引擎，更新子单报价用的盘口并驱动POV跟量。需注册MARKET_DATA事件。
+class ExecutionAlgoHandler : public EventHandler {
+public:
+    explicit ExecutionAlgoHandler(std::shared_ptr<ExecutionAlgoEngine> engine)
+        : EventHandler("ExecutionAlgoHandler"), engine_(engine) {}
+
+    ~ExecutionAlgoHandler() override = default;
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::MARKET_DATA) return;
+
+        engine_->onMarketData(static_cast<const MarketDataEvent*>(event.get())->getData());
+    }
+
+private:
+    std::shared_ptr<ExecutionAlgoEngine> engine_;
+};
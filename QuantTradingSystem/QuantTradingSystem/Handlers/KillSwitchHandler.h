@@ -0,0 +1,40 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Trade/TradeService.h"
+#include <memory>
+
+// 熔断处理器
+// 收到严重级别（CRITICAL）的风控事件时触发TradeService的熔断开关。需注册RISK_CONTROL事件。
+// 默认按事件确定范围：带策略ID时熔断该策略，只带合约时熔断该合约，否则熔断整个账户。
+class KillSwitchHandler : public EventHandler {
+public:
+    KillSwitchHandler(std::shared_ptr<TradeService> tradingService, bool alwaysGlobal = false)
+        : EventHandler("KillSwitchHandler"),
+          tradingService_(tradingService),
+          alwaysGlobal_(alwaysGlobal) {}
+
+    ~KillSwitchHandler() override = default;
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::RISK_CONTROL) return;
+
+        const RiskData& data = static_cast<const RiskEvent*>(event.get())->getData();
+        if (data.level != RiskLevel::CRITICAL) {
+            return;
+        }
+
+        if (alwaysGlobal_ || (data.strategyId.empty() && data.symbol.empty())) {
+            tradingService_->EngageKillSwitch(KillScope::GLOBAL, "", data.message);
+        } else if (!data.strategyId.empty()) {
+            tradingService_->EngageKillSwitch(KillScope::STRATEGY, data.strategyId, data.message);
+        } else {
+            tradingService_->EngageKillSwitch(KillScope::INSTRUMENT, data.symbol, data.message);
+        }
+    }
+
+private:
+    std::shared_ptr<TradeService> tradingService_;
+    bool alwaysGlobal_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Risk/PnlEngine.h"
+#include <memory>
+
+// 盈亏处理器
+// 把行情和成交送入PnlEngine，持仓事件（登录后的柜台持仓快照）覆盖对应合约的持仓。
+// 需注册MARKET_DATA、TRADE和POSITION事件，并先于RiskManager注册。
+class PnlHandler : public EventHandler {
+public:
+    explicit PnlHandler(std::shared_ptr<PnlEngine> pnlEngine)
+        : EventHandler("PnlHandler"), pnlEngine_(pnlEngine) {}
+    
+    ~PnlHandler() override = default;
+    
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event) return;
+        
+        if (event->getType() == EventType::MARKET_DATA) {
+            const auto& data = static_cast<const MarketDataEvent*>(event.get())->getData();
+            int instrument = pnlEngine_->findInstrument(data.symbol);
+            if (instrument < 0) {
+                instrument = pnlEngine_->internInstrument(data.symbol);
+            }
+            pnlEngine_->onTick(instrument, data.lastPrice);
+            pnlEngine_->setPriceLimits(instrument, data.upperLimit, data.lowerLimit);
+        } else if (event->getType() == EventType::TRADE) {
+            pnlEngine_->onTrade(static_cast<const TradeEvent*>(event.get())->getData());
+        } else if (event->getType() == EventType::POSITION) {
+            const auto& data = static_cast<const PositionEvent*>(event.get())->getData();
+            int instrument = pnlEngine_->internInstrument(data.symbol);
+            if (instrument < 0) {
+                return;
+            }
+            int64_t netPosition = data.direction == PositionDirection::LONG ? data.position : -data.position;
+            pnlEngine_->setPosition(data.symbol, netPosition,
+                getPositionAvgPrice(data, pnlEngine_->getContractSpec(instrument).multiplier));
+        }
+    }
+    
+    // 获取盈亏引擎
+    std::shared_ptr<PnlEngine> getPnlEngine() const { return pnlEngine_; }
+    
+private:
+    std::shared_ptr<PnlEngine> pnlEngine_;
+};
@@ -1,6 +1,10 @@
 ﻿#pragma once
 #include "EventHandler.h"
 #include "../Events/AllEvents.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Risk/RiskEngine.h"
+#include "../Risk/RateLimiter.h"
+#include "../Risk/PnlEngine.h"
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -19,7 +23,9 @@
 // 风控规则基类
 class RiskRule {
 public:
-    RiskRule(const std::string& name) : name_(name) {}
+    RiskRule(const std::string& name)
+        : name_(name),
+          rejections_(MetricsRegistry::getInstance().getCounter("risk.rejections." + name)) {}
     virtual ~RiskRule() = default;
     
     // 检查风控规则
@@ -28,17 +34,25 @@ public:
     // 获取风控规则名称
     std::string getName() const { return name_; }
     
+    // 规则未通过时上报的风控类型
+    virtual RiskType getRiskType() const { return RiskType::SYSTEM_ERROR; }
+    
+    // 记录一次拒绝
+    void recordRejection() { rejections_.add(); }
+    
 protected:
     std::string name_;
+    MetricCounter& rejections_;
 };
 
 // 订单频率风控规则
+// 每个策略一个GCRA限速器：平均速率不超过maxOrdersPerSecond，突发不超过maxOrdersPerSecond*timeWindowSeconds。
+// 每个策略只保存一个时间戳，检查为O(1)。
 class OrderFrequencyRule : public RiskRule {
 public:
     OrderFrequencyRule(int maxOrdersPerSecond, int timeWindowSeconds)
         : RiskRule("OrderFrequencyRule"), 
-          maxOrdersPerSecond_(maxOrdersPerSecond),
-          timeWindowSeconds_(timeWindowSeconds) {}
+          limit_(maxOrdersPerSecond, static_cast<double>(maxOrdersPerSecond) * timeWindowSeconds) {}
     
     bool check(const std::shared_ptr<Event>& event) override {
         if (event->getType() != EventType::ORDER) {
@@ -52,47 +66,29 @@ public:
         
         const auto& data = orderEvent->getData();
         
-        // 获取当前时间
-        auto now = std::chrono::system_clock::now();
-        
-        // 清理过期记录
-        clearExpiredRecords(now);
+        // 只统计新报订单
+        if (data.status != OrderStatus::SUBMITTED) {
+            return true;
+        }
         
-        // 记录本次订单
         std::lock_guard<std::mutex> lock(mutex_);
-        orders_[data.strategyId].push_back(now);
-        
-        // 检查订单频率
-        if (orders_[data.strategyId].size() > static_cast<size_t>(maxOrdersPerSecond_ * timeWindowSeconds_)) {
-            return false; // 超过限制，拒绝订单
+        auto it = limiters_.find(data.strategyId);
+        if (it == limiters_.end()) {
+            it = limiters_.emplace(std::piecewise_construct,
+                                   std::forward_as_tuple(data.strategyId),
+                                   std::forward_as_tuple()).first;
+            it->second.configure(limit_);
         }
         
-        return true;
+        // 超过限制时拒绝订单，被拒绝的订单不消耗额度
+        return it->second.tryAcquire(latencyNow());
     }
     
-private:
-    void clearExpiredRecords(const std::chrono::system_clock::time_point& now) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto threshold = now - std::chrono::seconds(timeWindowSeconds_);
-        
-        for (auto& pair : orders_) {
-            auto& orderTimes = pair.second;
-            orderTimes.erase(
-                std::remove_if(
-                    orderTimes.begin(), 
-                    orderTimes.end(),
-                    [&threshold](const std::chrono::system_clock::time_point& t) { 
-                        return t < threshold; 
-                    }
-                ),
-                orderTimes.end()
-            );
-        }
-    }
+    RiskType getRiskType() const override { return RiskType::ORDER_FREQUENCY_LIMIT; }
     
-    int maxOrdersPerSecond_;
-    int timeWindowSeconds_;
-    std::unordered_map<std::string, std::vector<std::chrono::system_clock::time_point>> orders_;
+private:
+    RateLimit limit_;
+    std::unordered_map<std::string, GcraLimiter> limiters_;
     std::mutex mutex_;
 };
 
@@ -121,71 +117,91 @@ public:
             return true;
         }
         
-        // 检查单个合约持仓限制
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto& pos = positions_[data.symbol];
-            if (pos + data.volume > maxPositionPerSymbol_) {
-                return false;
-            }
+        // 单个合约和总持仓在同一次加锁内检查，总持仓在更新时维护
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = positions_.find(data.symbol);
+        int pos = it != positions_.end() ? it->second : 0;
+        if (pos + data.volume > maxPositionPerSymbol_) {
+            return false;
         }
         
-        // 检查总持仓限制
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            int totalPos = 0;
-            for (const auto& pair : positions_) {
-                totalPos += pair.second;
-            }
-            
-            if (totalPos + data.volume > maxTotalPosition_) {
-                return false;
-            }
+        if (totalPosition_ + data.volume > maxTotalPosition_) {
+            return false;
         }
         
         return true;
     }
     
+    RiskType getRiskType() const override { return RiskType::POSITION_LIMIT; }
+    
     // 更新持仓数据
     void updatePosition(const std::string& symbol, int position) {
         std::lock_guard<std::mutex> lock(mutex_);
-        positions_[symbol] = position;
+        int& current = positions_[symbol];
+        totalPosition_ += position - current;
+        current = position;
     }
     
 private:
     int maxPositionPerSymbol_;
     int maxTotalPosition_;
+    int totalPosition_ = 0;
     std::unordered_map<std::string, int> positions_;
     std::mutex mutex_;
 };
 
 // 亏损限制风控规则
+// 设置PnlEngine后按实时盈亏检查：当日亏损或回撤超限时拒绝新报订单，单笔成交亏损超限时上报。
+// PnlHandler需先于RiskManager注册，规则读取到的是已计入本笔成交的盈亏。
 class LossLimitRule : public RiskRule {
 public:
     LossLimitRule(double maxLossPerTrade, double maxDailyLoss)
         : RiskRule("LossLimitRule"), 
           maxLossPerTrade_(maxLossPerTrade),
           maxDailyLoss_(maxDailyLoss),
+          maxDrawdown_(0.0),
           dailyLoss_(0.0) {}
     
+    // 使用实时盈亏引擎，maxDrawdown为0时不检查回撤
+    void setPnlEngine(std::shared_ptr<PnlEngine> pnlEngine, double maxDrawdown) {
+        pnlEngine_ = pnlEngine;
+        maxDrawdown_ = maxDrawdown;
+    }
+    
     bool check(const std::shared_ptr<Event>& event) override {
-        if (event->getType() != EventType::TRADE) {
-            return true; // 非成交事件，直接通过
+        if (event->getType() == EventType::ORDER) {
+            const auto& data = static_cast<const OrderEvent*>(event.get())->getData();
+            if (data.status != OrderStatus::SUBMITTED) {
+                return true;
+            }
+            return !isLossLimitBreached();
         }
         
-        auto tradeEvent = std::dynamic_pointer_cast<TradeEvent>(event);
-        if (!tradeEvent) {
+        if (event->getType() != EventType::TRADE) {
             return true;
         }
         
-        const auto& data = tradeEvent->getData();
+        // 本笔成交的已实现亏损
+        if (pnlEngine_ && -pnlEngine_->getLastTradeRealized() > maxLossPerTrade_) {
+            return false;
+        }
         
-        // 计算本次交易盈亏
-        // 这里需要更多的成交和持仓信息才能准确计算
+        return !isLossLimitBreached();
+    }
+    
+    // 当日亏损或回撤是否超限
+    bool isLossLimitBreached() const {
+        if (pnlEngine_) {
+            return pnlEngine_->getDailyPnl() <= -maxDailyLoss_ ||
+                   (maxDrawdown_ > 0.0 && pnlEngine_->getDrawdown() >= maxDrawdown_);
+        }
         
-        return true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dailyLoss_ >= maxDailyLoss_;
     }
     
+    RiskType getRiskType() const override { return RiskType::LOSS_LIMIT; }
+    
     // 重置每日亏损
     void resetDailyLoss() {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -201,24 +217,42 @@ public:
 private:
     double maxLossPerTrade_;
     double maxDailyLoss_;
+    double maxDrawdown_;
     double dailyLoss_;
-    std::mutex mutex_;
+    std::shared_ptr<PnlEngine> pnlEngine_;
+    mutable std::mutex mutex_;
 };
 
 // 风控管理器
+// 订单和成交回报先更新风控引擎中的预计算状态，新报订单先经过引擎的O(1)限额检查，再依次经过各条规则。
+// 持仓事件（登录后的柜台持仓快照）直接覆盖引擎中的净持仓。
+// 下单路径上启用RiskGate后，应切换为事后监控模式：只维护引擎状态，规则未通过时只发布风控事件。
 class RiskManager : public EventHandler {
 public:
-    RiskManager(std::shared_ptr<EventManager> eventManager)
-        : EventHandler("RiskManager"), eventManager_(eventManager) {}
+    typedef std::vector<std::shared_ptr<RiskRule>> RuleList;
+    
+    RiskManager(std::shared_ptr<EventManager> eventManager,
+                std::shared_ptr<RiskEngine> engine = std::make_shared<RiskEngine>())
+        : EventHandler("RiskManager"), eventManager_(eventManager), engine_(engine),
+          rules_(std::make_shared<const RuleList>()), postTradeOnly_(false) {}
     
     ~RiskManager() override = default;
     
+    // 设置事后监控模式，订单已由RiskGate在发送前检查并登记
+    void setPostTradeOnly(bool postTradeOnly) { postTradeOnly_ = postTradeOnly; }
+    bool isPostTradeOnly() const { return postTradeOnly_; }
+    
+    // 获取风控引擎
+    std::shared_ptr<RiskEngine> getRiskEngine() const { return engine_; }
+    
     // 添加风控规则
     void addRule(std::shared_ptr<RiskRule> rule) {
         if (!rule) return;
         
         std::lock_guard<std::mutex> lock(mutex_);
-        rules_.push_back(rule);
+        auto updated = std::make_shared<RuleList>(*rules_);
+        updated->push_back(rule);
+        std::atomic_store(&rules_, std::shared_ptr<const RuleList>(updated));
         
         // 记录添加规则的时间
         auto now = std::chrono::system_clock::now();
@@ -231,16 +265,18 @@ public:
     // 移除风控规则
     bool removeRule(const std::string& ruleName) {
         std::lock_guard<std::mutex> lock(mutex_);
+        auto updated = std::make_shared<RuleList>(*rules_);
         auto it = std::find_if(
-            rules_.begin(), 
-            rules_.end(),
+            updated->begin(), 
+            updated->end(),
             [&ruleName](const std::shared_ptr<RiskRule>& rule) { 
                 return rule->getName() == ruleName; 
             }
         );
         
-        if (it != rules_.end()) {
-            rules_.erase(it);
+        if (it != updated->end()) {
+            updated->erase(it);
+            std::atomic_store(&rules_, std::shared_ptr<const RuleList>(updated));
             return true;
         }
         
@@ -251,59 +287,119 @@ public:
     void handleEvent(const std::shared_ptr<Event>& event) override {
         if (!event) return;
         
+        // 柜台持仓快照覆盖引擎中的净持仓，不经过风控规则
+        if (event->getType() == EventType::POSITION) {
+            const auto& data = static_cast<const PositionEvent*>(event.get())->getData();
+            int instrument = engine_->internInstrument(data.symbol);
+            if (instrument >= 0) {
+                int64_t netPosition = data.direction == PositionDirection::LONG ? data.position : -data.position;
+                engine_->setPosition(data.symbol, netPosition,
+                    getPositionAvgPrice(data, engine_->getContractMultiplier(instrument)));
+            }
+            return;
+        }
+        
+        const OrderEvent* orderEvent = nullptr;
+        RiskOrder riskOrder;
+        bool newOrder = false;
+        
+        // 回报先更新引擎状态
+        if (event->getType() == EventType::ORDER) {
+            orderEvent = static_cast<const OrderEvent*>(event.get());
+            const auto& data = orderEvent->getData();
+            if (data.status == OrderStatus::SUBMITTED) {
+                newOrder = !postTradeOnly_ && engine_->makeOrder(data, riskOrder);
+            } else {
+                engine_->onOrderUpdate(data);
+            }
+        } else if (event->getType() == EventType::TRADE) {
+            engine_->onTrade(static_cast<const TradeEvent*>(event.get())->getData());
+        }
+        
         // 检查所有风控规则
         bool passed = true;
         std::string failedRule;
+        RiskType failedType = RiskType::SYSTEM_ERROR;
         
-        std::vector<std::shared_ptr<RiskRule>> rulesCopy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            rulesCopy = rules_;
+        if (newOrder) {
+            uint32_t violations = engine_->check(riskOrder);
+            if (violations != RISK_OK) {
+                passed = false;
+                failedRule = getRiskViolationName(violations);
+                failedType = (violations & (RISK_INSTRUMENT_OPEN_ORDERS | RISK_STRATEGY_OPEN_ORDERS)) ?
+                             RiskType::ORDER_FREQUENCY_LIMIT : RiskType::POSITION_LIMIT;
+            }
         }
         
-        for (auto& rule : rulesCopy) {
-            if (!rule->check(event)) {
-                passed = false;
-                failedRule = rule->getName();
-                break;
+        // 规则列表写时复制，这里只增加一次引用计数
+        std::shared_ptr<const RuleList> rules = std::atomic_load(&rules_);
+        if (passed) {
+            for (auto& rule : *rules) {
+                if (!rule->check(event)) {
+                    passed = false;
+                    failedRule = rule->getName();
+                    failedType = rule->getRiskType();
+                    rule->recordRejection();
+                    break;
+                }
             }
         }
         
+        if (passed && newOrder) {
+            engine_->reserve(orderEvent->getData().orderId, riskOrder);
+        }
+        
+        // 成交未通过检查时只上报风控事件
+        if (!passed && event->getType() == EventType::TRADE) {
+            const auto& data = static_cast<const TradeEvent*>(event.get())->getData();
+            publishRiskEvent(failedType, data.strategyId, data.symbol, "Post-trade risk check failed: " + failedRule);
+        }
+        
         // 如果未通过风控检查，生成风控事件
-        if (!passed && event->getType() == EventType::ORDER) {
-            auto orderEvent = std::dynamic_pointer_cast<OrderEvent>(event);
-            if (orderEvent) {
-                const auto& data = orderEvent->getData();
-                
-                RiskData riskData;
-                riskData.level = RiskLevel::WARNING;
-                riskData.type = RiskType::ORDER_FREQUENCY_LIMIT; // 这里应该根据具体规则类型设置
-                riskData.strategyId = data.strategyId;
-                riskData.symbol = data.symbol;
-                riskData.message = "Risk check failed: " + failedRule;
-                
-				auto now = std::chrono::system_clock::now();
-				auto now_time_t = std::chrono::system_clock::to_time_t(now);
-				char timeStr[26];
-				SAFE_CTIME(timeStr, &now_time_t, sizeof(timeStr));
-                riskData.triggerTime = timeStr;
-                
-                auto riskEvent = std::make_shared<RiskEvent>(riskData);
-                eventManager_->addEvent(riskEvent);
-                
-                // 将订单修改为被拒绝状态
-                OrderData rejectedOrder = data;
-                rejectedOrder.status = OrderStatus::REJECTED;
-                
-                auto rejectedOrderEvent = std::make_shared<OrderEvent>(rejectedOrder);
-                eventManager_->addEvent(rejectedOrderEvent);
+        if (!passed && orderEvent) {
+            const auto& data = orderEvent->getData();
+            publishRiskEvent(failedType, data.strategyId, data.symbol, "Risk check failed: " + failedRule);
+            
+            // 订单已在报单路径上发出，事后监控只上报风控事件
+            if (postTradeOnly_) {
+                return;
             }
+            
+            // 将订单修改为被拒绝状态
+            OrderData rejectedOrder = data;
+            rejectedOrder.status = OrderStatus::REJECTED;
+            
+            auto rejectedOrderEvent = std::make_shared<OrderEvent>(rejectedOrder);
+            eventManager_->addEvent(rejectedOrderEvent);
         }
     }
     
 private:
+    // 发布风控事件
+    void publishRiskEvent(RiskType type, const std::string& strategyId, const std::string& symbol,
+                          const std::string& message) {
+        RiskData riskData;
+        riskData.level = RiskLevel::WARNING;
+        riskData.type = type;
+        riskData.strategyId = strategyId;
+        riskData.symbol = symbol;
+        riskData.message = message;
+        
+        auto now = std::chrono::system_clock::now();
+        auto now_time_t = std::chrono::system_clock::to_time_t(now);
+        char timeStr[26];
+        SAFE_CTIME(timeStr, &now_time_t, sizeof(timeStr));
+        riskData.triggerTime = timeStr;
+        
+        auto riskEvent = std::make_shared<RiskEvent>(riskData);
+        eventManager_->addEvent(riskEvent);
+    }
+    
     std::shared_ptr<EventManager> eventManager_;
-    std::vector<std::shared_ptr<RiskRule>> rules_;
+    std::shared_ptr<RiskEngine> engine_;
+    // 规则列表，写时复制，事件处理时无锁读取
+    std::shared_ptr<const RuleList> rules_;
+    bool postTradeOnly_;
     std::mutex mutex_;
     std::string lastRuleUpdateTime_;
 }; 
\ No newline at end of file
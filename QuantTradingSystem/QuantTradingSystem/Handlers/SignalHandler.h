@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "EventHandler.h"
+#include "StrategyContext.h"
 #include "../Events/AllEvents.h"
 #include "../Trade/TradeService.h"
 #include <memory>
@@ -14,7 +15,7 @@
 #endif
 
 // 信号处理器
-class SignalHandler : public EventHandler {
+class SignalHandler : public EventHandler, public ISignalSink {
 public:
     SignalHandler(std::shared_ptr<EventManager> eventManager, 
                  std::shared_ptr<TradeService> tradingService)
@@ -37,6 +38,13 @@ public:
         }
     }
     
+    // 直接处理策略信号（DIRECT模式，不经过事件队列）
+    void onSignal(const std::shared_ptr<StrategySignalEvent>& signal) override {
+        if (signal) {
+            processSignal(signal);
+        }
+    }
+    
 private:
     // 处理信号
     void processSignal(const std::shared_ptr<StrategySignalEvent>& signal) {
@@ -44,13 +52,8 @@ private:
             return;
         }
         
-        // 检查交易服务是否就绪
-        if (!tradingService_->IsConnected() || !tradingService_->IsLoggedIn()) {
-            // 记录错误：交易服务未就绪
-            return;
-        }
-        
-        // 处理信号并下单
+        // 处理信号并下单（就绪检查和风控检查在TradeService下单路径上同步完成，
+        // 交易服务未就绪时同样按处理失败记录，未报出的止损止盈平仓信号由TradeService重新挂上）
         if (!tradingService_->ProcessSignal(signal)) {
             // 处理失败，可以生成风控事件或系统事件
             const auto& data = signal->getData();
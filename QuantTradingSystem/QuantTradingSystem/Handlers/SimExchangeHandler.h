@@ -0,0 +1,25 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Trade/SimTradeFeed.h"
+#include <memory>
+
+// 模拟交易所行情处理器
+// 把行情（实时或回放）送入SimTradeFeed作为撮合的对手盘。需注册MARKET_DATA事件。
+class SimExchangeHandler : public EventHandler {
+public:
+    explicit SimExchangeHandler(std::shared_ptr<SimTradeFeed> simFeed)
+        : EventHandler("SimExchangeHandler"), simFeed_(simFeed) {}
+
+    ~SimExchangeHandler() override = default;
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::MARKET_DATA) return;
+
+        simFeed_->onMarketData(static_cast<const MarketDataEvent*>(event.get())->getData());
+    }
+
+private:
+    std::shared_ptr<SimTradeFeed> simFeed_;
+};
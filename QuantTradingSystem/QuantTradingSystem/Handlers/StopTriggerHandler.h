@@ -0,0 +1,25 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Trade/StopTriggerEngine.h"
+#include <memory>
+
+// 止损止盈行情处理器
+// 把行情送入止损止盈触发引擎，越过触发价时发出平仓信号。需注册MARKET_DATA事件。
+class StopTriggerHandler : public EventHandler {
+public:
+    explicit StopTriggerHandler(std::shared_ptr<StopTriggerEngine> engine)
+        : EventHandler("StopTriggerHandler"), engine_(engine) {}
+
+    ~StopTriggerHandler() override = default;
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::MARKET_DATA) return;
+
+        engine_->onMarketData(static_cast<const MarketDataEvent*>(event.get())->getData());
+    }
+
+private:
+    std::shared_ptr<StopTriggerEngine> engine_;
+};
@@ -0,0 +1,52 @@
+#include "StrategyContext.h"
+#include "../EventManager.h"
+#include "../Utils/timer/TimerService.h"
+
+StrategyContext::StrategyContext(const std::string& strategyId,
+                                 std::shared_ptr<EventManager> eventManager,
+                                 SignalDispatchMode mode,
+                                 std::shared_ptr<ISignalSink> signalSink)
+    : strategyId_(strategyId),
+      eventManager_(eventManager),
+      mode_(mode),
+      signalSink_(signalSink),
+      currentTrace_(nullptr) {
+    // 未设置信号接收端时退回到事件队列
+    if (mode_ == SignalDispatchMode::DIRECT && !signalSink_) {
+        mode_ = SignalDispatchMode::EVENT_QUEUE;
+    }
+}
+
+bool StrategyContext::emitSignal(const StrategySignalData& signal) {
+    auto event = std::make_shared<StrategySignalEvent>(signal);
+    
+    // 信号继承触发它的行情的打点记录
+    if (currentTrace_) {
+        event->setTrace(*currentTrace_);
+    }
+    event->getTrace().stamp(LatencyStage::SIGNAL);
+    
+    switch (mode_) {
+        case SignalDispatchMode::DIRECT:
+            signalSink_->onSignal(event);
+            return true;
+        case SignalDispatchMode::SIGNAL_LANE:
+            if (!eventManager_) return false;
+            eventManager_->addSignalEvent(event);
+            return true;
+        case SignalDispatchMode::EVENT_QUEUE:
+        default:
+            if (!eventManager_) return false;
+            eventManager_->addEvent(event);
+            return true;
+    }
+}
+
+uint64_t StrategyContext::scheduleTimer(int64_t delayMs, uint64_t tag, int64_t intervalMs) {
+    if (!timerService_) return 0;
+    return timerService_->schedule(strategyId_, delayMs, tag, intervalMs);
+}
+
+bool StrategyContext::cancelTimer(uint64_t timerId) {
+    return timerService_ && timerService_->cancel(timerId);
+}
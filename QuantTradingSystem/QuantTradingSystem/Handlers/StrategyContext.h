@@ -0,0 +1,67 @@
+#pragma once
+#include "../Events/AllEvents.h"
+#include <memory>
+#include <string>
+
+class EventManager;
+class PnlEngine;
+class TimerService;
+
+// 信号发送模式
+enum class SignalDispatchMode {
+    EVENT_QUEUE,   // 经EventManager通用事件队列发送
+    SIGNAL_LANE,   // 经EventManager信号专用通道发送，优先于队列中的其它事件处理
+    DIRECT         // 直接交给信号接收端处理，不经过任何队列
+};
+
+// 信号接收端接口
+class ISignalSink {
+public:
+    virtual ~ISignalSink() = default;
+    
+    // 处理策略信号（DIRECT模式下在策略所在线程上调用）
+    virtual void onSignal(const std::shared_ptr<StrategySignalEvent>& signal) = 0;
+};
+
+// 策略上下文，由StrategyManager在注册策略时注入
+class StrategyContext {
+public:
+    StrategyContext(const std::string& strategyId,
+                    std::shared_ptr<EventManager> eventManager,
+                    SignalDispatchMode mode,
+                    std::shared_ptr<ISignalSink> signalSink);
+    
+    // 获取所属策略ID
+    const std::string& getStrategyId() const { return strategyId_; }
+    
+    // 获取信号发送模式
+    SignalDispatchMode getSignalDispatchMode() const { return mode_; }
+    
+    // 发送交易信号
+    bool emitSignal(const StrategySignalData& signal);
+    
+    // 设置当前正在处理的行情的打点记录，信号事件会继承该记录
+    void setCurrentTrace(const LatencyTrace* trace) { currentTrace_ = trace; }
+    
+    // 实时盈亏引擎，策略可无锁读取持仓盈亏和账户盈亏；未启用时为空
+    void setPnlEngine(std::shared_ptr<const PnlEngine> pnlEngine) { pnlEngine_ = pnlEngine; }
+    const PnlEngine* getPnlEngine() const { return pnlEngine_.get(); }
+    
+    // 定时器服务，未启用时登记定时器返回0
+    void setTimerService(std::shared_ptr<TimerService> timerService) { timerService_ = timerService; }
+    
+    // 登记定时器，delayMs后以onTimer回调策略；intervalMs大于0时为周期定时器，需显式取消。返回定时器编号
+    uint64_t scheduleTimer(int64_t delayMs, uint64_t tag, int64_t intervalMs = 0);
+    
+    // 取消定时器，已到期或已取消时返回false
+    bool cancelTimer(uint64_t timerId);
+    
+private:
+    std::string strategyId_;
+    std::shared_ptr<EventManager> eventManager_;
+    SignalDispatchMode mode_;
+    std::shared_ptr<ISignalSink> signalSink_;
+    const LatencyTrace* currentTrace_;
+    std::shared_ptr<const PnlEngine> pnlEngine_;
+    std::shared_ptr<TimerService> timerService_;
+};
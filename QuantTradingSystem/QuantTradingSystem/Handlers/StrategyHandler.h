@@ -1,9 +1,12 @@
 ﻿#pragma once
 #include "EventHandler.h"
+#include "StrategyWorkerPool.h"
+#include "StrategyContext.h"
 #include "../Events/AllEvents.h"
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <mutex>
 #include <atomic>
 #include "MarketDataField.h"
@@ -71,6 +74,9 @@ public:
         return false;
     }
     
+    // 获取策略订阅的合约列表，返回空表示接收所有合约的行情
+    virtual std::vector<std::string> getSubscribedSymbols() const { return {}; }
+    
     // 处理行情数据
     virtual void onMarketData(const MarketDataField& data) = 0;
     
@@ -80,22 +86,115 @@ public:
     // 处理成交回报
     virtual void onTrade(const TradeData& data) = 0;
     
+    // 处理本策略登记的定时器到期，与行情和回报在同一线程上调用
+    virtual void onTimer(const TimerEventData& /*data*/) {}
+    
+    // 设置策略上下文（由StrategyManager注册策略时注入）
+    void setContext(std::shared_ptr<StrategyContext> context) { context_ = context; }
+    
+    // 获取策略上下文
+    const std::shared_ptr<StrategyContext>& getContext() const { return context_; }
+    
 protected:
+    // 发送交易信号
+    bool emitSignal(const StrategySignalData& signal) {
+        return context_ && context_->emitSignal(signal);
+    }
+    
+    // 登记定时器，返回定时器编号，未启用定时器服务时返回0
+    uint64_t scheduleTimer(int64_t delayMs, uint64_t tag, int64_t intervalMs = 0) {
+        return context_ ? context_->scheduleTimer(delayMs, tag, intervalMs) : 0;
+    }
+    
+    // 取消定时器
+    bool cancelTimer(uint64_t timerId) {
+        return context_ && context_->cancelTimer(timerId);
+    }
+    
     std::string id_;
     std::string name_;
     std::atomic<StrategyStatus> status_;
+    std::shared_ptr<StrategyContext> context_;
 };
 
 // 策略管理器
 class StrategyManager : public EventHandler {
 public:
     StrategyManager(std::shared_ptr<EventManager> eventManager)
-        : EventHandler("StrategyManager"), eventManager_(eventManager) {}
+        : EventHandler("StrategyManager"), 
+          eventManager_(eventManager),
+          executionMode_(StrategyExecutionMode::INLINE),
+          signalMode_(SignalDispatchMode::EVENT_QUEUE),
+          routingTable_(std::make_shared<RoutingTable>()) {}
+    
+    ~StrategyManager() override {
+        auto workerPool = std::atomic_load(&workerPool_);
+        if (workerPool) {
+            workerPool->stop();
+        }
+    }
+    
+    // 设置策略执行模式，只能在注册策略之前调用
+    // WORKER_POOL模式下sharedWorkers个共享线程承载轻量策略，sharedCpus指定其绑定的CPU核心
+    // WORKER_POOL不能与DIRECT信号发送方式同时使用，见setSignalDispatch
+    bool setExecutionMode(StrategyExecutionMode mode, size_t sharedWorkers = 1,
+                          const std::vector<int>& sharedCpus = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!strategies_.empty()) {
+            return false;
+        }
+        if (mode == StrategyExecutionMode::WORKER_POOL && signalMode_ == SignalDispatchMode::DIRECT) {
+            return false;
+        }
+        
+        auto oldPool = std::atomic_load(&workerPool_);
+        if (oldPool) {
+            oldPool->stop();
+        }
+        
+        executionMode_ = mode;
+        std::shared_ptr<StrategyWorkerPool> workerPool;
+        if (mode == StrategyExecutionMode::WORKER_POOL) {
+            workerPool = std::make_shared<StrategyWorkerPool>(sharedWorkers, sharedCpus);
+            workerPool->start();
+        }
+        // 分发线程和统计查询不持锁读取，替换须原子发布
+        std::atomic_store(&workerPool_, workerPool);
+        
+        return true;
+    }
     
-    ~StrategyManager() override = default;
+    // 获取策略执行模式
+    StrategyExecutionMode getExecutionMode() const { return executionMode_; }
     
-    // 注册策略
-    bool registerStrategy(std::shared_ptr<Strategy> strategy) {
+    // 设置策略信号的发送方式，只对之后注册的策略生效
+    // DIRECT模式下信号在策略所在线程上直接交给signalSink处理。WORKER_POOL模式下多个工作线程会同时
+    // 进入下单路径（风控登记、持仓拆分冻结、止损登记），这些状态按单一信号线程设计，因此拒绝该组合
+    bool setSignalDispatch(SignalDispatchMode mode, std::shared_ptr<ISignalSink> signalSink = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (mode == SignalDispatchMode::DIRECT && executionMode_ == StrategyExecutionMode::WORKER_POOL) {
+            return false;
+        }
+        signalMode_ = mode;
+        signalSink_ = signalSink;
+        return true;
+    }
+    
+    // 设置实时盈亏引擎，注入之后注册的策略的上下文
+    void setPnlEngine(std::shared_ptr<const PnlEngine> pnlEngine) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pnlEngine_ = pnlEngine;
+    }
+    
+    // 设置定时器服务，注入之后注册的策略的上下文
+    void setTimerService(std::shared_ptr<TimerService> timerService) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timerService_ = timerService;
+    }
+    
+    // 注册策略，profile仅在WORKER_POOL模式下生效
+    bool registerStrategy(std::shared_ptr<Strategy> strategy,
+                          const StrategyExecutionProfile& profile = StrategyExecutionProfile()) {
         if (!strategy) return false;
         
         std::lock_guard<std::mutex> lock(mutex_);
@@ -104,7 +203,21 @@ public:
             return false; // 策略已存在
         }
         
+        if (workerPool_) {
+            auto inbox = workerPool_->addStrategy(strategy, profile);
+            if (!inbox) {
+                return false;
+            }
+            inboxes_[id] = inbox;
+        }
+        
+        auto context = std::make_shared<StrategyContext>(id, eventManager_, signalMode_, signalSink_);
+        context->setPnlEngine(pnlEngine_);
+        context->setTimerService(timerService_);
+        strategy->setContext(context);
+        
         strategies_[id] = strategy;
+        rebuildRoutingTable();
         return true;
     }
     
@@ -119,9 +232,25 @@ public:
         // 确保策略已停止
         it->second->stop();
         strategies_.erase(it);
+        
+        if (workerPool_) {
+            workerPool_->removeStrategy(strategyId);
+            inboxes_.erase(strategyId);
+        }
+        
+        rebuildRoutingTable();
         return true;
     }
     
+    // 获取各策略收件箱的队列深度和延迟（仅WORKER_POOL模式）
+    std::vector<StrategyQueueStats> getQueueStats() const {
+        auto workerPool = std::atomic_load(&workerPool_);
+        if (!workerPool) {
+            return {};
+        }
+        return workerPool->getStats();
+    }
+    
     // 启动策略
     bool startStrategy(const std::string& strategyId) {
         std::shared_ptr<Strategy> strategy;
@@ -134,7 +263,14 @@ public:
             strategy = it->second;
         }
         
-        return strategy->start();
+        if (!strategy->start()) {
+            return false;
+        }
+        
+        // 策略状态变化后重建行情路由表
+        std::lock_guard<std::mutex> lock(mutex_);
+        rebuildRoutingTable();
+        return true;
     }
     
     // 停止策略
@@ -149,7 +285,14 @@ public:
             strategy = it->second;
         }
         
-        return strategy->stop();
+        if (!strategy->stop()) {
+            return false;
+        }
+        
+        // 策略状态变化后重建行情路由表
+        std::lock_guard<std::mutex> lock(mutex_);
+        rebuildRoutingTable();
+        return true;
     }
     
     // 暂停策略
@@ -164,7 +307,14 @@ public:
             strategy = it->second;
         }
         
-        return strategy->pause();
+        if (!strategy->pause()) {
+            return false;
+        }
+        
+        // 策略状态变化后重建行情路由表
+        std::lock_guard<std::mutex> lock(mutex_);
+        rebuildRoutingTable();
+        return true;
     }
     
     // 恢复策略
@@ -179,7 +329,14 @@ public:
             strategy = it->second;
         }
         
-        return strategy->resume();
+        if (!strategy->resume()) {
+            return false;
+        }
+        
+        // 策略状态变化后重建行情路由表
+        std::lock_guard<std::mutex> lock(mutex_);
+        rebuildRoutingTable();
+        return true;
     }
     
     // 处理事件
@@ -190,21 +347,28 @@ public:
             case EventType::MARKET_DATA: {
                 auto mdEvent = std::dynamic_pointer_cast<MarketDataEvent>(event);
                 if (mdEvent) {
-                    onMarketData(mdEvent->getData());
+                    onMarketData(event, mdEvent->getData());
                 }
                 break;
             }
             case EventType::ORDER: {
                 auto orderEvent = std::dynamic_pointer_cast<OrderEvent>(event);
                 if (orderEvent) {
-                    onOrder(orderEvent->getData());
+                    onOrder(event, orderEvent->getData());
                 }
                 break;
             }
             case EventType::TRADE: {
                 auto tradeEvent = std::dynamic_pointer_cast<TradeEvent>(event);
                 if (tradeEvent) {
-                    onTrade(tradeEvent->getData());
+                    onTrade(event, tradeEvent->getData());
+                }
+                break;
+            }
+            case EventType::TIMER: {
+                auto timerEvent = std::dynamic_pointer_cast<TimerEvent>(event);
+                if (timerEvent) {
+                    onTimer(event, timerEvent->getData());
                 }
                 break;
             }
@@ -214,40 +378,126 @@ public:
     }
     
 private:
-    // 处理行情数据
-    void onMarketData(const MarketDataField& data) {
-        std::vector<std::shared_ptr<Strategy>> activeStrategies;
+    // 路由项：INLINE模式下inbox为空，直接调用策略
+    struct StrategyRoute {
+        std::shared_ptr<Strategy> strategy;
+        std::shared_ptr<StrategyInbox> inbox;
+    };
+    
+    typedef std::vector<StrategyRoute> StrategyList;
+    
+    // 行情路由表：合约 -> 订阅该合约的运行中策略
+    // 只在策略注册/启停时重建，行情处理时只读，不做任何分配
+    struct RoutingTable {
+        std::unordered_map<std::string, StrategyList> bySymbol;
+        StrategyList allSymbols;  // 未声明订阅合约的策略，接收所有行情
+    };
+    
+    // 重建行情路由表（调用方需持有mutex_）
+    void rebuildRoutingTable() {
+        auto table = std::make_shared<RoutingTable>();
         
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            for (auto& pair : strategies_) {
-                if (pair.second->getStatus() == StrategyStatus::RUNNING) {
-                    activeStrategies.push_back(pair.second);
-                }
+        for (auto& pair : strategies_) {
+            const auto& strategy = pair.second;
+            if (strategy->getStatus() != StrategyStatus::RUNNING) {
+                continue;
+            }
+            
+            StrategyRoute route;
+            route.strategy = strategy;
+            auto inboxIt = inboxes_.find(pair.first);
+            if (inboxIt != inboxes_.end()) {
+                route.inbox = inboxIt->second;
+            }
+            
+            auto symbols = strategy->getSubscribedSymbols();
+            if (symbols.empty()) {
+                table->allSymbols.push_back(route);
+                continue;
             }
+            
+            for (const auto& symbol : symbols) {
+                table->bySymbol[symbol].push_back(route);
+            }
+        }
+        
+        // 原子替换，正在处理行情的线程继续使用旧表直至本次处理结束
+        std::atomic_store(&routingTable_, std::shared_ptr<const RoutingTable>(table));
+    }
+    
+    // 处理行情数据
+    void onMarketData(const std::shared_ptr<Event>& event, const MarketDataField& data) {
+        auto table = std::atomic_load(&routingTable_);
+        
+        // 只向订阅了该合约的策略传递行情数据
+        auto it = table->bySymbol.find(data.symbol);
+        if (it != table->bySymbol.end()) {
+            dispatchMarketData(it->second, event, data);
         }
         
-        // 向所有运行中的策略传递行情数据
-        for (auto& strategy : activeStrategies) {
+        dispatchMarketData(table->allSymbols, event, data);
+    }
+    
+    // 向策略列表分发行情数据
+    void dispatchMarketData(const StrategyList& routes, const std::shared_ptr<Event>& event,
+                            const MarketDataField& data) {
+        LatencyTrace& trace = event->getTrace();
+        
+        for (const auto& route : routes) {
+            if (route.inbox) {
+                route.inbox->post(event);
+                continue;
+            }
+            
+            // 延迟打点：第一个策略进入和最后一个策略完成
+            if (!trace.has(LatencyStage::STRATEGY_ENTRY)) {
+                trace.stamp(LatencyStage::STRATEGY_ENTRY);
+            }
+            
+            const auto& context = route.strategy->getContext();
+            if (context) {
+                context->setCurrentTrace(&trace);
+            }
+            
             try {
-                strategy->onMarketData(data);
+                route.strategy->onMarketData(data);
             } catch (const std::exception& e) {
                 // 记录异常信息
             }
+            
+            if (context) {
+                context->setCurrentTrace(nullptr);
+            }
+            trace.stamp(LatencyStage::STRATEGY_EXIT);
         }
     }
     
+    // 查找接收回报的策略及其收件箱
+    std::shared_ptr<Strategy> findReportTarget(const std::string& strategyId,
+                                               std::shared_ptr<StrategyInbox>& inbox) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = strategies_.find(strategyId);
+        if (it == strategies_.end() || it->second->getStatus() == StrategyStatus::STOPPED) {
+            return nullptr;
+        }
+        
+        auto inboxIt = inboxes_.find(strategyId);
+        if (inboxIt != inboxes_.end()) {
+            inbox = inboxIt->second;
+        }
+        return it->second;
+    }
+    
     // 处理订单状态
-    void onOrder(const OrderData& data) {
+    void onOrder(const std::shared_ptr<Event>& event, const OrderData& data) {
         // 找到对应的策略
-        std::shared_ptr<Strategy> strategy;
+        std::shared_ptr<StrategyInbox> inbox;
+        std::shared_ptr<Strategy> strategy = findReportTarget(data.strategyId, inbox);
         
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = strategies_.find(data.strategyId);
-            if (it != strategies_.end() && it->second->getStatus() != StrategyStatus::STOPPED) {
-                strategy = it->second;
-            }
+        // 工作线程模式下回报也进入策略收件箱，保证策略状态只在一个线程上访问
+        if (inbox) {
+            inbox->post(event);
+            return;
         }
         
         if (strategy) {
@@ -260,16 +510,14 @@ private:
     }
     
     // 处理成交回报
-    void onTrade(const TradeData& data) {
+    void onTrade(const std::shared_ptr<Event>& event, const TradeData& data) {
         // 找到对应的策略
-        std::shared_ptr<Strategy> strategy;
+        std::shared_ptr<StrategyInbox> inbox;
+        std::shared_ptr<Strategy> strategy = findReportTarget(data.strategyId, inbox);
         
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = strategies_.find(data.strategyId);
-            if (it != strategies_.end() && it->second->getStatus() != StrategyStatus::STOPPED) {
-                strategy = it->second;
-            }
+        if (inbox) {
+            inbox->post(event);
+            return;
         }
         
         if (strategy) {
@@ -281,8 +529,42 @@ private:
         }
     }
     
+    // 处理定时器到期
+    void onTimer(const std::shared_ptr<Event>& event, const TimerEventData& data) {
+        if (data.owner.empty()) return;
+        
+        std::shared_ptr<StrategyInbox> inbox;
+        std::shared_ptr<Strategy> strategy = findReportTarget(data.owner, inbox);
+        
+        if (inbox) {
+            inbox->post(event);
+            return;
+        }
+        
+        if (strategy) {
+            try {
+                strategy->onTimer(data);
+            } catch (const std::exception& e) {
+                // 记录异常信息
+            }
+        }
+    }
+    
 private:
     std::shared_ptr<EventManager> eventManager_;
     std::unordered_map<std::string, std::shared_ptr<Strategy>> strategies_;
+    
+    // 工作线程池及各策略收件箱（WORKER_POOL模式）
+    StrategyExecutionMode executionMode_;
+    std::shared_ptr<StrategyWorkerPool> workerPool_;      // 替换时原子发布，持锁之外用atomic_load读取
+    std::unordered_map<std::string, std::shared_ptr<StrategyInbox>> inboxes_;
+    
+    // 信号发送方式
+    SignalDispatchMode signalMode_;
+    std::shared_ptr<ISignalSink> signalSink_;
+    std::shared_ptr<const PnlEngine> pnlEngine_;
+    std::shared_ptr<TimerService> timerService_;
+    
+    std::shared_ptr<const RoutingTable> routingTable_;
     std::mutex mutex_;
 }; 
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "StrategyWorkerPool.h"
+#include "../EventManager.h"
+#include "StrategyHandler.h"
+#include "../Utils/thread/ThreadUtil.h"
+#include "../Utils/latency/LatencyTracer.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void StrategyInbox::post(const std::shared_ptr<Event>& event) {
+    Item item;
+    item.event = event;
+    item.enqueueNs = steadyNowNs();
+    
+    if (queue_.push(item)) {
+        return;
+    }
+    
+    if (event->getType() == EventType::MARKET_DATA) {
+        // 策略处理跟不上，丢弃旧行情而不阻塞分发线程
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    while (!queue_.push(item)) {
+        std::this_thread::yield();
+    }
+}
+
+size_t StrategyInbox::drain(size_t maxItems) {
+    size_t count = 0;
+    Item item;
+    
+    while (count < maxItems && queue_.pop(item)) {
+        int64_t lag = steadyNowNs() - item.enqueueNs;
+        lastLagNs_.store(lag, std::memory_order_relaxed);
+        if (lag > maxLagNs_.load(std::memory_order_relaxed)) {
+            maxLagNs_.store(lag, std::memory_order_relaxed);
+        }
+        
+        try {
+            dispatch(item.event);
+        } catch (const std::exception& e) {
+            // 记录异常信息
+        }
+        
+        item.event.reset();
+        processed_.fetch_add(1, std::memory_order_relaxed);
+        ++count;
+    }
+    
+    return count;
+}
+
+void StrategyInbox::dispatch(const std::shared_ptr<Event>& event) {
+    switch (event->getType()) {
+        case EventType::MARKET_DATA: {
+            if (strategy_->getStatus() != StrategyStatus::RUNNING) {
+                break;
+            }
+            auto mdEvent = std::static_pointer_cast<MarketDataEvent>(event);
+            
+            // 行情事件由多个收件箱共享，打点记录在本地副本上
+            LatencyTrace trace = event->getTrace();
+            trace.stamp(LatencyStage::STRATEGY_ENTRY);
+            
+            const auto& context = strategy_->getContext();
+            if (context) {
+                context->setCurrentTrace(&trace);
+            }
+            
+            strategy_->onMarketData(mdEvent->getData());
+            
+            if (context) {
+                context->setCurrentTrace(nullptr);
+            }
+            trace.stamp(LatencyStage::STRATEGY_EXIT);
+            LatencyTracer::getInstance().record(trace, LatencyStage::STRATEGY_ENTRY,
+                                                LatencyStage::STRATEGY_EXIT);
+            break;
+        }
+        case EventType::ORDER: {
+            if (strategy_->getStatus() == StrategyStatus::STOPPED) {
+                break;
+            }
+            auto orderEvent = std::static_pointer_cast<OrderEvent>(event);
+            strategy_->onOrder(orderEvent->getData());
+            break;
+        }
+        case EventType::TRADE: {
+            if (strategy_->getStatus() == StrategyStatus::STOPPED) {
+                break;
+            }
+            auto tradeEvent = std::static_pointer_cast<TradeEvent>(event);
+            strategy_->onTrade(tradeEvent->getData());
+            break;
+        }
+        case EventType::TIMER: {
+            if (strategy_->getStatus() == StrategyStatus::STOPPED) {
+                break;
+            }
+            auto timerEvent = std::static_pointer_cast<TimerEvent>(event);
+            strategy_->onTimer(timerEvent->getData());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+StrategyQueueStats StrategyInbox::getStats() const {
+    StrategyQueueStats stats;
+    stats.strategyId = strategy_->getId();
+    stats.workerIndex = workerIndex_;
+    stats.queueDepth = queue_.size();
+    stats.processed = processed_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.lastLagNs = lastLagNs_.load(std::memory_order_relaxed);
+    stats.maxLagNs = maxLagNs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+StrategyWorkerPool::StrategyWorkerPool(size_t sharedWorkers, const std::vector<int>& sharedCpus)
+    : running_(false) {
+    if (sharedWorkers == 0) {
+        sharedWorkers = 1;
+    }
+    
+    for (size_t i = 0; i < sharedWorkers; ++i) {
+        int cpuId = i < sharedCpus.size() ? sharedCpus[i] : -1;
+        workers_.push_back(std::make_unique<Worker>(cpuId, false));
+    }
+}
+
+StrategyWorkerPool::~StrategyWorkerPool() {
+    stop();
+}
+
+void StrategyWorkerPool::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (!workers_[i]->retired.load(std::memory_order_relaxed)) {
+            startWorker(i);
+        }
+    }
+}
+
+void StrategyWorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::shared_ptr<StrategyInbox> StrategyWorkerPool::addStrategy(std::shared_ptr<Strategy> strategy,
+                                                              const StrategyExecutionProfile& profile) {
+    if (!strategy) return nullptr;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (strategyWorkers_.find(strategy->getId()) != strategyWorkers_.end()) {
+        return nullptr; // 策略已存在
+    }
+    
+    size_t index;
+    if (profile.dedicated) {
+        workers_.push_back(std::make_unique<Worker>(profile.cpuId, true));
+        index = workers_.size() - 1;
+    } else {
+        index = selectSharedWorker();
+    }
+    
+    auto inbox = std::make_shared<StrategyInbox>(strategy, index);
+    
+    // 写时复制，工作线程持有的旧列表不受影响
+    Worker* worker = workers_[index].get();
+    auto inboxes = std::make_shared<InboxList>(*std::atomic_load(&worker->inboxes));
+    inboxes->push_back(inbox);
+    std::atomic_store(&worker->inboxes, std::shared_ptr<const InboxList>(inboxes));
+    
+    strategyWorkers_[strategy->getId()] = index;
+    
+    // 收件箱深度在指标输出时采样
+    std::weak_ptr<StrategyInbox> weakInbox = inbox;
+    MetricsRegistry::getInstance().registerProbe(
+        "strategy." + strategy->getId() + ".inbox_depth",
+        [weakInbox]() -> int64_t {
+            auto inbox = weakInbox.lock();
+            return inbox ? static_cast<int64_t>(inbox->getStats().queueDepth) : 0;
+        });
+    
+    if (profile.dedicated && running_) {
+        startWorker(index);
+    }
+    
+    return inbox;
+}
+
+void StrategyWorkerPool::removeStrategy(const std::string& strategyId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = strategyWorkers_.find(strategyId);
+    if (it == strategyWorkers_.end()) {
+        return;
+    }
+    
+    Worker* worker = workers_[it->second].get();
+    auto inboxes = std::make_shared<InboxList>(*std::atomic_load(&worker->inboxes));
+    inboxes->erase(
+        std::remove_if(
+            inboxes->begin(),
+            inboxes->end(),
+            [&strategyId](const std::shared_ptr<StrategyInbox>& inbox) {
+                return inbox->getStrategy()->getId() == strategyId;
+            }
+        ),
+        inboxes->end()
+    );
+    std::atomic_store(&worker->inboxes, std::shared_ptr<const InboxList>(inboxes));
+    
+    if (worker->dedicated) {
+        // 独占线程随策略退出，在此回收，避免反复调整时积累未回收的线程
+        worker->retired = true;
+        if (worker->thread.joinable() && worker->thread.get_id() != std::this_thread::get_id()) {
+            worker->thread.join();
+        }
+    }
+    
+    strategyWorkers_.erase(it);
+    MetricsRegistry::getInstance().unregisterProbe("strategy." + strategyId + ".inbox_depth");
+}
+
+std::vector<StrategyQueueStats> StrategyWorkerPool::getStats() const {
+    std::vector<StrategyQueueStats> result;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& worker : workers_) {
+        auto inboxes = std::atomic_load(&worker->inboxes);
+        for (const auto& inbox : *inboxes) {
+            result.push_back(inbox->getStats());
+        }
+    }
+    
+    return result;
+}
+
+void StrategyWorkerPool::startWorker(size_t index) {
+    Worker* worker = workers_[index].get();
+    worker->thread = std::thread(&StrategyWorkerPool::workerLoop, this, worker, index);
+}
+
+size_t StrategyWorkerPool::selectSharedWorker() const {
+    size_t best = 0;
+    size_t bestCount = SIZE_MAX;
+    
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (workers_[i]->dedicated) {
+            continue;
+        }
+        size_t count = std::atomic_load(&workers_[i]->inboxes)->size();
+        if (count < bestCount) {
+            best = i;
+            bestCount = count;
+        }
+    }
+    
+    return best;
+}
+
+void StrategyWorkerPool::workerLoop(Worker* worker, size_t index) {
+    ThreadUtil::setCurrentThreadName("strategy-" + std::to_string(index));
+    ThreadUtil::bindCurrentThreadToCpu(worker->cpuId);
+    
+    // 空闲时先自旋让出，长时间无事件再短暂休眠，避免空转占满共享核心
+    const int SPIN_LIMIT = 1000;
+    int idleSpins = 0;
+    
+    while (running_.load(std::memory_order_acquire) &&
+           !worker->retired.load(std::memory_order_relaxed)) {
+        auto inboxes = std::atomic_load(&worker->inboxes);
+        
+        size_t processed = 0;
+        for (const auto& inbox : *inboxes) {
+            processed += inbox->drain(MAX_BATCH_SIZE);
+        }
+        
+        if (processed > 0) {
+            idleSpins = 0;
+        } else if (worker->dedicated || ++idleSpins < SPIN_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
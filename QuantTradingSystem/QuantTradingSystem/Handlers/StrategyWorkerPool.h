@@ -0,0 +1,130 @@
+#pragma once
+#include "../Events/AllEvents.h"
+#include "../Utils/SpscQueue.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+class Strategy;
+
+// 策略执行模式
+enum class StrategyExecutionMode {
+    INLINE,        // 在事件分发线程上直接调用策略
+    WORKER_POOL    // 每个策略绑定到一个工作线程，通过独立收件箱异步执行
+};
+
+// 策略执行配置
+struct StrategyExecutionProfile {
+    bool dedicated;   // 是否独占工作线程（重负载策略）
+    int cpuId;        // 独占线程绑定的CPU核心，-1表示不绑定
+    
+    StrategyExecutionProfile() : dedicated(false), cpuId(-1) {}
+};
+
+// 策略收件箱统计信息
+struct StrategyQueueStats {
+    std::string strategyId;   // 策略ID
+    size_t workerIndex;       // 所在工作线程
+    size_t queueDepth;        // 当前队列深度
+    uint64_t processed;       // 已处理事件数
+    uint64_t dropped;         // 因队列满丢弃的行情数
+    int64_t lastLagNs;        // 最近一次事件的排队延迟（纳秒）
+    int64_t maxLagNs;         // 最大排队延迟（纳秒）
+};
+
+// 策略收件箱：事件分发线程写入，策略所在工作线程读取
+class StrategyInbox {
+public:
+    static const size_t CAPACITY = 4096;
+    
+    struct Item {
+        std::shared_ptr<Event> event;
+        int64_t enqueueNs;
+    };
+    
+    StrategyInbox(std::shared_ptr<Strategy> strategy, size_t workerIndex)
+        : strategy_(strategy), workerIndex_(workerIndex),
+          processed_(0), dropped_(0), lastLagNs_(0), maxLagNs_(0) {}
+    
+    // 投递事件（仅事件分发线程调用）
+    // 行情在队列满时直接丢弃并计数，订单和成交回报必须送达，队列满时等待
+    void post(const std::shared_ptr<Event>& event);
+    
+    // 处理收件箱中的事件（仅工作线程调用），返回处理的事件数
+    size_t drain(size_t maxItems);
+    
+    const std::shared_ptr<Strategy>& getStrategy() const { return strategy_; }
+    
+    StrategyQueueStats getStats() const;
+    
+private:
+    void dispatch(const std::shared_ptr<Event>& event);
+    
+    std::shared_ptr<Strategy> strategy_;
+    size_t workerIndex_;
+    Utils::SpscQueue<Item, CAPACITY> queue_;
+    
+    std::atomic<uint64_t> processed_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<int64_t> lastLagNs_;
+    std::atomic<int64_t> maxLagNs_;
+};
+
+// 策略工作线程池
+// 轻量策略平均分配到共享工作线程上，重负载策略各自独占一个（可绑核的）线程。
+// 每个策略在任意时刻只会在一个线程上执行，策略内部状态无需加锁。
+class StrategyWorkerPool {
+public:
+    explicit StrategyWorkerPool(size_t sharedWorkers, const std::vector<int>& sharedCpus = {});
+    ~StrategyWorkerPool();
+    
+    // 启动和停止所有工作线程
+    void start();
+    void stop();
+    
+    // 为策略分配工作线程并创建收件箱
+    std::shared_ptr<StrategyInbox> addStrategy(std::shared_ptr<Strategy> strategy,
+                                               const StrategyExecutionProfile& profile);
+    
+    // 移除策略的收件箱
+    void removeStrategy(const std::string& strategyId);
+    
+    // 获取所有策略的收件箱统计
+    std::vector<StrategyQueueStats> getStats() const;
+    
+private:
+    typedef std::vector<std::shared_ptr<StrategyInbox>> InboxList;
+    
+    struct Worker {
+        int cpuId;
+        bool dedicated;
+        std::atomic<bool> retired;   // 独占线程的策略被移除后退出
+        std::thread thread;
+        std::shared_ptr<const InboxList> inboxes;
+        
+        Worker(int cpu, bool isDedicated)
+            : cpuId(cpu), dedicated(isDedicated), retired(false),
+              inboxes(std::make_shared<InboxList>()) {}
+    };
+    
+    // 工作线程函数
+    void workerLoop(Worker* worker, size_t index);
+    
+    // 启动单个工作线程（调用方需持有mutex_）
+    void startWorker(size_t index);
+    
+    // 选择负载最轻的共享工作线程（调用方需持有mutex_）
+    size_t selectSharedWorker() const;
+    
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::unordered_map<std::string, size_t> strategyWorkers_;
+    std::atomic<bool> running_;
+    mutable std::mutex mutex_;
+    
+    static const size_t MAX_BATCH_SIZE = 64;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include "../Utils/timer/TimerService.h"
+#include <cstdint>
+#include <memory>
+
+// 回放时钟处理器
+// 定时器服务使用手动时钟时，按行情的更新时间（时分秒加毫秒）推进定时器，定时器与回放行情处于同一时间线。
+// 夜盘跨过午夜时时间回绕，累加一天保持单调；时钟不后退，乱序的行情不会让定时器提前触发。需注册MARKET_DATA事件。
+class TimerClockHandler : public EventHandler {
+public:
+    explicit TimerClockHandler(std::shared_ptr<TimerService> timerService)
+        : EventHandler("TimerClockHandler"), timerService_(timerService),
+          lastTimeOfDayNs_(-1), dayOffsetNs_(0) {}
+
+    ~TimerClockHandler() override = default;
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::MARKET_DATA) return;
+
+        const MarketDataField& data = static_cast<const MarketDataEvent*>(event.get())->getData();
+        int64_t timeOfDay = parseTimeOfDay(data.updateTime, data.updateMillisec);
+        if (timeOfDay < 0) return;
+
+        // 回退超过半天视为跨过午夜
+        if (lastTimeOfDayNs_ >= 0 && timeOfDay + HALF_DAY_NS < lastTimeOfDayNs_) {
+            dayOffsetNs_ += DAY_NS;
+        }
+        lastTimeOfDayNs_ = timeOfDay;
+
+        timerService_->advance(dayOffsetNs_ + timeOfDay);
+    }
+
+private:
+    static constexpr int64_t NS_PER_MS = 1000000;
+    static constexpr int64_t DAY_NS = 24LL * 3600 * 1000 * NS_PER_MS;
+    static constexpr int64_t HALF_DAY_NS = DAY_NS / 2;
+
+    // 解析HH:MM:SS，格式不符时返回-1
+    static int64_t parseTimeOfDay(const std::string& time, int millisec) {
+        if (time.size() < 8 || time[2] != ':' || time[5] != ':') return -1;
+
+        int fields[3];
+        for (int i = 0; i < 3; ++i) {
+            char high = time[i * 3];
+            char low = time[i * 3 + 1];
+            if (high < '0' || high > '9' || low < '0' || low > '9') return -1;
+            fields[i] = (high - '0') * 10 + (low - '0');
+        }
+        return ((fields[0] * 3600LL + fields[1] * 60 + fields[2]) * 1000 + millisec) * NS_PER_MS;
+    }
+
+    std::shared_ptr<TimerService> timerService_;
+    int64_t lastTimeOfDayNs_;
+    int64_t dayOffsetNs_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "EventHandler.h"
+#include "../Events/AllEvents.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 交易日处理器
+// 按行情的交易日字段识别交易日切换（夜盘开盘时即切换，只向后推进），在新交易日的第一笔行情上、
+// 其余行情处理器之前依次调用登记的回调，回调在事件分发线程上执行。启动后的第一笔行情同样视为交易日开始。
+// 需注册MARKET_DATA事件，并先于依赖当日状态的处理器注册。
+class TradingDayHandler : public EventHandler {
+public:
+    typedef std::function<void(const std::string& tradingDay)> Listener;
+
+    TradingDayHandler() : EventHandler("TradingDayHandler") {}
+
+    ~TradingDayHandler() override = default;
+
+    // 登记交易日开始时的回调（在行情开始之前调用）
+    void addListener(Listener listener) {
+        listeners_.push_back(std::move(listener));
+    }
+
+    // 处理事件
+    void handleEvent(const std::shared_ptr<Event>& event) override {
+        if (!event || event->getType() != EventType::MARKET_DATA) return;
+
+        const std::string& tradingDay = static_cast<const MarketDataEvent*>(event.get())->getData().tradingDay;
+        // 交易日为YYYYMMDD，按字符串比较；迟到或重放的旧交易日行情不回滚
+        if (tradingDay.empty() || tradingDay <= currentDay_) return;
+
+        currentDay_ = tradingDay;
+        for (const auto& listener : listeners_) {
+            listener(currentDay_);
+        }
+    }
+
+    // 当前交易日，未收到行情时为空
+    const std::string& getTradingDay() const { return currentDay_; }
+
+private:
+    std::vector<Listener> listeners_;
+    std::string currentDay_;
+};
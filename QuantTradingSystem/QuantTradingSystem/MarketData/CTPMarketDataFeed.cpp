@@ -3,6 +3,7 @@
 #include "config/ConfigManager.h"
 //#include "logger/spdlog/spdlog.h"
 #include "MarketDataEvent.h"
+#include "../Utils/latency/LatencyTrace.h"
 #include <algorithm>
 #include <ctime>
 
@@ -30,7 +31,7 @@ CTPMarketDataFeed::~CTPMarketDataFeed() {
 
 bool CTPMarketDataFeed::Init(const std::string& config) {
     try {
-        auto& configManager = ConfigManager::getInstance();
+        auto& configManager = QuantTrading::ConfigManager::getInstance();
         if (!configManager.loadConfig(config)) {
             //spdlog::error("Failed to load config file: {}", config);
             return false;
@@ -217,12 +218,16 @@ void CTPMarketDataFeed::OnRspSubMarketData(CThostFtdcSpecificInstrumentField *pS
 }
 
 void CTPMarketDataFeed::OnRtnDepthMarketData(CThostFtdcDepthMarketDataField *pDepthMarketData) {
+    // 回调入口打点
+    int64_t receiveTime = latencyNow();
+    
     if (!pDepthMarketData || !marketDataCallback_) {
         return;
     }
 
     try {
         MarketDataField data = ConvertMarketData(pDepthMarketData);
+        data.localTimestamp = receiveTime;
         marketDataCallback_(data);
     }
     catch (const std::exception& e) {
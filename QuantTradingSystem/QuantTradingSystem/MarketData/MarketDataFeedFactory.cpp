@@ -1,11 +1,15 @@
 ﻿#include "IMarketDataFeed.h"
 #include "CTPMarketDataFeed.h"
+#include "SyntheticMarketDataFeed.h"
 #include <stdexcept>
 
 std::shared_ptr<IMarketDataFeed> MarketDataFeedFactory::createMarketDataFeed(const std::string& provider) {
     if (provider == "CTP") {
         return std::make_shared<CTPMarketDataFeed>();
     }
+    else if (provider == "SYNTHETIC") {
+        return std::make_shared<SyntheticMarketDataFeed>();
+    }
     // 在这里添加其他数据源的支持
     // else if (provider == "XTP") {
     //     return std::make_shared<XTPMarketDataFeed>();
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <array>
+#include <cstdint>
 
 struct MarketDataField {
     std::string symbol;           // 合约代码
@@ -29,11 +30,13 @@ struct MarketDataField {
     double openInterest;       // 持仓量
     double preOpenInterest;    // 昨持仓量
     
+    int64_t localTimestamp;    // 本地收到行情的单调时钟时间（纳秒），用于延迟统计
+    
     MarketDataField() : 
         lastPrice(0.0), openPrice(0.0), highPrice(0.0), lowPrice(0.0),
         closePrice(0.0), preClosePrice(0.0), upperLimit(0.0), lowerLimit(0.0),
         volume(0), turnover(0.0), openInterest(0.0), preOpenInterest(0.0),
-        updateMillisec(0)
+        updateMillisec(0), localTimestamp(0)
     {
         bidPrice.fill(0.0);
         bidVolume.fill(0);
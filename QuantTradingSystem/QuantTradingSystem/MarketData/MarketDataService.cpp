@@ -14,9 +14,25 @@ MarketDataService::~MarketDataService() {
 }
 
 bool MarketDataService::init(const std::string& provider, const std::string& config) {
-    // TODO: 使用工厂模式创建具体的行情数据源实例
-    std::cerr << "Market data provider not implemented: " << provider << std::endl;
-    return false;
+    // 使用工厂创建具体的行情数据源实例
+    auto feed = MarketDataFeedFactory::createMarketDataFeed(provider);
+    if (!feed) {
+        std::cerr << "Market data provider not implemented: " << provider << std::endl;
+        return false;
+    }
+    
+    if (!feed->Init(config)) {
+        std::cerr << "Failed to initialize market data provider: " << provider << std::endl;
+        return false;
+    }
+    
+    feed->SetMarketDataCallback([this](const MarketDataField& field) {
+        onMarketData(field);
+    });
+    
+    quoteApi_ = feed;
+    providerName_ = provider;
+    return true;
 }
 
 bool MarketDataService::start() {
@@ -155,6 +171,10 @@ std::vector<std::string> MarketDataService::getSubscribedSymbols() const {
     return std::vector<std::string>(subscribedSymbols_.begin(), subscribedSymbols_.end());
 }
 
+std::string MarketDataService::getProviderName() const {
+    return providerName_;
+}
+
 bool MarketDataService::isConnected() const {
     return quoteApi_ && quoteApi_->IsConnected();
 }
@@ -174,5 +194,13 @@ void MarketDataService::onMarketData(const MarketDataField& field) {
 std::shared_ptr<MarketDataEvent> MarketDataService::convertToEvent(const MarketDataField& field) {
     // 创建市场数据事件
     auto event = std::make_shared<MarketDataEvent>(field);
+    
+    // 延迟打点：行情回调入口及事件转换完成
+    LatencyTrace& trace = event->getTrace();
+    if (field.localTimestamp != 0) {
+        trace.stamp(LatencyStage::CTP_CALLBACK, field.localTimestamp);
+    }
+    trace.stamp(LatencyStage::CONVERT);
+    
     return event;
 } 
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <vector>
 #include <set>
 #include <mutex>
+#include <atomic>
 #include "../Events/MarketDataEvent.h"
 #include "IMarketDataFeed.h"
 
@@ -38,13 +39,16 @@ public:
     // 获取当前使用的数据源名称
     std::string getProviderName() const;
     
+    // 获取行情数据源
+    std::shared_ptr<IMarketDataFeed> getFeed() const { return quoteApi_; }
+    
+    // 将行情数据转换为事件（不依赖服务状态，基准测试中单独测量）
+    static std::shared_ptr<MarketDataEvent> convertToEvent(const MarketDataField& field);
+    
 private:
     // 行情回调处理
     void onMarketData(const MarketDataField& field);
     
-    // 将行情数据转换为事件
-    std::shared_ptr<MarketDataEvent> convertToEvent(const MarketDataField& field);
-    
 private:
     // 事件管理器
     std::shared_ptr<EventManager> eventManager_;
@@ -52,6 +56,9 @@ private:
     // 行情数据源
     std::shared_ptr<IMarketDataFeed> quoteApi_;
     
+    // 数据源名称
+    std::string providerName_;
+    
     // 已订阅的合约集合
     std::set<std::string> subscribedSymbols_;
     
@@ -59,5 +66,5 @@ private:
     mutable std::mutex mutex_;
     
     // 服务状态
-    bool running_;
+    std::atomic<bool> running_;
 }; 
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "SyntheticMarketDataFeed.h"
+#include "config/ConfigManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <unordered_map>
+
+SyntheticMarketDataFeed::SyntheticMarketDataFeed()
+    : ticksPerSecond_(config_.ticksPerSecond),
+      generated_(0),
+      connected_(false),
+      running_(false),
+      symbols_(std::make_shared<SymbolList>()) {
+}
+
+SyntheticMarketDataFeed::~SyntheticMarketDataFeed() {
+    Disconnect();
+}
+
+bool SyntheticMarketDataFeed::Init(const std::string& config) {
+    if (config.empty()) {
+        return true;
+    }
+
+    auto& configManager = QuantTrading::ConfigManager::getInstance();
+    if (!configManager.loadConfig(config)) {
+        return false;
+    }
+
+    SyntheticFeedConfig settings;
+    settings.instrumentCount = configManager.getValue<int>("synthetic.instrument_count", settings.instrumentCount);
+    settings.symbolPrefix = configManager.getValue<std::string>("synthetic.symbol_prefix", settings.symbolPrefix);
+    settings.exchange = configManager.getValue<std::string>("synthetic.exchange", settings.exchange);
+    settings.ticksPerSecond = configManager.getValue<double>("synthetic.ticks_per_second", settings.ticksPerSecond);
+    settings.arrivalMode = configManager.getValue<std::string>("synthetic.arrival", "poisson") == "bursty" ?
+                           SyntheticArrivalMode::BURSTY : SyntheticArrivalMode::POISSON;
+    settings.burstMultiplier = configManager.getValue<double>("synthetic.burst_multiplier", settings.burstMultiplier);
+    settings.burstDurationMs = configManager.getValue<double>("synthetic.burst_duration_ms", settings.burstDurationMs);
+    settings.calmDurationMs = configManager.getValue<double>("synthetic.calm_duration_ms", settings.calmDurationMs);
+    settings.basePrice = configManager.getValue<double>("synthetic.base_price", settings.basePrice);
+    settings.priceTick = configManager.getValue<double>("synthetic.price_tick", settings.priceTick);
+    settings.volatilityTicks = configManager.getValue<double>("synthetic.volatility_ticks", settings.volatilityTicks);
+    settings.seed = configManager.getValue<unsigned int>("synthetic.seed", settings.seed);
+
+    setConfig(settings);
+    return true;
+}
+
+void SyntheticMarketDataFeed::setConfig(const SyntheticFeedConfig& config) {
+    if (running_) {
+        return; // 运行中只允许调整速率
+    }
+
+    config_ = config;
+    ticksPerSecond_.store(config.ticksPerSecond, std::memory_order_relaxed);
+}
+
+void SyntheticMarketDataFeed::setTicksPerSecond(double ticksPerSecond) {
+    ticksPerSecond_.store(ticksPerSecond, std::memory_order_relaxed);
+}
+
+bool SyntheticMarketDataFeed::Connect() {
+    if (running_) {
+        return true;
+    }
+
+    // 生成模拟合约代码，保留已订阅的合约
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto symbols = std::make_shared<SymbolList>(*std::atomic_load(&symbols_));
+        for (int i = 0; i < config_.instrumentCount; ++i) {
+            char symbol[32];
+            std::snprintf(symbol, sizeof(symbol), "%s%04d", config_.symbolPrefix.c_str(), i);
+            if (std::find(symbols->begin(), symbols->end(), symbol) == symbols->end()) {
+                symbols->push_back(symbol);
+            }
+        }
+        std::atomic_store(&symbols_, std::shared_ptr<const SymbolList>(symbols));
+    }
+
+    running_ = true;
+    connected_ = true;
+    generatorThread_ = std::thread(&SyntheticMarketDataFeed::generatorLoop, this);
+    return true;
+}
+
+void SyntheticMarketDataFeed::Disconnect() {
+    running_ = false;
+    connected_ = false;
+
+    if (generatorThread_.joinable()) {
+        generatorThread_.join();
+    }
+}
+
+void SyntheticMarketDataFeed::Release() {
+    Disconnect();
+}
+
+bool SyntheticMarketDataFeed::IsConnected() const {
+    return connected_;
+}
+
+bool SyntheticMarketDataFeed::Subscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto updated = std::make_shared<SymbolList>(*std::atomic_load(&symbols_));
+    for (const auto& symbol : symbols) {
+        if (std::find(updated->begin(), updated->end(), symbol) == updated->end()) {
+            updated->push_back(symbol);
+        }
+    }
+    std::atomic_store(&symbols_, std::shared_ptr<const SymbolList>(updated));
+    return true;
+}
+
+bool SyntheticMarketDataFeed::Unsubscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto updated = std::make_shared<SymbolList>(*std::atomic_load(&symbols_));
+    updated->erase(
+        std::remove_if(
+            updated->begin(),
+            updated->end(),
+            [&symbols](const std::string& symbol) {
+                return std::find(symbols.begin(), symbols.end(), symbol) != symbols.end();
+            }
+        ),
+        updated->end()
+    );
+    std::atomic_store(&symbols_, std::shared_ptr<const SymbolList>(updated));
+    return true;
+}
+
+void SyntheticMarketDataFeed::syncInstruments(const SymbolList& symbols, std::vector<Instrument>& instruments) {
+    std::unordered_map<std::string, Instrument> existing;
+    for (auto& instrument : instruments) {
+        existing[instrument.symbol] = instrument;
+    }
+
+    instruments.clear();
+    for (const auto& symbol : symbols) {
+        auto it = existing.find(symbol);
+        if (it != existing.end()) {
+            instruments.push_back(it->second);
+            continue;
+        }
+
+        Instrument instrument;
+        instrument.symbol = symbol;
+        instrument.lastPrice = config_.basePrice;
+        instrument.openPrice = config_.basePrice;
+        instrument.highPrice = config_.basePrice;
+        instrument.lowPrice = config_.basePrice;
+        instrument.preClosePrice = config_.basePrice;
+        instrument.volume = 0;
+        instrument.turnover = 0.0;
+        instrument.openInterest = 100000.0;
+        instruments.push_back(instrument);
+    }
+}
+
+void SyntheticMarketDataFeed::generatorLoop() {
+    typedef std::chrono::steady_clock Clock;
+
+    std::mt19937_64 rng(config_.seed);
+    std::exponential_distribution<double> unitExponential(1.0);
+    std::uniform_real_distribution<double> unitUniform(0.0, 1.0);
+
+    std::shared_ptr<const SymbolList> currentSymbols;
+    std::vector<Instrument> instruments;
+    CThostFtdcDepthMarketDataField field;
+
+    bool inBurst = false;
+    Clock::time_point next = Clock::now();
+    Clock::time_point phaseEnd = next + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(unitExponential(rng) * config_.calmDurationMs));
+
+    while (running_) {
+        auto symbols = std::atomic_load(&symbols_);
+        if (symbols != currentSymbols) {
+            syncInstruments(*symbols, instruments);
+            currentSymbols = symbols;
+        }
+
+        double rate = ticksPerSecond_.load(std::memory_order_relaxed);
+        if (instruments.empty() || rate <= 0.0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            next = Clock::now();
+            continue;
+        }
+
+        if (config_.arrivalMode == SyntheticArrivalMode::BURSTY) {
+            // 到达阶段结束时切换平静期/突发期
+            if (next >= phaseEnd) {
+                inBurst = !inBurst;
+                double meanMs = inBurst ? config_.burstDurationMs : config_.calmDurationMs;
+                phaseEnd = next + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(unitExponential(rng) * meanMs));
+            }
+            if (inBurst) {
+                rate *= config_.burstMultiplier;
+            }
+        }
+
+        // 泊松到达：间隔服从均值为1/rate的指数分布
+        next += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(unitExponential(rng) / rate));
+
+        // 等待到达时刻，远的用sleep，近的用yield
+        Clock::time_point now = Clock::now();
+        while (now < next && running_) {
+            if (next - now > std::chrono::milliseconds(2)) {
+                std::this_thread::sleep_for(next - now - std::chrono::milliseconds(1));
+            } else {
+                std::this_thread::yield();
+            }
+            now = Clock::now();
+        }
+
+        // 落后超过一秒时不再追赶，避免暂停之后集中补发
+        if (now - next > std::chrono::seconds(1)) {
+            next = now;
+        }
+
+        size_t index = static_cast<size_t>(unitUniform(rng) * instruments.size());
+        if (index >= instruments.size()) {
+            index = instruments.size() - 1;
+        }
+
+        nextTick(instruments[index], field, rng);
+        OnRtnDepthMarketData(&field);
+        generated_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SyntheticMarketDataFeed::nextTick(Instrument& instrument, CThostFtdcDepthMarketDataField& field,
+                                       std::mt19937_64& rng) {
+    std::normal_distribution<double> walk(0.0, config_.volatilityTicks);
+    std::uniform_int_distribution<int> tradeVolume(1, 20);
+    std::uniform_int_distribution<int> bookVolume(1, 200);
+    std::uniform_int_distribution<int> interestChange(-5, 5);
+
+    const double tick = config_.priceTick;
+    const double upperLimit = std::floor(instrument.preClosePrice * 1.07 / tick) * tick;
+    const double lowerLimit = std::ceil(instrument.preClosePrice * 0.93 / tick) * tick;
+
+    // 价格随机游走，按最小变动价位取整并限制在涨跌停之内
+    double price = instrument.lastPrice + std::round(walk(rng)) * tick;
+    price = std::min(std::max(price, lowerLimit), upperLimit);
+
+    int volume = tradeVolume(rng);
+    instrument.lastPrice = price;
+    instrument.highPrice = std::max(instrument.highPrice, price);
+    instrument.lowPrice = std::min(instrument.lowPrice, price);
+    instrument.volume += volume;
+    instrument.turnover += price * volume;
+    instrument.openInterest = std::max(0.0, instrument.openInterest + interestChange(rng));
+
+    // 时间字段
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    std::tm timeInfo;
+#ifdef _WIN32
+    localtime_s(&timeInfo, &now_time_t);
+#else
+    localtime_r(&now_time_t, &timeInfo);
+#endif
+
+    std::memset(&field, 0, sizeof(field));
+    SAFE_STRNCPY(field.InstrumentID, sizeof(field.InstrumentID), instrument.symbol.c_str(), sizeof(field.InstrumentID) - 1);
+    SAFE_STRNCPY(field.ExchangeID, sizeof(field.ExchangeID), config_.exchange.c_str(), sizeof(field.ExchangeID) - 1);
+    std::strftime(field.TradingDay, sizeof(field.TradingDay), "%Y%m%d", &timeInfo);
+    std::strftime(field.ActionDay, sizeof(field.ActionDay), "%Y%m%d", &timeInfo);
+    std::strftime(field.UpdateTime, sizeof(field.UpdateTime), "%H:%M:%S", &timeInfo);
+    field.UpdateMillisec = static_cast<int>(millis);
+
+    field.LastPrice = price;
+    field.PreSettlementPrice = instrument.preClosePrice;
+    field.PreClosePrice = instrument.preClosePrice;
+    field.PreOpenInterest = 100000.0;
+    field.OpenPrice = instrument.openPrice;
+    field.HighestPrice = instrument.highPrice;
+    field.LowestPrice = instrument.lowPrice;
+    field.Volume = instrument.volume;
+    field.Turnover = instrument.turnover;
+    field.OpenInterest = instrument.openInterest;
+    field.UpperLimitPrice = upperLimit;
+    field.LowerLimitPrice = lowerLimit;
+    field.AveragePrice = instrument.volume > 0 ? instrument.turnover / instrument.volume : price;
+
+    // 五档盘口围绕最新价对称展开
+    double* bidPrices[] = {&field.BidPrice1, &field.BidPrice2, &field.BidPrice3, &field.BidPrice4, &field.BidPrice5};
+    int* bidVolumes[] = {&field.BidVolume1, &field.BidVolume2, &field.BidVolume3, &field.BidVolume4, &field.BidVolume5};
+    double* askPrices[] = {&field.AskPrice1, &field.AskPrice2, &field.AskPrice3, &field.AskPrice4, &field.AskPrice5};
+    int* askVolumes[] = {&field.AskVolume1, &field.AskVolume2, &field.AskVolume3, &field.AskVolume4, &field.AskVolume5};
+
+    for (int i = 0; i < 5; ++i) {
+        *bidPrices[i] = std::max(lowerLimit, price - (i + 1) * tick);
+        *askPrices[i] = std::min(upperLimit, price + (i + 1) * tick);
+        *bidVolumes[i] = bookVolume(rng);
+        *askVolumes[i] = bookVolume(rng);
+    }
+}
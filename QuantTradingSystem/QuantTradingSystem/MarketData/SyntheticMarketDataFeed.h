@@ -0,0 +1,103 @@
+#pragma once
+#include "CTPMarketDataFeed.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 行情到达模式
+enum class SyntheticArrivalMode {
+    POISSON,   // 泊松到达，间隔服从指数分布
+    BURSTY     // 平静期和突发期交替（马尔可夫调制泊松过程）
+};
+
+// 模拟行情配置
+struct SyntheticFeedConfig {
+    int instrumentCount;              // 模拟合约数量
+    std::string symbolPrefix;         // 模拟合约代码前缀
+    std::string exchange;             // 交易所代码
+    double ticksPerSecond;            // 所有合约合计的行情速率（突发模式下为平静期速率）
+    SyntheticArrivalMode arrivalMode; // 到达模式
+    double burstMultiplier;           // 突发期速率倍数
+    double burstDurationMs;           // 突发期平均持续时间（毫秒）
+    double calmDurationMs;            // 平静期平均持续时间（毫秒）
+    double basePrice;                 // 初始价格
+    double priceTick;                 // 最小变动价位
+    double volatilityTicks;           // 每笔行情价格变动的标准差（以最小变动价位计）
+    unsigned int seed;                // 随机数种子
+
+    SyntheticFeedConfig()
+        : instrumentCount(10), symbolPrefix("SYN"), exchange("SYN"),
+          ticksPerSecond(1000.0), arrivalMode(SyntheticArrivalMode::POISSON),
+          burstMultiplier(10.0), burstDurationMs(50.0), calmDurationMs(950.0),
+          basePrice(3500.0), priceTick(1.0), volatilityTicks(1.0), seed(12345) {}
+};
+
+// 模拟行情源
+// 生成CThostFtdcDepthMarketDataField并经由CTPMarketDataFeed::OnRtnDepthMarketData回调，
+// 与实盘走相同的转换和回调路径，用于压力测试和无前置环境下的联调。
+class SyntheticMarketDataFeed : public CTPMarketDataFeed {
+public:
+    SyntheticMarketDataFeed();
+    ~SyntheticMarketDataFeed();
+
+    // IMarketDataFeed接口实现
+    // config为配置文件名，读取其中synthetic节点；为空时使用默认配置
+    bool Init(const std::string& config) override;
+    bool Connect() override;
+    void Disconnect() override;
+    bool IsConnected() const override;
+    bool Subscribe(const std::vector<std::string>& symbols) override;
+    bool Unsubscribe(const std::vector<std::string>& symbols) override;
+    void Release() override;
+
+    // 设置模拟参数（需在Connect之前调用）
+    void setConfig(const SyntheticFeedConfig& config);
+    const SyntheticFeedConfig& getConfig() const { return config_; }
+
+    // 运行期间调整行情速率
+    void setTicksPerSecond(double ticksPerSecond);
+    double getTicksPerSecond() const { return ticksPerSecond_.load(std::memory_order_relaxed); }
+
+    // 已生成的行情数量
+    uint64_t getGeneratedCount() const { return generated_.load(std::memory_order_relaxed); }
+
+private:
+    // 单个模拟合约的状态
+    struct Instrument {
+        std::string symbol;
+        double lastPrice;
+        double openPrice;
+        double highPrice;
+        double lowPrice;
+        double preClosePrice;
+        int volume;
+        double turnover;
+        double openInterest;
+    };
+
+    typedef std::vector<std::string> SymbolList;
+
+    // 行情生成线程
+    void generatorLoop();
+
+    // 生成指定合约的下一笔行情
+    void nextTick(Instrument& instrument, CThostFtdcDepthMarketDataField& field, std::mt19937_64& rng);
+
+    // 根据合约列表补齐合约状态
+    void syncInstruments(const SymbolList& symbols, std::vector<Instrument>& instruments);
+
+    SyntheticFeedConfig config_;
+    std::atomic<double> ticksPerSecond_;
+    std::atomic<uint64_t> generated_;
+    std::atomic<bool> connected_;
+    std::atomic<bool> running_;
+    std::thread generatorThread_;
+
+    // 合约列表，写时复制，生成线程无锁读取
+    std::shared_ptr<const SymbolList> symbols_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,377 @@
+#include "KillSwitch.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/logger/AsyncLogger.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
+#include <chrono>
+
+namespace {
+
+// 受速率限制的撤单的重试间隔
+const int64_t RETRY_INTERVAL_NS = 200000;
+
+// 触发后再次扫描挂单表的延迟，覆盖触发瞬间已通过检查、正在报出的订单
+const int64_t RESWEEP_DELAY_NS = 5000000;
+
+// 仍有未确认的撤单时与挂单表核对的间隔，补上登记前到达而错过的回报
+const int64_t RECONCILE_INTERVAL_NS = 100000000;
+
+const char* getScopeName(KillScope scope) {
+    switch (scope) {
+        case KillScope::GLOBAL: return "global";
+        case KillScope::STRATEGY: return "strategy";
+        case KillScope::INSTRUMENT: return "instrument";
+    }
+    return "unknown";
+}
+
+bool isTerminal(trade::OrderStatus status) {
+    return status == trade::OrderStatus::Filled ||
+           status == trade::OrderStatus::Canceled ||
+           status == trade::OrderStatus::Rejected;
+}
+
+} // namespace
+
+KillSwitch::KillSwitch()
+    : engaged_(0),
+      scopes_(std::make_shared<const Scopes>()),
+      flattenCount_(0),
+      running_(false),
+      engagedCount_(MetricsRegistry::getInstance().getCounter("kill_switch.engaged")),
+      cancelsSent_(MetricsRegistry::getInstance().getCounter("kill_switch.cancels_sent")),
+      cancelsThrottled_(MetricsRegistry::getInstance().getCounter("kill_switch.cancels_throttled")),
+      cancelsFailed_(MetricsRegistry::getInstance().getCounter("kill_switch.cancels_failed")),
+      fanoutTime_(MetricsRegistry::getInstance().getHistogram("kill_switch.cancel_fanout_ns")),
+      timeToFlat_(MetricsRegistry::getInstance().getHistogram("kill_switch.time_to_flat_ns")) {
+}
+
+KillSwitch::~KillSwitch() {
+    stop();
+}
+
+void KillSwitch::setHooks(PendingOrdersProvider pendingOrders, CancelSender cancelSender) {
+    pendingOrders_ = pendingOrders;
+    cancelSender_ = cancelSender;
+}
+
+void KillSwitch::start() {
+    std::lock_guard<std::mutex> lock(flattenMutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    retryThread_ = std::thread(&KillSwitch::retryLoop, this);
+}
+
+void KillSwitch::stop() {
+    {
+        std::lock_guard<std::mutex> lock(flattenMutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+
+    flattenCondition_.notify_all();
+    if (retryThread_.joinable()) {
+        retryThread_.join();
+    }
+}
+
+bool KillSwitch::isBlockedSlow(const std::string& strategyId, const std::string& symbol) const {
+    std::shared_ptr<const Scopes> scopes = std::atomic_load(&scopes_);
+    return scopes->global ||
+           (!scopes->strategies.empty() && scopes->strategies.count(strategyId) != 0) ||
+           (!scopes->instruments.empty() && scopes->instruments.count(symbol) != 0);
+}
+
+bool KillSwitch::matches(KillScope scope, const std::string& key, const trade::OrderData& order) {
+    switch (scope) {
+        case KillScope::GLOBAL: return true;
+        case KillScope::STRATEGY: return order.strategyId == key;
+        case KillScope::INSTRUMENT: return order.symbol == key;
+    }
+    return false;
+}
+
+bool KillSwitch::engage(KillScope scope, const std::string& key, const std::string& reason) {
+    const int64_t engagedAt = latencyNow();
+
+    // 先阻止新订单，再读取挂单表
+    {
+        std::lock_guard<std::mutex> lock(scopeMutex_);
+        std::shared_ptr<const Scopes> current = std::atomic_load(&scopes_);
+        auto updated = std::make_shared<Scopes>(*current);
+        bool inserted = true;
+        switch (scope) {
+            case KillScope::GLOBAL:
+                inserted = !updated->global;
+                updated->global = true;
+                break;
+            case KillScope::STRATEGY:
+                inserted = updated->strategies.insert(key).second;
+                break;
+            case KillScope::INSTRUMENT:
+                inserted = updated->instruments.insert(key).second;
+                break;
+        }
+        if (!inserted) {
+            return false;
+        }
+        std::atomic_store(&scopes_, std::shared_ptr<const Scopes>(updated));
+        engaged_.store(1, std::memory_order_release);
+    }
+    engagedCount_.add();
+    LOG_ERROR(std::string("Kill switch engaged: scope=") + getScopeName(scope) + " key=" + key + " reason=" + reason);
+
+    Flatten flatten;
+    flatten.scope = scope;
+    flatten.key = key;
+    flatten.engagedAt = engagedAt;
+    flatten.resweepAt = engagedAt + RESWEEP_DELAY_NS;
+    flatten.swept = false;
+    flatten.lastClosedAt = 0;
+    flatten.fanoutRecorded = false;
+    flatten.inProgress = false;
+
+    // 撤单在锁外发送，交易接口回调线程可能同时持有接口锁回报订单状态
+    if (pendingOrders_ && cancelSender_) {
+        sweep(flatten, pendingOrders_(scope, key));
+    }
+    if (flatten.throttled.empty()) {
+        fanoutTime_.record(latencyNow() - engagedAt);
+        flatten.fanoutRecorded = true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flattenMutex_);
+        flattens_.push_back(std::move(flatten));
+        flattenCount_.fetch_add(1, std::memory_order_release);
+    }
+    flattenCondition_.notify_all();
+    return true;
+}
+
+bool KillSwitch::release(KillScope scope, const std::string& key) {
+    std::lock_guard<std::mutex> lock(scopeMutex_);
+    std::shared_ptr<const Scopes> current = std::atomic_load(&scopes_);
+    auto updated = std::make_shared<Scopes>(*current);
+    bool removed = false;
+    switch (scope) {
+        case KillScope::GLOBAL:
+            removed = updated->global;
+            updated->global = false;
+            break;
+        case KillScope::STRATEGY:
+            removed = updated->strategies.erase(key) != 0;
+            break;
+        case KillScope::INSTRUMENT:
+            removed = updated->instruments.erase(key) != 0;
+            break;
+    }
+    if (!removed) {
+        return false;
+    }
+
+    std::atomic_store(&scopes_, std::shared_ptr<const Scopes>(updated));
+    engaged_.store(updated->empty() ? 0 : 1, std::memory_order_release);
+    LOG_WARNING(std::string("Kill switch released: scope=") + getScopeName(scope) + " key=" + key);
+    return true;
+}
+
+void KillSwitch::releaseAll() {
+    std::lock_guard<std::mutex> lock(scopeMutex_);
+    std::atomic_store(&scopes_, std::make_shared<const Scopes>());
+    engaged_.store(0, std::memory_order_release);
+    LOG_WARNING("Kill switch released: all scopes");
+}
+
+void KillSwitch::sweep(Flatten& flatten, const std::vector<trade::OrderData>& orders) {
+    for (const auto& order : orders) {
+        if (!matches(flatten.scope, flatten.key, order) || isTerminal(order.status) ||
+            flatten.open.count(order.orderId) != 0) {
+            continue;
+        }
+
+        bool queued = false;
+        for (const auto& throttled : flatten.throttled) {
+            if (throttled.orderId == order.orderId) {
+                queued = true;
+                break;
+            }
+        }
+        if (queued) {
+            continue;
+        }
+
+        switch (cancelSender_(order)) {
+            case KillCancelResult::SENT:
+                cancelsSent_.add();
+                flatten.open.insert(order.orderId);
+                break;
+            case KillCancelResult::THROTTLED:
+                cancelsThrottled_.add();
+                flatten.throttled.push_back(order);
+                break;
+            case KillCancelResult::FAILED:
+                cancelsFailed_.add();
+                LOG_ERROR("Kill switch cannot cancel order " + order.orderId + " " + order.symbol);
+                break;
+        }
+    }
+}
+
+bool KillSwitch::advance(Flatten& flatten, int64_t now) {
+    if (!flatten.fanoutRecorded && flatten.throttled.empty()) {
+        fanoutTime_.record(now - flatten.engagedAt);
+        flatten.fanoutRecorded = true;
+    }
+
+    if (!flatten.swept || !flatten.throttled.empty() || !flatten.open.empty()) {
+        return false;
+    }
+
+    // 清空时间取最后一笔挂单进入终态的时间，而不是确认清空（再次扫描）的时间
+    const int64_t flatAt = flatten.lastClosedAt != 0 ? flatten.lastClosedAt : now;
+    timeToFlat_.record(flatAt - flatten.engagedAt);
+    LOG_WARNING(std::string("Kill switch flat: scope=") + getScopeName(flatten.scope) + " key=" + flatten.key +
+                " time_to_flat_us=" + std::to_string((flatAt - flatten.engagedAt) / 1000));
+    return true;
+}
+
+void KillSwitch::onOrderUpdate(const trade::OrderData& order) {
+    // 没有进行中的撤单时只有一次原子读取
+    if (flattenCount_.load(std::memory_order_acquire) == 0 || !isTerminal(order.status)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(flattenMutex_);
+    const int64_t now = latencyNow();
+    for (auto it = flattens_.begin(); it != flattens_.end();) {
+        if (it->open.erase(order.orderId) != 0) {
+            it->lastClosedAt = now;
+        }
+        // 重试线程正在锁外重发该范围的撤单：记下终态回报，由重试线程合并结果时剔除
+        if (it->inProgress) {
+            it->closed.insert(order.orderId);
+            ++it;
+            continue;
+        }
+        for (auto throttled = it->throttled.begin(); throttled != it->throttled.end(); ++throttled) {
+            if (throttled->orderId == order.orderId) {
+                it->throttled.erase(throttled);
+                break;
+            }
+        }
+
+        if (advance(*it, now)) {
+            it = flattens_.erase(it);
+            flattenCount_.fetch_sub(1, std::memory_order_release);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t KillSwitch::getActiveFlattenCount() const {
+    return static_cast<size_t>(flattenCount_.load(std::memory_order_acquire));
+}
+
+void KillSwitch::retryLoop() {
+    ThreadUtil::setCurrentThreadName("KillSwitch");
+
+    std::unique_lock<std::mutex> lock(flattenMutex_);
+    while (running_) {
+        // 有待重试的撤单时按重试间隔唤醒，否则等到最近的再扫描时间
+        int64_t now = latencyNow();
+        int64_t wakeAt = 0;
+        for (const auto& flatten : flattens_) {
+            int64_t next = !flatten.throttled.empty() ? now + RETRY_INTERVAL_NS : flatten.resweepAt;
+            if (next != 0 && (wakeAt == 0 || next < wakeAt)) {
+                wakeAt = next;
+            }
+        }
+        if (wakeAt == 0) {
+            flattenCondition_.wait(lock);
+        } else if (wakeAt > now) {
+            flattenCondition_.wait_for(lock, std::chrono::nanoseconds(wakeAt - now));
+        }
+        if (!running_) {
+            break;
+        }
+
+        // 取出需要处理的撤单，在锁外发送
+        now = latencyNow();
+        for (auto it = flattens_.begin(); it != flattens_.end();) {
+            bool resweep = it->resweepAt != 0 && now >= it->resweepAt;
+            if (it->throttled.empty() && !resweep) {
+                ++it;
+                continue;
+            }
+
+            Flatten work;
+            work.scope = it->scope;
+            work.key = it->key;
+            work.open = it->open;
+            work.throttled.swap(it->throttled);
+            const std::unordered_set<std::string> known = it->open;
+            it->inProgress = true;
+            lock.unlock();
+
+            std::vector<trade::OrderData> retries;
+            retries.swap(work.throttled);
+            sweep(work, retries);
+
+            // 扫描时以挂单表为准：已不在挂单表中的订单视为已进入终态，
+            // 补上在锁外发送撤单期间到达、未被onOrderUpdate看到的回报
+            std::unordered_set<std::string> stillOpen;
+            if (resweep && pendingOrders_) {
+                std::vector<trade::OrderData> pending = pendingOrders_(work.scope, work.key);
+                sweep(work, pending);
+                for (const auto& order : pending) {
+                    if (!isTerminal(order.status)) {
+                        stillOpen.insert(order.orderId);
+                    }
+                }
+            }
+
+            lock.lock();
+            it->inProgress = false;
+            for (const auto& order : work.throttled) {
+                if (it->closed.count(order.orderId) == 0) {
+                    it->throttled.push_back(order);
+                }
+            }
+            for (const auto& orderId : work.open) {
+                if (known.count(orderId) == 0) {
+                    if (it->closed.count(orderId) == 0) {
+                        it->open.insert(orderId);
+                    } else {
+                        it->lastClosedAt = latencyNow();
+                    }
+                }
+            }
+            it->closed.clear();
+            if (resweep) {
+                for (auto open = it->open.begin(); open != it->open.end();) {
+                    if (stillOpen.count(*open) == 0) {
+                        it->lastClosedAt = latencyNow();
+                        open = it->open.erase(open);
+                    } else {
+                        ++open;
+                    }
+                }
+                it->swept = true;
+                it->resweepAt = it->open.empty() ? 0 : latencyNow() + RECONCILE_INTERVAL_NS;
+            }
+
+            if (advance(*it, latencyNow())) {
+                it = flattens_.erase(it);
+                flattenCount_.fetch_sub(1, std::memory_order_release);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "../Trade/TradeDataStruct.h"
+#include "../Utils/metrics/Metrics.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// 熔断范围
+enum class KillScope {
+    GLOBAL,      // 整个账户
+    STRATEGY,    // 单个策略
+    INSTRUMENT   // 单个合约
+};
+
+// 撤单发送结果
+enum class KillCancelResult {
+    SENT,        // 已发送
+    THROTTLED,   // 撤单速率受限，稍后重试
+    FAILED       // 无法撤单（撤单次数或比例超限、订单不存在等），不再重试
+};
+
+// 熔断开关
+// 触发后立即阻止范围内的新订单，并对范围内的全部挂单批量撤单：能立即发送的撤单在触发线程上
+// 一次发出，受速率限制的由后台线程按令牌到达时间重试，并在稍后再扫描一次挂单表以撤掉触发瞬间
+// 正在报出的订单。所有挂单进入终态后记录从触发到清空（time-to-flat）的耗时。
+// 报单路径上的检查在未触发时只有一次原子读取。
+class KillSwitch {
+public:
+    // 读取范围内的当前挂单（GLOBAL范围忽略key）
+    typedef std::function<std::vector<trade::OrderData>(KillScope scope, const std::string& key)> PendingOrdersProvider;
+    // 发送单笔撤单
+    typedef std::function<KillCancelResult(const trade::OrderData&)> CancelSender;
+
+    KillSwitch();
+    ~KillSwitch();
+
+    // 禁止拷贝和赋值
+    KillSwitch(const KillSwitch&) = delete;
+    KillSwitch& operator=(const KillSwitch&) = delete;
+
+    // 设置挂单来源和撤单发送方式（在触发前设置）
+    void setHooks(PendingOrdersProvider pendingOrders, CancelSender cancelSender);
+
+    // 启动和停止撤单重试线程
+    void start();
+    void stop();
+
+    // 订单是否被熔断阻止
+    bool isBlocked(const std::string& strategyId, const std::string& symbol) const {
+        if (engaged_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        return isBlockedSlow(strategyId, symbol);
+    }
+
+    // 触发熔断并撤掉范围内的挂单；GLOBAL范围忽略key。该范围已触发时返回false
+    bool engage(KillScope scope, const std::string& key, const std::string& reason);
+
+    // 解除熔断，只恢复报单，不影响进行中的撤单
+    bool release(KillScope scope, const std::string& key);
+    void releaseAll();
+
+    bool isEngaged() const { return engaged_.load(std::memory_order_acquire) != 0; }
+
+    // 订单状态回报，用于判断范围内的挂单是否已清空
+    void onOrderUpdate(const trade::OrderData& order);
+
+    // 当前进行中的清仓撤单数
+    size_t getActiveFlattenCount() const;
+
+private:
+    // 已触发的范围，写时复制
+    struct Scopes {
+        bool global;
+        std::unordered_set<std::string> strategies;
+        std::unordered_set<std::string> instruments;
+
+        Scopes() : global(false) {}
+        bool empty() const { return !global && strategies.empty() && instruments.empty(); }
+    };
+
+    // 一次触发对应的撤单进度
+    struct Flatten {
+        KillScope scope;
+        std::string key;
+        int64_t engagedAt;                        // 触发时间（单调时钟纳秒）
+        int64_t resweepAt;                        // 下次扫描挂单表的时间，0表示不再扫描
+        bool swept;                               // 是否已完成触发后的再次扫描
+        int64_t lastClosedAt;                     // 最近一笔挂单进入终态的时间
+        std::vector<trade::OrderData> throttled;  // 受速率限制待重试的撤单
+        std::unordered_set<std::string> open;     // 已发送撤单、尚未进入终态的订单
+        bool fanoutRecorded;                      // 是否已记录撤单全部发出的耗时
+        bool inProgress;                          // 重试线程正在锁外处理，期间不删除
+        std::unordered_set<std::string> closed;   // 锁外处理期间进入终态的订单
+    };
+
+    bool isBlockedSlow(const std::string& strategyId, const std::string& symbol) const;
+
+    static bool matches(KillScope scope, const std::string& key, const trade::OrderData& order);
+
+    // 对挂单中属于该范围且尚未处理的订单发送撤单（不持有flattenMutex_，flatten为局部副本）
+    void sweep(Flatten& flatten, const std::vector<trade::OrderData>& orders);
+
+    // 检查撤单是否全部发出、挂单是否已清空并记录指标（持有flattenMutex_时调用），返回true表示已清空
+    bool advance(Flatten& flatten, int64_t now);
+
+    void retryLoop();
+
+    std::atomic<int> engaged_;
+    std::shared_ptr<const Scopes> scopes_;
+    std::mutex scopeMutex_;
+
+    PendingOrdersProvider pendingOrders_;
+    CancelSender cancelSender_;
+
+    std::list<Flatten> flattens_;
+    std::atomic<int> flattenCount_;
+    mutable std::mutex flattenMutex_;
+    std::condition_variable flattenCondition_;
+    std::thread retryThread_;
+    bool running_;
+
+    MetricCounter& engagedCount_;
+    MetricCounter& cancelsSent_;
+    MetricCounter& cancelsThrottled_;
+    MetricCounter& cancelsFailed_;
+    MetricHistogram& fanoutTime_;
+    MetricHistogram& timeToFlat_;
+};
@@ -0,0 +1,331 @@
+#include "PnlEngine.h"
+
+namespace {
+
+inline void addRelaxed(std::atomic<double>& target, double delta) {
+    target.store(target.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline int64_t absPosition(int64_t value) {
+    return value < 0 ? -value : value;
+}
+
+} // namespace
+
+PnlEngine::PnlEngine()
+    : instruments_(new InstrumentState[MAX_INSTRUMENTS]),
+      index_(std::make_shared<const IndexMap>()),
+      symbols_(std::make_shared<const SymbolList>()),
+      sequence_(0),
+      realizedPnl_(0.0),
+      unrealizedPnl_(0.0),
+      margin_(0.0),
+      commission_(0.0),
+      dayBase_(0.0),
+      dailyPnl_(0.0),
+      peakDailyPnl_(0.0),
+      drawdown_(0.0),
+      lastTradeRealized_(0.0) {
+    ContractSpec defaultSpec;
+    for (int i = 0; i < MAX_INSTRUMENTS; ++i) {
+        InstrumentState& state = instruments_[i];
+        state.netPosition.store(0, std::memory_order_relaxed);
+        state.avgCost.store(0.0, std::memory_order_relaxed);
+        state.lastPrice.store(0.0, std::memory_order_relaxed);
+        state.realizedPnl.store(0.0, std::memory_order_relaxed);
+        state.unrealizedPnl.store(0.0, std::memory_order_relaxed);
+        state.margin.store(0.0, std::memory_order_relaxed);
+        state.multiplier.store(defaultSpec.multiplier, std::memory_order_relaxed);
+        state.longMarginRate.store(defaultSpec.longMarginRate, std::memory_order_relaxed);
+        state.shortMarginRate.store(defaultSpec.shortMarginRate, std::memory_order_relaxed);
+        state.upperLimit.store(0.0, std::memory_order_relaxed);
+        state.lowerLimit.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+int PnlEngine::findInstrument(const std::string& symbol) const {
+    std::shared_ptr<const IndexMap> table = std::atomic_load(&index_);
+    auto it = table->find(symbol);
+    return it != table->end() ? it->second : -1;
+}
+
+int PnlEngine::internInstrument(const std::string& symbol) {
+    int index = findInstrument(symbol);
+    if (index >= 0) {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock(internMutex_);
+    std::shared_ptr<const IndexMap> current = std::atomic_load(&index_);
+    auto it = current->find(symbol);
+    if (it != current->end()) {
+        return it->second;
+    }
+
+    index = static_cast<int>(current->size());
+    if (index >= MAX_INSTRUMENTS) {
+        return -1;
+    }
+
+    auto updated = std::make_shared<IndexMap>(*current);
+    (*updated)[symbol] = index;
+    auto symbols = std::make_shared<SymbolList>(*std::atomic_load(&symbols_));
+    symbols->push_back(symbol);
+
+    std::atomic_store(&symbols_, std::shared_ptr<const SymbolList>(symbols));
+    std::atomic_store(&index_, std::shared_ptr<const IndexMap>(updated));
+    return index;
+}
+
+void PnlEngine::setContractSpec(const std::string& symbol, const ContractSpec& spec) {
+    int index = internInstrument(symbol);
+    if (index < 0) {
+        return;
+    }
+
+    InstrumentState& state = instruments_[index];
+    beginWrite();
+    state.multiplier.store(spec.multiplier > 0.0 ? spec.multiplier : 1.0, std::memory_order_relaxed);
+    state.longMarginRate.store(spec.longMarginRate, std::memory_order_relaxed);
+    state.shortMarginRate.store(spec.shortMarginRate, std::memory_order_relaxed);
+    revalue(state);
+    updateDaily();
+    endWrite();
+}
+
+void PnlEngine::loadContractSpecs(const nlohmann::json& json) {
+    if (!json.is_object()) {
+        return;
+    }
+
+    for (auto it = json.begin(); it != json.end(); ++it) {
+        if (!it.value().is_object()) {
+            continue;
+        }
+        ContractSpec spec;
+        spec.multiplier = it.value().value("multiplier", spec.multiplier);
+        spec.longMarginRate = it.value().value("long_margin_rate", spec.longMarginRate);
+        spec.shortMarginRate = it.value().value("short_margin_rate", spec.shortMarginRate);
+        setContractSpec(it.key(), spec);
+    }
+}
+
+void PnlEngine::onTick(const std::string& symbol, double lastPrice) {
+    int index = findInstrument(symbol);
+    if (index < 0) {
+        index = internInstrument(symbol);
+    }
+    onTick(index, lastPrice);
+}
+
+void PnlEngine::onTick(int instrument, double lastPrice) {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS) || lastPrice <= 0.0) {
+        return;
+    }
+
+    InstrumentState& state = instruments_[instrument];
+
+    // 未持仓的合约只记录价格，不改变任何盈亏
+    if (state.netPosition.load(std::memory_order_relaxed) == 0) {
+        state.lastPrice.store(lastPrice, std::memory_order_relaxed);
+        return;
+    }
+
+    beginWrite();
+    state.lastPrice.store(lastPrice, std::memory_order_relaxed);
+    revalue(state);
+    updateDaily();
+    endWrite();
+}
+
+void PnlEngine::setPriceLimits(int instrument, double upperLimit, double lowerLimit) {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return;
+    }
+
+    // 涨跌停价当日不变，通常只有首笔行情会写入
+    InstrumentState& state = instruments_[instrument];
+    if (state.upperLimit.load(std::memory_order_relaxed) != upperLimit) {
+        state.upperLimit.store(upperLimit, std::memory_order_relaxed);
+    }
+    if (state.lowerLimit.load(std::memory_order_relaxed) != lowerLimit) {
+        state.lowerLimit.store(lowerLimit, std::memory_order_relaxed);
+    }
+}
+
+double PnlEngine::onTrade(const TradeData& data) {
+    int instrument = internInstrument(data.symbol);
+    if (instrument < 0 || data.volume <= 0) {
+        return 0.0;
+    }
+
+    InstrumentState& state = instruments_[instrument];
+    const double multiplier = state.multiplier.load(std::memory_order_relaxed);
+    const int64_t quantity = data.direction == OrderDirection::BUY ? data.volume : -data.volume;
+    const int64_t oldPosition = state.netPosition.load(std::memory_order_relaxed);
+    const int64_t newPosition = oldPosition + quantity;
+    double avgCost = state.avgCost.load(std::memory_order_relaxed);
+    double realized = 0.0;
+
+    if (oldPosition == 0 || (oldPosition > 0) == (quantity > 0)) {
+        // 开仓或加仓，更新持仓均价
+        avgCost = (avgCost * absPosition(oldPosition) + data.price * data.volume) / absPosition(newPosition);
+    } else {
+        // 平仓部分按均价结算，反手部分以成交价为新均价
+        int64_t closed = absPosition(quantity) < absPosition(oldPosition) ? absPosition(quantity) : absPosition(oldPosition);
+        double direction = oldPosition > 0 ? 1.0 : -1.0;
+        realized = (data.price - avgCost) * closed * direction * multiplier;
+        if (newPosition == 0) {
+            avgCost = 0.0;
+        } else if ((newPosition > 0) != (oldPosition > 0)) {
+            avgCost = data.price;
+        }
+    }
+    realized -= data.commission;
+
+    beginWrite();
+    state.netPosition.store(newPosition, std::memory_order_relaxed);
+    state.avgCost.store(avgCost, std::memory_order_relaxed);
+    state.lastPrice.store(data.price, std::memory_order_relaxed);
+    addRelaxed(state.realizedPnl, realized);
+    addRelaxed(realizedPnl_, realized);
+    addRelaxed(commission_, data.commission);
+    revalue(state);
+    updateDaily();
+    lastTradeRealized_.store(realized, std::memory_order_relaxed);
+    endWrite();
+
+    return realized;
+}
+
+void PnlEngine::setPosition(const std::string& symbol, int64_t netPosition, double avgCost) {
+    int instrument = internInstrument(symbol);
+    if (instrument < 0) {
+        return;
+    }
+
+    InstrumentState& state = instruments_[instrument];
+    beginWrite();
+    state.netPosition.store(netPosition, std::memory_order_relaxed);
+    state.avgCost.store(netPosition != 0 ? avgCost : 0.0, std::memory_order_relaxed);
+    if (state.lastPrice.load(std::memory_order_relaxed) <= 0.0) {
+        state.lastPrice.store(avgCost, std::memory_order_relaxed);
+    }
+    revalue(state);
+    updateDaily();
+    endWrite();
+}
+
+void PnlEngine::revalue(InstrumentState& state) {
+    const int64_t position = state.netPosition.load(std::memory_order_relaxed);
+    const double lastPrice = state.lastPrice.load(std::memory_order_relaxed);
+    const double multiplier = state.multiplier.load(std::memory_order_relaxed);
+    const double marginRate = position >= 0 ? state.longMarginRate.load(std::memory_order_relaxed)
+                                            : state.shortMarginRate.load(std::memory_order_relaxed);
+
+    double unrealized = (lastPrice - state.avgCost.load(std::memory_order_relaxed)) * position * multiplier;
+    double margin = absPosition(position) * lastPrice * multiplier * marginRate;
+
+    addRelaxed(unrealizedPnl_, unrealized - state.unrealizedPnl.load(std::memory_order_relaxed));
+    addRelaxed(margin_, margin - state.margin.load(std::memory_order_relaxed));
+    state.unrealizedPnl.store(unrealized, std::memory_order_relaxed);
+    state.margin.store(margin, std::memory_order_relaxed);
+}
+
+void PnlEngine::updateDaily() {
+    double daily = realizedPnl_.load(std::memory_order_relaxed) +
+                   unrealizedPnl_.load(std::memory_order_relaxed) -
+                   dayBase_.load(std::memory_order_relaxed);
+    double peak = peakDailyPnl_.load(std::memory_order_relaxed);
+    if (daily > peak) {
+        peak = daily;
+        peakDailyPnl_.store(peak, std::memory_order_relaxed);
+    }
+    dailyPnl_.store(daily, std::memory_order_relaxed);
+    drawdown_.store(peak - daily, std::memory_order_relaxed);
+}
+
+void PnlEngine::startNewDay() {
+    beginWrite();
+    dayBase_.store(realizedPnl_.load(std::memory_order_relaxed) + unrealizedPnl_.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    peakDailyPnl_.store(0.0, std::memory_order_relaxed);
+    updateDaily();
+    endWrite();
+}
+
+bool PnlEngine::getPosition(int instrument, PositionPnl& position) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return false;
+    }
+
+    const InstrumentState& state = instruments_[instrument];
+    uint64_t before;
+    uint64_t after;
+    do {
+        before = sequence_.load(std::memory_order_acquire);
+        position.netPosition = state.netPosition.load(std::memory_order_relaxed);
+        position.avgCost = state.avgCost.load(std::memory_order_relaxed);
+        position.lastPrice = state.lastPrice.load(std::memory_order_relaxed);
+        position.realizedPnl = state.realizedPnl.load(std::memory_order_relaxed);
+        position.unrealizedPnl = state.unrealizedPnl.load(std::memory_order_relaxed);
+        position.margin = state.margin.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    return true;
+}
+
+bool PnlEngine::getPosition(const std::string& symbol, PositionPnl& position) const {
+    return getPosition(findInstrument(symbol), position);
+}
+
+AccountPnl PnlEngine::getAccount() const {
+    AccountPnl account;
+    uint64_t before;
+    uint64_t after;
+    do {
+        before = sequence_.load(std::memory_order_acquire);
+        account.realizedPnl = realizedPnl_.load(std::memory_order_relaxed);
+        account.unrealizedPnl = unrealizedPnl_.load(std::memory_order_relaxed);
+        account.dailyPnl = dailyPnl_.load(std::memory_order_relaxed);
+        account.peakDailyPnl = peakDailyPnl_.load(std::memory_order_relaxed);
+        account.drawdown = drawdown_.load(std::memory_order_relaxed);
+        account.margin = margin_.load(std::memory_order_relaxed);
+        account.commission = commission_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    return account;
+}
+
+std::vector<std::string> PnlEngine::getSymbols() const {
+    return *std::atomic_load(&symbols_);
+}
+
+size_t PnlEngine::getInstrumentCount() const {
+    return std::atomic_load(&symbols_)->size();
+}
+
+ContractSpec PnlEngine::getContractSpec(int instrument) const {
+    ContractSpec spec;
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return spec;
+    }
+    const InstrumentState& state = instruments_[instrument];
+    spec.multiplier = state.multiplier.load(std::memory_order_relaxed);
+    spec.longMarginRate = state.longMarginRate.load(std::memory_order_relaxed);
+    spec.shortMarginRate = state.shortMarginRate.load(std::memory_order_relaxed);
+    return spec;
+}
+
+void PnlEngine::getPriceLimits(int instrument, double& upperLimit, double& lowerLimit) const {
+    upperLimit = 0.0;
+    lowerLimit = 0.0;
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return;
+    }
+    const InstrumentState& state = instruments_[instrument];
+    upperLimit = state.upperLimit.load(std::memory_order_relaxed);
+    lowerLimit = state.lowerLimit.load(std::memory_order_relaxed);
+}
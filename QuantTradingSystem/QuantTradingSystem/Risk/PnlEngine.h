@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../Events/TradeEvent.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// 合约参数
+struct ContractSpec {
+    double multiplier;        // 合约乘数
+    double longMarginRate;    // 多头保证金率
+    double shortMarginRate;   // 空头保证金率
+
+    ContractSpec() : multiplier(1.0), longMarginRate(0.1), shortMarginRate(0.1) {}
+};
+
+// 单个合约的持仓盈亏
+struct PositionPnl {
+    int64_t netPosition;      // 净持仓，多头为正
+    double avgCost;           // 持仓均价
+    double lastPrice;         // 最新价
+    double realizedPnl;       // 已实现盈亏（已扣手续费）
+    double unrealizedPnl;     // 浮动盈亏
+    double margin;            // 占用保证金
+};
+
+// 账户盈亏汇总
+struct AccountPnl {
+    double realizedPnl;       // 已实现盈亏
+    double unrealizedPnl;     // 浮动盈亏
+    double dailyPnl;          // 当日盈亏（相对交易日开始时）
+    double peakDailyPnl;      // 当日盈亏的最高点
+    double drawdown;          // 从最高点的回撤
+    double margin;            // 占用保证金
+    double commission;        // 手续费
+};
+
+// 实时盈亏和保证金引擎
+// 每笔成交和每笔持仓合约的行情都以O(1)增量更新持仓均价、已实现/浮动盈亏和保证金，
+// 并同步更新账户汇总。更新只允许在单一线程（事件分发线程）上进行；
+// 读取不加锁，通过版本号（seqlock）得到一致的快照，可在任意线程调用。
+class PnlEngine {
+public:
+    static const int MAX_INSTRUMENTS = 4096;
+
+    PnlEngine();
+
+    // 禁止拷贝和赋值
+    PnlEngine(const PnlEngine&) = delete;
+    PnlEngine& operator=(const PnlEngine&) = delete;
+
+    // 设置合约参数（启动时加载）
+    void setContractSpec(const std::string& symbol, const ContractSpec& spec);
+
+    // 从配置节点加载合约参数：{"IF2306": {"multiplier": 300, "long_margin_rate": 0.12, ...}}
+    void loadContractSpecs(const nlohmann::json& json);
+
+    // 登记合约，返回编号；槽位用尽时返回-1
+    int internInstrument(const std::string& symbol);
+
+    // 查找已登记的合约编号，未登记返回-1（无锁）
+    int findInstrument(const std::string& symbol) const;
+
+    // 行情更新，未持仓的合约只记录最新价
+    void onTick(const std::string& symbol, double lastPrice);
+    void onTick(int instrument, double lastPrice);
+    
+    // 记录涨跌停价（价格不变时不写入），供压力测试使用
+    void setPriceLimits(int instrument, double upperLimit, double lowerLimit);
+
+    // 成交更新，返回本笔成交的已实现盈亏（已扣手续费）
+    double onTrade(const TradeData& data);
+
+    // 同步持仓（如启动时查询到的昨仓）
+    void setPosition(const std::string& symbol, int64_t netPosition, double avgCost);
+
+    // 交易日开始，以当前盈亏为基准重新计算当日盈亏和回撤
+    void startNewDay();
+
+    // 读取单个合约的持仓盈亏，未登记返回false
+    bool getPosition(int instrument, PositionPnl& position) const;
+    bool getPosition(const std::string& symbol, PositionPnl& position) const;
+
+    // 读取账户汇总
+    AccountPnl getAccount() const;
+
+    // 常用指标的单次读取
+    double getDailyPnl() const { return dailyPnl_.load(std::memory_order_acquire); }
+    double getDrawdown() const { return drawdown_.load(std::memory_order_acquire); }
+    double getMargin() const { return margin_.load(std::memory_order_acquire); }
+
+    // 最近一笔成交的已实现盈亏（供事件分发线程上的风控规则读取）
+    double getLastTradeRealized() const { return lastTradeRealized_.load(std::memory_order_relaxed); }
+
+    // 已登记的合约，下标即合约编号
+    std::vector<std::string> getSymbols() const;
+
+    // 已登记的合约数量，合约编号为[0, 数量)
+    size_t getInstrumentCount() const;
+
+    // 合约参数
+    ContractSpec getContractSpec(int instrument) const;
+    
+    // 涨跌停价，未收到时为0
+    void getPriceLimits(int instrument, double& upperLimit, double& lowerLimit) const;
+
+private:
+    struct alignas(64) InstrumentState {
+        std::atomic<int64_t> netPosition;
+        std::atomic<double> avgCost;
+        std::atomic<double> lastPrice;
+        std::atomic<double> realizedPnl;
+        std::atomic<double> unrealizedPnl;
+        std::atomic<double> margin;
+        std::atomic<double> multiplier;
+        std::atomic<double> longMarginRate;
+        std::atomic<double> shortMarginRate;
+        std::atomic<double> upperLimit;
+        std::atomic<double> lowerLimit;
+    };
+
+    typedef std::unordered_map<std::string, int> IndexMap;
+    typedef std::vector<std::string> SymbolList;
+
+    // 按最新价重新计算浮动盈亏和保证金，并把差额计入账户汇总（写线程内调用）
+    void revalue(InstrumentState& state);
+
+    // 更新当日盈亏和回撤（写线程内调用）
+    void updateDaily();
+
+    // 写入开始和结束，版本号为奇数时读者重试
+    void beginWrite() { sequence_.fetch_add(1, std::memory_order_acq_rel); }
+    void endWrite() { sequence_.fetch_add(1, std::memory_order_release); }
+
+    std::unique_ptr<InstrumentState[]> instruments_;
+
+    // 合约名称到编号的映射，写时复制
+    std::shared_ptr<const IndexMap> index_;
+    std::shared_ptr<const SymbolList> symbols_;
+    std::mutex internMutex_;
+
+    // 账户汇总
+    std::atomic<uint64_t> sequence_;
+    std::atomic<double> realizedPnl_;
+    std::atomic<double> unrealizedPnl_;
+    std::atomic<double> margin_;
+    std::atomic<double> commission_;
+    std::atomic<double> dayBase_;
+    std::atomic<double> dailyPnl_;
+    std::atomic<double> peakDailyPnl_;
+    std::atomic<double> drawdown_;
+    std::atomic<double> lastTradeRealized_;
+};
@@ -0,0 +1,174 @@
+#include "RateLimiter.h"
+
+namespace {
+
+RateLimit readRateLimit(const nlohmann::json& json, const RateLimit& defaultValue) {
+    RateLimit limit = defaultValue;
+    if (json.is_object()) {
+        limit.ratePerSecond = json.value("rate", limit.ratePerSecond);
+        limit.burst = json.value("burst", limit.burst);
+    }
+    return limit;
+}
+
+} // namespace
+
+OrderRateLimitConfig OrderRateLimitConfig::fromJson(const nlohmann::json& json) {
+    OrderRateLimitConfig config;
+    if (!json.is_object()) {
+        return config;
+    }
+
+    if (json.contains("strategy")) config.strategy = readRateLimit(json["strategy"], config.strategy);
+    if (json.contains("instrument")) config.instrument = readRateLimit(json["instrument"], config.instrument);
+    if (json.contains("account")) config.account = readRateLimit(json["account"], config.account);
+    if (json.contains("cancel")) config.cancel = readRateLimit(json["cancel"], config.cancel);
+
+    if (json.contains("exchanges") && json["exchanges"].is_object()) {
+        for (auto it = json["exchanges"].begin(); it != json["exchanges"].end(); ++it) {
+            config.exchanges[it.key()] = readRateLimit(it.value(), RateLimit());
+        }
+    }
+    if (json.contains("instrument_exchanges") && json["instrument_exchanges"].is_object()) {
+        for (auto it = json["instrument_exchanges"].begin(); it != json["instrument_exchanges"].end(); ++it) {
+            if (it.value().is_string()) {
+                config.instrumentExchanges[it.key()] = it.value().get<std::string>();
+            }
+        }
+    }
+
+    config.maxCancelRatio = json.value("max_cancel_ratio", config.maxCancelRatio);
+    config.cancelRatioMinOrders = json.value("cancel_ratio_min_orders", config.cancelRatioMinOrders);
+    config.maxCancelsPerInstrument = json.value("max_cancels_per_instrument", config.maxCancelsPerInstrument);
+    return config;
+}
+
+OrderRateLimiter::OrderRateLimiter(const OrderRateLimitConfig& config)
+    : config_(config),
+      strategies_(new GcraLimiter[RiskEngine::MAX_STRATEGIES]),
+      instruments_(new GcraLimiter[RiskEngine::MAX_INSTRUMENTS]),
+      cancels_(new GcraLimiter[RiskEngine::MAX_INSTRUMENTS]),
+      exchangeCount_(0),
+      instrumentExchange_(new std::atomic<int>[RiskEngine::MAX_INSTRUMENTS]),
+      orderCounts_(new std::atomic<int64_t>[RiskEngine::MAX_INSTRUMENTS]),
+      cancelCounts_(new std::atomic<int64_t>[RiskEngine::MAX_INSTRUMENTS]) {
+    for (int i = 0; i < RiskEngine::MAX_STRATEGIES; ++i) {
+        strategies_[i].configure(config_.strategy);
+    }
+    for (int i = 0; i < RiskEngine::MAX_INSTRUMENTS; ++i) {
+        instruments_[i].configure(config_.instrument);
+        cancels_[i].configure(config_.cancel);
+        instrumentExchange_[i].store(-1, std::memory_order_relaxed);
+        orderCounts_[i].store(0, std::memory_order_relaxed);
+        cancelCounts_[i].store(0, std::memory_order_relaxed);
+    }
+    account_.configure(config_.account);
+
+    for (const auto& pair : config_.exchanges) {
+        if (exchangeCount_ >= MAX_EXCHANGES) {
+            break;
+        }
+        exchangeNames_[exchangeCount_] = pair.first;
+        exchanges_[exchangeCount_].configure(pair.second);
+        ++exchangeCount_;
+    }
+}
+
+int OrderRateLimiter::findExchange(const std::string& exchange) const {
+    for (int i = 0; i < exchangeCount_; ++i) {
+        if (exchangeNames_[i] == exchange) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void OrderRateLimiter::setInstrumentExchange(int instrument, const std::string& exchange) {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(RiskEngine::MAX_INSTRUMENTS)) {
+        return;
+    }
+    instrumentExchange_[instrument].store(findExchange(exchange), std::memory_order_relaxed);
+}
+
+uint32_t OrderRateLimiter::acquireOrder(int instrument, int strategy, int64_t now) {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(RiskEngine::MAX_INSTRUMENTS) ||
+        static_cast<unsigned>(strategy) >= static_cast<unsigned>(RiskEngine::MAX_STRATEGIES)) {
+        return RISK_UNKNOWN_INSTRUMENT;
+    }
+
+    int exchange = instrumentExchange_[instrument].load(std::memory_order_relaxed);
+    GcraLimiter* const limiters[] = {
+        &strategies_[strategy],
+        &instruments_[instrument],
+        &account_,
+        exchange >= 0 ? &exchanges_[exchange] : nullptr
+    };
+    const uint32_t levelViolations[] = {
+        RISK_STRATEGY_RATE, RISK_INSTRUMENT_RATE, RISK_ACCOUNT_RATE, RISK_EXCHANGE_RATE
+    };
+    const int levels = sizeof(limiters) / sizeof(limiters[0]);
+
+    // 检查和扣减在每一层上是一次CAS，并发申请不会同时通过检查后一起超扣；
+    // 被拒时退回已扣减的层级，被拒订单不消耗其他层级的额度
+    for (int level = 0; level < levels; ++level) {
+        if (limiters[level] && !limiters[level]->tryAcquire(now)) {
+            for (int i = 0; i < level; ++i) {
+                if (limiters[i]) {
+                    limiters[i]->release();
+                }
+            }
+            return levelViolations[level];
+        }
+    }
+
+    orderCounts_[instrument].fetch_add(1, std::memory_order_relaxed);
+    return RISK_OK;
+}
+
+uint32_t OrderRateLimiter::acquireCancel(int instrument, int64_t now) {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(RiskEngine::MAX_INSTRUMENTS)) {
+        return RISK_UNKNOWN_INSTRUMENT;
+    }
+
+    // 先占用撤单次数再检查，并发撤单各自看到不同的计数；被拒时退回
+    int64_t orders = orderCounts_[instrument].load(std::memory_order_relaxed);
+    int64_t cancels = cancelCounts_[instrument].fetch_add(1, std::memory_order_relaxed) + 1;
+
+    uint32_t violations = RISK_OK;
+    if (config_.maxCancelsPerInstrument > 0 && cancels > config_.maxCancelsPerInstrument) {
+        violations |= RISK_CANCEL_LIMIT;
+    }
+    if (config_.maxCancelRatio > 0.0 && orders >= config_.cancelRatioMinOrders &&
+        static_cast<double>(cancels) > config_.maxCancelRatio * orders) {
+        violations |= RISK_CANCEL_RATIO;
+    }
+    if (violations == RISK_OK && !cancels_[instrument].tryAcquire(now)) {
+        violations = RISK_CANCEL_RATE;
+    }
+
+    if (violations != RISK_OK) {
+        cancelCounts_[instrument].fetch_sub(1, std::memory_order_relaxed);
+    }
+    return violations;
+}
+
+void OrderRateLimiter::resetDailyCounters() {
+    for (int i = 0; i < RiskEngine::MAX_INSTRUMENTS; ++i) {
+        orderCounts_[i].store(0, std::memory_order_relaxed);
+        cancelCounts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int64_t OrderRateLimiter::getOrderCount(int instrument) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(RiskEngine::MAX_INSTRUMENTS)) {
+        return 0;
+    }
+    return orderCounts_[instrument].load(std::memory_order_relaxed);
+}
+
+int64_t OrderRateLimiter::getCancelCount(int instrument) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(RiskEngine::MAX_INSTRUMENTS)) {
+        return 0;
+    }
+    return cancelCounts_[instrument].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "RiskEngine.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <nlohmann/json.hpp>
+
+// 速率限制参数
+struct RateLimit {
+    double ratePerSecond;   // 持续速率，0表示不限制
+    double burst;           // 允许的突发数量
+
+    RateLimit() : ratePerSecond(0.0), burst(1.0) {}
+    RateLimit(double rate, double burstSize) : ratePerSecond(rate), burst(burstSize) {}
+};
+
+// GCRA（通用信元速率算法）限速器，等价于令牌桶
+// 只保存一个理论到达时间，检查和扣减都是O(1)，不分配内存。
+// configure需在使用前调用；tryAcquire可在多个线程上并发调用。
+class GcraLimiter {
+public:
+    GcraLimiter() : interval_(0), tolerance_(0), tat_(0) {}
+
+    void configure(const RateLimit& limit) {
+        if (limit.ratePerSecond <= 0.0) {
+            interval_ = 0;
+            tolerance_ = 0;
+        } else {
+            double burst = limit.burst < 1.0 ? 1.0 : limit.burst;
+            interval_ = static_cast<int64_t>(1e9 / limit.ratePerSecond);
+            tolerance_ = static_cast<int64_t>((burst - 1.0) * interval_);
+        }
+        tat_.store(0, std::memory_order_relaxed);
+    }
+
+    bool isLimited() const { return interval_ != 0; }
+
+    // 在now时刻申请n个令牌是否会被允许（不扣减）
+    bool conforms(int64_t now, int64_t n = 1) const {
+        if (interval_ == 0) {
+            return true;
+        }
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        int64_t start = tat > now ? tat : now;
+        return start + (n - 1) * interval_ - now <= tolerance_;
+    }
+
+    // 检查并扣减n个令牌，不允许时不扣减
+    bool tryAcquire(int64_t now, int64_t n = 1) {
+        if (interval_ == 0) {
+            return true;
+        }
+        int64_t tat = tat_.load(std::memory_order_relaxed);
+        int64_t updated;
+        do {
+            int64_t start = tat > now ? tat : now;
+            if (start + (n - 1) * interval_ - now > tolerance_) {
+                return false;
+            }
+            updated = start + n * interval_;
+        } while (!tat_.compare_exchange_weak(tat, updated, std::memory_order_relaxed));
+        return true;
+    }
+
+    // 退回tryAcquire扣减的n个令牌（多层限速中后续层级被拒时调用），退回后的额度不会多于扣减前
+    void release(int64_t n = 1) {
+        if (interval_ == 0) {
+            return;
+        }
+        tat_.fetch_sub(n * interval_, std::memory_order_relaxed);
+    }
+
+private:
+    int64_t interval_;          // 每个令牌的间隔（纳秒）
+    int64_t tolerance_;         // 突发容忍度（纳秒）
+    std::atomic<int64_t> tat_;  // 理论到达时间
+};
+
+// 报单限速配置
+struct OrderRateLimitConfig {
+    RateLimit strategy;                         // 每个策略的报单速率
+    RateLimit instrument;                       // 每个合约的报单速率
+    RateLimit account;                          // 账户总报单速率
+    RateLimit cancel;                           // 每个合约的撤单速率
+    std::map<std::string, RateLimit> exchanges; // 各交易所的报单速率
+    std::map<std::string, std::string> instrumentExchanges; // 合约所属交易所
+    double maxCancelRatio;                      // 撤单数与报单数之比上限，0表示不限制
+    int64_t cancelRatioMinOrders;               // 报单数达到该值后才检查撤单比例
+    int64_t maxCancelsPerInstrument;            // 单合约每日撤单次数上限，0表示不限制
+
+    OrderRateLimitConfig()
+        : maxCancelRatio(0.0), cancelRatioMinOrders(100), maxCancelsPerInstrument(0) {}
+
+    // 从配置节点读取，缺省项保持默认值
+    static OrderRateLimitConfig fromJson(const nlohmann::json& json);
+};
+
+// 报单和撤单限速器
+// 按策略、合约、账户、交易所分层限速，并执行交易所规定的撤单次数和撤单比例限制。
+// 合约和策略使用RiskEngine登记的编号，状态保存在定长数组中。
+class OrderRateLimiter {
+public:
+    static const int MAX_EXCHANGES = 16;
+
+    explicit OrderRateLimiter(const OrderRateLimitConfig& config);
+
+    // 禁止拷贝和赋值
+    OrderRateLimiter(const OrderRateLimiter&) = delete;
+    OrderRateLimiter& operator=(const OrderRateLimiter&) = delete;
+
+    // 设置合约所属交易所（合约编号来自RiskEngine）
+    void setInstrumentExchange(int instrument, const std::string& exchange);
+
+    // 申请报单，所有层级都允许时才扣减令牌，返回第一个不允许的层级对应的RiskViolation
+    // 各层级逐一原子地检查并扣减，某层被拒时退回已扣减的层级，可在多个线程上并发调用
+    uint32_t acquireOrder(int instrument, int strategy, int64_t now = latencyNow());
+
+    // 申请撤单，返回RiskViolation位组合；撤单次数先占后查，并发撤单不会越过次数和比例限制
+    uint32_t acquireCancel(int instrument, int64_t now = latencyNow());
+
+    // 交易日切换时清零报单和撤单计数（由交易日处理器在新交易日的第一笔行情时调用）
+    void resetDailyCounters();
+
+    // 查询接口
+    int64_t getOrderCount(int instrument) const;
+    int64_t getCancelCount(int instrument) const;
+    const OrderRateLimitConfig& getConfig() const { return config_; }
+
+private:
+    // 查找交易所编号，未配置返回-1
+    int findExchange(const std::string& exchange) const;
+
+    OrderRateLimitConfig config_;
+
+    std::unique_ptr<GcraLimiter[]> strategies_;
+    std::unique_ptr<GcraLimiter[]> instruments_;
+    std::unique_ptr<GcraLimiter[]> cancels_;
+    GcraLimiter account_;
+    GcraLimiter exchanges_[MAX_EXCHANGES];
+    std::string exchangeNames_[MAX_EXCHANGES];
+    int exchangeCount_;
+
+    // 每个合约所属交易所编号，-1表示未配置
+    std::unique_ptr<std::atomic<int>[]> instrumentExchange_;
+
+    // 每个合约当日报单和撤单次数
+    std::unique_ptr<std::atomic<int64_t>[]> orderCounts_;
+    std::unique_ptr<std::atomic<int64_t>[]> cancelCounts_;
+};
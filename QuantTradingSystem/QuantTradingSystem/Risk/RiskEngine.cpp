@@ -0,0 +1,536 @@
+#include "RiskEngine.h"
+#include <algorithm>
+
+namespace {
+
+// 暂存的未知订单回报达到该数量时清理已不可能被认领的项
+const size_t MAX_EARLY_REPORTS = 1024;
+
+inline int64_t absPosition(int64_t value) {
+    return value < 0 ? -value : value;
+}
+
+// 单线程更新原子浮点数（调用方持有更新锁）
+inline void addRelaxed(std::atomic<double>& target, double delta) {
+    target.store(target.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void addRelaxed(std::atomic<int64_t>& target, int64_t delta) {
+    target.store(target.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* getRiskViolationName(uint32_t violations) {
+    if (violations & RISK_UNKNOWN_INSTRUMENT) return "UnknownInstrument";
+    if (violations & RISK_INVALID_ORDER) return "InvalidOrder";
+    if (violations & RISK_INSTRUMENT_POSITION) return "InstrumentPositionLimit";
+    if (violations & RISK_TOTAL_POSITION) return "TotalPositionLimit";
+    if (violations & RISK_INSTRUMENT_NOTIONAL) return "InstrumentNotionalLimit";
+    if (violations & RISK_TOTAL_NOTIONAL) return "TotalNotionalLimit";
+    if (violations & RISK_INSTRUMENT_OPEN_ORDERS) return "InstrumentOpenOrderLimit";
+    if (violations & RISK_STRATEGY_OPEN_ORDERS) return "StrategyOpenOrderLimit";
+    if (violations & RISK_STRATEGY_POSITION) return "StrategyPositionLimit";
+    if (violations & RISK_STRATEGY_RATE) return "StrategyOrderRate";
+    if (violations & RISK_INSTRUMENT_RATE) return "InstrumentOrderRate";
+    if (violations & RISK_ACCOUNT_RATE) return "AccountOrderRate";
+    if (violations & RISK_EXCHANGE_RATE) return "ExchangeOrderRate";
+    if (violations & RISK_CANCEL_RATE) return "CancelRate";
+    if (violations & RISK_CANCEL_RATIO) return "CancelRatio";
+    if (violations & RISK_CANCEL_LIMIT) return "CancelLimit";
+    if (violations & RISK_DAILY_LOSS) return "DailyLossLimit";
+    if (violations & RISK_DRAWDOWN) return "DrawdownLimit";
+    return "OK";
+}
+
+RiskEngine::RiskEngine(const RiskLimits& limits)
+    : limits_(limits),
+      instruments_(new InstrumentState[MAX_INSTRUMENTS]),
+      strategies_(new StrategyState[MAX_STRATEGIES]),
+      instrumentIndex_(std::make_shared<const IndexMap>()),
+      strategyIndex_(std::make_shared<const IndexMap>()),
+      totalPosition_(0),
+      totalNotional_(0.0),
+      nextReservation_(1) {
+    for (int i = 0; i < MAX_INSTRUMENTS; ++i) {
+        InstrumentState& state = instruments_[i];
+        state.netPosition.store(0, std::memory_order_relaxed);
+        state.pendingBuy.store(0, std::memory_order_relaxed);
+        state.pendingSell.store(0, std::memory_order_relaxed);
+        state.openOrders.store(0, std::memory_order_relaxed);
+        state.notional.store(0.0, std::memory_order_relaxed);
+        state.pendingNotional.store(0.0, std::memory_order_relaxed);
+        state.lastPrice.store(0.0, std::memory_order_relaxed);
+        state.maxPosition.store(limits_.maxPositionPerInstrument, std::memory_order_relaxed);
+        state.maxNotional.store(limits_.maxNotionalPerInstrument, std::memory_order_relaxed);
+        state.multiplier.store(1.0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MAX_STRATEGIES; ++i) {
+        strategies_[i].openOrders.store(0, std::memory_order_relaxed);
+        strategies_[i].grossPosition.store(0, std::memory_order_relaxed);
+    }
+}
+
+int RiskEngine::internLocked(std::shared_ptr<const IndexMap>& table, const std::string& key, int capacity) {
+    std::shared_ptr<const IndexMap> current = std::atomic_load(&table);
+    auto it = current->find(key);
+    if (it != current->end()) {
+        return it->second;
+    }
+
+    int index = static_cast<int>(current->size());
+    if (index >= capacity) {
+        return -1;
+    }
+
+    auto updated = std::make_shared<IndexMap>(*current);
+    (*updated)[key] = index;
+    std::atomic_store(&table, std::shared_ptr<const IndexMap>(updated));
+    return index;
+}
+
+int RiskEngine::internInstrument(const std::string& symbol) {
+    int index = findInstrument(symbol);
+    if (index >= 0) {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    return internLocked(instrumentIndex_, symbol, MAX_INSTRUMENTS);
+}
+
+int RiskEngine::internStrategy(const std::string& strategyId) {
+    int index = findStrategy(strategyId);
+    if (index >= 0) {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    return internLocked(strategyIndex_, strategyId, MAX_STRATEGIES);
+}
+
+int RiskEngine::findInstrument(const std::string& symbol) const {
+    std::shared_ptr<const IndexMap> table = std::atomic_load(&instrumentIndex_);
+    auto it = table->find(symbol);
+    return it != table->end() ? it->second : -1;
+}
+
+int RiskEngine::findStrategy(const std::string& strategyId) const {
+    std::shared_ptr<const IndexMap> table = std::atomic_load(&strategyIndex_);
+    auto it = table->find(strategyId);
+    return it != table->end() ? it->second : -1;
+}
+
+void RiskEngine::setContractMultiplier(const std::string& symbol, double multiplier) {
+    int index = internInstrument(symbol);
+    if (index < 0 || multiplier <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    instruments_[index].multiplier.store(multiplier, std::memory_order_relaxed);
+}
+
+void RiskEngine::setInstrumentLimits(const std::string& symbol, int64_t maxPosition, double maxNotional) {
+    int index = internInstrument(symbol);
+    if (index < 0) {
+        return;
+    }
+
+    instruments_[index].maxPosition.store(maxPosition, std::memory_order_relaxed);
+    instruments_[index].maxNotional.store(maxNotional, std::memory_order_relaxed);
+}
+
+uint32_t RiskEngine::check(const RiskOrder& order) const {
+    if (static_cast<unsigned>(order.instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS) ||
+        static_cast<unsigned>(order.strategy) >= static_cast<unsigned>(MAX_STRATEGIES)) {
+        return RISK_UNKNOWN_INSTRUMENT;
+    }
+
+    const InstrumentState& instrument = instruments_[order.instrument];
+    const StrategyState& strategy = strategies_[order.strategy];
+
+    const int64_t net = instrument.netPosition.load(std::memory_order_relaxed);
+    const int64_t pendingBuy = instrument.pendingBuy.load(std::memory_order_relaxed);
+    const int64_t pendingSell = instrument.pendingSell.load(std::memory_order_relaxed);
+
+    // 假设同向挂单全部成交后的净持仓
+    const int64_t sign = order.buy ? 1 : -1;
+    const int64_t pending = order.buy ? pendingBuy : pendingSell;
+    const int64_t projected = net + sign * (pending + order.volume);
+    const int64_t netAbs = absPosition(net);
+    const int64_t projectedAbs = absPosition(projected);
+    const int64_t positionDelta = projectedAbs - netAbs;
+
+    const uint32_t increasing = positionDelta > 0 ? 1u : 0u;
+    const double orderNotional = order.price * static_cast<double>(order.volume) *
+                                 instrument.multiplier.load(std::memory_order_relaxed);
+    const double instrumentNotional = instrument.notional.load(std::memory_order_relaxed) +
+                                      instrument.pendingNotional.load(std::memory_order_relaxed) +
+                                      orderNotional;
+
+    // 敞口类限额只约束增加持仓的订单，减仓订单只检查订单合法性和挂单数
+    uint32_t exposure = 0;
+    exposure |= static_cast<uint32_t>(projectedAbs > instrument.maxPosition.load(std::memory_order_relaxed)) << 2;
+    exposure |= static_cast<uint32_t>(totalPosition_.load(std::memory_order_relaxed) + positionDelta >
+                                      limits_.maxTotalPosition) << 3;
+    exposure |= static_cast<uint32_t>(instrumentNotional > instrument.maxNotional.load(std::memory_order_relaxed)) << 4;
+    exposure |= static_cast<uint32_t>(totalNotional_.load(std::memory_order_relaxed) + orderNotional >
+                                      limits_.maxTotalNotional) << 5;
+    exposure |= static_cast<uint32_t>(strategy.grossPosition.load(std::memory_order_relaxed) + positionDelta >
+                                      limits_.maxPositionPerStrategy) << 8;
+
+    uint32_t violations = exposure & (0u - increasing);
+    violations |= static_cast<uint32_t>(order.volume <= 0 || order.price < 0.0) << 1;
+    violations |= static_cast<uint32_t>(instrument.openOrders.load(std::memory_order_relaxed) >=
+                                        limits_.maxOpenOrdersPerInstrument) << 6;
+    violations |= static_cast<uint32_t>(strategy.openOrders.load(std::memory_order_relaxed) >=
+                                        limits_.maxOpenOrdersPerStrategy) << 7;
+    return violations;
+}
+
+bool RiskEngine::isReducing(const RiskOrder& order) const {
+    if (static_cast<unsigned>(order.instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return false;
+    }
+
+    const InstrumentState& instrument = instruments_[order.instrument];
+    const int64_t net = instrument.netPosition.load(std::memory_order_relaxed);
+    const int64_t pending = order.buy ? instrument.pendingBuy.load(std::memory_order_relaxed)
+                                      : instrument.pendingSell.load(std::memory_order_relaxed);
+    const int64_t projected = net + (order.buy ? 1 : -1) * (pending + order.volume);
+    return absPosition(projected) <= absPosition(net);
+}
+
+void RiskEngine::reserve(const std::string& orderId, const RiskOrder& order) {
+    if (static_cast<unsigned>(order.instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS) ||
+        static_cast<unsigned>(order.strategy) >= static_cast<unsigned>(MAX_STRATEGIES)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    if (orders_.count(orderId)) {
+        return;
+    }
+    orders_[orderId] = occupyLocked(order);
+}
+
+uint64_t RiskEngine::reserveInFlight(const RiskOrder& order) {
+    if (static_cast<unsigned>(order.instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS) ||
+        static_cast<unsigned>(order.strategy) >= static_cast<unsigned>(MAX_STRATEGIES)) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    uint64_t reservation = nextReservation_++;
+    inFlight_[reservation] = occupyLocked(order);
+    return reservation;
+}
+
+void RiskEngine::bindInFlight(uint64_t reservation, const std::string& orderId) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    auto it = inFlight_.find(reservation);
+    if (it == inFlight_.end()) {
+        return;
+    }
+    PendingOrder order = it->second;
+    inFlight_.erase(it);
+
+    // 回报先于发送完成到达：成交已计入合约持仓，这里归属到策略并释放挂单量，再应用终结状态
+    auto early = earlyReports_.find(orderId);
+    if (early != earlyReports_.end()) {
+        const EarlyReport& report = early->second;
+        if (report.traded > 0) {
+            order.traded += report.traded;
+            releaseLocked(order, report.traded);
+            applyStrategyPositionLocked(order.instrument, order.strategy, report.delta);
+        }
+        if (report.final) {
+            applyStatusLocked(order, report.status, report.tradedVolume);
+        }
+        earlyReports_.erase(early);
+    }
+    if (order.remaining <= 0) {
+        closeLocked(order);
+    }
+    if ((order.open || order.remaining > 0) && !orders_.emplace(orderId, order).second) {
+        // 同一订单编号已登记，不重复占用
+        releaseLocked(order, order.remaining);
+        closeLocked(order);
+    }
+
+    if (inFlight_.empty()) {
+        earlyReports_.clear();
+    }
+}
+
+void RiskEngine::releaseInFlight(uint64_t reservation) {
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    auto it = inFlight_.find(reservation);
+    if (it == inFlight_.end()) {
+        return;
+    }
+    releaseLocked(it->second, it->second.remaining);
+    closeLocked(it->second);
+    inFlight_.erase(it);
+
+    if (inFlight_.empty()) {
+        earlyReports_.clear();
+    }
+}
+
+RiskEngine::PendingOrder RiskEngine::occupyLocked(const RiskOrder& order) {
+    PendingOrder pending;
+    pending.instrument = order.instrument;
+    pending.strategy = order.strategy;
+    pending.buy = order.buy;
+    pending.remaining = order.volume;
+    pending.traded = 0;
+    pending.open = true;
+    pending.price = order.price;
+
+    InstrumentState& instrument = instruments_[order.instrument];
+    addRelaxed(order.buy ? instrument.pendingBuy : instrument.pendingSell, order.volume);
+    addRelaxed(instrument.openOrders, 1);
+    double notional = order.price * order.volume * instrument.multiplier.load(std::memory_order_relaxed);
+    addRelaxed(instrument.pendingNotional, notional);
+    addRelaxed(totalNotional_, notional);
+    addRelaxed(strategies_[order.strategy].openOrders, 1);
+    return pending;
+}
+
+void RiskEngine::releaseLocked(PendingOrder& order, int64_t volume) {
+    if (volume > order.remaining) {
+        volume = order.remaining;
+    }
+    if (volume <= 0) {
+        return;
+    }
+
+    InstrumentState& instrument = instruments_[order.instrument];
+    addRelaxed(order.buy ? instrument.pendingBuy : instrument.pendingSell, -volume);
+    double notional = order.price * volume * instrument.multiplier.load(std::memory_order_relaxed);
+    addRelaxed(instrument.pendingNotional, -notional);
+    addRelaxed(totalNotional_, -notional);
+    order.remaining -= volume;
+}
+
+void RiskEngine::closeLocked(PendingOrder& order) {
+    if (!order.open) {
+        return;
+    }
+    order.open = false;
+    addRelaxed(instruments_[order.instrument].openOrders, -1);
+    addRelaxed(strategies_[order.strategy].openOrders, -1);
+}
+
+void RiskEngine::applyStatusLocked(PendingOrder& order, OrderStatus status, int64_t tradedVolume) {
+    switch (status) {
+        case OrderStatus::CANCELLED:
+        case OrderStatus::REJECTED:
+        case OrderStatus::EXPIRED: {
+            // 已成交但成交回报尚未到达的部分继续占用，等待onTrade释放
+            int64_t unreported = tradedVolume - order.traded;
+            releaseLocked(order, order.remaining - (unreported > 0 ? unreported : 0));
+            closeLocked(order);
+            break;
+        }
+        case OrderStatus::FILLED:
+            closeLocked(order);
+            break;
+        default:
+            break;
+    }
+}
+
+RiskEngine::EarlyReport* RiskEngine::recordEarlyLocked(const std::string& orderId) {
+    if (inFlight_.empty()) {
+        return nullptr;
+    }
+
+    // 不属于任何在途订单的回报（如其他终端的订单）在积累到上限时清理：
+    // 到达时已登记的在途订单都已绑定或释放后，它不可能再被认领
+    if (earlyReports_.size() >= MAX_EARLY_REPORTS && earlyReports_.count(orderId) == 0) {
+        uint64_t oldest = nextReservation_;
+        for (const auto& pair : inFlight_) {
+            oldest = std::min(oldest, pair.first);
+        }
+        for (auto it = earlyReports_.begin(); it != earlyReports_.end();) {
+            if (it->second.horizon <= oldest) {
+                it = earlyReports_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    EarlyReport& report = earlyReports_[orderId];
+    report.horizon = nextReservation_;
+    return &report;
+}
+
+void RiskEngine::onOrderUpdate(const OrderData& data) {
+    const bool final = data.status == OrderStatus::CANCELLED || data.status == OrderStatus::REJECTED ||
+                       data.status == OrderStatus::EXPIRED || data.status == OrderStatus::FILLED;
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    auto it = orders_.find(data.orderId);
+    if (it == orders_.end()) {
+        // 可能属于尚未完成发送的在途订单，暂存终结状态
+        EarlyReport* report = final ? recordEarlyLocked(data.orderId) : nullptr;
+        if (report) {
+            report->final = true;
+            report->status = data.status;
+            report->tradedVolume = data.tradedVolume;
+        }
+        return;
+    }
+
+    PendingOrder& order = it->second;
+    applyStatusLocked(order, data.status, data.tradedVolume);
+    if (!order.open && order.remaining <= 0) {
+        orders_.erase(it);
+    }
+}
+
+void RiskEngine::onTrade(const TradeData& data) {
+    int instrument = internInstrument(data.symbol);
+    if (instrument < 0 || data.volume <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    int strategy = -1;
+    auto it = orders_.find(data.orderId);
+    if (it != orders_.end()) {
+        PendingOrder& order = it->second;
+        strategy = order.strategy;
+        order.traded += data.volume;
+        releaseLocked(order, data.volume);
+        if (order.remaining <= 0) {
+            closeLocked(order);
+            orders_.erase(it);
+        }
+    }
+
+    int64_t delta = data.direction == OrderDirection::BUY ? data.volume : -data.volume;
+    applyPositionLocked(instrument, strategy, delta, data.price);
+
+    // 可能属于尚未完成发送的在途订单：持仓已计入合约，策略归属和挂单释放留到绑定时
+    if (strategy < 0) {
+        EarlyReport* report = recordEarlyLocked(data.orderId);
+        if (report) {
+            report->traded += data.volume;
+            report->delta += delta;
+        }
+    }
+}
+
+void RiskEngine::setPosition(const std::string& symbol, int64_t netPosition, double price) {
+    int instrument = internInstrument(symbol);
+    if (instrument < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    int64_t current = instruments_[instrument].netPosition.load(std::memory_order_relaxed);
+    applyPositionLocked(instrument, -1, netPosition - current, price);
+}
+
+void RiskEngine::applyPositionLocked(int instrument, int strategy, int64_t delta, double price) {
+    InstrumentState& state = instruments_[instrument];
+    if (price > 0.0) {
+        state.lastPrice.store(price, std::memory_order_relaxed);
+    }
+
+    int64_t oldNet = state.netPosition.load(std::memory_order_relaxed);
+    int64_t newNet = oldNet + delta;
+    state.netPosition.store(newNet, std::memory_order_relaxed);
+    addRelaxed(totalPosition_, absPosition(newNet) - absPosition(oldNet));
+
+    // 按最新成交价重估持仓名义价值
+    double oldNotional = state.notional.load(std::memory_order_relaxed);
+    double newNotional = absPosition(newNet) * state.lastPrice.load(std::memory_order_relaxed) *
+                         state.multiplier.load(std::memory_order_relaxed);
+    state.notional.store(newNotional, std::memory_order_relaxed);
+    addRelaxed(totalNotional_, newNotional - oldNotional);
+
+    if (strategy >= 0) {
+        applyStrategyPositionLocked(instrument, strategy, delta);
+    }
+}
+
+void RiskEngine::applyStrategyPositionLocked(int instrument, int strategy, int64_t delta) {
+    int64_t key = (static_cast<int64_t>(strategy) << 32) | static_cast<uint32_t>(instrument);
+    int64_t& position = strategyPositions_[key];
+    int64_t oldAbs = absPosition(position);
+    position += delta;
+    addRelaxed(strategies_[strategy].grossPosition, absPosition(position) - oldAbs);
+}
+
+bool RiskEngine::makeOrder(const OrderData& data, RiskOrder& order) {
+    order.instrument = internInstrument(data.symbol);
+    order.strategy = internStrategy(data.strategyId);
+    order.buy = data.direction == OrderDirection::BUY;
+    order.volume = data.volume;
+    order.price = data.price;
+    return order.instrument >= 0 && order.strategy >= 0;
+}
+
+int64_t RiskEngine::getNetPosition(int instrument) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return 0;
+    }
+    return instruments_[instrument].netPosition.load(std::memory_order_relaxed);
+}
+
+double RiskEngine::getContractMultiplier(int instrument) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return 1.0;
+    }
+    return instruments_[instrument].multiplier.load(std::memory_order_relaxed);
+}
+
+int64_t RiskEngine::getOpenOrders(int instrument) const {
+    if (static_cast<unsigned>(instrument) >= static_cast<unsigned>(MAX_INSTRUMENTS)) {
+        return 0;
+    }
+    return instruments_[instrument].openOrders.load(std::memory_order_relaxed);
+}
+
+void RiskEngine::getStrategyPositions(std::vector<StrategyPositionEntry>& positions) const {
+    positions.clear();
+
+    std::shared_ptr<const IndexMap> instrumentTable = std::atomic_load(&instrumentIndex_);
+    std::shared_ptr<const IndexMap> strategyTable = std::atomic_load(&strategyIndex_);
+    std::vector<const std::string*> symbols(instrumentTable->size(), nullptr);
+    std::vector<const std::string*> strategies(strategyTable->size(), nullptr);
+    for (const auto& pair : *instrumentTable) {
+        symbols[pair.second] = &pair.first;
+    }
+    for (const auto& pair : *strategyTable) {
+        strategies[pair.second] = &pair.first;
+    }
+
+    std::lock_guard<std::mutex> lock(updateMutex_);
+    for (const auto& pair : strategyPositions_) {
+        size_t strategy = static_cast<size_t>(pair.first >> 32);
+        size_t instrument = static_cast<size_t>(pair.first & 0xFFFFFFFF);
+        if (pair.second == 0 || strategy >= strategies.size() || instrument >= symbols.size()) {
+            continue;
+        }
+
+        StrategyPositionEntry entry;
+        entry.strategyId = *strategies[strategy];
+        entry.symbol = *symbols[instrument];
+        entry.netPosition = pair.second;
+        positions.push_back(entry);
+    }
+}
+
+int64_t RiskEngine::getStrategyOpenOrders(int strategy) const {
+    if (static_cast<unsigned>(strategy) >= static_cast<unsigned>(MAX_STRATEGIES)) {
+        return 0;
+    }
+    return strategies_[strategy].openOrders.load(std::memory_order_relaxed);
+}
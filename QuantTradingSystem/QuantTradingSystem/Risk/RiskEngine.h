@@ -0,0 +1,247 @@
+#pragma once
+
+#include "../Events/OrderEvent.h"
+#include "../Events/TradeEvent.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 风控检查未通过的原因，按位组合
+enum RiskViolation : uint32_t {
+    RISK_OK                      = 0,
+    RISK_UNKNOWN_INSTRUMENT      = 1u << 0,  // 合约或策略槽位已满，无法登记
+    RISK_INVALID_ORDER           = 1u << 1,  // 数量或价格非法
+    RISK_INSTRUMENT_POSITION     = 1u << 2,  // 单合约净持仓超限
+    RISK_TOTAL_POSITION          = 1u << 3,  // 总持仓超限
+    RISK_INSTRUMENT_NOTIONAL     = 1u << 4,  // 单合约名义价值超限
+    RISK_TOTAL_NOTIONAL          = 1u << 5,  // 总名义价值超限
+    RISK_INSTRUMENT_OPEN_ORDERS  = 1u << 6,  // 单合约挂单数超限
+    RISK_STRATEGY_OPEN_ORDERS    = 1u << 7,  // 单策略挂单数超限
+    RISK_STRATEGY_POSITION       = 1u << 8,  // 单策略总持仓超限
+    RISK_STRATEGY_RATE           = 1u << 9,  // 单策略报单速率超限
+    RISK_INSTRUMENT_RATE         = 1u << 10, // 单合约报单速率超限
+    RISK_ACCOUNT_RATE            = 1u << 11, // 账户报单速率超限
+    RISK_EXCHANGE_RATE           = 1u << 12, // 交易所报单速率超限
+    RISK_CANCEL_RATE             = 1u << 13, // 单合约撤单速率超限
+    RISK_CANCEL_RATIO            = 1u << 14, // 撤单比例超限
+    RISK_CANCEL_LIMIT            = 1u << 15, // 单合约撤单次数超限
+    RISK_DAILY_LOSS              = 1u << 16, // 当日亏损超限
+    RISK_DRAWDOWN                = 1u << 17  // 当日回撤超限
+};
+
+// 获取风控检查失败原因的描述（取最低位的原因）
+const char* getRiskViolationName(uint32_t violations);
+
+// 风控限额
+struct RiskLimits {
+    int64_t maxPositionPerInstrument;   // 单合约最大净持仓（含同向挂单）
+    int64_t maxTotalPosition;           // 所有合约净持仓绝对值之和上限
+    double maxNotionalPerInstrument;    // 单合约最大名义价值（持仓加挂单）
+    double maxTotalNotional;            // 总名义价值上限
+    int64_t maxOpenOrdersPerInstrument; // 单合约最大挂单数
+    int64_t maxOpenOrdersPerStrategy;   // 单策略最大挂单数
+    int64_t maxPositionPerStrategy;     // 单策略所有合约持仓绝对值之和上限
+
+    RiskLimits()
+        : maxPositionPerInstrument(50), maxTotalPosition(200),
+          maxNotionalPerInstrument(1e8), maxTotalNotional(1e9),
+          maxOpenOrdersPerInstrument(50), maxOpenOrdersPerStrategy(100),
+          maxPositionPerStrategy(200) {}
+};
+
+// 待检查订单，合约和策略使用登记后的编号，热路径上不做字符串查找
+struct RiskOrder {
+    int instrument;         // 合约编号
+    int strategy;           // 策略编号
+    bool buy;               // 是否买入
+    int64_t volume;         // 数量
+    double price;           // 价格
+    uint64_t reservation;   // 在途登记编号，0表示尚未登记
+
+    RiskOrder() : instrument(-1), strategy(-1), buy(false), volume(0), price(0.0), reservation(0) {}
+};
+
+// 策略在单个合约上的净持仓
+struct StrategyPositionEntry {
+    std::string strategyId;
+    std::string symbol;
+    int64_t netPosition;
+};
+
+// 预先计算状态的事前风控引擎
+// 净持仓、挂单量、挂单数和名义价值在报单和成交回报时增量维护，保存在按编号索引的定长数组中。
+// check只读取数组中的原子变量并一次性汇总所有限额比较结果，没有锁、分配和字符串操作。
+// 状态更新（reserve/onOrderUpdate/onTrade）由内部互斥锁串行化，不影响检查路径。
+// check与随后的reserve之间没有原子性，同一账户的报单应由单一线程完成检查和登记，
+// 或像RiskGate那样用一把锁把检查和登记合为一步。
+// 报单发出前即可用reserveInFlight登记为在途挂单，连续检查的一批订单互相可见；发出后bindInFlight
+// 改按订单编号登记。在途期间到达的未知订单回报被暂存，绑定时结算，回报先于发送完成到达也不会遗漏。
+class RiskEngine {
+public:
+    // 合约和策略槽位数量上限，数组一次性分配，登记后编号不变
+    static const int MAX_INSTRUMENTS = 4096;
+    static const int MAX_STRATEGIES = 256;
+
+    explicit RiskEngine(const RiskLimits& limits = RiskLimits());
+
+    // 禁止拷贝和赋值
+    RiskEngine(const RiskEngine&) = delete;
+    RiskEngine& operator=(const RiskEngine&) = delete;
+
+    // 登记合约或策略，返回编号；槽位用尽时返回-1
+    int internInstrument(const std::string& symbol);
+    int internStrategy(const std::string& strategyId);
+
+    // 查找已登记的编号，未登记返回-1（无锁）
+    int findInstrument(const std::string& symbol) const;
+    int findStrategy(const std::string& strategyId) const;
+
+    // 设置合约乘数，用于名义价值计算，默认为1
+    void setContractMultiplier(const std::string& symbol, double multiplier);
+
+    // 设置单个合约的持仓和名义价值限额，覆盖默认限额
+    void setInstrumentLimits(const std::string& symbol, int64_t maxPosition, double maxNotional);
+
+    // 获取默认限额
+    const RiskLimits& getLimits() const { return limits_; }
+
+    // 检查订单，返回RiskViolation位组合，0表示通过
+    uint32_t check(const RiskOrder& order) const;
+
+    // 订单是否只减少持仓（含同向挂单），减仓订单不受亏损类限额约束
+    bool isReducing(const RiskOrder& order) const;
+
+    // 检查通过后登记挂单，占用挂单量和挂单数
+    void reserve(const std::string& orderId, const RiskOrder& order);
+
+    // 检查通过、尚未发出（没有订单编号）时登记为在途挂单，返回在途登记编号，登记失败返回0
+    uint64_t reserveInFlight(const RiskOrder& order);
+
+    // 在途订单已发出：改按订单编号登记，并结算发送期间先到达的回报
+    void bindInFlight(uint64_t reservation, const std::string& orderId);
+
+    // 在途订单未能发出：释放占用的挂单量和挂单数
+    void releaseInFlight(uint64_t reservation);
+
+    // 订单状态回报：撤单、拒单、过期时释放剩余挂单
+    void onOrderUpdate(const OrderData& data);
+
+    // 成交回报：更新净持仓和名义价值，释放对应挂单量
+    void onTrade(const TradeData& data);
+
+    // 以成交以外的方式同步持仓（如启动时查询到的持仓）
+    void setPosition(const std::string& symbol, int64_t netPosition, double price);
+
+    // 便于从事件构造待检查订单，会登记未知的合约和策略
+    bool makeOrder(const OrderData& data, RiskOrder& order);
+
+    // 查询接口
+    int64_t getNetPosition(int instrument) const;
+    double getContractMultiplier(int instrument) const;
+    int64_t getOpenOrders(int instrument) const;
+    int64_t getTotalPosition() const { return totalPosition_.load(std::memory_order_relaxed); }
+    double getTotalNotional() const { return totalNotional_.load(std::memory_order_relaxed); }
+    int64_t getStrategyOpenOrders(int strategy) const;
+    
+    // 复制各策略在各合约上的非零净持仓（加锁，供周期性的组合风险计算使用）
+    void getStrategyPositions(std::vector<StrategyPositionEntry>& positions) const;
+
+private:
+    // 单合约状态，独占缓存行，避免不同合约的更新互相干扰
+    struct alignas(64) InstrumentState {
+        std::atomic<int64_t> netPosition;   // 净持仓，多头为正
+        std::atomic<int64_t> pendingBuy;    // 未成交买单量
+        std::atomic<int64_t> pendingSell;   // 未成交卖单量
+        std::atomic<int64_t> openOrders;    // 挂单数
+        std::atomic<double> notional;       // 持仓名义价值
+        std::atomic<double> pendingNotional;// 挂单名义价值
+        std::atomic<double> lastPrice;      // 最近成交价，用于重估持仓名义价值
+        std::atomic<int64_t> maxPosition;   // 持仓限额
+        std::atomic<double> maxNotional;    // 名义价值限额
+        std::atomic<double> multiplier;     // 合约乘数
+    };
+
+    // 单策略状态
+    struct alignas(64) StrategyState {
+        std::atomic<int64_t> openOrders;    // 挂单数
+        std::atomic<int64_t> grossPosition; // 各合约持仓绝对值之和
+    };
+
+    // 已登记挂单的剩余数量
+    struct PendingOrder {
+        int instrument;
+        int strategy;
+        bool buy;
+        int64_t remaining;  // 尚未成交且未释放的数量
+        int64_t traded;     // 已收到成交回报的数量
+        bool open;          // 是否仍计入挂单数
+        double price;
+    };
+
+    // 在途期间到达的未知订单回报
+    struct EarlyReport {
+        int64_t traded;         // 成交量（已计入合约持仓，尚未归属策略和释放挂单量）
+        int64_t delta;          // 成交带来的净持仓变化
+        bool final;             // 是否收到终结状态
+        OrderStatus status;     // 终结状态
+        int64_t tradedVolume;   // 终结回报中的累计成交量
+        uint64_t horizon;       // 到达时的下一个在途登记编号，只可能属于更早登记的在途订单
+
+        EarlyReport() : traded(0), delta(0), final(false), status(OrderStatus::SUBMITTED),
+                        tradedVolume(0), horizon(0) {}
+    };
+
+    typedef std::unordered_map<std::string, int> IndexMap;
+
+    // 在更新锁内登记编号
+    int internLocked(std::shared_ptr<const IndexMap>& table, const std::string& key, int capacity);
+
+    // 在更新锁内占用挂单量和挂单数
+    PendingOrder occupyLocked(const RiskOrder& order);
+
+    // 在更新锁内释放挂单的剩余数量
+    void releaseLocked(PendingOrder& order, int64_t volume);
+
+    // 在更新锁内应用订单状态回报
+    void applyStatusLocked(PendingOrder& order, OrderStatus status, int64_t tradedVolume);
+
+    // 在更新锁内暂存未知订单的回报（只在有在途订单时），返回暂存项
+    EarlyReport* recordEarlyLocked(const std::string& orderId);
+
+    // 在更新锁内将订单移出挂单数
+    void closeLocked(PendingOrder& order);
+
+    // 在更新锁内应用净持仓变化
+    void applyPositionLocked(int instrument, int strategy, int64_t delta, double price);
+
+    // 在更新锁内应用策略持仓变化
+    void applyStrategyPositionLocked(int instrument, int strategy, int64_t delta);
+
+    RiskLimits limits_;
+    std::unique_ptr<InstrumentState[]> instruments_;
+    std::unique_ptr<StrategyState[]> strategies_;
+
+    // 名称到编号的映射，写时复制，检查路径无锁读取
+    std::shared_ptr<const IndexMap> instrumentIndex_;
+    std::shared_ptr<const IndexMap> strategyIndex_;
+
+    // 账户汇总
+    std::atomic<int64_t> totalPosition_;
+    std::atomic<double> totalNotional_;
+
+    // 已登记挂单，按订单编号索引
+    std::unordered_map<std::string, PendingOrder> orders_;
+    // 尚未发出的在途挂单，按在途登记编号索引
+    std::unordered_map<uint64_t, PendingOrder> inFlight_;
+    uint64_t nextReservation_;
+    // 在途期间到达的未知订单回报，按订单编号索引；没有在途订单时清空
+    std::unordered_map<std::string, EarlyReport> earlyReports_;
+    // 策略在各合约上的净持仓（键为策略编号<<32|合约编号），用于维护策略总持仓
+    std::unordered_map<int64_t, int64_t> strategyPositions_;
+
+    mutable std::mutex updateMutex_;
+};
@@ -0,0 +1,196 @@
+#include "RiskGate.h"
+#include "../EventManager.h"
+#include "../Events/AllEvents.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include <chrono>
+#include <ctime>
+
+#ifdef _WIN32
+#define SAFE_CTIME(result, time, size) ctime_s(result, size, time)
+#else
+#define SAFE_CTIME(result, time, size) ctime_r(time, result)
+#endif
+
+RiskGate::RiskGate(std::shared_ptr<RiskEngine> engine, std::shared_ptr<EventManager> eventManager)
+    : engine_(engine),
+      maxDailyLoss_(0.0),
+      maxDrawdown_(0.0),
+      eventManager_(eventManager),
+      lossBreached_(false),
+      approved_(MetricsRegistry::getInstance().getCounter("risk_gate.approved")),
+      rejected_(MetricsRegistry::getInstance().getCounter("risk_gate.rejected")) {
+}
+
+bool RiskGate::approve(const trade::OrderData& order, RiskOrder& riskOrder) {
+    riskOrder.instrument = engine_->internInstrument(order.symbol);
+    riskOrder.strategy = engine_->internStrategy(order.strategyId);
+    riskOrder.buy = order.direction == trade::OrderDirection::Buy;
+    riskOrder.volume = order.volume;
+    riskOrder.price = order.price;
+
+    // 检查到登记在途挂单为一步：信号订单在分发线程、算法子单在网关线程审批，
+    // 两个线程不能同时通过检查后再各自登记，否则持仓和挂单数限额会被突破
+    uint32_t violations = RISK_OK;
+    {
+        std::lock_guard<std::mutex> lock(approveMutex_);
+
+        // 限额通过后才申请限速令牌，被拒订单不消耗额度
+        violations = engine_->check(riskOrder);
+        if (violations == RISK_OK && pnlEngine_) {
+            double dailyPnl = pnlEngine_->getDailyPnl();
+            double drawdown = pnlEngine_->getDrawdown();
+            uint32_t loss = RISK_OK;
+            if (maxDailyLoss_ > 0.0 && dailyPnl <= -maxDailyLoss_) {
+                loss |= RISK_DAILY_LOSS;
+            }
+            if (maxDrawdown_ > 0.0 && drawdown >= maxDrawdown_) {
+                loss |= RISK_DRAWDOWN;
+            }
+            if (loss == RISK_OK) {
+                lossBreached_.store(false, std::memory_order_relaxed);
+            } else if (!lossBreached_.exchange(true)) {
+                publishLossBreach(loss, dailyPnl, drawdown);
+            }
+            if (loss != RISK_OK && !engine_->isReducing(riskOrder)) {
+                violations = loss;
+            }
+        }
+        if (violations == RISK_OK && rateLimiter_) {
+            if (!order.exchangeId.empty()) {
+                rateLimiter_->setInstrumentExchange(riskOrder.instrument, order.exchangeId);
+            }
+            violations = rateLimiter_->acquireOrder(riskOrder.instrument, riskOrder.strategy);
+        }
+        if (violations == RISK_OK) {
+            riskOrder.reservation = engine_->reserveInFlight(riskOrder);
+        }
+    }
+
+    if (violations == RISK_OK) {
+        approved_.add();
+        return true;
+    }
+
+    rejected_.add();
+    publishRejection(order, violations, false);
+    return false;
+}
+
+bool RiskGate::approveCancel(const trade::OrderData& order) {
+    if (!rateLimiter_) {
+        return true;
+    }
+
+    uint32_t violations = rateLimiter_->acquireCancel(engine_->internInstrument(order.symbol));
+    if (violations == RISK_OK) {
+        return true;
+    }
+
+    rejected_.add();
+    publishRejection(order, violations, true);
+    return false;
+}
+
+void RiskGate::setLossLimits(std::shared_ptr<PnlEngine> pnlEngine, double maxDailyLoss, double maxDrawdown) {
+    pnlEngine_ = pnlEngine;
+    maxDailyLoss_ = maxDailyLoss;
+    maxDrawdown_ = maxDrawdown;
+}
+
+void RiskGate::setRateLimiter(std::shared_ptr<OrderRateLimiter> rateLimiter) {
+    rateLimiter_ = rateLimiter;
+    if (!rateLimiter_) {
+        return;
+    }
+
+    for (const auto& pair : rateLimiter_->getConfig().instrumentExchanges) {
+        rateLimiter_->setInstrumentExchange(engine_->internInstrument(pair.first), pair.second);
+    }
+}
+
+void RiskGate::commit(const std::string& orderId, const RiskOrder& riskOrder) {
+    // 发送期间先到达的回报由引擎暂存，绑定时结算
+    if (riskOrder.reservation != 0) {
+        engine_->bindInFlight(riskOrder.reservation, orderId);
+    } else {
+        engine_->reserve(orderId, riskOrder);
+    }
+}
+
+void RiskGate::rollback(const RiskOrder& riskOrder) {
+    if (riskOrder.reservation != 0) {
+        engine_->releaseInFlight(riskOrder.reservation);
+    }
+}
+
+void RiskGate::publishLossBreach(uint32_t violations, double dailyPnl, double drawdown) {
+    if (!eventManager_) {
+        return;
+    }
+
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    char timeStr[26];
+    SAFE_CTIME(timeStr, &now_time_t, sizeof(timeStr));
+
+    // 亏损按账户统计，不带策略和合约，熔断范围为整个账户
+    RiskData riskData;
+    riskData.level = RiskLevel::CRITICAL;
+    riskData.type = RiskType::LOSS_LIMIT;
+    riskData.message = std::string("Loss limit breached: ") + getRiskViolationName(violations) +
+                       " dailyPnl=" + std::to_string(dailyPnl) +
+                       " drawdown=" + std::to_string(drawdown);
+    riskData.triggerTime = timeStr;
+    eventManager_->addEvent(std::make_shared<RiskEvent>(riskData));
+}
+
+void RiskGate::publishRejection(const trade::OrderData& order, uint32_t violations, bool cancel) {
+    std::string reason = getRiskViolationName(violations);
+    MetricsRegistry::getInstance().getCounter("risk.rejections." + reason).add();
+
+    if (!eventManager_) {
+        return;
+    }
+
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    char timeStr[26];
+    SAFE_CTIME(timeStr, &now_time_t, sizeof(timeStr));
+
+    RiskData riskData;
+    riskData.level = RiskLevel::WARNING;
+    if (violations & (RISK_DAILY_LOSS | RISK_DRAWDOWN)) {
+        riskData.type = RiskType::LOSS_LIMIT;
+    } else if (violations & (RISK_INSTRUMENT_POSITION | RISK_TOTAL_POSITION | RISK_INSTRUMENT_NOTIONAL |
+                             RISK_TOTAL_NOTIONAL | RISK_STRATEGY_POSITION)) {
+        riskData.type = RiskType::POSITION_LIMIT;
+    } else {
+        riskData.type = RiskType::ORDER_FREQUENCY_LIMIT;
+    }
+    riskData.strategyId = order.strategyId;
+    riskData.symbol = order.symbol;
+    riskData.message = std::string(cancel ? "Cancel" : "Pre-trade risk check") + " rejected: " + reason;
+    riskData.triggerTime = timeStr;
+    eventManager_->addEvent(std::make_shared<RiskEvent>(riskData));
+
+    // 撤单被拒时原订单仍然有效，不发布拒单事件
+    if (cancel) {
+        return;
+    }
+
+    // 订单未发送，没有订单编号
+    OrderData rejectedOrder;
+    rejectedOrder.symbol = order.symbol;
+    rejectedOrder.direction = order.direction == trade::OrderDirection::Buy ?
+                              OrderDirection::BUY : OrderDirection::SELL;
+    rejectedOrder.type = order.priceType == trade::OrderPriceType::Limit ?
+                         OrderType::LIMIT : OrderType::MARKET;
+    rejectedOrder.status = OrderStatus::REJECTED;
+    rejectedOrder.price = order.price;
+    rejectedOrder.volume = order.volume;
+    rejectedOrder.tradedVolume = 0;
+    rejectedOrder.strategyId = order.strategyId;
+    rejectedOrder.createTime = timeStr;
+    rejectedOrder.updateTime = timeStr;
+    eventManager_->addEvent(std::make_shared<OrderEvent>(rejectedOrder));
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "RiskEngine.h"
+#include "RateLimiter.h"
+#include "PnlEngine.h"
+#include "../Trade/TradeDataStruct.h"
+#include "../Utils/metrics/Metrics.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class EventManager;
+
+// 同步事前风控闸门
+// 在TradeService的下单路径上内联调用，订单在发送前完成检查，不经过事件队列。
+// 拒绝时发布风控事件和拒单事件；通过时即登记为在途挂单，随后检查的订单（如网关队列中的一批）都能看到，
+// 调用方在发送成功后调用commit改按订单编号登记，发送失败时调用rollback释放。
+// 检查和在途登记在一把锁内完成，分发线程和网关线程可以同时审批。
+// 当日亏损或回撤首次超限时另发布一条账户级的严重（CRITICAL）风控事件，由熔断处理器触发熔断。
+// 回报（订单状态、成交）仍由RiskManager从事件队列送入同一个RiskEngine。
+class RiskGate {
+public:
+    RiskGate(std::shared_ptr<RiskEngine> engine, std::shared_ptr<EventManager> eventManager);
+
+    // 检查订单，通过时填写riskOrder并返回true
+    bool approve(const trade::OrderData& order, RiskOrder& riskOrder);
+
+    // 订单已发送，在途挂单改按订单编号登记
+    void commit(const std::string& orderId, const RiskOrder& riskOrder);
+
+    // 订单未能发送，释放在途挂单
+    void rollback(const RiskOrder& riskOrder);
+    
+    // 检查撤单是否超过撤单速率、次数或比例限制
+    bool approveCancel(const trade::OrderData& order);
+    
+    // 设置报单限速器（在开始交易前调用），同时登记配置中的合约交易所
+    void setRateLimiter(std::shared_ptr<OrderRateLimiter> rateLimiter);
+    std::shared_ptr<OrderRateLimiter> getRateLimiter() const { return rateLimiter_; }
+    
+    // 设置亏损限额：当日亏损或回撤超限后只允许减仓订单，maxDrawdown为0时不检查回撤
+    void setLossLimits(std::shared_ptr<PnlEngine> pnlEngine, double maxDailyLoss, double maxDrawdown);
+
+    // 获取风控引擎
+    std::shared_ptr<RiskEngine> getRiskEngine() const { return engine_; }
+
+private:
+    // 发布风控事件和拒单事件
+    void publishRejection(const trade::OrderData& order, uint32_t violations, bool cancel);
+
+    // 发布亏损超限的严重风控事件
+    void publishLossBreach(uint32_t violations, double dailyPnl, double drawdown);
+
+    std::shared_ptr<RiskEngine> engine_;
+    std::shared_ptr<OrderRateLimiter> rateLimiter_;
+    std::shared_ptr<PnlEngine> pnlEngine_;
+    double maxDailyLoss_;
+    double maxDrawdown_;
+    std::shared_ptr<EventManager> eventManager_;
+
+    // 串行化检查和在途登记
+    std::mutex approveMutex_;
+
+    // 亏损限额是否处于超限状态，恢复到限额以内之前不重复发布严重事件
+    std::atomic<bool> lossBreached_;
+
+    MetricCounter& approved_;
+    MetricCounter& rejected_;
+};
@@ -0,0 +1,437 @@
+#include "ScenarioRiskEngine.h"
+#include "../EventManager.h"
+#include "../Events/AllEvents.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <sstream>
+
+#ifdef _WIN32
+#define SAFE_CTIME(result, time, size) ctime_s(result, size, time)
+#else
+#define SAFE_CTIME(result, time, size) ctime_r(time, result)
+#endif
+
+namespace {
+
+// 每个线程至少分到的持仓行数，行数较少时唤醒工作线程的开销大于计算本身
+const size_t MIN_ROWS_PER_WORKER = 1024;
+
+// 每个线程至少分到的(持仓簿, 情景)任务数
+const size_t MIN_BOOKS_PER_WORKER = 64;
+
+// 自动选择时的最大并行线程数，避免占用交易线程所在的核心
+const int MAX_AUTO_WORKERS = 4;
+
+StressScenario::Kind parseScenarioKind(const std::string& type) {
+    if (type == "limit_up") return StressScenario::LIMIT_UP;
+    if (type == "limit_down") return StressScenario::LIMIT_DOWN;
+    return StressScenario::RELATIVE;
+}
+
+} // namespace
+
+ScenarioRiskConfig::ScenarioRiskConfig()
+    : intervalMs(1000), workerCount(0), maxAccountLoss(0.0), maxStrategyLoss(0.0) {
+    scenarios.push_back(StressScenario("down_3pct", StressScenario::RELATIVE, -0.03));
+    scenarios.push_back(StressScenario("down_1pct", StressScenario::RELATIVE, -0.01));
+    scenarios.push_back(StressScenario("up_1pct", StressScenario::RELATIVE, 0.01));
+    scenarios.push_back(StressScenario("up_3pct", StressScenario::RELATIVE, 0.03));
+    scenarios.push_back(StressScenario("limit_down", StressScenario::LIMIT_DOWN, -0.1));
+    scenarios.push_back(StressScenario("limit_up", StressScenario::LIMIT_UP, 0.1));
+}
+
+ScenarioRiskConfig ScenarioRiskConfig::fromJson(const nlohmann::json& json) {
+    ScenarioRiskConfig config;
+    if (!json.is_object()) {
+        return config;
+    }
+
+    config.intervalMs = json.value("interval_ms", config.intervalMs);
+    config.workerCount = json.value("workers", config.workerCount);
+    config.maxAccountLoss = json.value("max_account_loss", config.maxAccountLoss);
+    config.maxStrategyLoss = json.value("max_strategy_loss", config.maxStrategyLoss);
+
+    if (json.contains("scenarios") && json["scenarios"].is_array() && !json["scenarios"].empty()) {
+        config.scenarios.clear();
+        for (const auto& item : json["scenarios"]) {
+            if (!item.is_object()) {
+                continue;
+            }
+            StressScenario scenario;
+            scenario.name = item.value("name", std::string());
+            scenario.kind = parseScenarioKind(item.value("type", std::string("relative")));
+            scenario.shock = item.value("shock", 0.0);
+            if (scenario.name.empty()) {
+                scenario.name = "scenario" + std::to_string(config.scenarios.size());
+            }
+            config.scenarios.push_back(scenario);
+        }
+    }
+    return config;
+}
+
+ScenarioRiskEngine::ScenarioRiskEngine(const ScenarioRiskConfig& config,
+                                       std::shared_ptr<PnlEngine> pnlEngine,
+                                       std::shared_ptr<RiskEngine> riskEngine,
+                                       std::shared_ptr<EventManager> eventManager)
+    : config_(config),
+      pnlEngine_(pnlEngine),
+      riskEngine_(riskEngine),
+      eventManager_(eventManager),
+      workerCount_(1),
+      task_(nullptr),
+      taskCount_(0),
+      taskChunk_(0),
+      taskSegments_(0),
+      taskGeneration_(0),
+      pendingWorkers_(0),
+      workersExiting_(false),
+      running_(false) {
+    int workers = config_.workerCount;
+    if (workers <= 0) {
+        workers = std::min(ThreadUtil::getCpuCount() / 2, MAX_AUTO_WORKERS);
+    }
+    workerCount_ = static_cast<size_t>(workers > 0 ? workers : 1);
+
+    // 第一段由调用revalue的线程执行，其余各段由常驻线程执行，重估时不再创建线程
+    workers_.reserve(workerCount_ - 1);
+    for (size_t w = 0; w + 1 < workerCount_; ++w) {
+        workers_.emplace_back(&ScenarioRiskEngine::workerLoop, this, w);
+    }
+}
+
+ScenarioRiskEngine::~ScenarioRiskEngine() {
+    stop();
+
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        workersExiting_ = true;
+    }
+    workReady_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool ScenarioRiskEngine::start() {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    if (running_ || config_.intervalMs <= 0 || config_.scenarios.empty()) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&ScenarioRiskEngine::revaluationLoop, this);
+    return true;
+}
+
+void ScenarioRiskEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(threadMutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+
+    condition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ScenarioRiskEngine::revaluationLoop() {
+    ThreadUtil::setCurrentThreadName("ScenarioRisk");
+
+    std::unique_lock<std::mutex> lock(threadMutex_);
+    while (running_) {
+        condition_.wait_for(lock, std::chrono::milliseconds(config_.intervalMs));
+        if (!running_) {
+            break;
+        }
+
+        lock.unlock();
+        revalue();
+        lock.lock();
+    }
+}
+
+void ScenarioRiskEngine::revalue() {
+    static MetricHistogram& duration = MetricsRegistry::getInstance().getHistogram("scenario_risk.revalue_ns");
+    static MetricGauge& rows = MetricsRegistry::getInstance().getGauge("scenario_risk.rows");
+
+    if (config_.scenarios.empty()) {
+        return;
+    }
+
+    int64_t start = latencyNow();
+    buildPositionTable();
+
+    const size_t rowCount = exposure_.size();
+    const size_t taskCount = bookNames_.size() * config_.scenarios.size();
+    moves_.resize(rowCount * config_.scenarios.size());
+    bookPnl_.assign(taskCount, 0.0);
+
+    parallelFor(rowCount, MIN_ROWS_PER_WORKER, &ScenarioRiskEngine::buildScenarioMatrix);
+    parallelFor(taskCount, MIN_BOOKS_PER_WORKER, &ScenarioRiskEngine::evaluateBooks);
+
+    publishResults();
+
+    rows.set(static_cast<int64_t>(rowCount));
+    duration.record(latencyNow() - start);
+}
+
+void ScenarioRiskEngine::buildPositionTable() {
+    exposure_.clear();
+    lastPrice_.clear();
+    upperLimit_.clear();
+    lowerLimit_.clear();
+    bookOffsets_.clear();
+    bookNames_.clear();
+
+    // 各合约的最新价和涨跌停价只读取一次，账户和策略共用
+    const size_t instrumentCount = pnlEngine_->getInstrumentCount();
+    instrumentPositions_.resize(instrumentCount);
+    instrumentMultipliers_.resize(instrumentCount);
+    instrumentUppers_.resize(instrumentCount);
+    instrumentLowers_.resize(instrumentCount);
+    std::vector<PositionPnl>& positions = instrumentPositions_;
+    std::vector<double>& multipliers = instrumentMultipliers_;
+    std::vector<double>& uppers = instrumentUppers_;
+    std::vector<double>& lowers = instrumentLowers_;
+    for (size_t i = 0; i < instrumentCount; ++i) {
+        int instrument = static_cast<int>(i);
+        pnlEngine_->getPosition(instrument, positions[i]);
+        pnlEngine_->getPriceLimits(instrument, uppers[i], lowers[i]);
+        multipliers[i] = pnlEngine_->getContractSpec(instrument).multiplier;
+    }
+
+    auto appendRow = [&](size_t instrument, int64_t netPosition) {
+        exposure_.push_back(static_cast<double>(netPosition) * multipliers[instrument]);
+        lastPrice_.push_back(positions[instrument].lastPrice);
+        upperLimit_.push_back(uppers[instrument]);
+        lowerLimit_.push_back(lowers[instrument]);
+    };
+
+    // 账户持仓簿
+    bookNames_.push_back(std::string());
+    bookOffsets_.push_back(0);
+    for (size_t i = 0; i < instrumentCount; ++i) {
+        if (positions[i].netPosition != 0 && positions[i].lastPrice > 0.0) {
+            appendRow(i, positions[i].netPosition);
+        }
+    }
+
+    // 策略持仓簿，按策略排序后每个策略的行连续存放
+    if (riskEngine_) {
+        riskEngine_->getStrategyPositions(strategyPositions_);
+        std::sort(strategyPositions_.begin(), strategyPositions_.end(),
+                  [](const StrategyPositionEntry& a, const StrategyPositionEntry& b) {
+                      return a.strategyId < b.strategyId;
+                  });
+
+        for (const auto& entry : strategyPositions_) {
+            int instrument = pnlEngine_->findInstrument(entry.symbol);
+            if (instrument < 0 || static_cast<size_t>(instrument) >= instrumentCount ||
+                positions[instrument].lastPrice <= 0.0) {
+                continue;
+            }
+            if (entry.strategyId != bookNames_.back()) {
+                bookNames_.push_back(entry.strategyId);
+                bookOffsets_.push_back(exposure_.size());
+            }
+            appendRow(static_cast<size_t>(instrument), entry.netPosition);
+        }
+    }
+    bookOffsets_.push_back(exposure_.size());
+}
+
+void ScenarioRiskEngine::buildScenarioMatrix(size_t begin, size_t end) {
+    const size_t rowCount = exposure_.size();
+    const double* price = lastPrice_.data();
+    const double* upper = upperLimit_.data();
+    const double* lower = lowerLimit_.data();
+
+    // 每个情景写一段连续内存，循环内没有分支依赖，便于编译器向量化
+    for (size_t s = 0; s < config_.scenarios.size(); ++s) {
+        const StressScenario& scenario = config_.scenarios[s];
+        const double shock = scenario.shock;
+        double* move = moves_.data() + s * rowCount;
+
+        switch (scenario.kind) {
+            case StressScenario::RELATIVE:
+                for (size_t i = begin; i < end; ++i) {
+                    move[i] = price[i] * shock;
+                }
+                break;
+            case StressScenario::LIMIT_UP:
+                for (size_t i = begin; i < end; ++i) {
+                    move[i] = upper[i] > 0.0 ? upper[i] - price[i] : price[i] * shock;
+                }
+                break;
+            case StressScenario::LIMIT_DOWN:
+                for (size_t i = begin; i < end; ++i) {
+                    move[i] = lower[i] > 0.0 ? lower[i] - price[i] : price[i] * shock;
+                }
+                break;
+        }
+    }
+}
+
+void ScenarioRiskEngine::evaluateBooks(size_t begin, size_t end) {
+    const size_t rowCount = exposure_.size();
+    const size_t scenarioCount = config_.scenarios.size();
+    const double* exposure = exposure_.data();
+
+    for (size_t task = begin; task < end; ++task) {
+        const size_t book = task / scenarioCount;
+        const size_t scenario = task % scenarioCount;
+        const double* move = moves_.data() + scenario * rowCount;
+
+        double pnl = 0.0;
+        for (size_t i = bookOffsets_[book]; i < bookOffsets_[book + 1]; ++i) {
+            pnl += exposure[i] * move[i];
+        }
+        bookPnl_[task] = pnl;
+    }
+}
+
+void ScenarioRiskEngine::parallelFor(size_t count, size_t minPerWorker, RangeTask task) {
+    size_t segments = std::min(workerCount_, count / minPerWorker);
+    if (segments <= 1) {
+        (this->*task)(0, count);
+        return;
+    }
+
+    const size_t chunk = (count + segments - 1) / segments;
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        task_ = task;
+        taskCount_ = count;
+        taskChunk_ = chunk;
+        taskSegments_ = segments;
+        pendingWorkers_ = segments - 1;
+        ++taskGeneration_;
+    }
+    workReady_.notify_all();
+
+    // 第一段在当前线程执行，完成后等待其余各段
+    (this->*task)(0, std::min(count, chunk));
+
+    std::unique_lock<std::mutex> lock(workMutex_);
+    workDone_.wait(lock, [this]() { return pendingWorkers_ == 0; });
+}
+
+void ScenarioRiskEngine::workerLoop(size_t index) {
+    ThreadUtil::setCurrentThreadName("ScenarioWorker");
+
+    // 参与某一轮的线程在该轮结束前必然已经领取，不参与的线程跳过的轮次无需补做
+    const size_t segment = index + 1;
+    uint64_t seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(workMutex_);
+    while (true) {
+        workReady_.wait(lock, [this, seenGeneration]() {
+            return workersExiting_ || taskGeneration_ != seenGeneration;
+        });
+        if (workersExiting_) {
+            break;
+        }
+        seenGeneration = taskGeneration_;
+        if (segment >= taskSegments_) {
+            continue;
+        }
+
+        RangeTask task = task_;
+        size_t begin = segment * taskChunk_;
+        size_t end = std::min(taskCount_, begin + taskChunk_);
+        lock.unlock();
+        if (begin < end) {
+            (this->*task)(begin, end);
+        }
+        lock.lock();
+
+        if (--pendingWorkers_ == 0) {
+            workDone_.notify_one();
+        }
+    }
+}
+
+void ScenarioRiskEngine::publishResults() {
+    static MetricGauge& accountWorst = MetricsRegistry::getInstance().getGauge("scenario_risk.account_worst_pnl");
+
+    const size_t scenarioCount = config_.scenarios.size();
+    std::vector<ScenarioBookResult>& results = pendingResults_;
+    results.resize(bookNames_.size());
+    for (size_t b = 0; b < bookNames_.size(); ++b) {
+        ScenarioBookResult& result = results[b];
+        result.book = bookNames_[b];
+        result.scenarioPnl.assign(bookPnl_.begin() + b * scenarioCount, bookPnl_.begin() + (b + 1) * scenarioCount);
+
+        size_t worst = 0;
+        for (size_t s = 1; s < scenarioCount; ++s) {
+            if (result.scenarioPnl[s] < result.scenarioPnl[worst]) {
+                worst = s;
+            }
+        }
+        result.worstPnl = result.scenarioPnl[worst];
+        result.worstScenario = config_.scenarios[worst].name;
+
+        // 超限时只在首次进入超限状态时发布，恢复后重新计数
+        double limit = result.book.empty() ? config_.maxAccountLoss : config_.maxStrategyLoss;
+        bool breached = limit > 0.0 && -result.worstPnl > limit;
+        bool& wasBreached = breached_[result.book];
+        if (breached && !wasBreached) {
+            publishBreach(result, limit);
+        }
+        wasBreached = breached;
+    }
+
+    // 本轮已无持仓的策略视为恢复
+    for (auto& pair : breached_) {
+        if (pair.second && std::find(bookNames_.begin(), bookNames_.end(), pair.first) == bookNames_.end()) {
+            pair.second = false;
+        }
+    }
+
+    accountWorst.set(static_cast<int64_t>(results.front().worstPnl));
+
+    // 交换后pendingResults_持有上一轮的结果，下一轮在其上原地覆盖
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    results_.swap(results);
+}
+
+void ScenarioRiskEngine::publishBreach(const ScenarioBookResult& result, double limit) {
+    if (!eventManager_) {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "Scenario stress loss exceeds limit: " << (result.book.empty() ? "account" : "strategy " + result.book)
+       << " scenario=" << result.worstScenario
+       << " pnl=" << result.worstPnl
+       << " limit=" << limit;
+
+    RiskData riskData;
+    riskData.level = RiskLevel::CRITICAL;
+    riskData.type = RiskType::LOSS_LIMIT;
+    riskData.strategyId = result.book;
+    riskData.message = ss.str();
+
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    char timeStr[26];
+    SAFE_CTIME(timeStr, &now_time_t, sizeof(timeStr));
+    riskData.triggerTime = timeStr;
+
+    eventManager_->addEvent(std::make_shared<RiskEvent>(riskData));
+}
+
+std::vector<ScenarioBookResult> ScenarioRiskEngine::getResults() const {
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    return results_;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "PnlEngine.h"
+#include "RiskEngine.h"
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class EventManager;
+
+// 压力情景
+struct StressScenario {
+    enum Kind {
+        RELATIVE,     // 所有合约按同一比例变动
+        LIMIT_UP,     // 所有合约涨停
+        LIMIT_DOWN    // 所有合约跌停
+    };
+
+    std::string name;
+    Kind kind;
+    double shock;     // 价格变动比例；涨跌停情景在未收到涨跌停价时以此比例代替
+
+    StressScenario() : kind(RELATIVE), shock(0.0) {}
+    StressScenario(const std::string& scenarioName, Kind scenarioKind, double scenarioShock)
+        : name(scenarioName), kind(scenarioKind), shock(scenarioShock) {}
+};
+
+// 组合压力测试配置
+struct ScenarioRiskConfig {
+    std::vector<StressScenario> scenarios;  // 默认±1%、±3%、涨停、跌停
+    int intervalMs;                         // 重估周期
+    int workerCount;                        // 并行线程数，0表示按CPU核数自动选择
+    double maxAccountLoss;                  // 账户最差情景亏损上限，0表示不检查
+    double maxStrategyLoss;                 // 单策略最差情景亏损上限，0表示不检查
+
+    ScenarioRiskConfig();
+
+    // 从配置节点读取，缺省项保持默认值
+    static ScenarioRiskConfig fromJson(const nlohmann::json& json);
+};
+
+// 单个持仓簿（账户或策略）的压力测试结果
+struct ScenarioBookResult {
+    std::string book;                  // 策略ID，账户为空
+    std::vector<double> scenarioPnl;   // 各情景下的盈亏，与配置的情景顺序一致
+    double worstPnl;                   // 最差情景下的盈亏，负数为亏损
+    std::string worstScenario;         // 最差情景名称
+};
+
+// 组合层面的情景重估
+// 周期性地把账户持仓（PnlEngine）和各策略持仓（RiskEngine）拷贝成按持仓簿分组的列式持仓表，
+// 生成"情景 × 持仓行"的价格变动矩阵，再对每个(持仓簿, 情景)做连续内存上的点积，
+// 两个阶段都按行或按任务切分到常驻的工作线程。最差情景亏损超过限额时发布严重级别的LOSS_LIMIT风控事件
+// （策略持仓簿带策略ID，由熔断处理器按策略或账户熔断），同一持仓簿在恢复到限额以内之前不重复发布。
+class ScenarioRiskEngine {
+public:
+    ScenarioRiskEngine(const ScenarioRiskConfig& config,
+                       std::shared_ptr<PnlEngine> pnlEngine,
+                       std::shared_ptr<RiskEngine> riskEngine,
+                       std::shared_ptr<EventManager> eventManager);
+    ~ScenarioRiskEngine();
+
+    // 禁止拷贝和赋值
+    ScenarioRiskEngine(const ScenarioRiskEngine&) = delete;
+    ScenarioRiskEngine& operator=(const ScenarioRiskEngine&) = delete;
+
+    // 启动和停止重估线程
+    bool start();
+    void stop();
+
+    // 立即执行一次重估并检查限额（重估线程调用，也可在测试和基准中直接调用）
+    void revalue();
+
+    // 最近一次重估结果，第一项为账户
+    std::vector<ScenarioBookResult> getResults() const;
+
+    const ScenarioRiskConfig& getConfig() const { return config_; }
+
+private:
+    // 从盈亏引擎和风控引擎拷贝持仓，构建列式持仓表
+    void buildPositionTable();
+
+    // 计算[begin, end)行在所有情景下的价格变动
+    void buildScenarioMatrix(size_t begin, size_t end);
+
+    // 计算[begin, end)号任务，任务号 = 持仓簿 × 情景数 + 情景
+    void evaluateBooks(size_t begin, size_t end);
+
+    // 按区段执行的计算阶段
+    typedef void (ScenarioRiskEngine::*RangeTask)(size_t begin, size_t end);
+
+    // 把[0, count)切分给当前线程和常驻工作线程执行，数量较少时只在当前线程执行
+    void parallelFor(size_t count, size_t minPerWorker, RangeTask task);
+
+    // 常驻工作线程：等待parallelFor分发，执行第index + 1段
+    void workerLoop(size_t index);
+
+    // 汇总结果并检查限额
+    void publishResults();
+
+    // 发布亏损超限风控事件
+    void publishBreach(const ScenarioBookResult& result, double limit);
+
+    void revaluationLoop();
+
+    ScenarioRiskConfig config_;
+    std::shared_ptr<PnlEngine> pnlEngine_;
+    std::shared_ptr<RiskEngine> riskEngine_;
+    std::shared_ptr<EventManager> eventManager_;
+    size_t workerCount_;
+
+    // 列式持仓表，同一持仓簿的行连续存放，第bookOffsets_[b]到第bookOffsets_[b + 1]行属于持仓簿b
+    std::vector<double> exposure_;      // 净持仓 × 合约乘数
+    std::vector<double> lastPrice_;     // 最新价
+    std::vector<double> upperLimit_;    // 涨停价，未知为0
+    std::vector<double> lowerLimit_;    // 跌停价，未知为0
+    std::vector<size_t> bookOffsets_;
+    std::vector<std::string> bookNames_;
+
+    // 价格变动矩阵，第s个情景第i行位于moves_[s * 行数 + i]
+    std::vector<double> moves_;
+
+    // 各持仓簿各情景的盈亏，位于bookPnl_[b * 情景数 + s]
+    std::vector<double> bookPnl_;
+
+    // 构建持仓表时复用的缓冲区，按合约编号索引的各项只在合约数增加时扩容
+    std::vector<StrategyPositionEntry> strategyPositions_;
+    std::vector<PositionPnl> instrumentPositions_;
+    std::vector<double> instrumentMultipliers_;
+    std::vector<double> instrumentUppers_;
+    std::vector<double> instrumentLowers_;
+
+    // 汇总结果时复用的缓冲区，与results_交换
+    std::vector<ScenarioBookResult> pendingResults_;
+
+    // 已发布过超限事件的持仓簿
+    std::map<std::string, bool> breached_;
+
+    std::vector<ScenarioBookResult> results_;
+    mutable std::mutex resultsMutex_;
+
+    // 常驻工作线程（workerCount_ - 1个），构造时创建，析构时退出
+    // taskGeneration_每次分发加一，pendingWorkers_为本轮尚未完成的工作线程数
+    std::vector<std::thread> workers_;
+    std::mutex workMutex_;
+    std::condition_variable workReady_;
+    std::condition_variable workDone_;
+    RangeTask task_;
+    size_t taskCount_;
+    size_t taskChunk_;
+    size_t taskSegments_;
+    uint64_t taskGeneration_;
+    size_t pendingWorkers_;
+    bool workersExiting_;
+
+    // 重估线程（revalue只在该线程或停止后调用，持仓表等缓冲区不加锁）
+    std::thread thread_;
+    bool running_;
+    std::mutex threadMutex_;
+    std::condition_variable condition_;
+};
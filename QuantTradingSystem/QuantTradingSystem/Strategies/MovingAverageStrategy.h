@@ -50,6 +50,11 @@ public:
         return true;
     }
     
+    // 只订阅参数中指定的交易合约
+    std::vector<std::string> getSubscribedSymbols() const override {
+        return { param_.symbol };
+    }
+    
     // 处理行情数据
     void onMarketData(const MarketDataField& data) override {
         if (!initialized_ || status_ != StrategyStatus::RUNNING) {
@@ -138,10 +143,8 @@ private:
         signal.signalTime = data.updateTime;
         signal.comment = "MA CrossOver: Short MA crosses above Long MA";
         
-        // 创建并发送信号事件
-        auto event = std::make_shared<StrategySignalEvent>(signal);
-        // 事件发送到事件管理器
-        // 需要持有EventManager引用才能发送事件
+        // 通过策略上下文发送信号
+        emitSignal(signal);
     }
     
     // 生成开空信号
@@ -157,10 +160,8 @@ private:
         signal.signalTime = data.updateTime;
         signal.comment = "MA CrossUnder: Short MA crosses below Long MA";
         
-        // 创建并发送信号事件
-        auto event = std::make_shared<StrategySignalEvent>(signal);
-        // 事件发送到事件管理器
-        // 需要持有EventManager引用才能发送事件
+        // 通过策略上下文发送信号
+        emitSignal(signal);
     }
     
 private:
@@ -0,0 +1,279 @@
+#include "CTPQueryScheduler.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
+
+namespace {
+
+// CTP请求函数的返回值：未处理请求超过许可数、每秒发送请求数超过许可数
+const int CTP_RET_PENDING_LIMIT = -2;
+const int CTP_RET_RATE_LIMIT = -3;
+
+} // namespace
+
+CTPQueryScheduler::CTPQueryScheduler(const CTPQueryConfig& config)
+    : config_(config),
+      running_(false),
+      queriesSent_(MetricsRegistry::getInstance().getCounter("ctp_query.sent")),
+      queriesCoalesced_(MetricsRegistry::getInstance().getCounter("ctp_query.coalesced")),
+      queriesThrottled_(MetricsRegistry::getInstance().getCounter("ctp_query.throttled")),
+      queriesTimedOut_(MetricsRegistry::getInstance().getCounter("ctp_query.timed_out")),
+      queryLatency_(MetricsRegistry::getInstance().getHistogram("ctp_query.latency_ns")) {
+}
+
+CTPQueryScheduler::~CTPQueryScheduler() {
+    stop();
+}
+
+void CTPQueryScheduler::setConfig(const CTPQueryConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+}
+
+void CTPQueryScheduler::setSender(RequestIdAllocator allocator, Sender sender) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allocator_ = allocator;
+    sender_ = sender;
+}
+
+void CTPQueryScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    nextSendTime_ = Clock::now();
+    thread_ = std::thread(&CTPQueryScheduler::schedulerLoop, this);
+}
+
+void CTPQueryScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    condition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // 排队和在途的查询不会再有回报
+    std::deque<QueryPtr> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled.swap(queue_);
+        if (inFlight_) {
+            cancelled.push_back(inFlight_);
+            inFlight_.reset();
+        }
+    }
+    for (const QueryPtr& query : cancelled) {
+        complete(query, CTPQueryResult::CANCELLED);
+    }
+}
+
+bool CTPQueryScheduler::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+std::shared_future<CTPQueryResult> CTPQueryScheduler::submit(CTPQueryType type, Callback callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 合并到队列中尚未发出的同类查询
+    for (const QueryPtr& queued : queue_) {
+        if (queued->type == type) {
+            if (callback) {
+                queued->callbacks.push_back(callback);
+            }
+            queriesCoalesced_.add();
+            return queued->future;
+        }
+    }
+
+    QueryPtr query = std::make_shared<Query>();
+    query->type = type;
+    query->requestId = 0;
+    query->sentNs = 0;
+    query->future = query->promise.get_future().share();
+    if (callback) {
+        query->callbacks.push_back(callback);
+    }
+
+    if (!running_) {
+        lock.unlock();
+        complete(query, CTPQueryResult::CANCELLED);
+        return query->future;
+    }
+
+    queue_.push_back(query);
+    lock.unlock();
+    condition_.notify_all();
+    return query->future;
+}
+
+bool CTPQueryScheduler::onPosition(int requestId, const trade::PositionData* position, bool isLast) {
+    QueryPtr finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inFlight_ || inFlight_->requestId != requestId || inFlight_->type != CTPQueryType::Position) {
+            return false;
+        }
+        if (position) {
+            mergePosition(inFlight_->result.positions, *position);
+        }
+        if (isLast) {
+            finished = takeInFlight(requestId);
+        }
+    }
+
+    if (finished) {
+        queryLatency_.record(latencyNow() - finished->sentNs);
+        complete(finished, CTPQueryResult::OK);
+        condition_.notify_all();
+    }
+    return true;
+}
+
+bool CTPQueryScheduler::onAccount(int requestId, const trade::AccountData* account, bool isLast) {
+    QueryPtr finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inFlight_ || inFlight_->requestId != requestId || inFlight_->type != CTPQueryType::Account) {
+            return false;
+        }
+        if (account) {
+            inFlight_->result.account = *account;
+        }
+        if (isLast) {
+            finished = takeInFlight(requestId);
+        }
+    }
+
+    if (finished) {
+        queryLatency_.record(latencyNow() - finished->sentNs);
+        complete(finished, CTPQueryResult::OK);
+        condition_.notify_all();
+    }
+    return true;
+}
+
+bool CTPQueryScheduler::onError(int requestId, int errorId, const std::string& errorMsg) {
+    QueryPtr finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished = takeInFlight(requestId);
+        if (!finished) {
+            return false;
+        }
+    }
+
+    finished->result.errorId = errorId;
+    finished->result.errorMsg = errorMsg;
+    complete(finished, CTPQueryResult::FAILED);
+    condition_.notify_all();
+    return true;
+}
+
+size_t CTPQueryScheduler::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + (inFlight_ ? 1 : 0);
+}
+
+void CTPQueryScheduler::schedulerLoop() {
+    ThreadUtil::setCurrentThreadName("CTPQuery");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        Clock::time_point now = Clock::now();
+
+        // 在途查询超时，释放流控让后续查询继续
+        if (inFlight_ && now >= deadline_) {
+            QueryPtr expired = inFlight_;
+            inFlight_.reset();
+            queriesTimedOut_.add();
+            lock.unlock();
+            complete(expired, CTPQueryResult::TIMEOUT);
+            lock.lock();
+            continue;
+        }
+
+        // 上一个查询完成且到了流控间隔时发出队首查询
+        if (!inFlight_ && !queue_.empty() && now >= nextSendTime_ && sender_) {
+            QueryPtr query = queue_.front();
+            queue_.pop_front();
+            query->requestId = allocator_ ? allocator_() : 0;
+            query->sentNs = latencyNow();
+            inFlight_ = query;
+            deadline_ = now + std::chrono::milliseconds(config_.timeoutMs);
+            nextSendTime_ = now + std::chrono::milliseconds(config_.minIntervalMs);
+
+            // 先登记再发送，回报可能在发送函数返回前到达
+            Sender sender = sender_;
+            lock.unlock();
+            int ret = sender(query->type, query->requestId);
+            lock.lock();
+
+            if (ret == 0) {
+                queriesSent_.add();
+            } else if (inFlight_ == query) {
+                inFlight_.reset();
+                if (ret == CTP_RET_PENDING_LIMIT || ret == CTP_RET_RATE_LIMIT) {
+                    queriesThrottled_.add();
+                    queue_.push_front(query);
+                } else {
+                    query->result.errorId = ret;
+                    query->result.errorMsg = "query request failed";
+                    lock.unlock();
+                    complete(query, CTPQueryResult::FAILED);
+                    lock.lock();
+                }
+            }
+            continue;
+        }
+
+        if (inFlight_) {
+            condition_.wait_until(lock, deadline_);
+        } else if (!queue_.empty()) {
+            condition_.wait_until(lock, nextSendTime_);
+        } else {
+            condition_.wait(lock);
+        }
+    }
+}
+
+CTPQueryScheduler::QueryPtr CTPQueryScheduler::takeInFlight(int requestId) {
+    if (!inFlight_ || inFlight_->requestId != requestId) {
+        return QueryPtr();
+    }
+    QueryPtr query = inFlight_;
+    inFlight_.reset();
+    return query;
+}
+
+void CTPQueryScheduler::complete(const QueryPtr& query, CTPQueryResult::Status status) {
+    query->result.status = status;
+    query->promise.set_value(query->result);
+    for (const Callback& callback : query->callbacks) {
+        callback(query->result);
+    }
+}
+
+void CTPQueryScheduler::mergePosition(std::vector<trade::PositionData>& positions,
+                                      const trade::PositionData& position) {
+    for (trade::PositionData& existing : positions) {
+        if (existing.symbol == position.symbol && existing.direction == position.direction) {
+            existing.totalPosition += position.totalPosition;
+            existing.todayPosition += position.todayPosition;
+            existing.yesterdayPosition += position.yesterdayPosition;
+            existing.openCost += position.openCost;
+            existing.positionCost += position.positionCost;
+            existing.marketValue += position.marketValue;
+            existing.unrealizedPnl += position.unrealizedPnl;
+            return;
+        }
+    }
+    positions.push_back(position);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include "../Utils/metrics/Metrics.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CTP查询类型
+enum class CTPQueryType {
+    Position,   // 投资者持仓
+    Account     // 资金账户
+};
+
+// CTP查询结果
+struct CTPQueryResult {
+    enum Status {
+        OK,          // 收到最后一包回报
+        FAILED,      // 请求发送失败或回报带错误
+        TIMEOUT,     // 超时未收到最后一包回报
+        CANCELLED    // 调度器停止（断线、登出）时仍未完成
+    };
+
+    Status status;
+    int errorId;
+    std::string errorMsg;
+    std::vector<trade::PositionData> positions;   // Position：按合约和方向汇总后的持仓
+    trade::AccountData account;                   // Account
+
+    CTPQueryResult() : status(OK), errorId(0), account() {}
+
+    bool ok() const { return status == OK; }
+};
+
+// CTP查询调度配置
+struct CTPQueryConfig {
+    int64_t minIntervalMs;   // 相邻两次查询的最小间隔，CTP查询流控为每秒1次
+    int64_t timeoutMs;       // 发出后等待最后一包回报的超时
+
+    CTPQueryConfig() : minIntervalMs(1000), timeoutMs(5000) {}
+};
+
+// CTP查询请求与回报的关联
+// 查询请求先进入队列，由调度线程按流控间隔逐个发出，同一时刻只有一个查询在途；
+// 在途查询按请求编号登记，SPI线程的多包回报按编号归并，bIsLast时完成。
+// 每个查询以std::shared_future和可选回调两种方式通知结果；队列中尚未发出的同类查询合并为一次，
+// 已在途时新的请求排队等下一次发送，保证拿到的是请求之后的数据。
+// 发送返回-2/-3（未处理请求或每秒请求数超过许可）时保留在队首，下个间隔重发。
+class CTPQueryScheduler {
+public:
+    typedef std::function<void(const CTPQueryResult&)> Callback;
+    // 分配请求编号，与报单等其他请求共用编号空间
+    typedef std::function<int()> RequestIdAllocator;
+    // 发送查询，返回CTP请求函数的返回值，0为成功
+    typedef std::function<int(CTPQueryType type, int requestId)> Sender;
+
+    explicit CTPQueryScheduler(const CTPQueryConfig& config = CTPQueryConfig());
+    ~CTPQueryScheduler();
+
+    // 禁止拷贝和赋值
+    CTPQueryScheduler(const CTPQueryScheduler&) = delete;
+    CTPQueryScheduler& operator=(const CTPQueryScheduler&) = delete;
+
+    // 设置配置和发送函数（在start之前调用）
+    void setConfig(const CTPQueryConfig& config);
+    void setSender(RequestIdAllocator allocator, Sender sender);
+
+    // 启动调度线程；停止时未完成的查询以CANCELLED结束
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // 提交查询，回调在SPI线程或调度线程上调用；未启动时立即以CANCELLED完成
+    std::shared_future<CTPQueryResult> submit(CTPQueryType type, Callback callback = nullptr);
+
+    // 查询回报（SPI线程调用），record为空表示本包无数据；请求编号不是在途查询时返回false
+    bool onPosition(int requestId, const trade::PositionData* position, bool isLast);
+    bool onAccount(int requestId, const trade::AccountData* account, bool isLast);
+
+    // 错误回报，在途查询以FAILED结束
+    bool onError(int requestId, int errorId, const std::string& errorMsg);
+
+    // 排队和在途的查询数
+    size_t getPendingCount() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Query {
+        CTPQueryType type;
+        int requestId;
+        int64_t sentNs;
+        CTPQueryResult result;
+        std::promise<CTPQueryResult> promise;
+        std::shared_future<CTPQueryResult> future;
+        std::vector<Callback> callbacks;
+    };
+    typedef std::shared_ptr<Query> QueryPtr;
+
+    void schedulerLoop();
+
+    // 取出在途查询（需持有mutex_），编号不匹配返回空
+    QueryPtr takeInFlight(int requestId);
+
+    // 设置结果并通知（不持有mutex_）
+    static void complete(const QueryPtr& query, CTPQueryResult::Status status);
+
+    // 同一合约同一方向的多条持仓记录（如上期所今仓、昨仓分开回报）合并为一条
+    static void mergePosition(std::vector<trade::PositionData>& positions, const trade::PositionData& position);
+
+    CTPQueryConfig config_;
+    RequestIdAllocator allocator_;
+    Sender sender_;
+
+    std::deque<QueryPtr> queue_;
+    QueryPtr inFlight_;
+    Clock::time_point deadline_;
+    Clock::time_point nextSendTime_;
+
+    bool running_;
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+
+    MetricCounter& queriesSent_;
+    MetricCounter& queriesCoalesced_;
+    MetricCounter& queriesThrottled_;
+    MetricCounter& queriesTimedOut_;
+    MetricHistogram& queryLatency_;
+};
@@ -1,23 +1,147 @@
 ﻿#include "CTPTradeFeed.h"
 #include "TradeDataStruct.h"
 #include "../Utils/config/ConfigManager.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
 //#include "../Utils/logger/Logger.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <sstream>
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
 
-// 在实际项目中需要包含CTP API的头文件
-// #include "ThostFtdcTraderApi.h"
-// #include "ThostFtdcUserApiStruct.h"
+namespace {
 
-// CTP交易接口SPI实现类 (在实际项目中应该继承自CThostFtdcTraderSpi)
-class CTPTraderSpi /*: public CTP::CThostFtdcTraderSpi*/ {
+// 连接和会话请求（认证、登录、结算确认、登出）的应答超时
+const int SESSION_TIMEOUT_MS = 10000;
+
+// 回报处理线程每次最多处理的条数
+const size_t RESPONSE_BATCH = 256;
+
+trade::OrderStatus convertOrderStatus(const CThostFtdcOrderField& field) {
+    if (field.OrderSubmitStatus == THOST_FTDC_OSS_InsertRejected) {
+        return trade::OrderStatus::Rejected;
+    }
+    switch (field.OrderStatus) {
+        case THOST_FTDC_OST_AllTraded:
+            return trade::OrderStatus::Filled;
+        case THOST_FTDC_OST_PartTradedQueueing:
+            return trade::OrderStatus::PartialFilled;
+        case THOST_FTDC_OST_PartTradedNotQueueing:
+        case THOST_FTDC_OST_NoTradeNotQueueing:
+        case THOST_FTDC_OST_Canceled:
+            return trade::OrderStatus::Canceled;
+        case THOST_FTDC_OST_NoTradeQueueing:
+        case THOST_FTDC_OST_NotTouched:
+        case THOST_FTDC_OST_Touched:
+            return trade::OrderStatus::Accepted;
+        default:
+            // THOST_FTDC_OST_Unknown：CTP已接收，交易所尚未应答
+            return trade::OrderStatus::Submitting;
+    }
+}
+
+trade::OrderDirection convertDirection(char direction) {
+    return direction == THOST_FTDC_D_Sell ? trade::OrderDirection::Sell : trade::OrderDirection::Buy;
+}
+
+trade::OrderOffset convertOffset(char offsetFlag) {
+    switch (offsetFlag) {
+        case THOST_FTDC_OF_Open:
+            return trade::OrderOffset::Open;
+        case THOST_FTDC_OF_CloseToday:
+            return trade::OrderOffset::CloseToday;
+        case THOST_FTDC_OF_CloseYesterday:
+            return trade::OrderOffset::CloseYesterday;
+        default:
+            return trade::OrderOffset::Close;
+    }
+}
+
+} // namespace
+
+// CTP交易接口回调
+// 会话类应答（连接、认证、登录、结算确认、登出）直接通知等待的调用方；
+// 订单、成交和查询回报只把原始结构体拷入回报队列，由回报处理线程转换，API线程不会阻塞
+class CTPTraderSpi final : public CThostFtdcTraderSpi {
 public:
-    CTPTraderSpi(CTPTradeFeed* tradeFeed) : tradeFeed_(tradeFeed) {}
+    explicit CTPTraderSpi(CTPTradeFeed* tradeFeed) : tradeFeed_(tradeFeed) {}
+    
+    void OnFrontConnected() override {
+        tradeFeed_->NotifyFrontConnected(true);
+    }
+    
+    void OnFrontDisconnected(int /*nReason*/) override {
+        tradeFeed_->NotifyFrontConnected(false);
+    }
+    
+    void OnRspAuthenticate(CThostFtdcRspAuthenticateField* /*pRspAuthenticateField*/, CThostFtdcRspInfoField* pRspInfo,
+                           int nRequestID, bool /*bIsLast*/) override {
+        tradeFeed_->NotifySessionReply(nRequestID, pRspInfo);
+    }
+    
+    void OnRspUserLogin(CThostFtdcRspUserLoginField* pRspUserLogin, CThostFtdcRspInfoField* pRspInfo,
+                        int nRequestID, bool /*bIsLast*/) override {
+        tradeFeed_->NotifySessionReply(nRequestID, pRspInfo, pRspUserLogin);
+    }
+    
+    void OnRspUserLogout(CThostFtdcUserLogoutField* /*pUserLogout*/, CThostFtdcRspInfoField* pRspInfo,
+                         int nRequestID, bool /*bIsLast*/) override {
+        tradeFeed_->NotifySessionReply(nRequestID, pRspInfo);
+    }
     
-    // 这里需要实现CThostFtdcTraderSpi的所有回调函数
+    void OnRspSettlementInfoConfirm(CThostFtdcSettlementInfoConfirmField* /*pSettlementInfoConfirm*/,
+                                    CThostFtdcRspInfoField* pRspInfo, int nRequestID, bool /*bIsLast*/) override {
+        tradeFeed_->NotifySessionReply(nRequestID, pRspInfo);
+    }
+    
+    // 订单和成交回报
+    void OnRtnOrder(CThostFtdcOrderField* pOrder) override {
+        if (pOrder) {
+            tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::RTN_ORDER, pOrder, sizeof(*pOrder), nullptr, 0, true);
+        }
+    }
+    
+    void OnRtnTrade(CThostFtdcTradeField* pTrade) override {
+        if (pTrade) {
+            tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::RTN_TRADE, pTrade, sizeof(*pTrade), nullptr, 0, true);
+        }
+    }
+    
+    // 报单被CTP（OnRspOrderInsert）或交易所（OnErrRtnOrderInsert）拒绝，两者可能都会到达，重复的拒单由订单状态机过滤
+    void OnRspOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo,
+                          int nRequestID, bool bIsLast) override {
+        if (pInputOrder) {
+            tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::ORDER_INSERT_ERROR, pInputOrder, sizeof(*pInputOrder),
+                                     pRspInfo, nRequestID, bIsLast);
+        }
+    }
+    
+    void OnErrRtnOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo) override {
+        if (pInputOrder) {
+            tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::ORDER_INSERT_ERROR, pInputOrder, sizeof(*pInputOrder),
+                                     pRspInfo, 0, true);
+        }
+    }
+    
+    // 查询回报，无数据时pInvestorPosition/pTradingAccount为空
+    void OnRspQryInvestorPosition(CThostFtdcInvestorPositionField* pInvestorPosition, CThostFtdcRspInfoField* pRspInfo,
+                                  int nRequestID, bool bIsLast) override {
+        tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::QRY_POSITION, pInvestorPosition,
+                                 sizeof(*pInvestorPosition), pRspInfo, nRequestID, bIsLast);
+    }
+    
+    void OnRspQryTradingAccount(CThostFtdcTradingAccountField* pTradingAccount, CThostFtdcRspInfoField* pRspInfo,
+                                int nRequestID, bool bIsLast) override {
+        tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::QRY_ACCOUNT, pTradingAccount,
+                                 sizeof(*pTradingAccount), pRspInfo, nRequestID, bIsLast);
+    }
+    
+    void OnRspError(CThostFtdcRspInfoField* pRspInfo, int nRequestID, bool bIsLast) override {
+        tradeFeed_->PushResponse(CTPTradeFeed::RawResponse::RSP_ERROR, nullptr, 0, pRspInfo, nRequestID, bIsLast);
+    }
     
 private:
     CTPTradeFeed* tradeFeed_;
@@ -26,11 +150,25 @@ private:
 CTPTradeFeed::CTPTradeFeed()
     : traderApi_(nullptr), 
       traderSpi_(nullptr),
+      apiStarted_(false),
       connected_(false),
       loggedIn_(false),
       frontId_(0),
       sessionId_(0),
-      orderRef_(0) {
+      orderRef_(0),
+      requestId_(0),
+      responseRing_(new ResponseRing()),
+      responseOverflowing_(false),
+      responseRunning_(false),
+      externalPolling_(false),
+      frontConnected_(false),
+      sessionRequestId_(0),
+      sessionReplied_(false),
+      sessionErrorId_(0),
+      loginReply_(),
+      responsesReceived_(MetricsRegistry::getInstance().getCounter("ctp_trade.responses")),
+      responsesOverflowed_(MetricsRegistry::getInstance().getCounter("ctp_trade.responses_overflowed")),
+      responseQueueDepth_(MetricsRegistry::getInstance().getHistogram("ctp_trade.response_queue_depth")) {
 }
 
 CTPTradeFeed::~CTPTradeFeed() {
@@ -42,7 +180,7 @@ bool CTPTradeFeed::Init(const std::string& config) {
     
     try {
         // 使用ConfigManager加载配置
-        auto& configManager = ConfigManager::getInstance();
+        auto& configManager = QuantTrading::ConfigManager::getInstance();
         
         // 假设config参数是配置文件路径
         if (!configManager.loadConfig(config)) {
@@ -56,6 +194,19 @@ bool CTPTradeFeed::Init(const std::string& config) {
         appId_ = configManager.getValue<std::string>("trade.ctp.app_id", "");
         authCode_ = configManager.getValue<std::string>("trade.ctp.auth_code", "");
         
+        // 预建报单模板的合约及其交易所，如{"IF2306": "CFFEX"}
+        instrumentExchanges_ = configManager.getValue<std::map<std::string, std::string>>(
+            "trade.ctp.instruments", std::map<std::string, std::string>());
+        
+        // 查询流控间隔和超时
+        CTPQueryConfig queryConfig;
+        queryConfig.minIntervalMs = configManager.getValue<int>("trade.ctp.query_interval_ms", 1000);
+        queryConfig.timeoutMs = configManager.getValue<int>("trade.ctp.query_timeout_ms", 5000);
+        queryScheduler_.setConfig(queryConfig);
+        queryScheduler_.setSender(
+            [this]() { return ++requestId_; },
+            [this](CTPQueryType type, int requestId) { return SendQuery(type, requestId); });
+        
         if (frontAddress_.empty() || brokerId_.empty()) {
             //Logger::error("CTPTradeFeed", "Missing required configuration: front_addr or broker_id");
             return false;
@@ -64,10 +215,15 @@ bool CTPTradeFeed::Init(const std::string& config) {
         //Logger::info("CTPTradeFeed", "Successfully initialized with front address: {}", frontAddress_);
         
         // 创建交易API实例
-        // 在实际项目中应该使用：
-        // traderApi_ = CTP::CThostFtdcTraderApi::CreateFtdcTraderApi();
-        // traderSpi_ = new CTPTraderSpi(this);
-        // traderApi_->RegisterSpi(traderSpi_);
+        if (!traderApi_) {
+            std::string flowPath = configManager.getValue<std::string>("trade.ctp.flow_path", "./tdflow/");
+            traderApi_ = CThostFtdcTraderApi::CreateFtdcTraderApi(flowPath.c_str());
+            if (!traderApi_) {
+                return false;
+            }
+            traderSpi_ = new CTPTraderSpi(this);
+            traderApi_->RegisterSpi(traderSpi_);
+        }
         
         return true;
     }
@@ -78,50 +234,60 @@ bool CTPTradeFeed::Init(const std::string& config) {
 }
 
 void CTPTradeFeed::Release() {
+    Disconnect();
+    
     std::lock_guard<std::mutex> lock(apiMutex_);
     
-    if (connected_) {
-        Disconnect();
+    // API的Release等待其线程退出，之后不会再有回调
+    if (traderApi_) {
+        traderApi_->RegisterSpi(nullptr);
+        traderApi_->Release();
+        traderApi_ = nullptr;
     }
     
-    // 在实际项目中应该使用：
-    // if (traderApi_) {
-    //     traderApi_->Release();
-    //     traderApi_ = nullptr;
-    // }
-    // 
-    // if (traderSpi_) {
-    //     delete traderSpi_;
-    //     traderSpi_ = nullptr;
-    // }
+    delete traderSpi_;
+    traderSpi_ = nullptr;
+    apiStarted_ = false;
 }
 
 bool CTPTradeFeed::Connect() {
-    std::lock_guard<std::mutex> lock(apiMutex_);
-    
-    if (!traderApi_) {
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(apiMutex_);
+        
+        if (!traderApi_) {
+            return false;
+        }
+        
+        if (connected_) {
+            return true;
+        }
+        
+        if (!apiStarted_) {
+            traderApi_->RegisterFront(const_cast<char*>(frontAddress_.c_str()));
+            traderApi_->SubscribePrivateTopic(THOST_TERT_QUICK);
+            traderApi_->SubscribePublicTopic(THOST_TERT_QUICK);
+            traderApi_->Init();
+            apiStarted_ = true;
+        }
     }
     
-    if (connected_) {
-        return true;
+    // 等待前置连接成功
+    {
+        std::unique_lock<std::mutex> lock(sessionMutex_);
+        if (!sessionCondition_.wait_for(lock, std::chrono::milliseconds(SESSION_TIMEOUT_MS),
+                                        [this]() { return frontConnected_; })) {
+            return false;
+        }
     }
     
-    // 在实际项目中应该使用：
-    // traderApi_->RegisterFront(const_cast<char*>(frontAddress_.c_str()));
-    // traderApi_->SubscribePrivateTopic(THOST_TERT_QUICK);
-    // traderApi_->SubscribePublicTopic(THOST_TERT_QUICK);
-    // traderApi_->Init();
-    
-    // 模拟连接成功
     connected_ = true;
-    
+    if (!externalPolling_) {
+        StartResponseThread();
+    }
     return true;
 }
 
 void CTPTradeFeed::Disconnect() {
-    std::lock_guard<std::mutex> lock(apiMutex_);
-    
     if (!connected_) {
         return;
     }
@@ -130,8 +296,8 @@ void CTPTradeFeed::Disconnect() {
         Logout();
     }
     
-    // 在实际项目中可能需要调用相关API方法
-    
+    // CTP没有单独的断开接口，连接随Release关闭；此处停止处理回报
+    StopResponseThread();
     connected_ = false;
 }
 
@@ -153,35 +319,94 @@ bool CTPTradeFeed::Login(const std::string& userId, const std::string& password)
     userId_ = userId;
     password_ = password;
     
-    // 在实际项目中应该使用：
-    // CTP::CThostFtdcReqUserLoginField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // strncpy(req.Password, password_.c_str(), sizeof(req.Password) - 1);
-    // int requestID = 1;
-    // traderApi_->ReqUserLogin(&req, requestID);
+    // 穿透式监管认证
+    if (!appId_.empty()) {
+        CThostFtdcReqAuthenticateField auth;
+        std::memset(&auth, 0, sizeof(auth));
+        std::strncpy(auth.BrokerID, brokerId_.c_str(), sizeof(auth.BrokerID) - 1);
+        std::strncpy(auth.UserID, userId_.c_str(), sizeof(auth.UserID) - 1);
+        std::strncpy(auth.AppID, appId_.c_str(), sizeof(auth.AppID) - 1);
+        std::strncpy(auth.AuthCode, authCode_.c_str(), sizeof(auth.AuthCode) - 1);
+        
+        int requestId = ++requestId_;
+        BeginSessionRequest(requestId);
+        if (traderApi_->ReqAuthenticate(&auth, requestId) != 0 || !WaitSessionReply()) {
+            return false;
+        }
+    }
+    
+    CThostFtdcReqUserLoginField req;
+    std::memset(&req, 0, sizeof(req));
+    std::strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
+    std::strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
+    std::strncpy(req.Password, password_.c_str(), sizeof(req.Password) - 1);
+    
+    int requestId = ++requestId_;
+    BeginSessionRequest(requestId);
+    if (traderApi_->ReqUserLogin(&req, requestId) != 0 || !WaitSessionReply()) {
+        return false;
+    }
+    
+    // 会话参数取自登录应答
+    {
+        std::lock_guard<std::mutex> sessionLock(sessionMutex_);
+        frontId_ = loginReply_.FrontID;
+        sessionId_ = loginReply_.SessionID;
+        orderRef_ = std::atoi(loginReply_.MaxOrderRef);
+    }
+    
+    // 确认结算单，未确认时不能报单
+    CThostFtdcSettlementInfoConfirmField confirm;
+    std::memset(&confirm, 0, sizeof(confirm));
+    std::strncpy(confirm.BrokerID, brokerId_.c_str(), sizeof(confirm.BrokerID) - 1);
+    std::strncpy(confirm.InvestorID, userId_.c_str(), sizeof(confirm.InvestorID) - 1);
+    
+    requestId = ++requestId_;
+    BeginSessionRequest(requestId);
+    if (traderApi_->ReqSettlementInfoConfirm(&confirm, requestId) != 0 || !WaitSessionReply()) {
+        return false;
+    }
+    
+    // 本会话的报单引用从当前值之后开始，订单存储按此建立下标；上一会话已终结的订单一并回收
+    orderStore_.purgeTerminal();
+    orderStore_.setOrderRefBase(orderRef_ + 1);
+    
+    // 建立报单模板，报单时只需填写价格、数量、开平和报单引用
+    orderTemplates_.setSession(brokerId_, userId_, userId_, frontId_, sessionId_);
+    for (const auto& instrument : instrumentExchanges_) {
+        orderTemplates_.addInstrument(instrument.first, instrument.second);
+    }
     
-    // 模拟登录成功
     loggedIn_ = true;
     
+    // 登录后才能查询
+    queryScheduler_.start();
+    
     return true;
 }
 
 bool CTPTradeFeed::Logout() {
+    // 查询调度线程发送时需要apiMutex_，先在锁外停止
+    queryScheduler_.stop();
+    
     std::lock_guard<std::mutex> lock(apiMutex_);
     
     if (!connected_ || !loggedIn_ || !traderApi_) {
         return false;
     }
     
-    // 在实际项目中应该使用：
-    // CTP::CThostFtdcUserLogoutField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // int requestID = 2;
-    // traderApi_->ReqUserLogout(&req, requestID);
+    CThostFtdcUserLogoutField req;
+    std::memset(&req, 0, sizeof(req));
+    std::strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
+    std::strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
+    
+    // 登出应答失败或超时也视为已登出
+    int requestId = ++requestId_;
+    BeginSessionRequest(requestId);
+    if (traderApi_->ReqUserLogout(&req, requestId) == 0) {
+        WaitSessionReply();
+    }
     
-    // 模拟登出成功
     loggedIn_ = false;
     
     return true;
@@ -193,195 +418,543 @@ bool CTPTradeFeed::IsLoggedIn() const {
 
 std::string CTPTradeFeed::PlaceOrder(const trade::OrderData& orderData) {
     std::lock_guard<std::mutex> lock(apiMutex_);
+    return PlaceOrderLocked(orderData);
+}
+
+void CTPTradeFeed::PlaceOrders(const std::vector<const trade::OrderData*>& orders, std::vector<std::string>& orderIds) {
+    orderIds.clear();
+    orderIds.reserve(orders.size());
     
+    std::lock_guard<std::mutex> lock(apiMutex_);
+    for (const trade::OrderData* order : orders) {
+        orderIds.push_back(PlaceOrderLocked(*order));
+    }
+}
+
+std::string CTPTradeFeed::PlaceOrderLocked(const trade::OrderData& orderData) {
     if (!connected_ || !loggedIn_ || !traderApi_) {
         return "";
     }
     
-    // 生成本地报单编号
-    orderRef_++;
-    std::string orderRef = std::to_string(orderRef_);
-    
-    // 在实际项目中应该使用：
-    // CTP::CThostFtdcInputOrderField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // strncpy(req.InstrumentID, orderData.symbol.c_str(), sizeof(req.InstrumentID) - 1);
-    // strncpy(req.OrderRef, orderRef.c_str(), sizeof(req.OrderRef) - 1);
-    
-    // 设置价格、数量等属性
-    // req.LimitPrice = orderData.price;
-    // req.VolumeTotalOriginal = orderData.volume;
-    
-    // 设置买卖方向
-    // if (orderData.direction == trade::OrderDirection::Buy) {
-    //     req.Direction = THOST_FTDC_D_Buy;
-    // } else {
-    //     req.Direction = THOST_FTDC_D_Sell;
-    // }
-    
-    // 设置开平标志
-    // switch (orderData.offset) {
-    // case trade::OrderOffset::Open:
-    //     req.CombOffsetFlag[0] = THOST_FTDC_OF_Open;
-    //     break;
-    // case trade::OrderOffset::Close:
-    //     req.CombOffsetFlag[0] = THOST_FTDC_OF_Close;
-    //     break;
-    // case trade::OrderOffset::CloseToday:
-    //     req.CombOffsetFlag[0] = THOST_FTDC_OF_CloseToday;
-    //     break;
-    // case trade::OrderOffset::CloseYesterday:
-    //     req.CombOffsetFlag[0] = THOST_FTDC_OF_CloseYesterday;
-    //     break;
-    // }
-    
-    // 设置价格类型
-    // if (orderData.priceType == trade::OrderPriceType::Limit) {
-    //     req.OrderPriceType = THOST_FTDC_OPT_LimitPrice;
-    // } else {
-    //     req.OrderPriceType = THOST_FTDC_OPT_AnyPrice;
-    // }
-    
-    // 其他必要参数
-    // req.CombHedgeFlag[0] = THOST_FTDC_HF_Speculation; // 投机
-    // req.ContingentCondition = THOST_FTDC_CC_Immediately; // 立即触发
-    // req.ForceCloseReason = THOST_FTDC_FCC_NotForceClose; // 非强平
-    // req.IsAutoSuspend = 0; // 非自动挂起
-    // req.TimeCondition = THOST_FTDC_TC_GFD; // 当日有效
-    // req.VolumeCondition = THOST_FTDC_VC_AV; // 任意数量
-    // req.MinVolume = 1; // 最小成交数量
+    // 取合约的报单模板，未预建的合约在此建立
+    int instrument = orderTemplates_.findInstrument(orderData.symbol);
+    if (instrument < 0) {
+        instrument = orderTemplates_.addInstrument(orderData.symbol, orderData.exchangeId);
+    }
     
-    // 请求报单
-    // int requestID = 3;
-    // traderApi_->ReqOrderInsert(&req, requestID);
+    // 生成本地报单编号，只改写模板上的可变字段
+    orderRef_++;
+    CThostFtdcInputOrderField* req = orderTemplates_.prepare(instrument, orderData, orderRef_, ++requestId_);
+    if (!req) {
+        return "";
+    }
     
     // 生成唯一订单ID
-    std::string orderId = std::to_string(frontId_) + ":" + std::to_string(sessionId_) + ":" + orderRef;
+    std::string orderId = orderTemplates_.makeOrderId(orderRef_);
     
     // 本地保存订单数据
     trade::OrderData localOrderData = orderData;
     localOrderData.orderId = orderId;
-    localOrderData.orderRef = orderRef;
+    localOrderData.orderRef = req->OrderRef;
     localOrderData.frontId = std::to_string(frontId_);
     localOrderData.sessionId = std::to_string(sessionId_);
     localOrderData.status = trade::OrderStatus::Submitting;
     localOrderData.tradedVolume = 0;
     
-    // 记录本地订单
-    orders_[orderId] = localOrderData;
+    // 先记录本地订单再发送，回报处理线程收到回报时订单已可查到
+    OrderStore::Handle handle = orderStore_.create(localOrderData, orderRef_);
+    if (handle == OrderStore::INVALID_HANDLE) {
+        return "";
+    }
+    
+    // 请求报单
+    if (traderApi_->ReqOrderInsert(req, req->RequestID) != 0) {
+        orderStore_.transition(handle, trade::OrderStatus::Rejected, -1, "ReqOrderInsert failed");
+        return "";
+    }
     
     return orderId;
 }
 
 bool CTPTradeFeed::CancelOrder(const std::string& orderId) {
+    // 查找订单不需要接口锁；已终结或已发出撤单的订单不再重复撤单
+    OrderStore::Handle handle = orderStore_.findByOrderId(orderId);
+    trade::OrderData orderData;
+    if (!orderStore_.get(handle, orderData) || !orderStore_.markCancelRequested(handle)) {
+        return false;
+    }
+    
     std::lock_guard<std::mutex> lock(apiMutex_);
+    return CancelOrderLocked(orderData);
+}
+
+void CTPTradeFeed::CancelOrders(const std::vector<std::string>& orderIds, std::vector<bool>& results) {
+    // 查找和去重在锁外完成
+    std::vector<trade::OrderData> orders(orderIds.size());
+    results.assign(orderIds.size(), false);
+    for (size_t i = 0; i < orderIds.size(); ++i) {
+        OrderStore::Handle handle = orderStore_.findByOrderId(orderIds[i]);
+        results[i] = orderStore_.get(handle, orders[i]) && orderStore_.markCancelRequested(handle);
+    }
     
+    std::lock_guard<std::mutex> lock(apiMutex_);
+    for (size_t i = 0; i < orderIds.size(); ++i) {
+        if (results[i]) {
+            results[i] = CancelOrderLocked(orders[i]);
+        }
+    }
+}
+
+bool CTPTradeFeed::CancelOrderLocked(const trade::OrderData& orderData) {
     if (!connected_ || !loggedIn_ || !traderApi_) {
         return false;
     }
     
-    auto it = orders_.find(orderId);
-    if (it == orders_.end()) {
-        return false;
+    CThostFtdcInputOrderActionField req;
+    std::memset(&req, 0, sizeof(req));
+    std::strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
+    std::strncpy(req.InvestorID, userId_.c_str(), sizeof(req.InvestorID) - 1);
+    std::strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
+    std::strncpy(req.InstrumentID, orderData.symbol.c_str(), sizeof(req.InstrumentID) - 1);
+    std::strncpy(req.ExchangeID, orderData.exchangeId.c_str(), sizeof(req.ExchangeID) - 1);
+    std::strncpy(req.OrderRef, orderData.orderRef.c_str(), sizeof(req.OrderRef) - 1);
+    req.FrontID = std::atoi(orderData.frontId.c_str());
+    req.SessionID = std::atoi(orderData.sessionId.c_str());
+    req.ActionFlag = THOST_FTDC_AF_Delete; // 撤单
+    
+    return traderApi_->ReqOrderAction(&req, ++requestId_) == 0;
+}
+
+std::vector<trade::OrderData> CTPTradeFeed::QueryPendingOrders() {
+    // 只遍历挂单链表
+    return orderStore_.getWorkingOrders();
+}
+
+std::vector<trade::OrderData> CTPTradeFeed::QueryPendingOrdersByStrategy(const std::string& strategyId) {
+    return orderStore_.getWorkingOrdersByStrategy(strategyId);
+}
+
+std::vector<trade::OrderData> CTPTradeFeed::QueryPendingOrdersByInstrument(const std::string& symbol) {
+    return orderStore_.getWorkingOrdersByInstrument(symbol);
+}
+
+void CTPTradeFeed::PurgeTerminalOrders() {
+    orderStore_.purgeTerminal();
+}
+
+trade::OrderData CTPTradeFeed::QueryOrder(const std::string& orderId) {
+    trade::OrderData order;
+    if (orderStore_.get(orderStore_.findByOrderId(orderId), order)) {
+        return order;
     }
     
-    const trade::OrderData& orderData = it->second;
-    
-    // 在实际项目中应该使用：
-    // CTP::CThostFtdcInputOrderActionField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // strncpy(req.InstrumentID, orderData.symbol.c_str(), sizeof(req.InstrumentID) - 1);
-    // strncpy(req.OrderRef, orderData.orderRef.c_str(), sizeof(req.OrderRef) - 1);
-    // req.FrontID = std::stoi(orderData.frontId);
-    // req.SessionID = std::stoi(orderData.sessionId);
-    // req.ActionFlag = THOST_FTDC_AF_Delete; // 撤单
-    
-    // int requestID = 4;
-    // traderApi_->ReqOrderAction(&req, requestID);
+    // 如果本地找不到，可以向服务器查询
+    // 在实际项目中，可能需要实现向CTP服务器查询订单的功能
     
-    return true;
+    return trade::OrderData(); // 返回空订单数据
 }
 
-std::vector<trade::OrderData> CTPTradeFeed::QueryPendingOrders() {
+std::vector<trade::PositionData> CTPTradeFeed::QueryPositions() {
+    // 同步等待查询调度完成（流控排队加超时），不持有apiMutex_
+    CTPQueryResult result = queryScheduler_.submit(CTPQueryType::Position).get();
+    return result.ok() ? result.positions : std::vector<trade::PositionData>();
+}
+
+trade::AccountData CTPTradeFeed::QueryAccount() {
+    CTPQueryResult result = queryScheduler_.submit(CTPQueryType::Account).get();
+    return result.ok() ? result.account : trade::AccountData();
+}
+
+void CTPTradeFeed::QueryPositionsAsync(PositionQueryCallback callback) {
+    queryScheduler_.submit(CTPQueryType::Position, [callback](const CTPQueryResult& result) {
+        callback(result.ok(), result.positions);
+    });
+}
+
+void CTPTradeFeed::QueryAccountAsync(AccountQueryCallback callback) {
+    queryScheduler_.submit(CTPQueryType::Account, [callback](const CTPQueryResult& result) {
+        callback(result.ok(), result.account);
+    });
+}
+
+int CTPTradeFeed::SendQuery(CTPQueryType type, int requestId) {
     std::lock_guard<std::mutex> lock(apiMutex_);
     
-    std::vector<trade::OrderData> result;
+    if (!connected_ || !loggedIn_ || !traderApi_) {
+        return -1;
+    }
     
-    for (const auto& pair : orders_) {
-        const trade::OrderData& order = pair.second;
-        if (order.status != trade::OrderStatus::Filled &&
-            order.status != trade::OrderStatus::Canceled &&
-            order.status != trade::OrderStatus::Rejected) {
-            result.push_back(order);
-        }
+    if (type == CTPQueryType::Position) {
+        CThostFtdcQryInvestorPositionField req;
+        std::memset(&req, 0, sizeof(req));
+        std::strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
+        std::strncpy(req.InvestorID, userId_.c_str(), sizeof(req.InvestorID) - 1);
+        return traderApi_->ReqQryInvestorPosition(&req, requestId);
     }
     
-    return result;
+    CThostFtdcQryTradingAccountField req;
+    std::memset(&req, 0, sizeof(req));
+    std::strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
+    std::strncpy(req.InvestorID, userId_.c_str(), sizeof(req.InvestorID) - 1);
+    return traderApi_->ReqQryTradingAccount(&req, requestId);
 }
 
-trade::OrderData CTPTradeFeed::QueryOrder(const std::string& orderId) {
-    std::lock_guard<std::mutex> lock(apiMutex_);
+void CTPTradeFeed::PushResponse(RawResponse::Kind kind, const void* data, size_t size,
+                                const CThostFtdcRspInfoField* rspInfo, int requestId, bool isLast) {
+    // 直接拷入队列槽位
+    if (!responseOverflowing_.load(std::memory_order_acquire)) {
+        RawResponse* slot = responseRing_->beginPush();
+        if (slot) {
+            FillResponse(*slot, kind, data, size, rspInfo, requestId, isLast);
+            responseRing_->commitPush();
+            return;
+        }
+    }
     
-    auto it = orders_.find(orderId);
-    if (it != orders_.end()) {
-        return it->second;
+    // 队列满（或溢出队列尚未取空，保持回报顺序）时写入溢出队列，只短暂加锁
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    responseOverflow_.emplace_back();
+    FillResponse(responseOverflow_.back(), kind, data, size, rspInfo, requestId, isLast);
+    responseOverflowing_.store(true, std::memory_order_release);
+    responsesOverflowed_.add();
+}
+
+void CTPTradeFeed::FillResponse(RawResponse& response, RawResponse::Kind kind, const void* data, size_t size,
+                                const CThostFtdcRspInfoField* rspInfo, int requestId, bool isLast) {
+    response.kind = kind;
+    response.requestId = requestId;
+    response.isLast = isLast;
+    response.hasData = data != nullptr;
+    if (data) {
+        std::memcpy(&response.order, data, size);
+    }
+    response.hasRspInfo = rspInfo != nullptr;
+    if (rspInfo) {
+        response.rspInfo = *rspInfo;
+    }
+}
+
+size_t CTPTradeFeed::PollResponses(size_t maxCount) {
+    size_t count = 0;
+    while (count < maxCount) {
+        RawResponse* response = responseRing_->front();
+        if (!response) {
+            break;
+        }
+        DispatchResponse(*response);
+        responseRing_->popFront();
+        ++count;
     }
     
-    // 如果本地找不到，可以向服务器查询
-    // 在实际项目中，可能需要实现向CTP服务器查询订单的功能
+    // 队列已取空时再取溢出队列，溢出队列中的回报都晚于队列中的回报
+    if (count < maxCount && responseOverflowing_.load(std::memory_order_acquire)) {
+        std::deque<RawResponse> overflow;
+        {
+            std::lock_guard<std::mutex> lock(overflowMutex_);
+            overflow.swap(responseOverflow_);
+            responseOverflowing_.store(false, std::memory_order_release);
+        }
+        for (const RawResponse& response : overflow) {
+            DispatchResponse(response);
+        }
+        count += overflow.size();
+    }
     
-    return trade::OrderData(); // 返回空订单数据
+    if (count > 0) {
+        responsesReceived_.add(count);
+        responseQueueDepth_.record(static_cast<int64_t>(count));
+    }
+    return count;
 }
 
-std::vector<trade::PositionData> CTPTradeFeed::QueryPositions() {
-    std::lock_guard<std::mutex> lock(apiMutex_);
+void CTPTradeFeed::SetExternalPolling(bool enabled) {
+    externalPolling_ = enabled;
+    if (enabled) {
+        StopResponseThread();
+    } else if (connected_) {
+        StartResponseThread();
+    }
+}
+
+void CTPTradeFeed::StartResponseThread() {
+    std::lock_guard<std::mutex> lock(responseThreadMutex_);
+    if (responseRunning_.exchange(true)) {
+        return;
+    }
+    responseThread_ = std::thread(&CTPTradeFeed::ResponseLoop, this);
+}
+
+void CTPTradeFeed::StopResponseThread() {
+    std::lock_guard<std::mutex> lock(responseThreadMutex_);
+    if (!responseRunning_.exchange(false)) {
+        return;
+    }
+    if (responseThread_.joinable()) {
+        responseThread_.join();
+    }
+}
+
+void CTPTradeFeed::ResponseLoop() {
+    ThreadUtil::setCurrentThreadName("CTPTraderRsp");
+    
+    // 空闲时先自旋让出，长时间无回报再短暂休眠
+    const int SPIN_LIMIT = 1000;
+    int idleSpins = 0;
+    
+    while (responseRunning_.load(std::memory_order_acquire)) {
+        if (PollResponses(RESPONSE_BATCH) > 0) {
+            idleSpins = 0;
+        } else if (++idleSpins < SPIN_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void CTPTradeFeed::DispatchResponse(const RawResponse& response) {
+    switch (response.kind) {
+        case RawResponse::RTN_ORDER:
+            HandleRtnOrder(response.order);
+            break;
+        case RawResponse::RTN_TRADE:
+            HandleRtnTrade(response.trade);
+            break;
+        case RawResponse::ORDER_INSERT_ERROR:
+            if (response.hasData && response.hasRspInfo) {
+                HandleOrderInsertError(response.inputOrder, response.rspInfo);
+            }
+            break;
+        case RawResponse::QRY_POSITION:
+            HandleQryPosition(response);
+            break;
+        case RawResponse::QRY_ACCOUNT:
+            HandleQryAccount(response);
+            break;
+        case RawResponse::RSP_ERROR:
+            // 请求编号属于在途查询时查询失败，其他请求的错误不在此处理
+            if (response.hasRspInfo) {
+                queryScheduler_.onError(response.requestId, response.rspInfo.ErrorID, response.rspInfo.ErrorMsg);
+            }
+            break;
+    }
+}
+
+OrderStore::Handle CTPTradeFeed::FindOrder(int frontId, int sessionId, const char* orderRef,
+                                           const char* exchangeId, const char* orderSysId) const {
+    if (frontId == frontId_ && sessionId == sessionId_) {
+        OrderStore::Handle handle = orderStore_.findByOrderRef(std::atoi(orderRef));
+        if (handle != OrderStore::INVALID_HANDLE) {
+            return handle;
+        }
+    }
+    if (orderSysId[0] != '\0') {
+        return orderStore_.findBySysId(exchangeId, orderSysId);
+    }
+    return OrderStore::INVALID_HANDLE;
+}
+
+void CTPTradeFeed::HandleRtnOrder(const CThostFtdcOrderField& field) {
+    trade::OrderStatus status = convertOrderStatus(field);
+    const char* updateTime = field.UpdateTime[0] != '\0' ? field.UpdateTime : field.InsertTime;
+    
+    OrderStore::Handle handle = FindOrder(field.FrontID, field.SessionID, field.OrderRef,
+                                          field.ExchangeID, field.OrderSysID);
+    if (handle != OrderStore::INVALID_HANDLE) {
+        // 首次收到交易所报单编号时登记，成交回报按此查找订单
+        if (field.OrderSysID[0] != '\0' && orderStore_.getStatus(handle) == trade::OrderStatus::Submitting) {
+            orderStore_.bindSysId(handle, field.ExchangeID, field.OrderSysID);
+        }
+        
+        // 重复或乱序的旧回报不再通知
+        if (!orderStore_.transition(handle, status, field.VolumeTraded, field.StatusMsg, updateTime)) {
+            return;
+        }
+        
+        trade::OrderData order;
+        if (orderCallback_ && orderStore_.get(handle, order)) {
+            orderCallback_(order);
+        }
+        return;
+    }
     
-    std::vector<trade::PositionData> positions;
+    // 其他会话（如手工下单）的订单，只转换并通知
+    if (!orderCallback_) {
+        return;
+    }
+    trade::OrderData order = trade::OrderData();
+    order.orderId = std::to_string(field.FrontID) + ":" + std::to_string(field.SessionID) + ":" + field.OrderRef;
+    order.symbol = field.InstrumentID;
+    order.direction = convertDirection(field.Direction);
+    order.offset = convertOffset(field.CombOffsetFlag[0]);
+    order.priceType = field.OrderPriceType == THOST_FTDC_OPT_AnyPrice ? trade::OrderPriceType::Market
+                                                                      : trade::OrderPriceType::Limit;
+    order.price = field.LimitPrice;
+    order.volume = field.VolumeTotalOriginal;
+    order.tradedVolume = field.VolumeTraded;
+    order.status = status;
+    order.statusMsg = field.StatusMsg;
+    order.insertTime = field.InsertTime;
+    order.updateTime = updateTime;
+    order.tradingDay = field.TradingDay;
+    order.accountId = field.InvestorID;
+    order.exchangeId = field.ExchangeID;
+    order.orderSysId = field.OrderSysID;
+    order.frontId = std::to_string(field.FrontID);
+    order.sessionId = std::to_string(field.SessionID);
+    order.orderRef = field.OrderRef;
+    orderCallback_(order);
+}
+
+void CTPTradeFeed::HandleRtnTrade(const CThostFtdcTradeField& field) {
+    if (!tradeCallback_) {
+        return;
+    }
     
-    if (!connected_ || !loggedIn_ || !traderApi_) {
-        return positions;
+    trade::TradeData data = trade::TradeData();
+    data.tradeId = field.TradeID;
+    data.symbol = field.InstrumentID;
+    data.direction = convertDirection(field.Direction);
+    data.offset = convertOffset(field.OffsetFlag);
+    data.price = field.Price;
+    data.volume = field.Volume;
+    data.tradeTime = field.TradeTime;
+    data.tradingDay = field.TradingDay;
+    data.accountId = field.InvestorID;
+    data.exchangeId = field.ExchangeID;
+    
+    // 成交回报不带会话信息，按交易所报单编号找到订单（报单回报先于成交回报到达）
+    trade::OrderData order;
+    if (orderStore_.get(orderStore_.findBySysId(field.ExchangeID, field.OrderSysID), order)) {
+        data.orderId = order.orderId;
     }
     
-    // 在实际项目中，应该向CTP服务器查询持仓数据
-    // 例如：
-    // CTP::CThostFtdcQryInvestorPositionField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // int requestID = 5;
-    // traderApi_->ReqQryInvestorPosition(&req, requestID);
+    tradeCallback_(data);
+}
+
+void CTPTradeFeed::HandleOrderInsertError(const CThostFtdcInputOrderField& field, const CThostFtdcRspInfoField& rspInfo) {
+    OrderStore::Handle handle = orderStore_.findByOrderRef(std::atoi(field.OrderRef));
     
-    // 返回模拟数据
-    // 在实际项目中这里应该等待回调并获取真实数据
+    // CTP和交易所的拒单可能各到一次，只通知第一次
+    if (!orderStore_.transition(handle, trade::OrderStatus::Rejected, -1, rspInfo.ErrorMsg)) {
+        return;
+    }
     
-    return positions;
+    trade::OrderData order;
+    if (orderCallback_ && orderStore_.get(handle, order)) {
+        orderCallback_(order);
+    }
 }
 
-trade::AccountData CTPTradeFeed::QueryAccount() {
-    std::lock_guard<std::mutex> lock(apiMutex_);
+void CTPTradeFeed::HandleQryPosition(const RawResponse& response) {
+    if (response.hasRspInfo && response.rspInfo.ErrorID != 0) {
+        queryScheduler_.onError(response.requestId, response.rspInfo.ErrorID, response.rspInfo.ErrorMsg);
+        return;
+    }
     
-    trade::AccountData account;
+    // 无持仓时只回一包空记录
+    if (!response.hasData) {
+        queryScheduler_.onPosition(response.requestId, nullptr, response.isLast);
+        return;
+    }
     
-    if (!connected_ || !loggedIn_ || !traderApi_) {
-        return account;
+    // 上期所和能源中心今仓、昨仓分两条记录回报，其他交易所一条记录内含今仓
+    const CThostFtdcInvestorPositionField& position = response.position;
+    trade::PositionData data = trade::PositionData();
+    data.symbol = position.InstrumentID;
+    data.direction = position.PosiDirection == THOST_FTDC_PD_Short ? trade::OrderDirection::Sell
+                                                                   : trade::OrderDirection::Buy;
+    data.totalPosition = position.Position;
+    if (position.PositionDate == THOST_FTDC_PSD_History) {
+        data.todayPosition = 0;
+        data.yesterdayPosition = position.Position;
+    } else {
+        data.todayPosition = position.TodayPosition;
+        data.yesterdayPosition = position.Position - position.TodayPosition;
+    }
+    data.openCost = position.OpenCost;
+    data.positionCost = position.PositionCost;
+    data.unrealizedPnl = position.PositionProfit;
+    data.tradingDay = position.TradingDay;
+    data.accountId = position.InvestorID;
+    data.exchangeId = position.ExchangeID;
+    
+    queryScheduler_.onPosition(response.requestId, &data, response.isLast);
+}
+
+void CTPTradeFeed::HandleQryAccount(const RawResponse& response) {
+    if (response.hasRspInfo && response.rspInfo.ErrorID != 0) {
+        queryScheduler_.onError(response.requestId, response.rspInfo.ErrorID, response.rspInfo.ErrorMsg);
+        return;
     }
     
-    // 在实际项目中，应该向CTP服务器查询账户数据
-    // 例如：
-    // CTP::CThostFtdcQryTradingAccountField req = {0};
-    // strncpy(req.BrokerID, brokerId_.c_str(), sizeof(req.BrokerID) - 1);
-    // strncpy(req.UserID, userId_.c_str(), sizeof(req.UserID) - 1);
-    // int requestID = 6;
-    // traderApi_->ReqQryTradingAccount(&req, requestID);
+    if (!response.hasData) {
+        queryScheduler_.onAccount(response.requestId, nullptr, response.isLast);
+        return;
+    }
     
-    // 返回模拟数据
-    account.accountId = userId_;
-    account.balance = 1000000.0;
-    account.available = 900000.0;
-    account.margin = 100000.0;
+    const CThostFtdcTradingAccountField& account = response.account;
+    trade::AccountData data = trade::AccountData();
+    data.accountId = account.AccountID;
+    data.balance = account.Balance;
+    data.available = account.Available;
+    data.frozenMargin = account.FrozenMargin;
+    data.frozenCommission = account.FrozenCommission;
+    data.commission = account.Commission;
+    data.margin = account.CurrMargin;
+    data.closeProfit = account.CloseProfit;
+    data.positionProfit = account.PositionProfit;
+    data.preBalance = account.PreBalance;
+    data.deposit = account.Deposit;
+    data.withdraw = account.Withdraw;
+    data.tradingDay = account.TradingDay;
+    data.currency = account.CurrencyID;
+    
+    queryScheduler_.onAccount(response.requestId, &data, response.isLast);
+}
+
+void CTPTradeFeed::BeginSessionRequest(int requestId) {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    sessionRequestId_ = requestId;
+    sessionReplied_ = false;
+    sessionErrorId_ = 0;
+}
+
+bool CTPTradeFeed::WaitSessionReply() {
+    std::unique_lock<std::mutex> lock(sessionMutex_);
+    bool replied = sessionCondition_.wait_for(lock, std::chrono::milliseconds(SESSION_TIMEOUT_MS),
+                                              [this]() { return sessionReplied_; });
+    return replied && sessionErrorId_ == 0;
+}
+
+void CTPTradeFeed::NotifySessionReply(int requestId, const CThostFtdcRspInfoField* rspInfo,
+                                      const CThostFtdcRspUserLoginField* login) {
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        if (requestId != sessionRequestId_) {
+            return;
+        }
+        sessionReplied_ = true;
+        sessionErrorId_ = rspInfo ? rspInfo->ErrorID : 0;
+        if (login) {
+            loginReply_ = *login;
+        }
+    }
+    sessionCondition_.notify_all();
+}
+
+void CTPTradeFeed::NotifyFrontConnected(bool connected) {
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        frontConnected_ = connected;
+    }
     
-    return account;
+    // 断线后会话失效，API自动重连后需要重新登录
+    if (!connected) {
+        loggedIn_ = false;
+        connected_ = false;
+    }
+    sessionCondition_.notify_all();
 }
 
 void CTPTradeFeed::SetOrderCallback(OrderCallback callback) {
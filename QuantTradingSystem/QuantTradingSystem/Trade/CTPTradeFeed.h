@@ -1,25 +1,28 @@
 #pragma once
 #include "ITradeFeed.h"
+#include "CTPQueryScheduler.h"
+#include "OrderStore.h"
+#include "OrderTemplateCache.h"
+#include "../MarketData/API/CTP/ThostFtdcTraderApi.h"
+#include "../Utils/SpscQueue.h"
+#include "../Utils/metrics/Metrics.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <string>
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 
-// 前置声明CTP的交易API类
-namespace CTP {
-    class CThostFtdcTraderApi;
-    class CThostFtdcTraderSpi;
-    struct CThostFtdcOrderField;
-    struct CThostFtdcTradeField;
-    struct CThostFtdcInvestorPositionField;
-    struct CThostFtdcTradingAccountField;
-    struct CThostFtdcRspInfoField;
-    struct CThostFtdcRspUserLoginField;
-}
+class CTPTraderSpi;
 
 // CTP交易接口实现
+// API线程上的回报回调只把CTP原始结构体拷入预分配的环形队列，不分配内存、不加锁、不构造字符串；
+// 转换为trade::OrderData等结构、更新订单存储和调用上层回调在回报处理线程上完成。
+// 启用报单网关时由网关线程轮询回报（SetExternalPolling），报单、撤单和回报处理在同一线程上。
 class CTPTradeFeed : public ITradeFeed {
 public:
     CTPTradeFeed();
@@ -45,22 +48,110 @@ public:
     std::string PlaceOrder(const trade::OrderData& orderData) override;
     bool CancelOrder(const std::string& orderId) override;
     
+    // 批量报单和撤单，整批只加一次接口锁
+    void PlaceOrders(const std::vector<const trade::OrderData*>& orders, std::vector<std::string>& orderIds) override;
+    void CancelOrders(const std::vector<std::string>& orderIds, std::vector<bool>& results) override;
+    
     // 查询接口
     std::vector<trade::OrderData> QueryPendingOrders() override;
+    std::vector<trade::OrderData> QueryPendingOrdersByStrategy(const std::string& strategyId) override;
+    std::vector<trade::OrderData> QueryPendingOrdersByInstrument(const std::string& symbol) override;
+    void PurgeTerminalOrders() override;
     trade::OrderData QueryOrder(const std::string& orderId) override;
     std::vector<trade::PositionData> QueryPositions() override;
     trade::AccountData QueryAccount() override;
     
+    // 异步查询，经查询调度按流控发送，多包回报汇总后回调
+    void QueryPositionsAsync(PositionQueryCallback callback) override;
+    void QueryAccountAsync(AccountQueryCallback callback) override;
+    
+    // 处理缓冲的回报
+    size_t PollResponses(size_t maxCount) override;
+    void SetExternalPolling(bool enabled) override;
+    
     // 设置回调
     void SetOrderCallback(OrderCallback callback) override;
     void SetTradeCallback(TradeCallback callback) override;
     void SetPositionCallback(PositionCallback callback) override;
     void SetAccountCallback(AccountCallback callback) override;
     
+    // 本地订单存储
+    OrderStore& GetOrderStore() { return orderStore_; }
+    
+    static const size_t RESPONSE_RING_CAPACITY = 4096;   // 回报队列容量，满时转入溢出队列
+    
 private:
+    friend class CTPTraderSpi;
+    
+    // API线程写入的原始回报
+    struct RawResponse {
+        enum Kind {
+            RTN_ORDER,            // OnRtnOrder
+            RTN_TRADE,            // OnRtnTrade
+            ORDER_INSERT_ERROR,   // OnRspOrderInsert、OnErrRtnOrderInsert
+            QRY_POSITION,         // OnRspQryInvestorPosition
+            QRY_ACCOUNT,          // OnRspQryTradingAccount
+            RSP_ERROR             // OnRspError
+        };
+        
+        Kind kind;
+        int requestId;
+        bool isLast;
+        bool hasData;
+        bool hasRspInfo;
+        CThostFtdcRspInfoField rspInfo;
+        union {
+            CThostFtdcOrderField order;
+            CThostFtdcTradeField trade;
+            CThostFtdcInputOrderField inputOrder;
+            CThostFtdcInvestorPositionField position;
+            CThostFtdcTradingAccountField account;
+        };
+    };
+    typedef Utils::SpscQueue<RawResponse, RESPONSE_RING_CAPACITY> ResponseRing;
+    
+    // API线程：拷贝原始回报入队，队列满时写入溢出队列，不等待消费
+    void PushResponse(RawResponse::Kind kind, const void* data, size_t size,
+                      const CThostFtdcRspInfoField* rspInfo, int requestId, bool isLast);
+    static void FillResponse(RawResponse& response, RawResponse::Kind kind, const void* data, size_t size,
+                             const CThostFtdcRspInfoField* rspInfo, int requestId, bool isLast);
+    
+    // 回报处理线程：转换并分发
+    void DispatchResponse(const RawResponse& response);
+    void HandleRtnOrder(const CThostFtdcOrderField& field);
+    void HandleRtnTrade(const CThostFtdcTradeField& field);
+    void HandleOrderInsertError(const CThostFtdcInputOrderField& field, const CThostFtdcRspInfoField& rspInfo);
+    void HandleQryPosition(const RawResponse& response);
+    void HandleQryAccount(const RawResponse& response);
+    
+    // 本会话订单按报单引用查找，其他会话的订单按交易所报单编号查找
+    OrderStore::Handle FindOrder(int frontId, int sessionId, const char* orderRef,
+                                 const char* exchangeId, const char* orderSysId) const;
+    
+    // 接口自带的回报处理线程，未由外部轮询时运行
+    void StartResponseThread();
+    void StopResponseThread();
+    void ResponseLoop();
+    
+    // 会话请求（连接、认证、登录、结算确认、登出）：API线程通知应答，调用方限时等待
+    void BeginSessionRequest(int requestId);
+    bool WaitSessionReply();
+    void NotifySessionReply(int requestId, const CThostFtdcRspInfoField* rspInfo,
+                            const CThostFtdcRspUserLoginField* login = nullptr);
+    void NotifyFrontConnected(bool connected);
+    
+
+    // 发送查询请求（查询调度线程调用），返回CTP请求函数的返回值
+    int SendQuery(CTPQueryType type, int requestId);
+    
+
+    // 报单和撤单（调用方需持有apiMutex_）
+    std::string PlaceOrderLocked(const trade::OrderData& orderData);
+    bool CancelOrderLocked(const trade::OrderData& orderData);
+    
     // CTP API相关
-    CTP::CThostFtdcTraderApi* traderApi_;
-    CTP::CThostFtdcTraderSpi* traderSpi_;
+    CThostFtdcTraderApi* traderApi_;
+    CTPTraderSpi* traderSpi_;
     
     // 回调函数
     OrderCallback orderCallback_;
@@ -77,17 +168,51 @@ private:
     std::string authCode_;
     
     // 状态标志
+    bool apiStarted_;   // API的Init只能调用一次，之后断线由API自动重连
     std::atomic<bool> connected_;
     std::atomic<bool> loggedIn_;
     
     // 会话参数
-    int frontId_;
-    int sessionId_;
+    std::atomic<int> frontId_;     // 回报处理线程按此判断是否本会话的订单
+    std::atomic<int> sessionId_;
     int orderRef_;
+    std::atomic<int> requestId_;   // 报单和查询共用的请求编号
+    
+    // 报单模板，登录时为配置的合约建立，未配置的合约首次报单时建立（在apiMutex_下使用）
+    OrderTemplateCache orderTemplates_;
+    std::map<std::string, std::string> instrumentExchanges_;
+    
+    // 查询调度，登录后启动，登出时未完成的查询以CANCELLED结束
+    CTPQueryScheduler queryScheduler_;
+    
+    // 原始回报队列（API线程写、回报处理线程读）及溢出队列
+    std::unique_ptr<ResponseRing> responseRing_;
+    std::deque<RawResponse> responseOverflow_;
+    std::atomic<bool> responseOverflowing_;
+    std::mutex overflowMutex_;
+    
+    // 回报处理线程
+    std::thread responseThread_;
+    std::atomic<bool> responseRunning_;
+    std::atomic<bool> externalPolling_;
+    std::mutex responseThreadMutex_;
+    
+    // 会话请求的应答
+    std::mutex sessionMutex_;
+    std::condition_variable sessionCondition_;
+    bool frontConnected_;
+    int sessionRequestId_;
+    bool sessionReplied_;
+    int sessionErrorId_;
+    CThostFtdcRspUserLoginField loginReply_;
+    
+    MetricCounter& responsesReceived_;
+    MetricCounter& responsesOverflowed_;
+    MetricHistogram& responseQueueDepth_;
     
-    // 订单映射，用于管理订单
-    std::unordered_map<std::string, trade::OrderData> orders_;
+    // 本地订单存储，查询和回报不经过apiMutex_
+    OrderStore orderStore_;
     
-    // 互斥锁
+    // 互斥锁（保护API调用和会话参数）
     mutable std::mutex apiMutex_;
 }; 
\ No newline at end of file
@@ -0,0 +1,615 @@
+#include "ExecutionAlgoEngine.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const int64_t NS_PER_MS = 1000000;
+const int64_t NO_TIMER = std::numeric_limits<int64_t>::max();
+
+bool isTerminal(trade::OrderStatus status) {
+    return status == trade::OrderStatus::Filled || status == trade::OrderStatus::Canceled ||
+           status == trade::OrderStatus::Rejected;
+}
+
+} // namespace
+
+ExecutionAlgoEngine::ExecutionAlgoEngine(const ExecutionAlgoConfig& config)
+    : config_(config),
+      nextParentId_(1),
+      nextChildId_(1),
+      activeCount_(0),
+      timers_(std::max<int64_t>(1, config.timerResolutionMs) * NS_PER_MS, latencyNow()),
+      nextTimerNs_(NO_TIMER),
+      hasActions_(false),
+      parentsSubmitted_(MetricsRegistry::getInstance().getCounter("exec_algo.parents_submitted")),
+      childrenSent_(MetricsRegistry::getInstance().getCounter("exec_algo.children_sent")),
+      childrenRefused_(MetricsRegistry::getInstance().getCounter("exec_algo.children_refused")),
+      childrenCancelled_(MetricsRegistry::getInstance().getCounter("exec_algo.children_cancelled")) {
+}
+
+void ExecutionAlgoEngine::setCallbacks(ChildSender sender, ChildCanceller canceller, ParentCallback parentCallback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sender_ = sender;
+    canceller_ = canceller;
+    parentCallback_ = parentCallback;
+}
+
+std::string ExecutionAlgoEngine::submit(const trade::OrderData& order, const ExecAlgoParams& params) {
+    if (order.volume <= 0 ||
+        params.type == ExecAlgoType::NONE ||
+        (params.type == ExecAlgoType::TWAP && params.durationMs <= 0) ||
+        (params.type == ExecAlgoType::POV && (params.participationRate <= 0.0 || params.participationRate > 1.0)) ||
+        (params.type == ExecAlgoType::ICEBERG && params.displayVolume <= 0)) {
+        return std::string();
+    }
+
+    const int64_t now = latencyNow();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint32_t index;
+    if (!freeParents_.empty()) {
+        index = freeParents_.back();
+        freeParents_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(parents_.size());
+        parents_.emplace_back();
+    }
+
+    Parent& parent = parents_[index];
+    parent.active = true;
+    parent.parentId = "ALGO-" + std::to_string(nextParentId_++);
+    parent.order = order;
+    parent.order.orderId = parent.parentId;
+    parent.order.tradedVolume = 0;
+    parent.order.status = trade::OrderStatus::Accepted;
+    parent.order.statusMsg.clear();
+    parent.params = params;
+    parent.startNs = now;
+    parent.endNs = params.durationMs > 0 ? now + params.durationMs * NS_PER_MS : 0;
+    parent.doneTraded = 0;
+    parent.slicesDone = 0;
+    parent.sliceCount = 0;
+    parent.sliceIntervalNs = 0;
+    parent.hasStartVolume = false;
+    parent.startVolume = 0;
+    parent.refused = 0;
+    parent.finishing = false;
+    parent.finalSent = false;
+    parent.cancelRequested = false;
+    parent.child = Child();
+    parent.child.childId = 0;
+    parent.timerId = TimerWheel::INVALID_TIMER;
+
+    parentIndex_[parent.parentId] = index;
+    instruments_[order.symbol].parents.push_back(index);
+    activeCount_.fetch_add(1);
+    parentsSubmitted_.add();
+    notify(parent);
+
+    std::string parentId = parent.parentId;
+    switch (params.type) {
+    case ExecAlgoType::TWAP:
+        parent.sliceCount = params.sliceCount > 0 ? params.sliceCount
+                                                  : static_cast<int>(std::max<int64_t>(1, params.durationMs / 1000));
+        parent.sliceIntervalNs = params.durationMs * NS_PER_MS / parent.sliceCount;
+        // 第一片立即发出
+        onTimer(index, now);
+        break;
+    case ExecAlgoType::ICEBERG:
+        sendChild(index, std::min(params.displayVolume, order.volume), now);
+        rescheduleTimer(index, now);
+        break;
+    default:
+        // POV等第一笔行情记下起始成交量
+        rescheduleTimer(index, now);
+        break;
+    }
+    return parentId;
+}
+
+bool ExecutionAlgoEngine::cancel(const std::string& parentId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = parentIndex_.find(parentId);
+    if (it == parentIndex_.end()) {
+        return false;
+    }
+
+    Parent& parent = parents_[it->second];
+    parent.cancelRequested = true;
+    parent.finishing = true;
+    if (parent.child.childId != 0) {
+        cancelChild(parent);
+    } else {
+        finish(it->second, "Canceled");
+    }
+    return true;
+}
+
+void ExecutionAlgoEngine::onMarketData(const MarketDataField& data) {
+    // 没有执行中的母单时不加锁
+    if (activeCount_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    const int64_t now = latencyNow();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = instruments_.find(data.symbol);
+    if (it == instruments_.end() || it->second.parents.empty()) {
+        return;
+    }
+
+    Instrument& instrument = it->second;
+    instrument.bidPrice = data.bidPrice[0];
+    instrument.askPrice = data.askPrice[0];
+    // 母单可能在处理中结束并从列表摘除，按下标倒序遍历
+    for (size_t i = instrument.parents.size(); i-- > 0;) {
+        if (i < instrument.parents.size() && parents_[instrument.parents[i]].params.type == ExecAlgoType::POV) {
+            onTick(instrument.parents[i], data.volume, now);
+        }
+    }
+}
+
+void ExecutionAlgoEngine::onChildPlaced(uint64_t childId, const std::string& orderId) {
+    const int64_t now = latencyNow();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (orderId.empty()) {
+        onChildRefused(childId, now);
+        return;
+    }
+
+    auto it = childIndex_.find(childId);
+    if (it == childIndex_.end()) {
+        return;
+    }
+    Parent& parent = parents_[it->second];
+    parent.child.orderId = orderId;
+    orderIndex_[orderId] = childId;
+    orderParents_[orderId] = parent.parentId;
+    retiredOrders_.push_back(orderId);
+    if (retiredOrders_.size() > RETIRED_ORDERS) {
+        retireOrder(retiredOrders_.front());
+        retiredOrders_.pop_front();
+    }
+
+    // 发出前已决定撤单
+    if (parent.child.cancelPending) {
+        parent.child.cancelPending = false;
+        cancelChild(parent);
+    }
+}
+
+void ExecutionAlgoEngine::onChildOrder(const trade::OrderData& order) {
+    const int64_t now = latencyNow();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto orderIt = orderIndex_.find(order.orderId);
+    if (orderIt == orderIndex_.end()) {
+        return;
+    }
+    auto childIt = childIndex_.find(orderIt->second);
+    if (childIt == childIndex_.end()) {
+        orderIndex_.erase(orderIt);
+        return;
+    }
+
+    uint32_t index = childIt->second;
+    Parent& parent = parents_[index];
+    Child& child = parent.child;
+
+    // 回报可能重复或乱序，成交量只增不减
+    int traded = std::min(child.volume, std::max(child.traded, order.tradedVolume));
+    if (traded != child.traded) {
+        child.traded = traded;
+        parent.order.tradedVolume = parent.doneTraded + traded;
+        parent.order.status = trade::OrderStatus::PartialFilled;
+        notify(parent);
+    }
+
+    if (isTerminal(order.status)) {
+        parent.doneTraded += child.traded;
+        childIndex_.erase(childIt);
+        orderIndex_.erase(orderIt);
+        child.childId = 0;
+        onChildDone(index, order.status, now);
+    }
+}
+
+std::string ExecutionAlgoEngine::getParentId(const std::string& orderId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orderParents_.find(orderId);
+    return it == orderParents_.end() ? std::string() : it->second;
+}
+
+size_t ExecutionAlgoEngine::poll(int64_t nowNs) {
+    if (nowNs < nextTimerNs_.load(std::memory_order_acquire) && !hasActions_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    ChildSender sender;
+    ChildCanceller canceller;
+    ParentCallback parentCallback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        advanceTimers(nowNs);
+        executing_.swap(actions_);
+        hasActions_.store(false, std::memory_order_release);
+        sender = sender_;
+        canceller = canceller_;
+        parentCallback = parentCallback_;
+    }
+
+    // 锁外执行，发送结果与计划不符时再回到锁内处理
+    std::vector<std::pair<uint64_t, int>> adjusted;
+    for (Action& action : executing_) {
+        switch (action.kind) {
+        case Action::SEND: {
+            int sent = sender ? sender(action.childId, action.order) : 0;
+            if (sent > 0) {
+                childrenSent_.add();
+            }
+            if (sent != action.order.volume) {
+                adjusted.emplace_back(action.childId, sent);
+            }
+            break;
+        }
+        case Action::CANCEL:
+            if (canceller) {
+                canceller(action.orderId);
+            }
+            break;
+        case Action::NOTIFY:
+            if (parentCallback) {
+                parentCallback(action.order);
+            }
+            break;
+        }
+    }
+    size_t executed = executing_.size();
+    executing_.clear();
+
+    if (!adjusted.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& result : adjusted) {
+            if (result.second <= 0) {
+                onChildRefused(result.first, nowNs);
+                continue;
+            }
+            auto it = childIndex_.find(result.first);
+            if (it != childIndex_.end()) {
+                parents_[it->second].child.volume = result.second;
+            }
+        }
+    }
+    return executed;
+}
+
+size_t ExecutionAlgoEngine::getActiveCount() const {
+    return activeCount_.load();
+}
+
+void ExecutionAlgoEngine::onTimer(uint32_t index, int64_t now) {
+    Parent& parent = parents_[index];
+
+    // POV和冰山单的执行时长到期
+    if (parent.endNs != 0 && now >= parent.endNs && !parent.finishing && parent.params.type != ExecAlgoType::TWAP) {
+        parent.finishing = true;
+        if (parent.child.childId == 0) {
+            finish(index, "Execution time expired");
+            return;
+        }
+        cancelChild(parent);
+    }
+
+    // 子单超时未成交：撤单，终结后按最新盘口重新报单（冰山单挂在限价上等待成交）
+    if (parent.child.childId != 0 && parent.params.type != ExecAlgoType::ICEBERG &&
+        now - parent.child.sentNs >= config_.childTimeoutMs * NS_PER_MS) {
+        cancelChild(parent);
+    }
+
+    if (parent.params.type == ExecAlgoType::TWAP && !parent.finishing &&
+        now >= parent.startNs + parent.slicesDone * parent.sliceIntervalNs) {
+        ++parent.slicesDone;
+        if (parent.slicesDone >= parent.sliceCount) {
+            parent.finishing = true;
+        }
+
+        // 上一片未成交的部分撤单后并入后续时间片；最后一片补齐全部剩余数量
+        if (parent.child.childId != 0) {
+            cancelChild(parent);
+        } else {
+            int64_t target = (static_cast<int64_t>(parent.order.volume) * parent.slicesDone +
+                              parent.sliceCount - 1) / parent.sliceCount;
+            if (target > parent.order.tradedVolume) {
+                sendChild(index, static_cast<int>(target - parent.order.tradedVolume), now);
+            }
+            if (parent.finishing) {
+                parent.finalSent = true;
+                if (parent.child.childId == 0) {
+                    finish(index, "Execution time expired");
+                    return;
+                }
+            }
+        }
+    }
+
+    rescheduleTimer(index, now);
+}
+
+void ExecutionAlgoEngine::onTick(uint32_t index, int volume, int64_t now) {
+    Parent& parent = parents_[index];
+    if (!parent.hasStartVolume || volume < parent.startVolume) {
+        // 起始成交量，或行情源重连、换日后成交量重置
+        parent.hasStartVolume = true;
+        parent.startVolume = volume;
+        return;
+    }
+    if (parent.finishing || parent.child.childId != 0) {
+        return;
+    }
+
+    int64_t target = static_cast<int64_t>((volume - parent.startVolume) * parent.params.participationRate);
+    target = std::min<int64_t>(target, parent.order.volume);
+    if (target > parent.order.tradedVolume) {
+        sendChild(index, static_cast<int>(target - parent.order.tradedVolume), now);
+        rescheduleTimer(index, now);
+    }
+}
+
+void ExecutionAlgoEngine::onChildDone(uint32_t index, trade::OrderStatus status, int64_t now) {
+    Parent& parent = parents_[index];
+    if (status == trade::OrderStatus::Rejected) {
+        ++parent.refused;
+    } else {
+        parent.refused = 0;
+    }
+
+    if (remaining(parent) <= 0) {
+        finish(index, std::string());
+        return;
+    }
+    if (parent.refused >= config_.maxRefusedChildren) {
+        finish(index, "Child orders refused");
+        return;
+    }
+    if (parent.cancelRequested) {
+        finish(index, "Canceled");
+        return;
+    }
+
+    switch (parent.params.type) {
+    case ExecAlgoType::ICEBERG:
+        // 显示部分成交或被拒后补下一笔；被外部撤单（如熔断）时结束
+        if (parent.finishing || (status != trade::OrderStatus::Filled && status != trade::OrderStatus::Rejected)) {
+            finish(index, parent.finishing ? "Execution time expired" : "Child order canceled");
+            return;
+        }
+        sendChild(index, std::min(parent.params.displayVolume, remaining(parent)), now);
+        break;
+    case ExecAlgoType::TWAP:
+        // 到期时撤下的子单终结后补齐剩余数量，补齐的子单终结后结束
+        if (parent.finishing) {
+            if (parent.finalSent) {
+                finish(index, "Execution time expired");
+                return;
+            }
+            parent.finalSent = true;
+            sendChild(index, remaining(parent), now);
+        }
+        break;
+    default:
+        if (parent.finishing) {
+            finish(index, "Execution time expired");
+            return;
+        }
+        break;
+    }
+
+    rescheduleTimer(index, now);
+}
+
+void ExecutionAlgoEngine::onChildRefused(uint64_t childId, int64_t now) {
+    auto it = childIndex_.find(childId);
+    if (it == childIndex_.end()) {
+        return;
+    }
+
+    uint32_t index = it->second;
+    childIndex_.erase(it);
+    parents_[index].child.childId = 0;
+    childrenRefused_.add();
+    onChildDone(index, trade::OrderStatus::Rejected, now);
+}
+
+void ExecutionAlgoEngine::retireOrder(const std::string& orderId) {
+    orderParents_.erase(orderId);
+}
+
+void ExecutionAlgoEngine::sendChild(uint32_t index, int volume, int64_t now) {
+    Parent& parent = parents_[index];
+    volume = std::min(volume, remaining(parent));
+    if (volume <= 0) {
+        return;
+    }
+
+    Child& child = parent.child;
+    child.childId = nextChildId_++;
+    child.orderId.clear();
+    child.volume = volume;
+    child.traded = 0;
+    child.sentNs = now;
+    child.cancelPending = false;
+    child.cancelSent = false;
+    childIndex_[child.childId] = index;
+
+    Action action;
+    action.kind = Action::SEND;
+    action.childId = child.childId;
+    action.order = parent.order;
+    action.order.orderId.clear();
+    action.order.statusMsg.clear();
+    action.order.status = trade::OrderStatus::Submitting;
+    action.order.tradedVolume = 0;
+    action.order.volume = volume;
+    action.order.price = childPrice(parent);
+    actions_.push_back(std::move(action));
+    hasActions_.store(true, std::memory_order_release);
+}
+
+void ExecutionAlgoEngine::cancelChild(Parent& parent) {
+    Child& child = parent.child;
+    if (child.childId == 0 || child.cancelSent || child.cancelPending) {
+        return;
+    }
+
+    // 尚未发出的子单在发出后撤
+    if (child.orderId.empty()) {
+        child.cancelPending = true;
+        return;
+    }
+
+    child.cancelSent = true;
+    childrenCancelled_.add();
+    Action action;
+    action.kind = Action::CANCEL;
+    action.childId = child.childId;
+    action.orderId = child.orderId;
+    actions_.push_back(std::move(action));
+    hasActions_.store(true, std::memory_order_release);
+}
+
+double ExecutionAlgoEngine::childPrice(const Parent& parent) const {
+    const double limit = parent.order.price;
+    if (parent.params.type == ExecAlgoType::ICEBERG) {
+        return limit;
+    }
+
+    // 取对手盘最优价，不劣于母单限价；尚无行情时用母单限价
+    auto it = instruments_.find(parent.order.symbol);
+    if (parent.order.direction == trade::OrderDirection::Buy) {
+        double ask = it != instruments_.end() ? it->second.askPrice : 0.0;
+        if (ask <= 0.0) {
+            return limit;
+        }
+        return limit > 0.0 ? std::min(ask, limit) : ask;
+    }
+    double bid = it != instruments_.end() ? it->second.bidPrice : 0.0;
+    if (bid <= 0.0) {
+        return limit;
+    }
+    return limit > 0.0 ? std::max(bid, limit) : bid;
+}
+
+void ExecutionAlgoEngine::finish(uint32_t index, const std::string& message) {
+    Parent& parent = parents_[index];
+    if (!parent.active) {
+        return;
+    }
+
+    if (parent.order.tradedVolume >= parent.order.volume) {
+        parent.order.status = trade::OrderStatus::Filled;
+    } else if (parent.order.tradedVolume == 0 && parent.refused >= config_.maxRefusedChildren) {
+        parent.order.status = trade::OrderStatus::Rejected;
+    } else {
+        parent.order.status = trade::OrderStatus::Canceled;
+    }
+    parent.order.statusMsg = message;
+    notify(parent);
+
+    cancelTimer(index);
+    auto it = instruments_.find(parent.order.symbol);
+    if (it != instruments_.end()) {
+        std::vector<uint32_t>& list = it->second.parents;
+        auto pos = std::find(list.begin(), list.end(), index);
+        if (pos != list.end()) {
+            *pos = list.back();
+            list.pop_back();
+        }
+        // 合约上没有母单后不再跟踪盘口，旧价格不能用于之后的母单
+        if (list.empty()) {
+            it->second.bidPrice = 0.0;
+            it->second.askPrice = 0.0;
+        }
+    }
+
+    parentIndex_.erase(parent.parentId);
+    parent.active = false;
+    freeParents_.push_back(index);
+    activeCount_.fetch_sub(1);
+}
+
+void ExecutionAlgoEngine::notify(const Parent& parent) {
+    Action action;
+    action.kind = Action::NOTIFY;
+    action.childId = 0;
+    action.order = parent.order;
+    actions_.push_back(std::move(action));
+    hasActions_.store(true, std::memory_order_release);
+}
+
+void ExecutionAlgoEngine::rescheduleTimer(uint32_t index, int64_t now) {
+    const Parent& parent = parents_[index];
+    int64_t next = NO_TIMER;
+    if (parent.params.type == ExecAlgoType::TWAP && !parent.finishing) {
+        next = parent.startNs + parent.slicesDone * parent.sliceIntervalNs;
+    }
+    if (parent.child.childId != 0 && !parent.child.cancelSent && !parent.child.cancelPending &&
+        parent.params.type != ExecAlgoType::ICEBERG) {
+        next = std::min(next, parent.child.sentNs + config_.childTimeoutMs * NS_PER_MS);
+    }
+    if (parent.endNs != 0 && !parent.finishing && parent.params.type != ExecAlgoType::TWAP) {
+        next = std::min(next, parent.endNs);
+    }
+
+    if (next == NO_TIMER) {
+        cancelTimer(index);
+    } else {
+        scheduleTimer(index, next, now);
+    }
+}
+
+void ExecutionAlgoEngine::scheduleTimer(uint32_t index, int64_t atNs, int64_t now) {
+    cancelTimer(index);
+
+    // 没有定时器时时间轮停在原处，登记前对齐到当前时间（空时间轮推进不会有到期）
+    if (timers_.size() == 0) {
+        timers_.advance(now, expired_);
+    }
+
+    parents_[index].timerId = timers_.schedule(atNs, index);
+    nextTimerNs_.store(timers_.nextExpiryNs(), std::memory_order_release);
+}
+
+void ExecutionAlgoEngine::cancelTimer(uint32_t index) {
+    Parent& parent = parents_[index];
+    if (parent.timerId == TimerWheel::INVALID_TIMER) {
+        return;
+    }
+
+    timers_.cancel(parent.timerId);
+    parent.timerId = TimerWheel::INVALID_TIMER;
+    nextTimerNs_.store(timers_.nextExpiryNs(), std::memory_order_release);
+}
+
+void ExecutionAlgoEngine::advanceTimers(int64_t now) {
+    // 先摘下到期的定时器，回调中可能重新登记
+    std::vector<TimerWheel::Expired> fired;
+    fired.swap(expired_);
+    fired.clear();
+    timers_.advance(now, fired);
+    nextTimerNs_.store(timers_.nextExpiryNs(), std::memory_order_release);
+
+    for (const auto& expired : fired) {
+        Parent& parent = parents_[static_cast<uint32_t>(expired.tag)];
+        if (parent.timerId != expired.id) {
+            continue;
+        }
+        parent.timerId = TimerWheel::INVALID_TIMER;
+        if (parent.active) {
+            onTimer(static_cast<uint32_t>(expired.tag), now);
+        }
+    }
+
+    fired.swap(expired_);
+}
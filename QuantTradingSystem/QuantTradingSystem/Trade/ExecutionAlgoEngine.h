@@ -0,0 +1,173 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include "../Events/StrategySignalEvent.h"
+#include "../MarketData/MarketDataField.h"
+#include "../Utils/metrics/Metrics.h"
+#include "../Utils/timer/TimerWheel.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 执行算法配置
+struct ExecutionAlgoConfig {
+    int64_t timerResolutionMs;   // 时间轮刻度
+    int64_t childTimeoutMs;      // 子单挂出后未成交的超时，超时撤单后按最新盘口重新报单
+    int maxRefusedChildren;      // 子单连续被风控拒绝或发送失败的次数上限，超过后母单结束
+
+    ExecutionAlgoConfig()
+        : timerResolutionMs(1), childTimeoutMs(2000), maxRefusedChildren(3) {}
+};
+
+// 执行算法引擎
+// 把信号的母单按TWAP、POV、冰山算法拆成子单。每个母单同一时刻至多一笔在途子单，
+// 子单价格取对手盘最优价并以母单限价封顶（冰山单挂在母单限价上）。
+// 母单的定时（下一片、子单超时、执行时长到期）挂在分层时间轮上，登记和取消都是O(1)；
+// 行情按合约找到该合约上的母单，每个母单只做一次成交量增量计算。
+// 行情线程、回报线程和下单线程只在锁内更新状态并登记待执行动作（发子单、撤子单、母单状态通知），
+// 由报单网关线程在poll中推进时间轮并在锁外执行动作，子单仍经网关队列发送。
+class ExecutionAlgoEngine {
+public:
+    // 发送子单，返回实际发出的数量（持仓台账可能缩减平仓数量），0表示被拒绝
+    typedef std::function<int(uint64_t childId, const trade::OrderData& child)> ChildSender;
+    // 撤销已发出的子单
+    typedef std::function<void(const std::string& orderId)> ChildCanceller;
+    // 母单状态变化，orderId为母单编号
+    typedef std::function<void(const trade::OrderData& parent)> ParentCallback;
+
+    explicit ExecutionAlgoEngine(const ExecutionAlgoConfig& config = ExecutionAlgoConfig());
+
+    // 禁止拷贝和赋值
+    ExecutionAlgoEngine(const ExecutionAlgoEngine&) = delete;
+    ExecutionAlgoEngine& operator=(const ExecutionAlgoEngine&) = delete;
+
+    // 设置回调（在使用之前调用）
+    void setCallbacks(ChildSender sender, ChildCanceller canceller, ParentCallback parentCallback);
+
+    // 提交母单，返回母单编号；参数无效时返回空
+    std::string submit(const trade::OrderData& order, const ExecAlgoParams& params);
+
+    // 撤销母单：撤掉在途子单，子单终结后母单以已撤结束
+    bool cancel(const std::string& parentId);
+
+    // 行情（行情线程调用）
+    void onMarketData(const MarketDataField& data);
+
+    // 子单已由网关发出，orderId为空表示发送失败
+    void onChildPlaced(uint64_t childId, const std::string& orderId);
+
+    // 子单回报，不是子单时忽略
+    void onChildOrder(const trade::OrderData& order);
+
+    // 子单对应的母单编号，不是子单时返回空
+    std::string getParentId(const std::string& orderId) const;
+
+    // 推进时间轮并执行待执行动作（网关线程调用），返回执行的动作数
+    size_t poll(int64_t nowNs);
+
+    // 未结束的母单数
+    size_t getActiveCount() const;
+
+private:
+    static constexpr size_t RETIRED_ORDERS = 65536;  // 已终结子单保留母单编号的数量
+
+    // 在途子单
+    struct Child {
+        uint64_t childId;          // 0表示没有在途子单
+        std::string orderId;       // 网关发出后填写
+        int volume;
+        int traded;
+        int64_t sentNs;
+        bool cancelPending;        // 已决定撤单，发出后立即撤
+        bool cancelSent;
+    };
+
+    struct Parent {
+        bool active;
+        std::string parentId;
+        trade::OrderData order;    // 母单，tradedVolume和status随子单更新
+        ExecAlgoParams params;
+        int64_t startNs;
+        int64_t endNs;             // 0为不限
+        int doneTraded;            // 已终结子单的成交量
+        int slicesDone;            // TWAP已到达的时间片
+        int sliceCount;
+        int64_t sliceIntervalNs;
+        bool hasStartVolume;       // POV：是否已记下起始成交量
+        int startVolume;
+        int refused;               // 子单连续被拒次数
+        bool finishing;            // 不再按计划发新子单，当前子单终结后结束
+        bool finalSent;            // TWAP：到期后已发出补齐剩余数量的子单
+        bool cancelRequested;
+        Child child;
+        TimerWheel::TimerId timerId;   // 时间轮上的定时器，标签为母单下标
+    };
+
+    struct Instrument {
+        double bidPrice;
+        double askPrice;
+        std::vector<uint32_t> parents;
+    };
+
+    struct Action {
+        enum Kind { SEND, CANCEL, NOTIFY };
+        Kind kind;
+        uint64_t childId;
+        trade::OrderData order;    // SEND：子单；NOTIFY：母单
+        std::string orderId;       // CANCEL
+    };
+
+    // 以下需持有mutex_
+    int remaining(const Parent& parent) const { return parent.order.volume - parent.order.tradedVolume; }
+    void onTimer(uint32_t index, int64_t now);
+    void onTick(uint32_t index, int volume, int64_t now);
+    void onChildDone(uint32_t index, trade::OrderStatus status, int64_t now);
+    void onChildRefused(uint64_t childId, int64_t now);
+    void retireOrder(const std::string& orderId);
+    void sendChild(uint32_t index, int volume, int64_t now);
+    void cancelChild(Parent& parent);
+    double childPrice(const Parent& parent) const;
+    void finish(uint32_t index, const std::string& message);
+    void notify(const Parent& parent);
+    void rescheduleTimer(uint32_t index, int64_t now);
+
+    // 时间轮（需持有mutex_）
+    void scheduleTimer(uint32_t index, int64_t atNs, int64_t now);
+    void cancelTimer(uint32_t index);
+    void advanceTimers(int64_t now);
+
+    ExecutionAlgoConfig config_;
+    ChildSender sender_;
+    ChildCanceller canceller_;
+    ParentCallback parentCallback_;
+
+    std::vector<Parent> parents_;
+    std::vector<uint32_t> freeParents_;
+    std::unordered_map<std::string, uint32_t> parentIndex_;
+    std::unordered_map<uint64_t, uint32_t> childIndex_;
+    std::unordered_map<std::string, uint64_t> orderIndex_;             // 在途子单
+    std::unordered_map<std::string, std::string> orderParents_;        // 子单订单编号到母单编号
+    std::deque<std::string> retiredOrders_;
+    std::unordered_map<std::string, Instrument> instruments_;
+    uint64_t nextParentId_;
+    uint64_t nextChildId_;
+    std::atomic<size_t> activeCount_;
+
+    TimerWheel timers_;
+    std::vector<TimerWheel::Expired> expired_;
+    std::atomic<int64_t> nextTimerNs_;     // 最早可能到期的刻度，poll据此免锁跳过
+
+    std::vector<Action> actions_;
+    std::vector<Action> executing_;
+    std::atomic<bool> hasActions_;
+    mutable std::mutex mutex_;
+
+    MetricCounter& parentsSubmitted_;
+    MetricCounter& childrenSent_;
+    MetricCounter& childrenRefused_;
+    MetricCounter& childrenCancelled_;
+};
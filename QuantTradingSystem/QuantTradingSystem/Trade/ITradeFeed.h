@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <functional>
@@ -11,6 +12,10 @@ using TradeCallback = std::function<void(const trade::TradeData&)>;
 using PositionCallback = std::function<void(const trade::PositionData&)>;
 using AccountCallback = std::function<void(const trade::AccountData&)>;
 
+// 异步查询回调，success为false时数据无效（发送失败、超时或已断开）
+using PositionQueryCallback = std::function<void(bool success, const std::vector<trade::PositionData>&)>;
+using AccountQueryCallback = std::function<void(bool success, const trade::AccountData&)>;
+
 // 交易接口基类
 class ITradeFeed {
 public:
@@ -33,12 +38,63 @@ public:
     virtual std::string PlaceOrder(const trade::OrderData& orderData) = 0;
     virtual bool CancelOrder(const std::string& orderId) = 0;
     
+    // 批量报单，orderIds与orders一一对应，失败的为空；默认逐笔调用PlaceOrder，
+    // 接口可重写以在一次加锁内发送整批
+    virtual void PlaceOrders(const std::vector<const trade::OrderData*>& orders, std::vector<std::string>& orderIds) {
+        orderIds.clear();
+        for (const trade::OrderData* order : orders) {
+            orderIds.push_back(PlaceOrder(*order));
+        }
+    }
+    
+    // 批量撤单，results与orderIds一一对应；默认逐笔调用CancelOrder
+    virtual void CancelOrders(const std::vector<std::string>& orderIds, std::vector<bool>& results) {
+        results.clear();
+        for (const std::string& orderId : orderIds) {
+            results.push_back(CancelOrder(orderId));
+        }
+    }
+    
     // 查询接口
     virtual std::vector<trade::OrderData> QueryPendingOrders() = 0;
     virtual trade::OrderData QueryOrder(const std::string& orderId) = 0;
     virtual std::vector<trade::PositionData> QueryPositions() = 0;
     virtual trade::AccountData QueryAccount() = 0;
     
+    // 按策略、按合约查询挂单；默认从全部挂单中筛选，按范围维护挂单的接口应重写
+    virtual std::vector<trade::OrderData> QueryPendingOrdersByStrategy(const std::string& strategyId) {
+        std::vector<trade::OrderData> orders = QueryPendingOrders();
+        orders.erase(std::remove_if(orders.begin(), orders.end(),
+                                    [&strategyId](const trade::OrderData& order) { return order.strategyId != strategyId; }),
+                     orders.end());
+        return orders;
+    }
+    virtual std::vector<trade::OrderData> QueryPendingOrdersByInstrument(const std::string& symbol) {
+        std::vector<trade::OrderData> orders = QueryPendingOrders();
+        orders.erase(std::remove_if(orders.begin(), orders.end(),
+                                    [&symbol](const trade::OrderData& order) { return order.symbol != symbol; }),
+                     orders.end());
+        return orders;
+    }
+    
+    // 回收本地已终结的订单（交易日切换时调用），没有本地订单存储的接口不做处理
+    virtual void PurgeTerminalOrders() {}
+    
+    // 异步查询持仓和账户，结果通过回调通知；默认同步查询后立即回调，
+    // 有查询流控的接口应重写为排队发送，回调在接口线程上调用
+    virtual void QueryPositionsAsync(PositionQueryCallback callback) {
+        callback(true, QueryPositions());
+    }
+    virtual void QueryAccountAsync(AccountQueryCallback callback) {
+        callback(true, QueryAccount());
+    }
+    
+    // 处理接口线程缓冲的回报（订单、成交、查询），返回处理的条数；回报在接口线程上直接处理的接口返回0
+    virtual size_t PollResponses(size_t /*maxCount*/) { return 0; }
+    
+    // 由外部线程（报单网关）调用PollResponses轮询回报；关闭时接口自行处理回报
+    virtual void SetExternalPolling(bool /*enabled*/) {}
+    
     // 资源释放
     virtual void Release() = 0;
     
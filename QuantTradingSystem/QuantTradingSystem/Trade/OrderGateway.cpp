@@ -0,0 +1,337 @@
+#include "OrderGateway.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
+#include <chrono>
+#include <utility>
+
+namespace {
+
+// 网关实例编号，线程本地的队列缓存按编号区分网关实例
+std::atomic<uint64_t> g_nextGatewayId(1);
+
+} // namespace
+
+OrderGateway::OrderGateway(std::shared_ptr<ITradeFeed> tradeFeed, const OrderGatewayConfig& config)
+    : tradeFeed_(tradeFeed),
+      config_(config),
+      instanceId_(g_nextGatewayId.fetch_add(1)),
+      nextHandle_(1),
+      producers_(std::make_shared<ProducerList>()),
+      running_(false),
+      submitting_(0),
+      handleSlots_(new HandleSlot[HANDLE_SLOTS]()),
+      ordersSent_(MetricsRegistry::getInstance().getCounter("order_gateway.orders_sent")),
+      sendFailed_(MetricsRegistry::getInstance().getCounter("order_gateway.send_failed")),
+      ringFull_(MetricsRegistry::getInstance().getCounter("order_gateway.ring_full")),
+      queueTime_(MetricsRegistry::getInstance().getHistogram("order_gateway.queue_ns")),
+      batchSize_(MetricsRegistry::getInstance().getHistogram("order_gateway.batch_size")) {
+    if (config_.maxBatch == 0) {
+        config_.maxBatch = 1;
+    }
+}
+
+OrderGateway::~OrderGateway() {
+    stop();
+}
+
+void OrderGateway::setCallbacks(PlaceCallback placeCallback, CancelCallback cancelCallback) {
+    placeCallback_ = placeCallback;
+    cancelCallback_ = cancelCallback;
+}
+
+void OrderGateway::setPollHook(PollHook pollHook) {
+    pollHook_ = pollHook;
+}
+
+void OrderGateway::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    // 交易接口的回报改由网关线程轮询
+    tradeFeed_->SetExternalPolling(true);
+    thread_ = std::thread(&OrderGateway::gatewayLoop, this);
+}
+
+void OrderGateway::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    tradeFeed_->SetExternalPolling(false);
+}
+
+OrderGateway::Producer& OrderGateway::localProducer() {
+    // 每个线程缓存自己在各网关实例上的队列
+    thread_local std::vector<std::pair<uint64_t, Producer*>> cache;
+    for (const auto& entry : cache) {
+        if (entry.first == instanceId_) {
+            return *entry.second;
+        }
+    }
+
+    auto producer = std::make_shared<Producer>();
+    {
+        std::lock_guard<std::mutex> lock(producerMutex_);
+        auto updated = std::make_shared<ProducerList>(*std::atomic_load(&producers_));
+        updated->push_back(producer);
+        std::atomic_store(&producers_, std::shared_ptr<const ProducerList>(updated));
+    }
+    cache.emplace_back(instanceId_, producer.get());
+    return *producer;
+}
+
+bool OrderGateway::enqueue(GatewayRequest& request) {
+    // 先登记再检查运行标志：网关线程停止时等登记清零后再最后取空一次，通过检查的请求
+    // 一定会发出；停止后的请求直接失败，不会写入无人取走的队列。
+    // 网关线程在最后取空时（发送回调中）提交的请求由同一循环发出
+    const bool onGatewayThread = std::this_thread::get_id() == gatewayThreadId_.load();
+    submitting_.fetch_add(1);
+    if (!running_.load() && !onGatewayThread) {
+        submitting_.fetch_sub(1);
+        return false;
+    }
+
+    request.enqueueNs = latencyNow();
+    Producer& producer = localProducer();
+    if (!producer.ring.push(std::move(request))) {
+        // 报单和撤单不能丢弃，队列满时等待网关线程取走；
+        // 网关线程自己（轮询钩子中）提交时无人取走，就地发出一批
+        ringFull_.add();
+        while (!producer.ring.push(std::move(request))) {
+            if (onGatewayThread) {
+                drainBatch();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    submitting_.fetch_sub(1);
+    return true;
+}
+
+ClientOrderHandle OrderGateway::submitOrder(const trade::OrderData& order, const RiskOrder* riskOrder,
+                                            const LatencyTrace& trace, bool frozenClose, uint64_t algoChildId) {
+    GatewayRequest request;
+    request.kind = GatewayRequest::PLACE;
+    request.handle = nextHandle_.fetch_add(1, std::memory_order_relaxed);
+    request.order = order;
+    request.hasRiskOrder = riskOrder != nullptr;
+    if (riskOrder) {
+        request.riskOrder = *riskOrder;
+    }
+    request.frozenClose = frozenClose;
+    request.algoChildId = algoChildId;
+    request.trace = trace;
+
+    ClientOrderHandle handle = request.handle;
+    return enqueue(request) ? handle : 0;
+}
+
+bool OrderGateway::submitCancel(ClientOrderHandle handle) {
+    if (handle == 0 || handle >= nextHandle_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    GatewayRequest request;
+    request.kind = GatewayRequest::CANCEL;
+    request.handle = handle;
+    request.hasRiskOrder = false;
+    request.frozenClose = false;
+    request.algoChildId = 0;
+    return enqueue(request);
+}
+
+bool OrderGateway::submitCancel(const std::string& orderId) {
+    if (orderId.empty()) {
+        return false;
+    }
+
+    GatewayRequest request;
+    request.kind = GatewayRequest::CANCEL;
+    request.handle = 0;
+    request.orderId = orderId;
+    request.hasRiskOrder = false;
+    request.frozenClose = false;
+    request.algoChildId = 0;
+    return enqueue(request);
+}
+
+std::string OrderGateway::getOrderId(ClientOrderHandle handle) const {
+    std::lock_guard<std::mutex> lock(handleMutex_);
+    return lookupOrderId(handle);
+}
+
+std::string OrderGateway::lookupOrderId(ClientOrderHandle handle) const {
+    const HandleSlot& slot = handleSlots_[handle & (HANDLE_SLOTS - 1)];
+    return slot.handle == handle ? slot.orderId : std::string();
+}
+
+size_t OrderGateway::getQueueDepth() const {
+    size_t depth = 0;
+    for (const auto& producer : *std::atomic_load(&producers_)) {
+        depth += producer->ring.size();
+    }
+    return depth;
+}
+
+void OrderGateway::gatewayLoop() {
+    ThreadUtil::setCurrentThreadName("OrderGateway");
+    gatewayThreadId_.store(std::this_thread::get_id());
+    ThreadUtil::bindCurrentThreadToCpu(config_.cpuId);
+
+    // 空闲时先自旋让出，长时间无请求再短暂休眠；绑核独占时持续轮询
+    const int SPIN_LIMIT = 1000;
+    int idleSpins = 0;
+
+    while (running_.load(std::memory_order_acquire)) {
+        size_t work = drainBatch();
+        work += tradeFeed_->PollResponses(config_.maxBatch);
+        if (pollHook_) {
+            work += pollHook_(latencyNow());
+        }
+        if (work > 0) {
+            idleSpins = 0;
+        } else if (config_.busyPoll || ++idleSpins < SPIN_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    // 发送停止前已入队的请求，并等待正在入队的提交完成；
+    // 先读登记数再取空，登记清零前写入的请求都能取到
+    for (;;) {
+        const bool idle = submitting_.load() == 0;
+        if (drainBatch() > 0) {
+            continue;
+        }
+        if (idle) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+size_t OrderGateway::drainBatch() {
+    places_.clear();
+    cancels_.clear();
+
+    // 各队列轮流取，单个生产者不能占满整批
+    std::shared_ptr<const ProducerList> producers = std::atomic_load(&producers_);
+    const int64_t now = latencyNow();
+    size_t taken = 0;
+    bool progress = true;
+    while (progress && taken < config_.maxBatch) {
+        progress = false;
+        for (const auto& producer : *producers) {
+            GatewayRequest request;
+            if (taken >= config_.maxBatch || !producer->ring.pop(request)) {
+                continue;
+            }
+            progress = true;
+            ++taken;
+            queueTime_.record(now - request.enqueueNs);
+            if (request.kind == GatewayRequest::CANCEL) {
+                cancels_.push_back(std::move(request));
+            } else {
+                request.trace.stamp(LatencyStage::GATEWAY_DEQUEUE, now);
+                places_.push_back(std::move(request));
+            }
+        }
+    }
+    if (taken == 0) {
+        return 0;
+    }
+    batchSize_.record(static_cast<int64_t>(taken));
+
+    // 撤单优先，降低挂单在市场上暴露的时间
+    if (!cancels_.empty()) {
+        sendCancels();
+    }
+    if (!places_.empty()) {
+        sendOrders();
+    }
+    return taken;
+}
+
+void OrderGateway::sendCancels() {
+    cancelIds_.clear();
+    for (const GatewayRequest& request : cancels_) {
+        if (!request.orderId.empty()) {
+            cancelIds_.push_back(request.orderId);
+            continue;
+        }
+
+        // 按句柄撤单：订单已发出时取订单编号，发送失败时无需撤单，尚未发出时记下，发出后补发撤单。
+        // 槽位已被更新的句柄覆盖说明订单早已处理过，丢弃，挂起的撤单只留给尚未处理的订单
+        const HandleSlot& slot = handleSlots_[request.handle & (HANDLE_SLOTS - 1)];
+        if (slot.handle == request.handle) {
+            if (!slot.orderId.empty()) {
+                cancelIds_.push_back(slot.orderId);
+            }
+        } else if (slot.handle < request.handle) {
+            pendingCancels_.insert(request.handle);
+        }
+    }
+    if (cancelIds_.empty()) {
+        return;
+    }
+
+    tradeFeed_->CancelOrders(cancelIds_, cancelResults_);
+    if (cancelCallback_) {
+        for (size_t i = 0; i < cancelIds_.size(); ++i) {
+            cancelCallback_(cancelIds_[i], i < cancelResults_.size() && cancelResults_[i]);
+        }
+    }
+}
+
+void OrderGateway::sendOrders() {
+    batchOrders_.clear();
+    for (const GatewayRequest& request : places_) {
+        batchOrders_.push_back(&request.order);
+    }
+
+    tradeFeed_->PlaceOrders(batchOrders_, batchOrderIds_);
+    batchOrderIds_.resize(places_.size());
+
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        // 发送失败的订单也登记，之后到达的撤单据此丢弃
+        for (size_t i = 0; i < places_.size(); ++i) {
+            HandleSlot& slot = handleSlots_[places_[i].handle & (HANDLE_SLOTS - 1)];
+            slot.handle = places_[i].handle;
+            slot.orderId = batchOrderIds_[i];
+        }
+    }
+
+    cancelIds_.clear();
+    for (size_t i = 0; i < places_.size(); ++i) {
+        GatewayRequest& request = places_[i];
+        const std::string& orderId = batchOrderIds_[i];
+        if (orderId.empty()) {
+            sendFailed_.add();
+        } else {
+            ordersSent_.add();
+            request.trace.stamp(LatencyStage::PLACE_ORDER);
+        }
+        if (placeCallback_) {
+            placeCallback_(request, orderId);
+        }
+
+        // 发出前已收到撤单请求的订单立即撤单
+        if (!pendingCancels_.empty() && pendingCancels_.erase(request.handle) != 0 && !orderId.empty()) {
+            cancelIds_.push_back(orderId);
+        }
+    }
+
+    if (!cancelIds_.empty()) {
+        tradeFeed_->CancelOrders(cancelIds_, cancelResults_);
+        if (cancelCallback_) {
+            for (size_t i = 0; i < cancelIds_.size(); ++i) {
+                cancelCallback_(cancelIds_[i], i < cancelResults_.size() && cancelResults_[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "ITradeFeed.h"
+#include "../Risk/RiskEngine.h"
+#include "../Utils/SpscQueue.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/metrics/Metrics.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// 客户端订单句柄，报单请求入队时立即分配，0为无效
+typedef uint64_t ClientOrderHandle;
+
+// 报单网关配置
+struct OrderGatewayConfig {
+    int cpuId;            // 网关线程绑定的CPU核心，-1表示不绑定
+    size_t maxBatch;      // 每批最多取出的请求数
+    bool busyPoll;        // 空闲时持续轮询（独占核心时使用），否则自旋一段时间后短暂休眠
+
+    OrderGatewayConfig() : cpuId(-1), maxBatch(64), busyPoll(false) {}
+};
+
+// 报单网关请求
+struct GatewayRequest {
+    enum Kind { PLACE, CANCEL };
+
+    Kind kind;
+    ClientOrderHandle handle;   // PLACE为新订单的句柄；CANCEL为要撤的订单句柄，按订单编号撤单时为0
+    trade::OrderData order;     // PLACE
+    std::string orderId;        // CANCEL：按订单编号撤单
+    RiskOrder riskOrder;        // PLACE：已通过事前风控并登记为在途挂单的订单，发送后按结果绑定或释放
+    bool hasRiskOrder;
+    bool frozenClose;           // PLACE：持仓台账拆出并冻结了持仓的平仓单，发送后登记或解冻
+    uint64_t algoChildId;       // PLACE：执行算法子单编号，0为普通订单
+    LatencyTrace trace;
+    int64_t enqueueNs;
+};
+
+// 异步报单网关
+// 报单和撤单请求由各生产线程写入各自的单生产者单消费者环形队列，立即返回客户端订单句柄；
+// 网关线程（可绑核）轮询所有队列，按批取出请求，先整批撤单再整批报单，交易接口的耗时
+// 不再阻塞行情和策略的处理线程。发送结果通过回调在网关线程上通知调用方。
+// 同一生产线程的请求按提交顺序发送；对尚未发出的订单的撤单在订单发出后立即补发。
+// 停止后提交的请求直接失败，由调用方回滚；停止前已入队的请求全部发出。
+// 网关运行期间交易接口的回报（订单、成交、查询）也由网关线程轮询处理。
+class OrderGateway {
+public:
+    typedef std::function<void(const GatewayRequest& request, const std::string& orderId)> PlaceCallback;
+    typedef std::function<void(const std::string& orderId, bool sent)> CancelCallback;
+    // 网关线程每轮循环调用一次（执行算法推进定时器），返回处理的工作量
+    typedef std::function<size_t(int64_t nowNs)> PollHook;
+
+    static const size_t RING_CAPACITY = 1024;     // 每个生产线程的队列容量
+    static const size_t HANDLE_SLOTS = 65536;     // 句柄到订单编号的映射槽数（按句柄取模，旧句柄被覆盖）
+
+    OrderGateway(std::shared_ptr<ITradeFeed> tradeFeed, const OrderGatewayConfig& config);
+    ~OrderGateway();
+
+    // 禁止拷贝和赋值
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    // 设置发送结果回调（在start之前调用）
+    void setCallbacks(PlaceCallback placeCallback, CancelCallback cancelCallback);
+
+    // 设置网关线程的轮询钩子（在start之前调用）
+    void setPollHook(PollHook pollHook);
+
+    // 启动和停止网关线程，停止时发送完已入队和正在入队的请求
+    void start();
+    void stop();
+
+    // 提交报单，返回客户端订单句柄，网关未运行时返回0；riskOrder为空表示未经事前风控
+    ClientOrderHandle submitOrder(const trade::OrderData& order, const RiskOrder* riskOrder,
+                                  const LatencyTrace& trace, bool frozenClose = false, uint64_t algoChildId = 0);
+
+    // 按客户端订单句柄或订单编号提交撤单，网关未运行时返回false
+    bool submitCancel(ClientOrderHandle handle);
+    bool submitCancel(const std::string& orderId);
+
+    // 查询句柄对应的订单编号，尚未发出、发送失败或映射已被覆盖时返回空
+    std::string getOrderId(ClientOrderHandle handle) const;
+
+    // 各队列中待发送的请求数
+    size_t getQueueDepth() const;
+
+private:
+    struct Producer {
+        Utils::SpscQueue<GatewayRequest, RING_CAPACITY> ring;
+    };
+    typedef std::vector<std::shared_ptr<Producer>> ProducerList;
+
+    struct HandleSlot {
+        ClientOrderHandle handle;   // 最近处理的占用该槽的句柄
+        std::string orderId;        // 发送失败时为空
+    };
+
+    // 当前线程的队列，首次提交时注册
+    Producer& localProducer();
+
+    // 写入当前线程的队列，队列满时等待网关线程取走；网关已停止时返回false
+    bool enqueue(GatewayRequest& request);
+
+    // 网关线程
+    void gatewayLoop();
+    size_t drainBatch();
+    void sendCancels();
+    void sendOrders();
+    std::string lookupOrderId(ClientOrderHandle handle) const;
+
+    std::shared_ptr<ITradeFeed> tradeFeed_;
+    OrderGatewayConfig config_;
+    PlaceCallback placeCallback_;
+    CancelCallback cancelCallback_;
+    PollHook pollHook_;
+
+    const uint64_t instanceId_;
+    std::atomic<ClientOrderHandle> nextHandle_;
+
+    // 生产线程队列列表，写时复制，网关线程无锁读取
+    std::shared_ptr<const ProducerList> producers_;
+    std::mutex producerMutex_;
+
+    std::atomic<bool> running_;
+    std::atomic<int> submitting_;     // 已通过运行检查、正在入队的提交数
+    std::thread thread_;
+    std::atomic<std::thread::id> gatewayThreadId_;
+
+    // 以下只在网关线程上修改
+    std::vector<GatewayRequest> places_;
+    std::vector<GatewayRequest> cancels_;
+    std::vector<const trade::OrderData*> batchOrders_;
+    std::vector<std::string> batchOrderIds_;
+    std::vector<std::string> cancelIds_;
+    std::vector<bool> cancelResults_;
+    std::unordered_set<ClientOrderHandle> pendingCancels_;
+
+    // 句柄到订单编号，网关线程每批写入一次
+    std::unique_ptr<HandleSlot[]> handleSlots_;
+    mutable std::mutex handleMutex_;
+
+    MetricCounter& ordersSent_;
+    MetricCounter& sendFailed_;
+    MetricCounter& ringFull_;
+    MetricHistogram& queueTime_;
+    MetricHistogram& batchSize_;
+};
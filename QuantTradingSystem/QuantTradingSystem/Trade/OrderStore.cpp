@@ -0,0 +1,481 @@
+#include "OrderStore.h"
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+// 槽位自旋锁，只在同一订单的读写之间竞争，临界区只有几个字段的拷贝
+class SpinGuard {
+public:
+    explicit SpinGuard(std::atomic_flag& flag) : flag_(flag) {
+        while (flag_.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~SpinGuard() { flag_.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag& flag_;
+};
+
+// 各状态允许迁移到的状态，按位表示
+uint32_t bit(trade::OrderStatus status) {
+    return 1u << static_cast<int>(status);
+}
+
+const uint32_t TERMINAL_MASK = (1u << static_cast<int>(trade::OrderStatus::Filled)) |
+                               (1u << static_cast<int>(trade::OrderStatus::Canceled)) |
+                               (1u << static_cast<int>(trade::OrderStatus::Rejected));
+
+uint32_t allowedTransitions(trade::OrderStatus from) {
+    switch (from) {
+        case trade::OrderStatus::Unknown:
+            return bit(trade::OrderStatus::Submitting);
+        case trade::OrderStatus::Submitting:
+            return bit(trade::OrderStatus::Accepted) | bit(trade::OrderStatus::PartialFilled) | TERMINAL_MASK;
+        case trade::OrderStatus::Accepted:
+            return bit(trade::OrderStatus::PartialFilled) | bit(trade::OrderStatus::Filled) |
+                   bit(trade::OrderStatus::Canceled);
+        case trade::OrderStatus::PartialFilled:
+            return bit(trade::OrderStatus::PartialFilled) | bit(trade::OrderStatus::Filled) |
+                   bit(trade::OrderStatus::Canceled);
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+OrderStore::OrderStore()
+    : slabCount_(0),
+      nextFresh_(0),
+      freeHead_(NIL),
+      orderRefBase_(0),
+      headSlots_(1, NIL),
+      workingCount_(0),
+      orderCount_(0) {
+    for (uint32_t i = 0; i < MAX_SLABS; ++i) {
+        slabs_[i].store(nullptr, std::memory_order_relaxed);
+        refSlabs_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+OrderStore::~OrderStore() {
+    for (uint32_t i = 0; i < MAX_SLABS; ++i) {
+        delete[] slabs_[i].load(std::memory_order_relaxed);
+        delete[] refSlabs_[i].load(std::memory_order_relaxed);
+    }
+}
+
+bool OrderStore::isTerminal(trade::OrderStatus status) {
+    return (bit(status) & TERMINAL_MASK) != 0;
+}
+
+bool OrderStore::isValidTransition(trade::OrderStatus from, trade::OrderStatus to) {
+    return (allowedTransitions(from) & bit(to)) != 0;
+}
+
+OrderStore::Slot* OrderStore::slotAt(uint32_t index) const {
+    Slot* slab = slabs_[index / SLAB_SIZE].load(std::memory_order_acquire);
+    return slab ? &slab[index % SLAB_SIZE] : nullptr;
+}
+
+OrderStore::Slot* OrderStore::resolve(Handle handle) const {
+    if (handle == INVALID_HANDLE) {
+        return nullptr;
+    }
+
+    uint64_t index = (handle & 0xFFFFFFFFull) - 1;
+    if (index >= static_cast<uint64_t>(MAX_SLABS) * SLAB_SIZE) {
+        return nullptr;
+    }
+
+    Slot* slot = slotAt(static_cast<uint32_t>(index));
+    if (!slot || slot->generation.load(std::memory_order_acquire) != static_cast<uint32_t>(handle >> 32)) {
+        return nullptr;
+    }
+    return slot;
+}
+
+int32_t OrderStore::allocateSlot() {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    if (freeHead_ != NIL) {
+        int32_t index = freeHead_;
+        freeHead_ = slotAt(static_cast<uint32_t>(index))->nextFree;
+        return index;
+    }
+
+    if (nextFresh_ >= MAX_SLABS * SLAB_SIZE) {
+        return NIL;
+    }
+
+    // 当前块用尽时分配新块，已有块的地址不变
+    uint32_t slabIndex = nextFresh_ / SLAB_SIZE;
+    if (!slabs_[slabIndex].load(std::memory_order_relaxed)) {
+        Slot* slab = new Slot[SLAB_SIZE];
+        for (uint32_t i = 0; i < SLAB_SIZE; ++i) {
+            slab[i].generation.store(1, std::memory_order_relaxed);
+            slab[i].status.store(static_cast<int>(trade::OrderStatus::Unknown), std::memory_order_relaxed);
+            slab[i].cancelRequested.store(false, std::memory_order_relaxed);
+            slab[i].lock.clear(std::memory_order_relaxed);
+            slab[i].orderRef.store(0, std::memory_order_relaxed);
+            slab[i].nextFree = NIL;
+            for (int k = 0; k < LIST_COUNT; ++k) {
+                slab[i].prev[k] = NIL;
+                slab[i].next[k] = NIL;
+                slab[i].listHead[k] = NIL;
+            }
+        }
+        slabs_[slabIndex].store(slab, std::memory_order_release);
+        slabCount_.store(slabIndex + 1, std::memory_order_release);
+    }
+    return static_cast<int32_t>(nextFresh_++);
+}
+
+void OrderStore::freeSlot(int32_t index) {
+    Slot* slot = slotAt(static_cast<uint32_t>(index));
+
+    // 先增加代数使旧句柄失效，再清理数据
+    slot->generation.fetch_add(1, std::memory_order_acq_rel);
+    slot->status.store(static_cast<int>(trade::OrderStatus::Unknown), std::memory_order_release);
+    slot->cancelRequested.store(false, std::memory_order_relaxed);
+    {
+        SpinGuard guard(slot->lock);
+        slot->data = trade::OrderData();
+    }
+    slot->orderRef.store(0, std::memory_order_relaxed);
+    slot->nextFree = freeHead_;
+    freeHead_ = index;
+}
+
+std::atomic<uint64_t>* OrderStore::findRefEntry(int orderRef) const {
+    int64_t offset = static_cast<int64_t>(orderRef) - orderRefBase_.load(std::memory_order_relaxed);
+    if (offset < 0) {
+        return nullptr;
+    }
+    offset %= static_cast<int64_t>(MAX_SLABS) * SLAB_SIZE;
+
+    std::atomic<uint64_t>* slab = refSlabs_[offset / SLAB_SIZE].load(std::memory_order_acquire);
+    return slab ? &slab[offset % SLAB_SIZE] : nullptr;
+}
+
+std::atomic<uint64_t>* OrderStore::createRefEntry(int orderRef) {
+    int64_t offset = static_cast<int64_t>(orderRef) - orderRefBase_.load(std::memory_order_relaxed);
+    if (offset < 0) {
+        return nullptr;
+    }
+    offset %= static_cast<int64_t>(MAX_SLABS) * SLAB_SIZE;
+
+    std::atomic<uint64_t>* slab = refSlabs_[offset / SLAB_SIZE].load(std::memory_order_acquire);
+    if (!slab) {
+        std::lock_guard<std::mutex> lock(allocMutex_);
+        slab = refSlabs_[offset / SLAB_SIZE].load(std::memory_order_relaxed);
+        if (!slab) {
+            slab = new std::atomic<uint64_t>[SLAB_SIZE];
+            for (uint32_t i = 0; i < SLAB_SIZE; ++i) {
+                slab[i].store(INVALID_HANDLE, std::memory_order_relaxed);
+            }
+            refSlabs_[offset / SLAB_SIZE].store(slab, std::memory_order_release);
+        }
+    }
+    return &slab[offset % SLAB_SIZE];
+}
+
+std::string OrderStore::makeSysIdKey(const std::string& exchangeId, const std::string& orderSysId) {
+    return exchangeId + ":" + orderSysId;
+}
+
+OrderStore::SysIdShard& OrderStore::shardFor(const std::string& key) const {
+    return sysIdShards_[std::hash<std::string>()(key) % SYS_ID_SHARDS];
+}
+
+OrderStore::Handle OrderStore::create(const trade::OrderData& order, int orderRef) {
+    int32_t index = allocateSlot();
+    if (index == NIL) {
+        // 槽位用尽：回收已终结的订单后重试
+        purgeTerminal();
+        index = allocateSlot();
+        if (index == NIL) {
+            return INVALID_HANDLE;
+        }
+    }
+
+    Slot* slot = slotAt(static_cast<uint32_t>(index));
+    {
+        SpinGuard guard(slot->lock);
+        slot->data = order;
+        slot->data.status = trade::OrderStatus::Submitting;
+        slot->data.tradedVolume = 0;
+    }
+    slot->orderRef.store(orderRef, std::memory_order_relaxed);
+    slot->cancelRequested.store(false, std::memory_order_relaxed);
+    slot->status.store(static_cast<int>(trade::OrderStatus::Submitting), std::memory_order_release);
+
+    Handle handle = makeHandle(static_cast<uint32_t>(index), slot->generation.load(std::memory_order_relaxed));
+    std::atomic<uint64_t>* entry = createRefEntry(orderRef);
+    if (entry) {
+        entry->store(handle, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(listMutex_);
+        linkWorking(index);
+    }
+    workingCount_.fetch_add(1, std::memory_order_relaxed);
+    orderCount_.fetch_add(1, std::memory_order_relaxed);
+    return handle;
+}
+
+OrderStore::Handle OrderStore::findByOrderRef(int orderRef) const {
+    std::atomic<uint64_t>* entry = findRefEntry(orderRef);
+    if (!entry) {
+        return INVALID_HANDLE;
+    }
+
+    // 环形表项可能已被相隔一整圈的新报单引用覆盖
+    Handle handle = entry->load(std::memory_order_acquire);
+    Slot* slot = resolve(handle);
+    return slot && slot->orderRef.load(std::memory_order_relaxed) == orderRef ? handle : INVALID_HANDLE;
+}
+
+OrderStore::Handle OrderStore::findBySysId(const std::string& exchangeId, const std::string& orderSysId) const {
+    std::string key = makeSysIdKey(exchangeId, orderSysId);
+    SysIdShard& shard = shardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.handles.find(key);
+    return it != shard.handles.end() && resolve(it->second) ? it->second : INVALID_HANDLE;
+}
+
+OrderStore::Handle OrderStore::findByOrderId(const std::string& orderId) const {
+    size_t separator = orderId.rfind(':');
+    if (separator == std::string::npos) {
+        return INVALID_HANDLE;
+    }
+
+    Handle handle = findByOrderRef(std::atoi(orderId.c_str() + separator + 1));
+    Slot* slot = resolve(handle);
+    if (!slot) {
+        return INVALID_HANDLE;
+    }
+
+    // 报单引用只在本会话内唯一，核对完整编号排除其他会话的同号订单
+    SpinGuard guard(slot->lock);
+    return slot->data.orderId == orderId ? handle : INVALID_HANDLE;
+}
+
+void OrderStore::bindSysId(Handle handle, const std::string& exchangeId, const std::string& orderSysId) {
+    Slot* slot = resolve(handle);
+    if (!slot || orderSysId.empty()) {
+        return;
+    }
+
+    {
+        SpinGuard guard(slot->lock);
+        slot->data.exchangeId = exchangeId;
+        slot->data.orderSysId = orderSysId;
+    }
+
+    std::string key = makeSysIdKey(exchangeId, orderSysId);
+    SysIdShard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.handles[key] = handle;
+}
+
+bool OrderStore::transition(Handle handle, trade::OrderStatus status, int tradedVolume,
+                            const std::string& statusMsg, const std::string& updateTime) {
+    Slot* slot = resolve(handle);
+    if (!slot) {
+        return false;
+    }
+
+    {
+        SpinGuard guard(slot->lock);
+        trade::OrderStatus from = static_cast<trade::OrderStatus>(slot->status.load(std::memory_order_relaxed));
+        if (!isValidTransition(from, status)) {
+            return false;
+        }
+        // 成交数量只增不减，乱序到达的旧回报不覆盖新状态
+        if (tradedVolume >= 0 && tradedVolume < slot->data.tradedVolume) {
+            return false;
+        }
+
+        slot->data.status = status;
+        if (tradedVolume >= 0) {
+            slot->data.tradedVolume = tradedVolume;
+        }
+        if (!statusMsg.empty()) {
+            slot->data.statusMsg = statusMsg;
+        }
+        if (!updateTime.empty()) {
+            slot->data.updateTime = updateTime;
+        }
+        slot->status.store(static_cast<int>(status), std::memory_order_release);
+    }
+
+    // 进入终态的订单从挂单链表摘除
+    if (isTerminal(status)) {
+        std::lock_guard<std::mutex> lock(listMutex_);
+        unlinkWorking(static_cast<int32_t>((handle & 0xFFFFFFFFull) - 1));
+        workingCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool OrderStore::markCancelRequested(Handle handle) {
+    Slot* slot = resolve(handle);
+    if (!slot || isTerminal(static_cast<trade::OrderStatus>(slot->status.load(std::memory_order_acquire)))) {
+        return false;
+    }
+    return !slot->cancelRequested.exchange(true, std::memory_order_acq_rel);
+}
+
+bool OrderStore::get(Handle handle, trade::OrderData& order) const {
+    Slot* slot = resolve(handle);
+    if (!slot) {
+        return false;
+    }
+
+    SpinGuard guard(slot->lock);
+    order = slot->data;
+    return true;
+}
+
+trade::OrderStatus OrderStore::getStatus(Handle handle) const {
+    Slot* slot = resolve(handle);
+    return slot ? static_cast<trade::OrderStatus>(slot->status.load(std::memory_order_acquire))
+                : trade::OrderStatus::Unknown;
+}
+
+int32_t OrderStore::headIndex(ListKind kind, const std::string& key) {
+    if (kind == LIST_ALL) {
+        return 0;
+    }
+
+    std::unordered_map<std::string, int32_t>& heads = kind == LIST_STRATEGY ? strategyHeads_ : instrumentHeads_;
+    auto it = heads.find(key);
+    if (it != heads.end()) {
+        return it->second;
+    }
+
+    int32_t index = static_cast<int32_t>(headSlots_.size());
+    headSlots_.push_back(NIL);
+    heads[key] = index;
+    return index;
+}
+
+void OrderStore::linkWorking(int32_t index) {
+    Slot* slot = slotAt(static_cast<uint32_t>(index));
+    const int32_t heads[LIST_COUNT] = {
+        headIndex(LIST_ALL, std::string()),
+        headIndex(LIST_STRATEGY, slot->data.strategyId),
+        headIndex(LIST_INSTRUMENT, slot->data.symbol)
+    };
+
+    for (int kind = 0; kind < LIST_COUNT; ++kind) {
+        int32_t& head = headSlots_[heads[kind]];
+        slot->prev[kind] = NIL;
+        slot->next[kind] = head;
+        if (head != NIL) {
+            slotAt(static_cast<uint32_t>(head))->prev[kind] = index;
+        }
+        head = index;
+        slot->listHead[kind] = heads[kind];
+    }
+}
+
+void OrderStore::unlinkWorking(int32_t index) {
+    Slot* slot = slotAt(static_cast<uint32_t>(index));
+    for (int kind = 0; kind < LIST_COUNT; ++kind) {
+        if (slot->listHead[kind] == NIL) {
+            continue;
+        }
+
+        if (slot->prev[kind] != NIL) {
+            slotAt(static_cast<uint32_t>(slot->prev[kind]))->next[kind] = slot->next[kind];
+        } else {
+            headSlots_[slot->listHead[kind]] = slot->next[kind];
+        }
+        if (slot->next[kind] != NIL) {
+            slotAt(static_cast<uint32_t>(slot->next[kind]))->prev[kind] = slot->prev[kind];
+        }
+        slot->prev[kind] = NIL;
+        slot->next[kind] = NIL;
+        slot->listHead[kind] = NIL;
+    }
+}
+
+void OrderStore::collect(int32_t head, ListKind kind, std::vector<trade::OrderData>& result) const {
+    for (int32_t index = head; index != NIL;) {
+        Slot* slot = slotAt(static_cast<uint32_t>(index));
+        {
+            SpinGuard guard(slot->lock);
+            result.push_back(slot->data);
+        }
+        index = slot->next[kind];
+    }
+}
+
+std::vector<trade::OrderData> OrderStore::getWorkingOrders() const {
+    std::vector<trade::OrderData> result;
+    result.reserve(getWorkingCount());
+
+    std::lock_guard<std::mutex> lock(listMutex_);
+    collect(headSlots_[0], LIST_ALL, result);
+    return result;
+}
+
+std::vector<trade::OrderData> OrderStore::getWorkingOrdersByStrategy(const std::string& strategyId) const {
+    std::vector<trade::OrderData> result;
+
+    std::lock_guard<std::mutex> lock(listMutex_);
+    auto it = strategyHeads_.find(strategyId);
+    if (it != strategyHeads_.end()) {
+        collect(headSlots_[it->second], LIST_STRATEGY, result);
+    }
+    return result;
+}
+
+std::vector<trade::OrderData> OrderStore::getWorkingOrdersByInstrument(const std::string& symbol) const {
+    std::vector<trade::OrderData> result;
+
+    std::lock_guard<std::mutex> lock(listMutex_);
+    auto it = instrumentHeads_.find(symbol);
+    if (it != instrumentHeads_.end()) {
+        collect(headSlots_[it->second], LIST_INSTRUMENT, result);
+    }
+    return result;
+}
+
+void OrderStore::purgeTerminal() {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    for (uint32_t index = 0; index < nextFresh_; ++index) {
+        Slot* slot = slotAt(index);
+        trade::OrderStatus status = static_cast<trade::OrderStatus>(slot->status.load(std::memory_order_acquire));
+        if (!isTerminal(status)) {
+            continue;
+        }
+
+        Handle handle = makeHandle(index, slot->generation.load(std::memory_order_relaxed));
+        std::atomic<uint64_t>* entry = findRefEntry(slot->orderRef.load(std::memory_order_relaxed));
+        if (entry && entry->load(std::memory_order_relaxed) == handle) {
+            entry->store(INVALID_HANDLE, std::memory_order_release);
+        }
+
+        std::string sysId;
+        std::string exchangeId;
+        {
+            SpinGuard guard(slot->lock);
+            sysId = slot->data.orderSysId;
+            exchangeId = slot->data.exchangeId;
+        }
+        if (!sysId.empty()) {
+            std::string key = makeSysIdKey(exchangeId, sysId);
+            SysIdShard& shard = shardFor(key);
+            std::lock_guard<std::mutex> shardLock(shard.mutex);
+            shard.handles.erase(key);
+        }
+
+        freeSlot(static_cast<int32_t>(index));
+        orderCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 本地订单存储（OMS）
+// 订单保存在按块分配、地址固定的槽位中，以整数句柄引用。句柄带代数，槽位回收后旧句柄自动失效。
+// - 订单状态是槽位上的原子量，按显式状态机迁移，非法或过期的回报被拒绝；读状态不加锁；
+// - 按本会话的报单引用（OrderRef）查找是环形数组下标，不加锁；按交易所编号（OrderSysID）查找走分段加锁的哈希表；
+// - 每个策略、每个合约各有一条挂单的侵入式双向链表，订单进入终态时O(1)摘除，
+//   查询挂单只遍历链表而不扫描全部订单。链表只在新订单和订单终结时加锁修改；
+// - 订单其余字段由槽位自旋锁保护，只在同一订单的读写之间竞争。
+class OrderStore {
+public:
+    typedef uint64_t Handle;
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    static constexpr uint32_t SLAB_SIZE = 4096;     // 每块槽位数
+    static constexpr uint32_t MAX_SLABS = 256;      // 最多块数（约一百万笔订单）
+
+    OrderStore();
+    ~OrderStore();
+
+    // 禁止拷贝和赋值
+    OrderStore(const OrderStore&) = delete;
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    // 设置本会话报单引用的起点（登录时取MaxOrderRef），之后的报单引用从该值开始递增
+    void setOrderRefBase(int base) { orderRefBase_.store(base, std::memory_order_relaxed); }
+
+    // 登记新订单，状态为Submitting，加入策略和合约的挂单链表；槽位用尽时先回收已终结的订单，
+    // 仍无空闲槽位（全部为挂单）返回INVALID_HANDLE
+    Handle create(const trade::OrderData& order, int orderRef);
+
+    // 查找订单
+    Handle findByOrderRef(int orderRef) const;
+    Handle findBySysId(const std::string& exchangeId, const std::string& orderSysId) const;
+
+    // 按"FrontID:SessionID:OrderRef"格式的订单编号查找，本会话的订单走报单引用下标
+    Handle findByOrderId(const std::string& orderId) const;
+
+    // 登记交易所订单编号（首次收到交易所回报时调用）
+    void bindSysId(Handle handle, const std::string& exchangeId, const std::string& orderSysId);
+
+    // 状态迁移，非法迁移（如终态之后的回报、乱序的旧状态）返回false且不修改订单；
+    // tradedVolume小于0时不修改成交数量
+    bool transition(Handle handle, trade::OrderStatus status, int tradedVolume = -1,
+                    const std::string& statusMsg = "", const std::string& updateTime = "");
+
+    // 标记已发出撤单，已标记或已终结时返回false，避免重复撤单
+    bool markCancelRequested(Handle handle);
+
+    // 读取订单，句柄失效返回false
+    bool get(Handle handle, trade::OrderData& order) const;
+
+    // 读取订单状态（不加锁），句柄失效返回Unknown
+    trade::OrderStatus getStatus(Handle handle) const;
+
+    // 挂单查询，只遍历挂单链表（按策略、按合约查询只遍历该策略、该合约的链表）
+    std::vector<trade::OrderData> getWorkingOrders() const;
+    std::vector<trade::OrderData> getWorkingOrdersByStrategy(const std::string& strategyId) const;
+    std::vector<trade::OrderData> getWorkingOrdersByInstrument(const std::string& symbol) const;
+
+    // 挂单数量
+    size_t getWorkingCount() const { return workingCount_.load(std::memory_order_relaxed); }
+
+    // 已登记的订单数量（含已终结）
+    size_t getOrderCount() const { return orderCount_.load(std::memory_order_relaxed); }
+
+    // 回收所有已终结的订单（登录、交易日切换和槽位用尽时调用），旧句柄随之失效
+    void purgeTerminal();
+
+    // 状态机：from状态能否迁移到to状态
+    static bool isValidTransition(trade::OrderStatus from, trade::OrderStatus to);
+    static bool isTerminal(trade::OrderStatus status);
+
+private:
+    static constexpr int32_t NIL = -1;
+
+    // 侵入式链表的三条链：全部挂单、按策略、按合约
+    enum ListKind { LIST_ALL = 0, LIST_STRATEGY = 1, LIST_INSTRUMENT = 2, LIST_COUNT = 3 };
+
+    struct Slot {
+        std::atomic<uint32_t> generation;   // 槽位代数，与句柄高32位比较
+        std::atomic<int> status;            // trade::OrderStatus
+        std::atomic<bool> cancelRequested;
+        std::atomic_flag lock;              // 保护data
+        trade::OrderData data;
+        std::atomic<int> orderRef;          // 报单引用表为环形，查找时核对
+        int32_t prev[LIST_COUNT];           // 挂单链表（在listMutex_下修改）
+        int32_t next[LIST_COUNT];
+        int32_t listHead[LIST_COUNT];       // 所在链表的表头编号，-1表示不在链表中
+        int32_t nextFree;                   // 空闲链表
+    };
+
+    // OrderSysID查找表的分段
+    struct SysIdShard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Handle> handles;
+    };
+    static constexpr size_t SYS_ID_SHARDS = 16;
+
+    // 槽位编号与句柄互相转换
+    static Handle makeHandle(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+    Slot* resolve(Handle handle) const;
+    Slot* slotAt(uint32_t index) const;
+
+    // 分配和回收槽位
+    int32_t allocateSlot();
+    void freeSlot(int32_t index);
+
+    // 挂单链表操作（持有listMutex_时调用）
+    int32_t headIndex(ListKind kind, const std::string& key);
+    void linkWorking(int32_t index);
+    void unlinkWorking(int32_t index);
+    void collect(int32_t head, ListKind kind, std::vector<trade::OrderData>& result) const;
+
+    // 报单引用下标表的表项，超出范围返回nullptr
+    std::atomic<uint64_t>* findRefEntry(int orderRef) const;
+    std::atomic<uint64_t>* createRefEntry(int orderRef);
+
+    // OrderSysID查找表的键和分段
+    static std::string makeSysIdKey(const std::string& exchangeId, const std::string& orderSysId);
+    SysIdShard& shardFor(const std::string& key) const;
+
+    // 槽位块，地址固定
+    std::atomic<Slot*> slabs_[MAX_SLABS];
+    std::atomic<uint32_t> slabCount_;
+    uint32_t nextFresh_;
+    int32_t freeHead_;
+    std::mutex allocMutex_;
+
+    // 报单引用到句柄，按块分配；以登录时的起点为零点环形使用，被覆盖的旧表项由核对报单引用排除
+    std::atomic<std::atomic<uint64_t>*> refSlabs_[MAX_SLABS];
+    std::atomic<int> orderRefBase_;
+
+    // 交易所订单编号到句柄
+    mutable SysIdShard sysIdShards_[SYS_ID_SHARDS];
+
+    // 挂单链表表头：headSlots_[0]为全部挂单，其余为各策略、各合约，链表中的槽位记录所在表头的编号
+    std::unordered_map<std::string, int32_t> strategyHeads_;
+    std::unordered_map<std::string, int32_t> instrumentHeads_;
+    std::vector<int32_t> headSlots_;
+    mutable std::mutex listMutex_;
+
+    std::atomic<size_t> workingCount_;
+    std::atomic<size_t> orderCount_;
+};
@@ -0,0 +1,130 @@
+#include "OrderTemplateCache.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// 复制字符串到定长字段，保证以0结尾
+template <size_t N>
+void copyField(char (&field)[N], const std::string& value) {
+    size_t length = value.size() < N - 1 ? value.size() : N - 1;
+    std::memcpy(field, value.data(), length);
+    field[length] = '\0';
+}
+
+char toOffsetFlag(trade::OrderOffset offset) {
+    switch (offset) {
+        case trade::OrderOffset::Open: return THOST_FTDC_OF_Open;
+        case trade::OrderOffset::Close: return THOST_FTDC_OF_Close;
+        case trade::OrderOffset::CloseToday: return THOST_FTDC_OF_CloseToday;
+        case trade::OrderOffset::CloseYesterday: return THOST_FTDC_OF_CloseYesterday;
+    }
+    return THOST_FTDC_OF_Open;
+}
+
+} // namespace
+
+OrderTemplateCache::OrderTemplateCache() {
+}
+
+void OrderTemplateCache::setSession(const std::string& brokerId, const std::string& investorId,
+                                    const std::string& userId, int frontId, int sessionId) {
+    brokerId_ = brokerId;
+    investorId_ = investorId;
+    userId_ = userId;
+    orderIdPrefix_ = std::to_string(frontId) + ":" + std::to_string(sessionId) + ":";
+
+    for (auto& templates : templates_) {
+        fillSession(templates.side[0]);
+        fillSession(templates.side[1]);
+    }
+}
+
+void OrderTemplateCache::fillSession(CThostFtdcInputOrderField& field) const {
+    copyField(field.BrokerID, brokerId_);
+    copyField(field.InvestorID, investorId_);
+    copyField(field.UserID, userId_);
+}
+
+void OrderTemplateCache::fillTemplate(CThostFtdcInputOrderField& field, const std::string& symbol,
+                                      const std::string& exchangeId, char direction) const {
+    std::memset(&field, 0, sizeof(field));
+    fillSession(field);
+    copyField(field.InstrumentID, symbol);
+    copyField(field.ExchangeID, exchangeId);
+
+    field.Direction = direction;
+    field.OrderPriceType = THOST_FTDC_OPT_LimitPrice;
+    field.CombOffsetFlag[0] = THOST_FTDC_OF_Open;
+    field.CombHedgeFlag[0] = THOST_FTDC_HF_Speculation;    // 投机
+    field.TimeCondition = THOST_FTDC_TC_GFD;               // 当日有效
+    field.VolumeCondition = THOST_FTDC_VC_AV;              // 任意数量
+    field.MinVolume = 1;
+    field.ContingentCondition = THOST_FTDC_CC_Immediately; // 立即触发
+    field.ForceCloseReason = THOST_FTDC_FCC_NotForceClose; // 非强平
+    field.IsAutoSuspend = 0;
+    field.UserForceClose = 0;
+}
+
+int OrderTemplateCache::addInstrument(const std::string& symbol, const std::string& exchangeId) {
+    int index = findInstrument(symbol);
+    if (index >= 0) {
+        return index;
+    }
+
+    index = static_cast<int>(templates_.size());
+    templates_.emplace_back();
+    fillTemplate(templates_.back().side[0], symbol, exchangeId, THOST_FTDC_D_Buy);
+    fillTemplate(templates_.back().side[1], symbol, exchangeId, THOST_FTDC_D_Sell);
+    index_[symbol] = index;
+    return index;
+}
+
+int OrderTemplateCache::findInstrument(const std::string& symbol) const {
+    auto it = index_.find(symbol);
+    return it != index_.end() ? it->second : -1;
+}
+
+CThostFtdcInputOrderField* OrderTemplateCache::prepare(int instrument, const trade::OrderData& order,
+                                                       int orderRef, int requestId) {
+    if (instrument < 0 || static_cast<size_t>(instrument) >= templates_.size()) {
+        return nullptr;
+    }
+
+    CThostFtdcInputOrderField& field =
+        templates_[instrument].side[order.direction == trade::OrderDirection::Buy ? 0 : 1];
+
+    size_t length = formatOrderRef(orderRef, field.OrderRef, sizeof(field.OrderRef));
+    field.OrderRef[length] = '\0';
+    field.LimitPrice = order.price;
+    field.VolumeTotalOriginal = order.volume;
+    field.CombOffsetFlag[0] = toOffsetFlag(order.offset);
+    field.RequestID = requestId;
+
+    // 市价单按任意价、立即成交剩余撤销发送
+    if (order.priceType == trade::OrderPriceType::Limit) {
+        field.OrderPriceType = THOST_FTDC_OPT_LimitPrice;
+        field.TimeCondition = THOST_FTDC_TC_GFD;
+    } else {
+        field.OrderPriceType = THOST_FTDC_OPT_AnyPrice;
+        field.TimeCondition = THOST_FTDC_TC_IOC;
+    }
+    return &field;
+}
+
+size_t OrderTemplateCache::formatOrderRef(int orderRef, char* buffer, size_t size) {
+    // 预留结尾的0
+    std::to_chars_result result = std::to_chars(buffer, buffer + size - 1, orderRef);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buffer) : 0;
+}
+
+std::string OrderTemplateCache::makeOrderId(int orderRef) const {
+    char buffer[16];
+    size_t length = formatOrderRef(orderRef, buffer, sizeof(buffer));
+
+    std::string orderId;
+    orderId.reserve(orderIdPrefix_.size() + length);
+    orderId.append(orderIdPrefix_);
+    orderId.append(buffer, length);
+    return orderId;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include "../MarketData/API/CTP/ThostFtdcUserApiStruct.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+// 报单模板缓存
+// 登录后为每个合约的买、卖方向各建立一个预先填好的CThostFtdcInputOrderField（经纪公司、投资者、
+// 合约、交易所、投机套保、有效期、成交量条件等固定字段），报单时只在模板上改写价格、数量、
+// 开平、价格类型和报单引用，不再逐个strncpy。报单引用和订单编号用整数格式化，不经过std::to_string。
+// 非线程安全：模板被原地改写后交给API发送，调用方需保证同一时刻只有一个发送线程
+// （CTPTradeFeed在apiMutex_内调用）。
+class OrderTemplateCache {
+public:
+    OrderTemplateCache();
+
+    // 设置会话参数（登录成功后调用），已建立的模板同步更新
+    void setSession(const std::string& brokerId, const std::string& investorId, const std::string& userId,
+                    int frontId, int sessionId);
+
+    // 为合约建立买、卖两个模板，返回合约编号；已存在时直接返回
+    int addInstrument(const std::string& symbol, const std::string& exchangeId);
+
+    // 查找合约编号，未建立返回-1
+    int findInstrument(const std::string& symbol) const;
+
+    // 在模板上写入本笔订单的可变字段并返回模板地址，指针在下一次prepare之前有效
+    CThostFtdcInputOrderField* prepare(int instrument, const trade::OrderData& order, int orderRef, int requestId);
+
+    // 生成"FrontID:SessionID:OrderRef"格式的订单编号，前缀在登录时生成，只分配一次
+    std::string makeOrderId(int orderRef) const;
+
+    // 格式化报单引用，不分配内存，返回写入的字符数（不含结尾的0）
+    static size_t formatOrderRef(int orderRef, char* buffer, size_t size);
+
+    size_t getInstrumentCount() const { return templates_.size(); }
+
+private:
+    // 单个合约的买卖模板
+    struct InstrumentTemplates {
+        CThostFtdcInputOrderField side[2];   // 0为买，1为卖
+    };
+
+    // 填写模板的固定字段
+    void fillTemplate(CThostFtdcInputOrderField& field, const std::string& symbol,
+                      const std::string& exchangeId, char direction) const;
+
+    // 写入会话相关字段
+    void fillSession(CThostFtdcInputOrderField& field) const;
+
+    std::string brokerId_;
+    std::string investorId_;
+    std::string userId_;
+    std::string orderIdPrefix_;
+
+    // 模板按合约编号存放，deque保证扩容时已有模板地址不变
+    std::deque<InstrumentTemplates> templates_;
+    std::unordered_map<std::string, int> index_;
+};
@@ -0,0 +1,198 @@
+#include "PositionLedger.h"
+#include <algorithm>
+
+PositionLedger::PositionLedger()
+    : closeTodayExchanges_({"SHFE", "INE"}),
+      loaded_(false) {
+}
+
+void PositionLedger::setCloseTodayExchanges(const std::vector<std::string>& exchanges) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeTodayExchanges_ = std::unordered_set<std::string>(exchanges.begin(), exchanges.end());
+    for (Entry& entry : entries_) {
+        entry.closeTodayRequired = closeTodayExchanges_.count(entry.exchangeId) != 0;
+    }
+}
+
+void PositionLedger::setInstrumentExchange(const std::string& symbol, const std::string& exchangeId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setExchange(entries_[entryFor(symbol)], exchangeId);
+}
+
+void PositionLedger::load(const std::vector<trade::PositionData>& positions) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 柜台没有返回的合约已无持仓
+    for (Entry& entry : entries_) {
+        for (LedgerPosition& side : entry.sides) {
+            side.today = 0;
+            side.yesterday = 0;
+        }
+    }
+
+    for (const trade::PositionData& position : positions) {
+        Entry& entry = entries_[entryFor(position.symbol)];
+        if (!position.exchangeId.empty()) {
+            setExchange(entry, position.exchangeId);
+        }
+        LedgerPosition& side = entry.sides[sideIndex(position.direction)];
+        side.today = position.todayPosition;
+        side.yesterday = position.yesterdayPosition;
+    }
+    loaded_ = true;
+}
+
+bool PositionLedger::isLoaded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_;
+}
+
+CloseSplit PositionLedger::splitClose(const trade::OrderData& order) {
+    CloseSplit split;
+    if (order.offset != trade::OrderOffset::Close) {
+        split.count = 1;
+        split.legs[0] = order;
+        return split;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[entryFor(order.symbol)];
+    if (!order.exchangeId.empty()) {
+        setExchange(entry, order.exchangeId);
+    }
+    if (!loaded_) {
+        split.count = 1;
+        split.legs[0] = order;
+        return split;
+    }
+
+    LedgerPosition& position = entry.sides[closedSide(order.direction)];
+    split.frozen = true;
+
+    // 不分今昨的交易所：一笔Close，冻结记在昨仓，可平数量按今昨合计
+    if (!entry.closeTodayRequired) {
+        int volume = std::min(order.volume, position.available());
+        if (volume > 0) {
+            split.legs[0] = order;
+            split.legs[0].volume = volume;
+            position.frozenYesterday += volume;
+            split.count = 1;
+        }
+        return split;
+    }
+
+    // 先平昨仓再平今仓
+    int yesterdayVolume = std::max(0, std::min(order.volume, position.availableYesterday()));
+    int todayVolume = std::max(0, std::min(order.volume - yesterdayVolume, position.availableToday()));
+    if (yesterdayVolume > 0) {
+        trade::OrderData& leg = split.legs[split.count++];
+        leg = order;
+        leg.offset = trade::OrderOffset::CloseYesterday;
+        leg.volume = yesterdayVolume;
+        position.frozenYesterday += yesterdayVolume;
+    }
+    if (todayVolume > 0) {
+        trade::OrderData& leg = split.legs[split.count++];
+        leg = order;
+        leg.offset = trade::OrderOffset::CloseToday;
+        leg.volume = todayVolume;
+        position.frozenToday += todayVolume;
+    }
+    return split;
+}
+
+void PositionLedger::release(const trade::OrderData& leg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[entryFor(leg.symbol)];
+    unfreeze(entry.sides[closedSide(leg.direction)], bucketFor(leg.offset), leg.volume);
+}
+
+void PositionLedger::bindOrder(const std::string& orderId, const trade::OrderData& leg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Binding binding;
+    binding.entry = entryFor(leg.symbol);
+    binding.side = closedSide(leg.direction);
+    binding.bucket = bucketFor(leg.offset);
+    binding.remaining = leg.volume;
+    bindings_[orderId] = binding;
+}
+
+void PositionLedger::onTrade(const trade::TradeData& trade) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t index = entryFor(trade.symbol);
+    Entry& entry = entries_[index];
+    if (!trade.exchangeId.empty() && entry.exchangeId.empty()) {
+        setExchange(entry, trade.exchangeId);
+    }
+
+    if (trade.offset == trade::OrderOffset::Open) {
+        entry.sides[sideIndex(trade.direction)].today += trade.volume;
+        return;
+    }
+
+    LedgerPosition& position = entry.sides[closedSide(trade.direction)];
+    if (trade.offset == trade::OrderOffset::CloseToday) {
+        position.today = std::max(0, position.today - trade.volume);
+    } else if (trade.offset == trade::OrderOffset::CloseYesterday || entry.closeTodayRequired) {
+        position.yesterday = std::max(0, position.yesterday - trade.volume);
+    } else {
+        // 不分今昨的交易所先平昨仓
+        int fromYesterday = std::min(position.yesterday, trade.volume);
+        position.yesterday -= fromYesterday;
+        position.today = std::max(0, position.today - (trade.volume - fromYesterday));
+    }
+
+    // 已成交的部分不再冻结
+    auto it = bindings_.find(trade.orderId);
+    if (it != bindings_.end()) {
+        int filled = std::min(it->second.remaining, trade.volume);
+        it->second.remaining -= filled;
+        unfreeze(entries_[it->second.entry].sides[it->second.side], it->second.bucket, filled);
+        if (it->second.remaining == 0) {
+            bindings_.erase(it);
+        }
+    }
+}
+
+void PositionLedger::onOrder(const trade::OrderData& order) {
+    if (order.status != trade::OrderStatus::Filled && order.status != trade::OrderStatus::Canceled &&
+        order.status != trade::OrderStatus::Rejected) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = bindings_.find(order.orderId);
+    if (it == bindings_.end()) {
+        return;
+    }
+    unfreeze(entries_[it->second.entry].sides[it->second.side], it->second.bucket, it->second.remaining);
+    bindings_.erase(it);
+}
+
+LedgerPosition PositionLedger::getPosition(const std::string& symbol, trade::OrderDirection side) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(symbol);
+    return it == index_.end() ? LedgerPosition() : entries_[it->second].sides[sideIndex(side)];
+}
+
+size_t PositionLedger::entryFor(const std::string& symbol) {
+    auto it = index_.find(symbol);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    entries_.emplace_back();
+    entries_.back().closeTodayRequired = false;
+    index_.emplace(symbol, entries_.size() - 1);
+    return entries_.size() - 1;
+}
+
+void PositionLedger::setExchange(Entry& entry, const std::string& exchangeId) {
+    entry.exchangeId = exchangeId;
+    entry.closeTodayRequired = closeTodayExchanges_.count(exchangeId) != 0;
+}
+
+void PositionLedger::unfreeze(LedgerPosition& position, Bucket bucket, int volume) {
+    int& value = frozen(position, bucket);
+    value = std::max(0, value - volume);
+}
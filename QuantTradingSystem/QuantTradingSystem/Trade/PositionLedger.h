@@ -0,0 +1,123 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 单边持仓：今仓、昨仓及被挂出的平仓单冻结的数量
+struct LedgerPosition {
+    int today;
+    int yesterday;
+    int frozenToday;
+    int frozenYesterday;
+
+    LedgerPosition() : today(0), yesterday(0), frozenToday(0), frozenYesterday(0) {}
+
+    int availableToday() const { return today - frozenToday; }
+    int availableYesterday() const { return yesterday - frozenYesterday; }
+    int available() const { return availableToday() + availableYesterday(); }
+};
+
+// 平仓单拆分结果
+struct CloseSplit {
+    static const int MAX_LEGS = 2;
+
+    int count;                            // 笔数，没有可平持仓时为0
+    bool frozen;                          // 是否已冻结持仓，冻结的各笔需在发出后bindOrder或未发出时release
+    trade::OrderData legs[MAX_LEGS];
+
+    CloseSplit() : count(0), frozen(false) {}
+};
+
+// 持仓台账
+// 按合约和多空方向记录今仓、昨仓，柜台持仓查询后整体装入，之后由成交回报增量维护。
+// 上期所、能源中心等区分平今平昨的交易所，平仓单按可平的今仓、昨仓拆成CloseToday和CloseYesterday两笔，
+// 避免被交易所拒单后再重发；其他交易所保持Close一笔。拆出的平仓单立即冻结对应数量，
+// 订单终结时解冻未成交部分，挂单期间不会被重复平仓。合约查找是哈希表，拆单和回报处理都是O(1)。
+// 线程安全：信号线程拆单，回报线程更新，由一把锁保护，临界区只有几次整数运算。
+class PositionLedger {
+public:
+    PositionLedger();
+
+    // 区分平今平昨的交易所，默认SHFE和INE
+    void setCloseTodayExchanges(const std::vector<std::string>& exchanges);
+
+    // 合约所属交易所（查询和成交回报也会带上交易所）
+    void setInstrumentExchange(const std::string& symbol, const std::string& exchangeId);
+
+    // 以柜台持仓重建今仓、昨仓，冻结数量保留
+    void load(const std::vector<trade::PositionData>& positions);
+
+    // 是否已装入过柜台持仓，未装入时不拆单
+    bool isLoaded() const;
+
+    // 把Close平仓单按可平的昨仓、今仓拆成至多两笔（先平昨）并冻结，可平数量不足时只拆出可平部分；
+    // 开仓单、指定了平今或平昨的订单以及尚未装入持仓时原样返回一笔且不冻结
+    CloseSplit splitClose(const trade::OrderData& order);
+
+    // 拆出的平仓单未发出（风控拒绝或发送失败）时解冻
+    void release(const trade::OrderData& leg);
+
+    // 拆出的平仓单发出后按订单编号登记，订单终结时解冻未成交部分
+    void bindOrder(const std::string& orderId, const trade::OrderData& leg);
+
+    // 成交回报：开仓增加今仓，平仓按开平标志减少今仓或昨仓
+    void onTrade(const trade::TradeData& trade);
+
+    // 订单回报：已登记的平仓单终结时解冻
+    void onOrder(const trade::OrderData& order);
+
+    // 查询单边持仓，side为持仓方向（Buy为多头）
+    LedgerPosition getPosition(const std::string& symbol, trade::OrderDirection side) const;
+
+private:
+    enum Bucket { TODAY, YESTERDAY };
+
+    struct Entry {
+        std::string exchangeId;
+        bool closeTodayRequired;
+        LedgerPosition sides[2];   // 0多头、1空头
+    };
+
+    // 已发出的平仓单冻结的数量
+    struct Binding {
+        size_t entry;
+        int side;
+        Bucket bucket;
+        int remaining;
+    };
+
+    // 查找或建立合约（持有mutex_时调用）
+    size_t entryFor(const std::string& symbol);
+    void setExchange(Entry& entry, const std::string& exchangeId);
+
+    static int sideIndex(trade::OrderDirection side) { return side == trade::OrderDirection::Buy ? 0 : 1; }
+
+    // 平仓单平的是反方向的持仓
+    static int closedSide(trade::OrderDirection orderDirection) {
+        return orderDirection == trade::OrderDirection::Sell ? 0 : 1;
+    }
+
+    // 平仓单冻结和成交对应的持仓：平今为今仓，其余（平昨；不分今昨的交易所的平仓先平昨仓）记在昨仓
+    static Bucket bucketFor(trade::OrderOffset offset) {
+        return offset == trade::OrderOffset::CloseToday ? TODAY : YESTERDAY;
+    }
+
+    static int& frozen(LedgerPosition& position, Bucket bucket) {
+        return bucket == TODAY ? position.frozenToday : position.frozenYesterday;
+    }
+
+    // 解冻，不低于0
+    static void unfreeze(LedgerPosition& position, Bucket bucket, int volume);
+
+    std::unordered_set<std::string> closeTodayExchanges_;
+    std::unordered_map<std::string, size_t> index_;
+    std::deque<Entry> entries_;
+    std::unordered_map<std::string, Binding> bindings_;
+    bool loaded_;
+    mutable std::mutex mutex_;
+};
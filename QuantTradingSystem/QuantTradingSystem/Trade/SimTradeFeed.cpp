@@ -0,0 +1,745 @@
+#include "SimTradeFeed.h"
+#include "../Utils/config/ConfigManager.h"
+#include "../Utils/latency/LatencyTrace.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include "../Utils/thread/ThreadUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 价格转为整数比较，避免浮点误差
+const double PRICE_SCALE = 10000.0;
+
+// 本会话的前置编号和会话编号
+const char* const SIM_FRONT_ID = "1";
+const char* const SIM_SESSION_ID = "1";
+
+// 最近的待处理事件在该时间内到期时让出时间片轮询，否则睡眠等待
+const int64_t SPIN_THRESHOLD_NS = 200000;
+
+// 小顶堆比较：到期时间早的在前，同时到期按序号
+struct LaterEvent {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a->due != b->due ? a->due > b->due : a->seq > b->seq;
+    }
+};
+
+} // namespace
+
+SimTradeFeed::SimTradeFeed()
+    : connected_(false),
+      loggedIn_(false),
+      running_(false),
+      orderRef_(0),
+      sleeping_(false),
+      nextSeq_(0),
+      nextTradeId_(0),
+      rng_(12345),
+      closeProfit_(0.0),
+      commission_(0.0),
+      ordersReceived_(MetricsRegistry::getInstance().getCounter("sim.orders_received")),
+      ordersRejected_(MetricsRegistry::getInstance().getCounter("sim.orders_rejected")),
+      fills_(MetricsRegistry::getInstance().getCounter("sim.fills")),
+      restingOrders_(MetricsRegistry::getInstance().getGauge("sim.resting_orders")) {
+}
+
+SimTradeFeed::~SimTradeFeed() {
+    Release();
+}
+
+bool SimTradeFeed::Init(const std::string& config) {
+    if (config.empty()) {
+        return true;
+    }
+
+    auto& configManager = QuantTrading::ConfigManager::getInstance();
+    if (!configManager.loadConfig(config)) {
+        return false;
+    }
+
+    SimFeedConfig settings;
+    settings.ackLatencyUs = configManager.getValue<int64_t>("sim.ack_latency_us", settings.ackLatencyUs);
+    settings.fillLatencyUs = configManager.getValue<int64_t>("sim.fill_latency_us", settings.fillLatencyUs);
+    settings.rejectRate = configManager.getValue<double>("sim.reject_rate", settings.rejectRate);
+    settings.queueModel = configManager.getValue<bool>("sim.queue_model", settings.queueModel);
+    settings.checkPriceLimits = configManager.getValue<bool>("sim.check_price_limits", settings.checkPriceLimits);
+    settings.initialBalance = configManager.getValue<double>("sim.initial_balance", settings.initialBalance);
+    settings.commissionPerLot = configManager.getValue<double>("sim.commission_per_lot", settings.commissionPerLot);
+    settings.defaultMultiplier = configManager.getValue<double>("sim.default_multiplier", settings.defaultMultiplier);
+    settings.multipliers = configManager.getValue<std::map<std::string, double>>(
+        "sim.multipliers", settings.multipliers);
+    settings.seed = configManager.getValue<unsigned int>("sim.seed", settings.seed);
+
+    setConfig(settings);
+    return true;
+}
+
+void SimTradeFeed::setConfig(const SimFeedConfig& config) {
+    if (running_) {
+        return;
+    }
+    config_ = config;
+    rng_.seed(config.seed);
+}
+
+void SimTradeFeed::Release() {
+    Disconnect();
+}
+
+bool SimTradeFeed::Connect() {
+    if (running_) {
+        return true;
+    }
+
+    running_ = true;
+    matchThread_ = std::thread(&SimTradeFeed::matchLoop, this);
+    connected_ = true;
+    return true;
+}
+
+void SimTradeFeed::Disconnect() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        running_ = false;
+    }
+    inboxCondition_.notify_all();
+    if (matchThread_.joinable()) {
+        matchThread_.join();
+    }
+    connected_ = false;
+    loggedIn_ = false;
+}
+
+bool SimTradeFeed::IsConnected() const {
+    return connected_;
+}
+
+bool SimTradeFeed::Login(const std::string& userId, const std::string& /*password*/) {
+    if (!connected_) {
+        return false;
+    }
+    if (loggedIn_) {
+        return true;
+    }
+
+    userId_ = userId;
+    orderIdPrefix_ = std::string(SIM_FRONT_ID) + ":" + SIM_SESSION_ID + ":";
+    orderStore_.purgeTerminal();
+    orderStore_.setOrderRefBase(orderRef_.load() + 1);
+    loggedIn_ = true;
+    return true;
+}
+
+bool SimTradeFeed::Logout() {
+    if (!loggedIn_) {
+        return false;
+    }
+    loggedIn_ = false;
+    return true;
+}
+
+bool SimTradeFeed::IsLoggedIn() const {
+    return loggedIn_;
+}
+
+std::string SimTradeFeed::PlaceOrder(const trade::OrderData& orderData) {
+    if (!connected_ || !loggedIn_) {
+        return "";
+    }
+
+    int orderRef = orderRef_.fetch_add(1) + 1;
+    std::unique_ptr<Order> order(new Order());
+    order->data = orderData;
+    order->data.orderRef = std::to_string(orderRef);
+    order->data.orderId = orderIdPrefix_ + order->data.orderRef;
+    order->data.frontId = SIM_FRONT_ID;
+    order->data.sessionId = SIM_SESSION_ID;
+    order->data.accountId = userId_;
+    order->data.status = trade::OrderStatus::Submitting;
+    order->data.tradedVolume = 0;
+
+    order->handle = orderStore_.create(order->data, orderRef);
+    if (order->handle == OrderStore::INVALID_HANDLE) {
+        return "";
+    }
+
+    order->orderRef = orderRef;
+    order->buy = orderData.direction == trade::OrderDirection::Buy;
+    if (orderData.priceType == trade::OrderPriceType::Market) {
+        order->priceKey = order->buy ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    } else {
+        order->priceKey = toPriceKey(orderData.price);
+    }
+    order->remaining = orderData.volume;
+    order->traded = 0;
+    order->queueAhead = 0;
+    order->lastReportAt = 0;
+    order->resting = false;
+    order->book = nullptr;
+    ordersReceived_.add();
+
+    std::string orderId = order->data.orderId;
+    EventPtr event(new Event());
+    event->kind = Event::ORDER_ARRIVE;
+    event->due = latencyNow() + config_.ackLatencyUs * 1000;
+    event->order = std::move(order);
+    post(std::move(event));
+    return orderId;
+}
+
+bool SimTradeFeed::CancelOrder(const std::string& orderId) {
+    if (!connected_ || !loggedIn_) {
+        return false;
+    }
+
+    OrderStore::Handle handle = orderStore_.findByOrderId(orderId);
+    trade::OrderData orderData;
+    if (!orderStore_.get(handle, orderData) || !orderStore_.markCancelRequested(handle)) {
+        return false;
+    }
+
+    EventPtr event(new Event());
+    event->kind = Event::CANCEL_ARRIVE;
+    event->due = latencyNow() + config_.ackLatencyUs * 1000;
+    event->orderRef = std::atoi(orderData.orderRef.c_str());
+    post(std::move(event));
+    return true;
+}
+
+void SimTradeFeed::onMarketData(const MarketDataField& data) {
+    if (!running_) {
+        return;
+    }
+
+    EventPtr event(new Event());
+    event->kind = Event::TICK;
+    event->due = 0;
+    event->symbol = data.symbol;
+    event->quote.lastPrice = data.lastPrice;
+    event->quote.upperLimit = data.upperLimit;
+    event->quote.lowerLimit = data.lowerLimit;
+    event->quote.volume = data.volume;
+    event->quote.tradingDay = data.tradingDay;
+    event->quote.updateTime = data.updateTime;
+    event->quote.bidPrice = data.bidPrice;
+    event->quote.bidVolume = data.bidVolume;
+    event->quote.askPrice = data.askPrice;
+    event->quote.askVolume = data.askVolume;
+    post(std::move(event));
+}
+
+void SimTradeFeed::post(EventPtr event) {
+    std::lock_guard<std::mutex> lock(inboxMutex_);
+    inbox_.push_back(std::move(event));
+    if (sleeping_) {
+        inboxCondition_.notify_one();
+    }
+}
+
+void SimTradeFeed::matchLoop() {
+    ThreadUtil::setCurrentThreadName("SimMatch");
+
+    std::vector<EventPtr> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(inboxMutex_);
+            while (running_ && inbox_.empty()) {
+                if (pending_.empty()) {
+                    sleeping_ = true;
+                    inboxCondition_.wait(lock);
+                    sleeping_ = false;
+                    continue;
+                }
+
+                // 有延迟回报待发送：临近到期时轮询，避免条件变量的唤醒误差
+                int64_t wait = pending_.front()->due - latencyNow();
+                if (wait <= 0) {
+                    break;
+                }
+                if (wait > SPIN_THRESHOLD_NS) {
+                    sleeping_ = true;
+                    inboxCondition_.wait_for(lock, std::chrono::nanoseconds(wait - SPIN_THRESHOLD_NS));
+                    sleeping_ = false;
+                } else {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+            }
+            if (!running_) {
+                break;
+            }
+            batch.swap(inbox_);
+        }
+
+        int64_t now = latencyNow();
+        runDue(now);
+        for (auto& event : batch) {
+            if (event->due <= now) {
+                dispatch(*event, now);
+            } else {
+                schedule(std::move(event));
+            }
+        }
+        batch.clear();
+        runDue(latencyNow());
+    }
+}
+
+void SimTradeFeed::schedule(EventPtr event) {
+    event->seq = nextSeq_++;
+    pending_.push_back(std::move(event));
+    std::push_heap(pending_.begin(), pending_.end(), LaterEvent());
+}
+
+void SimTradeFeed::runDue(int64_t now) {
+    while (!pending_.empty() && pending_.front()->due <= now) {
+        std::pop_heap(pending_.begin(), pending_.end(), LaterEvent());
+        EventPtr event = std::move(pending_.back());
+        pending_.pop_back();
+        dispatch(*event, now);
+    }
+}
+
+void SimTradeFeed::dispatch(Event& event, int64_t now) {
+    switch (event.kind) {
+        case Event::ORDER_ARRIVE:
+            onOrderArrive(std::move(event.order), now);
+            break;
+        case Event::CANCEL_ARRIVE:
+            onCancelArrive(event.orderRef, now);
+            break;
+        case Event::TICK:
+            onTick(event.symbol, event.quote, now);
+            break;
+        case Event::ORDER_REPORT:
+            deliverOrder(event);
+            break;
+        case Event::TRADE_REPORT:
+            deliverTrade(event);
+            break;
+    }
+}
+
+SimTradeFeed::Book& SimTradeFeed::getBook(const std::string& symbol) {
+    std::unique_ptr<Book>& book = books_[symbol];
+    if (!book) {
+        book.reset(new Book());
+        book->symbol = symbol;
+        book->hasQuote = false;
+        book->bidTaken.fill(0);
+        book->askTaken.fill(0);
+    }
+    return *book;
+}
+
+std::string SimTradeFeed::checkReject(const Order& order) {
+    if (order.data.volume <= 0) {
+        return "invalid volume";
+    }
+    if (order.data.priceType == trade::OrderPriceType::Limit) {
+        if (order.data.price <= 0.0) {
+            return "invalid price";
+        }
+        const Quote& quote = order.book->quote;
+        if (config_.checkPriceLimits && order.book->hasQuote &&
+            ((quote.upperLimit > 0.0 && order.data.price > quote.upperLimit) ||
+             (quote.lowerLimit > 0.0 && order.data.price < quote.lowerLimit))) {
+            return "price out of limits";
+        }
+    }
+    if (config_.rejectRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < config_.rejectRate) {
+        return "simulated reject";
+    }
+    return "";
+}
+
+void SimTradeFeed::onOrderArrive(std::unique_ptr<Order> order, int64_t now) {
+    order->book = &getBook(order->data.symbol);
+
+    std::string reason = checkReject(*order);
+    if (!reason.empty()) {
+        ordersRejected_.add();
+        reportOrder(*order, trade::OrderStatus::Rejected, reason, now);
+        return;
+    }
+    reportOrder(*order, trade::OrderStatus::Accepted, "", now);
+
+    Order* raw = order.get();
+    live_[raw->orderRef] = std::move(order);
+
+    // 先按当前盘口吃单，剩余部分限价单挂单，市价单撤销
+    takeLiquidity(*raw, now);
+    if (raw->remaining == 0) {
+        finish(*raw);
+    } else if (raw->data.priceType == trade::OrderPriceType::Market) {
+        reportOrder(*raw, trade::OrderStatus::Canceled, "market order remainder canceled", now);
+        finish(*raw);
+    } else {
+        rest(*raw);
+    }
+}
+
+void SimTradeFeed::onCancelArrive(int orderRef, int64_t now) {
+    // 已成交或已拒绝的订单不在live_中，撤单不生效
+    auto it = live_.find(orderRef);
+    if (it == live_.end()) {
+        return;
+    }
+
+    Order& order = *it->second;
+    reportOrder(order, trade::OrderStatus::Canceled, "", now);
+    finish(order);
+}
+
+void SimTradeFeed::onTick(const std::string& symbol, const Quote& quote, int64_t now) {
+    Book& book = getBook(symbol);
+
+    // 两笔行情之间的成交量
+    int64_t printVolume = book.hasQuote ? std::max(0, quote.volume - book.quote.volume) : 0;
+    book.quote = quote;
+    book.hasQuote = true;
+    book.bidTaken.fill(0);
+    book.askTaken.fill(0);
+
+    // 对手盘越过挂单价格时吃单
+    crossResting(book.bids, now);
+    crossResting(book.asks, now);
+
+    // 最新价触及挂单价格时按成交量排队成交
+    if (printVolume > 0 && quote.lastPrice > 0.0) {
+        fillPassive(book, book.bids, true, printVolume, now);
+        fillPassive(book, book.asks, false, printVolume, now);
+    }
+
+    // 同价位盘口量减少（前方撤单或成交）时，排在前面的量不超过盘口量
+    if (config_.queueModel) {
+        for (size_t i = 0; i < quote.bidPrice.size(); ++i) {
+            auto level = book.bids.find(-toPriceKey(quote.bidPrice[i]));
+            if (quote.bidPrice[i] > 0.0 && level != book.bids.end()) {
+                for (Order* order : level->second) {
+                    order->queueAhead = std::min<int64_t>(order->queueAhead, quote.bidVolume[i]);
+                }
+            }
+            level = book.asks.find(toPriceKey(quote.askPrice[i]));
+            if (quote.askPrice[i] > 0.0 && level != book.asks.end()) {
+                for (Order* order : level->second) {
+                    order->queueAhead = std::min<int64_t>(order->queueAhead, quote.askVolume[i]);
+                }
+            }
+        }
+    }
+}
+
+void SimTradeFeed::takeLiquidity(Order& order, int64_t now) {
+    Book& book = *order.book;
+    if (!book.hasQuote) {
+        return;
+    }
+
+    const Quote& quote = book.quote;
+    for (size_t i = 0; i < quote.askPrice.size() && order.remaining > 0; ++i) {
+        double price = order.buy ? quote.askPrice[i] : quote.bidPrice[i];
+        int volume = order.buy ? quote.askVolume[i] : quote.bidVolume[i];
+        int& taken = order.buy ? book.askTaken[i] : book.bidTaken[i];
+        if (price <= 0.0 || volume <= 0) {
+            break;
+        }
+
+        int64_t key = toPriceKey(price);
+        if (order.buy ? key > order.priceKey : key < order.priceKey) {
+            break;
+        }
+
+        int available = volume - taken;
+        if (available <= 0) {
+            continue;
+        }
+        int matched = std::min(available, order.remaining);
+        taken += matched;
+        fill(order, price, matched, now);
+    }
+}
+
+void SimTradeFeed::crossResting(Levels& levels, int64_t now) {
+    // 按价格-时间优先逐个吃单，最优的挂单不能全部成交时后面的挂单也不能成交
+    while (!levels.empty()) {
+        Order& order = *levels.begin()->second.front();
+        takeLiquidity(order, now);
+        if (order.remaining > 0) {
+            break;
+        }
+        finish(order);
+    }
+}
+
+void SimTradeFeed::fillPassive(Book& book, Levels& levels, bool buy, int64_t printVolume, int64_t now) {
+    const int64_t lastKey = toPriceKey(book.quote.lastPrice);
+
+    for (auto it = levels.begin(); it != levels.end() && printVolume > 0;) {
+        int64_t priceKey = buy ? -it->first : it->first;
+        if (buy ? priceKey < lastKey : priceKey > lastKey) {
+            break;
+        }
+
+        // 成交价越过挂单价时挂单必然成交，等于挂单价时需先排完前方的量
+        bool through = priceKey != lastKey;
+        auto next = std::next(it);
+        std::vector<Order*> queue(it->second.begin(), it->second.end());
+        for (Order* order : queue) {
+            if (printVolume <= 0) {
+                break;
+            }
+            if (!through && config_.queueModel) {
+                int64_t consumed = std::min(order->queueAhead, printVolume);
+                order->queueAhead -= consumed;
+                printVolume -= consumed;
+            }
+
+            int matched = static_cast<int>(std::min<int64_t>(order->remaining, printVolume));
+            if (matched > 0) {
+                printVolume -= matched;
+                fill(*order, order->data.price, matched, now);
+                if (order->remaining == 0) {
+                    finish(*order);
+                }
+            }
+        }
+        it = next;
+    }
+}
+
+void SimTradeFeed::rest(Order& order) {
+    Book& book = *order.book;
+
+    // 排在同价位已显示的盘口量之后；价格优于盘口时排在最前
+    order.queueAhead = 0;
+    if (config_.queueModel && book.hasQuote) {
+        const Quote& quote = book.quote;
+        for (size_t i = 0; i < quote.bidPrice.size(); ++i) {
+            double price = order.buy ? quote.bidPrice[i] : quote.askPrice[i];
+            if (price > 0.0 && toPriceKey(price) == order.priceKey) {
+                order.queueAhead = order.buy ? quote.bidVolume[i] : quote.askVolume[i];
+                break;
+            }
+        }
+    }
+
+    std::list<Order*>& queue = order.buy ? book.bids[-order.priceKey] : book.asks[order.priceKey];
+    order.levelIt = queue.insert(queue.end(), &order);
+    order.resting = true;
+    restingOrders_.add(1);
+}
+
+void SimTradeFeed::unlink(Order& order) {
+    if (!order.resting) {
+        return;
+    }
+
+    Levels& levels = order.buy ? order.book->bids : order.book->asks;
+    auto level = levels.find(order.buy ? -order.priceKey : order.priceKey);
+    if (level != levels.end()) {
+        level->second.erase(order.levelIt);
+        if (level->second.empty()) {
+            levels.erase(level);
+        }
+    }
+    order.resting = false;
+    restingOrders_.add(-1);
+}
+
+void SimTradeFeed::finish(Order& order) {
+    unlink(order);
+    live_.erase(order.orderRef);
+}
+
+void SimTradeFeed::fill(Order& order, double price, int volume, int64_t now) {
+    order.remaining -= volume;
+    order.traded += volume;
+    fills_.add();
+
+    int64_t due = std::max(now + config_.fillLatencyUs * 1000, order.lastReportAt);
+    reportOrder(order, order.remaining == 0 ? trade::OrderStatus::Filled : trade::OrderStatus::PartialFilled, "", due);
+
+    EventPtr event(new Event());
+    event->kind = Event::TRADE_REPORT;
+    event->due = due;
+    event->tradeReport.tradeId = std::to_string(++nextTradeId_);
+    event->tradeReport.orderId = order.data.orderId;
+    event->tradeReport.symbol = order.data.symbol;
+    event->tradeReport.direction = order.data.direction;
+    event->tradeReport.offset = order.data.offset;
+    event->tradeReport.price = price;
+    event->tradeReport.volume = volume;
+    event->tradeReport.tradeTime = order.book->quote.updateTime;
+    event->tradeReport.tradingDay = order.book->quote.tradingDay;
+    event->tradeReport.accountId = order.data.accountId;
+    event->tradeReport.exchangeId = order.data.exchangeId;
+    schedule(std::move(event));
+}
+
+void SimTradeFeed::reportOrder(Order& order, trade::OrderStatus status, const std::string& statusMsg, int64_t due) {
+    due = std::max(due, order.lastReportAt);
+    order.lastReportAt = due;
+
+    EventPtr event(new Event());
+    event->kind = Event::ORDER_REPORT;
+    event->due = due;
+    event->handle = order.handle;
+    event->orderReport = order.data;
+    event->orderReport.status = status;
+    event->orderReport.tradedVolume = order.traded;
+    event->orderReport.statusMsg = statusMsg;
+    if (order.book) {
+        event->orderReport.updateTime = order.book->quote.updateTime;
+    }
+    schedule(std::move(event));
+}
+
+void SimTradeFeed::deliverOrder(Event& event) {
+    const trade::OrderData& report = event.orderReport;
+    if (!orderStore_.transition(event.handle, report.status, report.tradedVolume,
+                                report.statusMsg, report.updateTime)) {
+        return;
+    }
+    if (orderCallback_) {
+        orderCallback_(report);
+    }
+}
+
+void SimTradeFeed::deliverTrade(Event& event) {
+    const trade::TradeData& report = event.tradeReport;
+    {
+        std::lock_guard<std::mutex> lock(positionMutex_);
+        Position& position = positions_[report.symbol];
+        position.exchangeId = report.exchangeId;
+
+        const double notional = report.price * report.volume * getMultiplier(report.symbol);
+        const bool buy = report.direction == trade::OrderDirection::Buy;
+        commission_ += config_.commissionPerLot * report.volume;
+
+        if (report.offset == trade::OrderOffset::Open) {
+            (buy ? position.longVolume : position.shortVolume) += report.volume;
+            (buy ? position.longCost : position.shortCost) += notional;
+        } else {
+            // 买平减空头，卖平减多头，按持仓均价计算平仓盈亏
+            int& held = buy ? position.shortVolume : position.longVolume;
+            double& cost = buy ? position.shortCost : position.longCost;
+            int closed = std::min(held, report.volume);
+            if (closed > 0) {
+                double closedCost = cost * closed / held;
+                double closedValue = notional * closed / report.volume;
+                closeProfit_ += buy ? closedCost - closedValue : closedValue - closedCost;
+                cost -= closedCost;
+                held -= closed;
+            }
+        }
+    }
+
+    if (tradeCallback_) {
+        tradeCallback_(report);
+    }
+}
+
+std::vector<trade::OrderData> SimTradeFeed::QueryPendingOrders() {
+    return orderStore_.getWorkingOrders();
+}
+
+std::vector<trade::OrderData> SimTradeFeed::QueryPendingOrdersByStrategy(const std::string& strategyId) {
+    return orderStore_.getWorkingOrdersByStrategy(strategyId);
+}
+
+std::vector<trade::OrderData> SimTradeFeed::QueryPendingOrdersByInstrument(const std::string& symbol) {
+    return orderStore_.getWorkingOrdersByInstrument(symbol);
+}
+
+void SimTradeFeed::PurgeTerminalOrders() {
+    orderStore_.purgeTerminal();
+}
+
+trade::OrderData SimTradeFeed::QueryOrder(const std::string& orderId) {
+    trade::OrderData orderData;
+    if (!orderStore_.get(orderStore_.findByOrderId(orderId), orderData)) {
+        return trade::OrderData();
+    }
+    return orderData;
+}
+
+std::vector<trade::PositionData> SimTradeFeed::QueryPositions() {
+    std::vector<trade::PositionData> result;
+
+    std::lock_guard<std::mutex> lock(positionMutex_);
+    for (const auto& item : positions_) {
+        const Position& position = item.second;
+        const double multiplier = getMultiplier(item.first);
+        for (int side = 0; side < 2; ++side) {
+            int volume = side == 0 ? position.longVolume : position.shortVolume;
+            double cost = side == 0 ? position.longCost : position.shortCost;
+            if (volume <= 0) {
+                continue;
+            }
+
+            trade::PositionData data = trade::PositionData();
+            data.symbol = item.first;
+            data.direction = side == 0 ? trade::OrderDirection::Buy : trade::OrderDirection::Sell;
+            data.totalPosition = volume;
+            data.todayPosition = volume;
+            data.yesterdayPosition = 0;
+            data.openCost = cost;
+            data.positionCost = cost;
+            data.openPrice = cost / (volume * multiplier);
+            data.positionPrice = data.openPrice;
+            data.accountId = userId_;
+            data.exchangeId = position.exchangeId;
+            result.push_back(data);
+        }
+    }
+    return result;
+}
+
+trade::AccountData SimTradeFeed::QueryAccount() {
+    std::lock_guard<std::mutex> lock(positionMutex_);
+
+    trade::AccountData account = trade::AccountData();
+    account.accountId = userId_;
+    account.preBalance = config_.initialBalance;
+    account.closeProfit = closeProfit_;
+    account.commission = commission_;
+    account.balance = config_.initialBalance + closeProfit_ - commission_;
+    account.available = account.balance;
+    account.currency = "CNY";
+    return account;
+}
+
+void SimTradeFeed::SetOrderCallback(OrderCallback callback) {
+    orderCallback_ = callback;
+}
+
+void SimTradeFeed::SetTradeCallback(TradeCallback callback) {
+    tradeCallback_ = callback;
+}
+
+void SimTradeFeed::SetPositionCallback(PositionCallback callback) {
+    positionCallback_ = callback;
+}
+
+void SimTradeFeed::SetAccountCallback(AccountCallback callback) {
+    accountCallback_ = callback;
+}
+
+double SimTradeFeed::getMultiplier(const std::string& symbol) const {
+    auto it = config_.multipliers.find(symbol);
+    return it != config_.multipliers.end() ? it->second : config_.defaultMultiplier;
+}
+
+int64_t SimTradeFeed::toPriceKey(double price) {
+    return std::llround(price * PRICE_SCALE);
+}
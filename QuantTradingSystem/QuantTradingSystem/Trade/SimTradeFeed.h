@@ -0,0 +1,233 @@
+#pragma once
+#include "ITradeFeed.h"
+#include "OrderStore.h"
+#include "../MarketData/MarketDataField.h"
+#include "../Utils/metrics/Metrics.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 模拟撮合配置
+struct SimFeedConfig {
+    int64_t ackLatencyUs;                         // 报单到达交易所并受理的延迟（微秒），撤单同样适用
+    int64_t fillLatencyUs;                        // 撮合成交到成交回报的延迟（微秒）
+    double rejectRate;                            // 随机拒单比例，用于演练拒单处理
+    bool queueModel;                              // 被动挂单排在同价位已有挂单之后，先消耗前方挂单量才成交
+    bool checkPriceLimits;                        // 超出涨跌停价的报单拒绝
+    double initialBalance;                        // 初始资金
+    double commissionPerLot;                      // 每手手续费
+    double defaultMultiplier;                     // 未配置合约的合约乘数
+    std::map<std::string, double> multipliers;    // 合约乘数
+    unsigned int seed;                            // 随机拒单的随机数种子
+
+    SimFeedConfig()
+        : ackLatencyUs(0), fillLatencyUs(0), rejectRate(0.0), queueModel(true),
+          checkPriceLimits(true), initialBalance(1000000.0), commissionPerLot(0.0),
+          defaultMultiplier(1.0), seed(12345) {}
+};
+
+// 模拟交易接口
+// 在本地撮合报单，用于无前置环境下的联调和压力测试。每个合约一本订单簿，本地挂单按价格-时间优先排列，
+// 对手方是最近一笔行情的五档盘口：
+// - 可成交的报单按盘口逐档吃单，每笔行情内同一档位的量只能被吃一次，剩余部分限价单挂单、市价单撤销；
+// - 挂单在新行情越过其价格时吃对手盘；在最新价等于其价格时，按两笔行情间的成交量先消耗排在前面的
+//   挂单量（加入时同价位的盘口量，随盘口量减少而减少），再成交；
+// - 受理、成交、撤单回报按配置的延迟在撮合线程上调用OrderCallback/TradeCallback，次序与CTP一致
+//   （先报单回报后成交回报），同一订单的回报不会乱序。
+// 行情通过onMarketData送入（实时行情或回放均可），报单、撤单和行情在同一撮合线程上按到达顺序处理。
+class SimTradeFeed : public ITradeFeed {
+public:
+    SimTradeFeed();
+    ~SimTradeFeed();
+
+    // ITradeFeed接口实现
+    // config为配置文件名，读取其中sim节点；为空时使用默认配置
+    bool Init(const std::string& config) override;
+    void Release() override;
+
+    bool Connect() override;
+    void Disconnect() override;
+    bool IsConnected() const override;
+
+    bool Login(const std::string& userId, const std::string& password) override;
+    bool Logout() override;
+    bool IsLoggedIn() const override;
+
+    std::string PlaceOrder(const trade::OrderData& orderData) override;
+    bool CancelOrder(const std::string& orderId) override;
+
+    std::vector<trade::OrderData> QueryPendingOrders() override;
+    std::vector<trade::OrderData> QueryPendingOrdersByStrategy(const std::string& strategyId) override;
+    std::vector<trade::OrderData> QueryPendingOrdersByInstrument(const std::string& symbol) override;
+    void PurgeTerminalOrders() override;
+    trade::OrderData QueryOrder(const std::string& orderId) override;
+    std::vector<trade::PositionData> QueryPositions() override;
+    trade::AccountData QueryAccount() override;
+
+    void SetOrderCallback(OrderCallback callback) override;
+    void SetTradeCallback(TradeCallback callback) override;
+    void SetPositionCallback(PositionCallback callback) override;
+    void SetAccountCallback(AccountCallback callback) override;
+
+    // 设置撮合参数（需在Connect之前调用）
+    void setConfig(const SimFeedConfig& config);
+    const SimFeedConfig& getConfig() const { return config_; }
+
+    // 送入行情，更新对手盘并撮合挂单
+    void onMarketData(const MarketDataField& data);
+
+    // 本地订单存储
+    OrderStore& GetOrderStore() { return orderStore_; }
+
+private:
+    // 盘口快照
+    struct Quote {
+        double lastPrice;
+        double upperLimit;
+        double lowerLimit;
+        int volume;
+        std::string tradingDay;
+        std::string updateTime;
+        std::array<double, 5> bidPrice;
+        std::array<int, 5> bidVolume;
+        std::array<double, 5> askPrice;
+        std::array<int, 5> askVolume;
+    };
+
+    struct Book;
+
+    // 撮合线程上的报单
+    struct Order {
+        trade::OrderData data;
+        OrderStore::Handle handle;
+        int orderRef;
+        bool buy;
+        int64_t priceKey;                           // 价格的整数表示，市价单为极值
+        int remaining;
+        int traded;
+        int64_t queueAhead;                         // 排在前面的挂单量
+        int64_t lastReportAt;                       // 最近一次回报的时间，保证同一订单回报有序
+        bool resting;                               // 是否在订单簿中挂单
+        Book* book;
+        std::list<Order*>::iterator levelIt;        // 在价位队列中的位置
+    };
+
+    typedef std::map<int64_t, std::list<Order*>> Levels;
+
+    // 单个合约的订单簿
+    struct Book {
+        std::string symbol;
+        Quote quote;
+        bool hasQuote;
+        std::array<int, 5> bidTaken;                // 本笔行情内已被吃掉的盘口量
+        std::array<int, 5> askTaken;
+        Levels bids;                                // 按-priceKey排列，最优价在前
+        Levels asks;                                // 按priceKey排列，最优价在前
+    };
+
+    // 撮合线程处理的事件
+    struct Event {
+        enum Kind { ORDER_ARRIVE, CANCEL_ARRIVE, TICK, ORDER_REPORT, TRADE_REPORT };
+        Kind kind;
+        int64_t due;
+        uint64_t seq;
+        std::unique_ptr<Order> order;               // ORDER_ARRIVE
+        int orderRef;                               // CANCEL_ARRIVE
+        std::string symbol;                         // TICK
+        Quote quote;                                // TICK
+        OrderStore::Handle handle;                  // ORDER_REPORT
+        trade::OrderData orderReport;               // ORDER_REPORT
+        trade::TradeData tradeReport;               // TRADE_REPORT
+    };
+    typedef std::unique_ptr<Event> EventPtr;
+
+    // 按合约记录的持仓
+    struct Position {
+        int longVolume;
+        int shortVolume;
+        double longCost;
+        double shortCost;
+        std::string exchangeId;
+    };
+
+    // 撮合线程
+    void matchLoop();
+    void dispatch(Event& event, int64_t now);
+    void runDue(int64_t now);
+    void schedule(EventPtr event);
+    void post(EventPtr event);
+
+    // 撮合
+    void onOrderArrive(std::unique_ptr<Order> order, int64_t now);
+    void onCancelArrive(int orderRef, int64_t now);
+    void onTick(const std::string& symbol, const Quote& quote, int64_t now);
+    void takeLiquidity(Order& order, int64_t now);
+    void fillPassive(Book& book, Levels& levels, bool buy, int64_t printVolume, int64_t now);
+    void crossResting(Levels& levels, int64_t now);
+    void rest(Order& order);
+    void unlink(Order& order);
+    void fill(Order& order, double price, int volume, int64_t now);
+    void finish(Order& order);
+    Book& getBook(const std::string& symbol);
+    std::string checkReject(const Order& order);
+
+    // 生成回报
+    void reportOrder(Order& order, trade::OrderStatus status, const std::string& statusMsg, int64_t due);
+    void deliverOrder(Event& event);
+    void deliverTrade(Event& event);
+
+    double getMultiplier(const std::string& symbol) const;
+    static int64_t toPriceKey(double price);
+
+    SimFeedConfig config_;
+
+    std::atomic<bool> connected_;
+    std::atomic<bool> loggedIn_;
+    std::atomic<bool> running_;
+    std::atomic<int> orderRef_;
+    std::string userId_;
+    std::string orderIdPrefix_;
+
+    OrderStore orderStore_;
+
+    OrderCallback orderCallback_;
+    TradeCallback tradeCallback_;
+    PositionCallback positionCallback_;
+    AccountCallback accountCallback_;
+
+    // 入站队列：报单、撤单、行情，撮合线程整批取走
+    std::vector<EventPtr> inbox_;
+    std::mutex inboxMutex_;
+    std::condition_variable inboxCondition_;
+    bool sleeping_;
+
+    // 以下只在撮合线程上访问
+    std::thread matchThread_;
+    std::vector<EventPtr> pending_;                 // 按(due, seq)排列的小顶堆
+    uint64_t nextSeq_;
+    uint64_t nextTradeId_;
+    std::unordered_map<std::string, std::unique_ptr<Book>> books_;
+    std::unordered_map<int, std::unique_ptr<Order>> live_;
+    std::mt19937 rng_;
+
+    // 持仓和资金，由撮合线程在成交回报时更新
+    std::unordered_map<std::string, Position> positions_;
+    double closeProfit_;
+    double commission_;
+    mutable std::mutex positionMutex_;
+
+    MetricCounter& ordersReceived_;
+    MetricCounter& ordersRejected_;
+    MetricCounter& fills_;
+    MetricGauge& restingOrders_;
+};
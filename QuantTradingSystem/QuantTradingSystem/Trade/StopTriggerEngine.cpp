@@ -0,0 +1,366 @@
+#include "StopTriggerEngine.h"
+#include "../Utils/metrics/MetricsRegistry.h"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+// 失效节点超过有效节点加此数量的一倍时重建阶梯
+const size_t COMPACT_SLACK = 64;
+
+// 暂存的先到成交最多涉及的订单数，超出后先到的成交不再跟踪
+const size_t MAX_EARLY_TRADES = 1024;
+
+bool isTerminal(trade::OrderStatus status) {
+    return status == trade::OrderStatus::Filled || status == trade::OrderStatus::Canceled ||
+           status == trade::OrderStatus::Rejected;
+}
+
+} // namespace
+
+StopTriggerEngine::StopTriggerEngine()
+    : armedCount_(0),
+      stopsFired_(MetricsRegistry::getInstance().getCounter("stop_trigger.stop_loss_fired")),
+      takesFired_(MetricsRegistry::getInstance().getCounter("stop_trigger.take_profit_fired")),
+      rearmed_(MetricsRegistry::getInstance().getCounter("stop_trigger.rearmed")) {}
+
+void StopTriggerEngine::setSignalCallback(SignalCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+}
+
+void StopTriggerEngine::onSignal(const StrategySignalData& signal) {
+    if (signal.signalType != SignalType::OPEN_LONG && signal.signalType != SignalType::OPEN_SHORT) {
+        return;
+    }
+    if (signal.stopLoss <= 0.0 && signal.takeProfit <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t index = entryFor(signal.strategyId, signal.symbol, signal.signalType == SignalType::OPEN_LONG ? 0 : 1);
+    StopProtection& protection = entries_[index].protection;
+    protection.stopLoss = std::max(0.0, signal.stopLoss);
+    protection.takeProfit = std::max(0.0, signal.takeProfit);
+    if (!protection.firing) {
+        rearm(index);
+    }
+}
+
+bool StopTriggerEngine::cancel(const std::string& strategyId, const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found = false;
+    for (int side = 0; side < 2; ++side) {
+        auto it = entryIndex_.find(keyOf(strategyId, symbol, side));
+        if (it == entryIndex_.end()) {
+            continue;
+        }
+        StopProtection& protection = entries_[it->second].protection;
+        protection.stopLoss = 0.0;
+        protection.takeProfit = 0.0;
+        disarm(it->second);
+        found = true;
+    }
+    return found;
+}
+
+void StopTriggerEngine::onOrder(const trade::OrderData& order) {
+    if (order.orderId.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(order.orderId);
+    if (it == orders_.end()) {
+        // 取出在订单回报之前到达的成交，不属于跟踪方向时一并丢弃
+        int earlyTraded = 0;
+        auto earlyIt = earlyTrades_.find(order.orderId);
+        if (earlyIt != earlyTrades_.end()) {
+            earlyTraded = earlyIt->second;
+            earlyTrades_.erase(earlyIt);
+        }
+        if (order.strategyId.empty()) {
+            return;
+        }
+
+        // 平仓单平的是反方向的持仓；没有登记止损止盈的方向不跟踪
+        const bool open = order.offset == trade::OrderOffset::Open;
+        const int side = open ? sideIndex(order.direction) : (order.direction == trade::OrderDirection::Sell ? 0 : 1);
+        auto entryIt = entryIndex_.find(keyOf(order.strategyId, order.symbol, side));
+        if (entryIt == entryIndex_.end()) {
+            return;
+        }
+
+        OrderBinding binding;
+        binding.entry = entryIt->second;
+        binding.open = open;
+        binding.traded = earlyTraded;
+        binding.finalTraded = -1;
+        it = orders_.emplace(order.orderId, binding).first;
+        if (earlyTraded > 0) {
+            applyTrade(binding.entry, open, earlyTraded);
+        }
+    }
+
+    if (!isTerminal(order.status)) {
+        return;
+    }
+
+    OrderBinding& binding = it->second;
+    const uint32_t index = binding.entry;
+    const bool open = binding.open;
+    binding.finalTraded = order.tradedVolume;
+    if (binding.traded >= binding.finalTraded) {
+        orders_.erase(it);
+    }
+
+    // 触发后的平仓单未能平掉全部持仓：重新挂上，价格仍越过触发价时下一笔行情再次触发
+    StopProtection& protection = entries_[index].protection;
+    if (!open && order.status != trade::OrderStatus::Filled &&
+        protection.firing && protection.position > 0) {
+        protection.firing = false;
+        rearm(index);
+        rearmed_.add();
+    }
+}
+
+void StopTriggerEngine::onTrade(const trade::TradeData& trade) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(trade.orderId);
+    if (it == orders_.end()) {
+        // 成交先于订单回报到达：成交回报不带策略ID，暂存数量，订单回报登记时再计入持仓
+        if (!trade.orderId.empty() &&
+            (earlyTrades_.size() < MAX_EARLY_TRADES || earlyTrades_.count(trade.orderId) > 0)) {
+            earlyTrades_[trade.orderId] += trade.volume;
+        }
+        return;
+    }
+
+    OrderBinding& binding = it->second;
+    const uint32_t index = binding.entry;
+    const bool open = binding.open;
+    binding.traded += trade.volume;
+    if (binding.finalTraded >= 0 && binding.traded >= binding.finalTraded) {
+        orders_.erase(it);
+    }
+    applyTrade(index, open, trade.volume);
+}
+
+void StopTriggerEngine::onCloseRejected(const std::string& strategyId, const std::string& symbol,
+                                        trade::OrderDirection side) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entryIndex_.find(keyOf(strategyId, symbol, sideIndex(side)));
+    if (it == entryIndex_.end()) {
+        return;
+    }
+
+    StopProtection& protection = entries_[it->second].protection;
+    if (!protection.firing) {
+        return;
+    }
+    protection.firing = false;
+    if (protection.position > 0) {
+        rearm(it->second);
+        rearmed_.add();
+    }
+}
+
+void StopTriggerEngine::onMarketData(const MarketDataField& data) {
+    if (armedCount_.load(std::memory_order_relaxed) == 0 || data.lastPrice <= 0.0) {
+        return;
+    }
+
+    const double price = data.lastPrice;
+    std::vector<StrategySignalData> signals;
+    SignalCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ladders_.find(data.symbol);
+        if (it == ladders_.end()) {
+            return;
+        }
+        Ladder& ladder = it->second;
+
+        // 只弹出已越过的触发价，失效节点顺带丢弃
+        while (!ladder.falling.empty() && ladder.falling.front().level >= price) {
+            std::pop_heap(ladder.falling.begin(), ladder.falling.end(), fallingFirst);
+            Node node = ladder.falling.back();
+            ladder.falling.pop_back();
+            if (isLive(node)) {
+                fire(node.entry, node.kind, data, signals);
+            }
+        }
+        while (!ladder.rising.empty() && ladder.rising.front().level <= price) {
+            std::pop_heap(ladder.rising.begin(), ladder.rising.end(), risingFirst);
+            Node node = ladder.rising.back();
+            ladder.rising.pop_back();
+            if (isLive(node)) {
+                fire(node.entry, node.kind, data, signals);
+            }
+        }
+
+        if (ladder.falling.size() + ladder.rising.size() > 2 * ladder.liveNodes + COMPACT_SLACK) {
+            compact(ladder);
+        }
+        callback = callback_;
+    }
+
+    if (callback) {
+        for (const auto& signal : signals) {
+            callback(signal);
+        }
+    }
+}
+
+StopProtection StopTriggerEngine::getProtection(const std::string& strategyId, const std::string& symbol,
+                                                trade::OrderDirection side) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entryIndex_.find(keyOf(strategyId, symbol, sideIndex(side)));
+    return it == entryIndex_.end() ? StopProtection() : entries_[it->second].protection;
+}
+
+uint32_t StopTriggerEngine::entryFor(const std::string& strategyId, const std::string& symbol, int side) {
+    std::string key = keyOf(strategyId, symbol, side);
+    auto it = entryIndex_.find(key);
+    if (it != entryIndex_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back();
+    Entry& entry = entries_.back();
+    entry.strategyId = strategyId;
+    entry.symbol = symbol;
+    entry.side = side;
+    entry.generation = 0;
+    entry.liveNodes = 0;
+    entryIndex_.emplace(std::move(key), index);
+    return index;
+}
+
+void StopTriggerEngine::rearm(uint32_t index) {
+    disarm(index);
+
+    Entry& entry = entries_[index];
+    StopProtection& protection = entry.protection;
+    if (protection.position <= 0 || protection.firing ||
+        (protection.stopLoss <= 0.0 && protection.takeProfit <= 0.0)) {
+        return;
+    }
+
+    // 多头止损、空头止盈在价格下跌时触发，多头止盈、空头止损在价格上涨时触发
+    Ladder& ladder = ladders_[entry.symbol];
+    if (protection.stopLoss > 0.0) {
+        push(ladder, index, STOP_LOSS, protection.stopLoss);
+    }
+    if (protection.takeProfit > 0.0) {
+        push(ladder, index, TAKE_PROFIT, protection.takeProfit);
+    }
+    protection.armed = true;
+    armedCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StopTriggerEngine::disarm(uint32_t index) {
+    Entry& entry = entries_[index];
+    ++entry.generation;
+    if (!entry.protection.armed) {
+        return;
+    }
+
+    entry.protection.armed = false;
+    armedCount_.fetch_sub(1, std::memory_order_relaxed);
+    ladders_[entry.symbol].liveNodes -= entry.liveNodes;
+    entry.liveNodes = 0;
+}
+
+void StopTriggerEngine::push(Ladder& ladder, uint32_t index, Kind kind, double level) {
+    Entry& entry = entries_[index];
+    Node node;
+    node.level = level;
+    node.entry = index;
+    node.generation = entry.generation;
+    node.kind = kind;
+
+    const bool falling = (entry.side == 0) == (kind == STOP_LOSS);
+    if (falling) {
+        ladder.falling.push_back(node);
+        std::push_heap(ladder.falling.begin(), ladder.falling.end(), fallingFirst);
+    } else {
+        ladder.rising.push_back(node);
+        std::push_heap(ladder.rising.begin(), ladder.rising.end(), risingFirst);
+    }
+    ++entry.liveNodes;
+    ++ladder.liveNodes;
+}
+
+void StopTriggerEngine::compact(Ladder& ladder) {
+    auto dead = [this](const Node& node) { return !isLive(node); };
+    ladder.falling.erase(std::remove_if(ladder.falling.begin(), ladder.falling.end(), dead), ladder.falling.end());
+    ladder.rising.erase(std::remove_if(ladder.rising.begin(), ladder.rising.end(), dead), ladder.rising.end());
+    std::make_heap(ladder.falling.begin(), ladder.falling.end(), fallingFirst);
+    std::make_heap(ladder.rising.begin(), ladder.rising.end(), risingFirst);
+}
+
+bool StopTriggerEngine::isLive(const Node& node) const {
+    return entries_[node.entry].generation == node.generation;
+}
+
+void StopTriggerEngine::fire(uint32_t index, Kind kind, const MarketDataField& data,
+                             std::vector<StrategySignalData>& signals) {
+    // 同一方向的另一个价位随之失效
+    disarm(index);
+    Entry& entry = entries_[index];
+    entry.protection.firing = true;
+
+    StrategySignalData signal;
+    signal.strategyId = entry.strategyId;
+    signal.symbol = entry.symbol;
+    signal.volume = entry.protection.position;
+    signal.stopLoss = 0.0;
+    signal.takeProfit = 0.0;
+    signal.signalTime = data.updateTime;
+    if (entry.side == 0) {
+        signal.signalType = SignalType::CLOSE_LONG;
+        signal.price = data.bidPrice[0] > 0.0 ? data.bidPrice[0] : data.lastPrice;
+    } else {
+        signal.signalType = SignalType::CLOSE_SHORT;
+        signal.price = data.askPrice[0] > 0.0 ? data.askPrice[0] : data.lastPrice;
+    }
+
+    std::ostringstream comment;
+    if (kind == STOP_LOSS) {
+        comment << "Stop loss " << entry.protection.stopLoss;
+        stopsFired_.add();
+    } else {
+        comment << "Take profit " << entry.protection.takeProfit;
+        takesFired_.add();
+    }
+    comment << " triggered at " << data.lastPrice;
+    signal.comment = comment.str();
+    signals.push_back(std::move(signal));
+}
+
+void StopTriggerEngine::applyTrade(uint32_t index, bool open, int volume) {
+    StopProtection& protection = entries_[index].protection;
+    if (open) {
+        protection.position += volume;
+    } else {
+        protection.position = std::max(0, protection.position - volume);
+    }
+
+    if (protection.position == 0) {
+        protection.firing = false;
+        disarm(index);
+    } else if (!protection.armed && !protection.firing) {
+        rearm(index);
+    }
+}
+
+std::string StopTriggerEngine::keyOf(const std::string& strategyId, const std::string& symbol, int side) {
+    std::string key;
+    key.reserve(strategyId.size() + symbol.size() + 3);
+    key.append(strategyId).push_back('\x1f');
+    key.append(symbol).push_back('\x1f');
+    key.push_back(side == 0 ? 'L' : 'S');
+    return key;
+}
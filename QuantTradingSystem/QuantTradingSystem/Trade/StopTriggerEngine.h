@@ -0,0 +1,140 @@
+#pragma once
+#include "TradeDataStruct.h"
+#include "../Events/StrategySignalEvent.h"
+#include "../MarketData/MarketDataField.h"
+#include "../Utils/metrics/Metrics.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 单边持仓的止损止盈
+struct StopProtection {
+    int position;        // 引擎跟踪的该策略在该方向上的持仓（只统计设置止损止盈之后的成交）
+    double stopLoss;     // 0为未设置
+    double takeProfit;   // 0为未设置
+    bool armed;          // 已挂在价格阶梯上
+    bool firing;         // 已发出平仓信号，等待平仓单终结
+
+    StopProtection() : position(0), stopLoss(0.0), takeProfit(0.0), armed(false), firing(false) {}
+};
+
+// 止损止盈触发引擎
+// 开仓信号带的止损价、止盈价按策略、合约和多空方向登记，该方向有持仓时挂到合约的价格阶梯上：
+// 多头止损和空头止盈在最新价跌到触发价时触发，放在按触发价从高到低的堆里；多头止盈和空头止损
+// 在最新价涨到触发价时触发，放在从低到高的堆里。每笔行情只比较两个堆顶，弹出已越过的触发价，
+// 触发k个时开销为O(k log n)，止损止盈与持仓一起在一处维护，策略不必逐笔扫描自己的持仓。
+// 触发后以平仓信号发出（平仓数量为当时持仓，价格取对手盘最优价），同一方向的另一个价位一并失效；
+// 平仓单被撤或被拒、或平仓信号未能报出而持仓仍在时重新挂上。触发价修改和撤销采用惰性删除，失效节点过多时整体重建。
+// 持仓由订单回报中的策略ID和成交回报增量维护，启用之前已有的持仓不在保护范围内；
+// 先于订单回报到达的成交按订单暂存，订单回报登记时计入。
+// 线程安全：信号、行情、回报线程共用一把锁，信号回调在锁外调用。
+class StopTriggerEngine {
+public:
+    // 发出平仓信号
+    typedef std::function<void(const StrategySignalData& signal)> SignalCallback;
+
+    StopTriggerEngine();
+
+    // 禁止拷贝和赋值
+    StopTriggerEngine(const StopTriggerEngine&) = delete;
+    StopTriggerEngine& operator=(const StopTriggerEngine&) = delete;
+
+    // 设置信号回调（在使用之前调用）
+    void setSignalCallback(SignalCallback callback);
+
+    // 策略信号：开仓信号带止损价或止盈价时更新该方向的触发价
+    void onSignal(const StrategySignalData& signal);
+
+    // 撤销策略在合约上两个方向的止损止盈
+    bool cancel(const std::string& strategyId, const std::string& symbol);
+
+    // 订单回报：登记订单所属的策略和方向；触发后发出的平仓单被撤或被拒时重新挂上
+    void onOrder(const trade::OrderData& order);
+
+    // 成交回报：开仓增加、平仓减少对应方向的持仓；订单尚未登记时暂存成交数量
+    void onTrade(const trade::TradeData& trade);
+
+    // 平仓信号未能报出（被风控或熔断拒绝、无可平持仓、发送失败，不会有订单回报）：
+    // 已触发的方向重新挂上，side为持仓方向（Buy为多头）
+    void onCloseRejected(const std::string& strategyId, const std::string& symbol, trade::OrderDirection side);
+
+    // 行情：触发已越过的止损止盈
+    void onMarketData(const MarketDataField& data);
+
+    // 查询单边止损止盈，side为持仓方向（Buy为多头）
+    StopProtection getProtection(const std::string& strategyId, const std::string& symbol,
+                                 trade::OrderDirection side) const;
+
+    // 挂在价格阶梯上的方向数
+    size_t getArmedCount() const { return armedCount_.load(std::memory_order_relaxed); }
+
+private:
+    enum Kind { STOP_LOSS, TAKE_PROFIT };
+
+    struct Entry {
+        std::string strategyId;
+        std::string symbol;
+        int side;                  // 0多头、1空头
+        StopProtection protection;
+        uint32_t generation;       // 重新挂上、修改或触发后递增，旧节点失效
+        int liveNodes;             // 阶梯上有效的节点数
+    };
+
+    // 阶梯节点
+    struct Node {
+        double level;
+        uint32_t entry;
+        uint32_t generation;
+        Kind kind;
+    };
+
+    // 合约的价格阶梯
+    struct Ladder {
+        std::vector<Node> falling;   // 价格跌到触发价时触发，堆顶为最高触发价
+        std::vector<Node> rising;    // 价格涨到触发价时触发，堆顶为最低触发价
+        size_t liveNodes;
+
+        Ladder() : liveNodes(0) {}
+    };
+
+    // 订单对应的持仓方向，成交全部到达后删除
+    struct OrderBinding {
+        uint32_t entry;
+        bool open;
+        int traded;          // 已收到的成交数量
+        int finalTraded;     // 订单终结时的成交数量，未终结为-1
+    };
+
+    static bool fallingFirst(const Node& a, const Node& b) { return a.level < b.level; }
+    static bool risingFirst(const Node& a, const Node& b) { return a.level > b.level; }
+    static int sideIndex(trade::OrderDirection side) { return side == trade::OrderDirection::Buy ? 0 : 1; }
+
+    // 以下需持有mutex_
+    uint32_t entryFor(const std::string& strategyId, const std::string& symbol, int side);
+    void rearm(uint32_t index);
+    void disarm(uint32_t index);
+    void push(Ladder& ladder, uint32_t index, Kind kind, double level);
+    void compact(Ladder& ladder);
+    bool isLive(const Node& node) const;
+    void fire(uint32_t index, Kind kind, const MarketDataField& data, std::vector<StrategySignalData>& signals);
+    void applyTrade(uint32_t index, bool open, int volume);
+
+    static std::string keyOf(const std::string& strategyId, const std::string& symbol, int side);
+
+    SignalCallback callback_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, uint32_t> entryIndex_;
+    std::unordered_map<std::string, Ladder> ladders_;
+    std::unordered_map<std::string, OrderBinding> orders_;
+    std::unordered_map<std::string, int> earlyTrades_;   // 订单回报之前到达的成交数量
+    std::atomic<size_t> armedCount_;
+    mutable std::mutex mutex_;
+
+    MetricCounter& stopsFired_;
+    MetricCounter& takesFired_;
+    MetricCounter& rearmed_;
+};
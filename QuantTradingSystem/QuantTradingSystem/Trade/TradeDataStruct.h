@@ -53,6 +53,7 @@ struct OrderData {
     std::string tradingDay;       // 交易日
     std::string accountId;        // 账户编号
     std::string exchangeId;       // 交易所代码
+    std::string orderSysId;       // 交易所报单编号
     std::string strategyId;       // 策略ID
     std::string frontId;          // 前置编号 
     std::string sessionId;        // 会话编号
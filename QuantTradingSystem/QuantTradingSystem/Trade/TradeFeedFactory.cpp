@@ -1,5 +1,6 @@
 #include "ITradeFeed.h"
 #include "CTPTradeFeed.h"
+#include "SimTradeFeed.h"
 #include <memory>
 #include <stdexcept>
 
@@ -7,6 +8,9 @@ std::shared_ptr<ITradeFeed> TradeFeedFactory::CreateTradeFeed(const std::string&
     if (provider == "CTP") {
         return std::make_shared<CTPTradeFeed>();
     }
+    else if (provider == "SIM") {
+        return std::make_shared<SimTradeFeed>();
+    }
     // 这里可以添加其他交易接口提供商的支持
     
     throw std::runtime_error("Unsupported trade feed provider: " + provider);
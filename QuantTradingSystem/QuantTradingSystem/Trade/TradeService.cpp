@@ -2,6 +2,8 @@
 #include "ITradeFeed.h"
 #include "../Events/AllEvents.h"
 #include "../Events/StrategySignalEvent.h"
+#include "../Utils/latency/LatencyTracer.h"
+#include "../Utils/metrics/MetricsRegistry.h"
 #include <memory>
 #include <stdexcept>
 #include <functional>
@@ -9,7 +11,14 @@
 TradeService::TradeService(std::shared_ptr<EventManager> eventManager)
     : eventManager_(eventManager), 
       tradeFeed_(nullptr),
+      refreshInFlight_(false),
+      refreshAgain_(false),
+      refreshOutstanding_(0),
+      positionsSeeded_(false),
       running_(false) {
+    killSwitch_.setHooks(
+        [this](KillScope scope, const std::string& key) { return QueryPendingOrders(scope, key); },
+        [this](const trade::OrderData& order) { return SendKillCancel(order); });
 }
 
 TradeService::~TradeService() {
@@ -45,6 +54,65 @@ bool TradeService::Init(const std::string& provider, const std::string& config)
     }
 }
 
+void TradeService::SetRiskGate(std::shared_ptr<RiskGate> riskGate) {
+    riskGate_ = riskGate;
+}
+
+bool TradeService::EnableOrderGateway(const OrderGatewayConfig& config) {
+    if (!tradeFeed_ || running_) {
+        return false;
+    }
+    
+    orderGateway_ = std::make_shared<OrderGateway>(tradeFeed_, config);
+    orderGateway_->setCallbacks(
+        [this](const GatewayRequest& request, const std::string& orderId) { OnGatewayPlaced(request, orderId); },
+        nullptr);
+    return true;
+}
+
+bool TradeService::EnableExecutionAlgos(const ExecutionAlgoConfig& config) {
+    if (!orderGateway_ || running_) {
+        return false;
+    }
+    
+    algoEngine_ = std::make_shared<ExecutionAlgoEngine>(config);
+    algoEngine_->setCallbacks(
+        [this](uint64_t childId, const trade::OrderData& child) { return SendAlgoChild(childId, child); },
+        [this](const std::string& orderId) { orderGateway_->submitCancel(orderId); },
+        [this](const trade::OrderData& parent) { OnAlgoParent(parent); });
+    
+    // 算法的定时器和待发子单由网关线程推进
+    std::shared_ptr<ExecutionAlgoEngine> engine = algoEngine_;
+    orderGateway_->setPollHook([engine](int64_t nowNs) { return engine->poll(nowNs); });
+    return true;
+}
+
+bool TradeService::EnablePositionLedger(const std::vector<std::string>& closeTodayExchanges,
+                                        const std::unordered_map<std::string, std::string>& instrumentExchanges) {
+    if (running_) {
+        return false;
+    }
+    
+    positionLedger_ = std::make_shared<PositionLedger>();
+    positionLedger_->setCloseTodayExchanges(closeTodayExchanges);
+    for (const auto& pair : instrumentExchanges) {
+        positionLedger_->setInstrumentExchange(pair.first, pair.second);
+    }
+    return true;
+}
+
+bool TradeService::EnableStopTriggers() {
+    if (!eventManager_ || running_) {
+        return false;
+    }
+    
+    stopTriggers_ = std::make_shared<StopTriggerEngine>();
+    stopTriggers_->setSignalCallback([this](const StrategySignalData& signal) {
+        eventManager_->addSignalEvent(std::make_shared<StrategySignalEvent>(signal));
+    });
+    return true;
+}
+
 bool TradeService::Start() {
     if (!tradeFeed_) {
         return false;
@@ -56,14 +124,23 @@ bool TradeService::Start() {
     }
     
     running_ = true;
+    killSwitch_.start();
+    if (orderGateway_) {
+        orderGateway_->start();
+    }
     return true;
 }
 
 void TradeService::Stop() {
-    if (tradeFeed_ && running_) {
+    // 先停止接收新订单，再停止网关；检查之后才停止的订单由网关拒绝入队并回滚
+    const bool wasRunning = running_.exchange(false);
+    killSwitch_.stop();
+    if (orderGateway_) {
+        orderGateway_->stop();
+    }
+    if (tradeFeed_ && wasRunning) {
         tradeFeed_->Disconnect();
         tradeFeed_->Release();
-        running_ = false;
     }
 }
 
@@ -72,7 +149,14 @@ bool TradeService::Login(const std::string& userId, const std::string& password)
         return false;
     }
     
-    return tradeFeed_->Login(userId, password);
+    if (!tradeFeed_->Login(userId, password)) {
+        return false;
+    }
+    
+    // 以柜台持仓为起点：持仓台账装入前平仓单不拆分，风控和盈亏引擎装入隔夜持仓
+    positionsSeeded_ = false;
+    RefreshData();
+    return true;
 }
 
 bool TradeService::Logout() {
@@ -85,17 +169,58 @@ bool TradeService::Logout() {
 
 bool TradeService::ProcessSignal(const std::shared_ptr<StrategySignalEvent>& signal) {
     if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
+        if (stopTriggers_) {
+            OnCloseNotSent(CreateOrderFromSignal(signal->getData()));
+        }
         return false;
     }
     
     try {
+        // 登记开仓信号的止损止盈，随成交挂上
+        if (stopTriggers_) {
+            stopTriggers_->onSignal(signal->getData());
+        }
+        
         // 创建订单
         trade::OrderData orderData = CreateOrderFromSignal(signal->getData());
         
-        // 发送订单
-        std::string orderId = tradeFeed_->PlaceOrder(orderData);
+        // 执行算法母单不直接报单，子单发出前再逐笔检查
+        const ExecAlgoParams& algo = signal->getData().execAlgo;
+        if (algoEngine_ && algo.type != ExecAlgoType::NONE) {
+            if (killSwitch_.isBlocked(orderData.strategyId, orderData.symbol)) {
+                OnKillSwitchBlocked(orderData);
+                OnCloseNotSent(orderData);
+                return false;
+            }
+            if (algoEngine_->submit(orderData, algo).empty()) {
+                OnCloseNotSent(orderData);
+                return false;
+            }
+            return true;
+        }
+        
+        if (!positionLedger_) {
+            return SendSignalOrder(orderData, &signal->getTrace(), false);
+        }
         
-        return !orderId.empty();
+        // 平仓单按可平的今仓、昨仓拆分，只记录第一笔的链路延迟
+        CloseSplit split = positionLedger_->splitClose(orderData);
+        if (split.count == 0) {
+            // 没有可平的持仓，与风控拒单一致以拒单事件通知策略
+            if (eventManager_) {
+                trade::OrderData rejected = orderData;
+                rejected.status = trade::OrderStatus::Rejected;
+                rejected.statusMsg = "No closable position";
+                eventManager_->addEvent(ConvertToOrderEvent(rejected));
+            }
+            OnCloseNotSent(orderData);
+            return false;
+        }
+        bool sent = false;
+        for (int i = 0; i < split.count; ++i) {
+            sent |= SendSignalOrder(split.legs[i], i == 0 ? &signal->getTrace() : nullptr, split.frozen);
+        }
+        return sent;
     }
     catch (const std::exception& e) {
         // 处理异常
@@ -103,12 +228,218 @@ bool TradeService::ProcessSignal(const std::shared_ptr<StrategySignalEvent>& sig
     }
 }
 
+bool TradeService::SendSignalOrder(const trade::OrderData& orderData, const LatencyTrace* signalTrace,
+                                   bool frozenClose) {
+    // 熔断和发送前同步风控检查
+    RiskOrder riskOrder;
+    if (!CheckOrder(orderData, riskOrder)) {
+        if (frozenClose) {
+            positionLedger_->release(orderData);
+        }
+        OnCloseNotSent(orderData);
+        return false;
+    }
+    LatencyTrace trace;
+    if (signalTrace) {
+        trace = *signalTrace;
+        trace.stamp(LatencyStage::RISK_CHECK);
+    }
+    
+    // 启用网关时入队后立即返回，发送结果在OnGatewayPlaced中处理；网关已停止时按发送失败处理
+    std::string orderId;
+    if (orderGateway_) {
+        if (orderGateway_->submitOrder(orderData, riskGate_ ? &riskOrder : nullptr, trace, frozenClose) != 0) {
+            return true;
+        }
+    } else {
+        // 发送订单
+        orderId = tradeFeed_->PlaceOrder(orderData);
+    }
+    if (orderId.empty()) {
+        if (riskGate_) {
+            riskGate_->rollback(riskOrder);
+        }
+        if (frozenClose) {
+            positionLedger_->release(orderData);
+        }
+        OnCloseNotSent(orderData);
+        return false;
+    }
+    if (riskGate_) {
+        riskGate_->commit(orderId, riskOrder);
+    }
+    if (frozenClose) {
+        BindFrozenClose(orderId, orderData);
+    }
+    
+    // 报单完成，记录信号到报单的各阶段及端到端耗时
+    if (signalTrace) {
+        trace.stamp(LatencyStage::PLACE_ORDER);
+        LatencyTracer::getInstance().recordOrder(trace);
+    }
+    
+    return true;
+}
+
+int TradeService::SendAlgoChild(uint64_t childId, const trade::OrderData& child) {
+    if (!running_ || !tradeFeed_->IsLoggedIn()) {
+        return 0;
+    }
+    
+    // 平仓子单只发拆分出的第一笔，其余数量留给后续子单
+    trade::OrderData order = child;
+    bool frozenClose = false;
+    if (positionLedger_) {
+        CloseSplit split = positionLedger_->splitClose(child);
+        if (split.count == 0) {
+            return 0;
+        }
+        for (int i = 1; i < split.count && split.frozen; ++i) {
+            positionLedger_->release(split.legs[i]);
+        }
+        order = split.legs[0];
+        frozenClose = split.frozen;
+    }
+    
+    RiskOrder riskOrder;
+    if (!CheckOrder(order, riskOrder)) {
+        if (frozenClose) {
+            positionLedger_->release(order);
+        }
+        return 0;
+    }
+    
+    if (orderGateway_->submitOrder(order, riskGate_ ? &riskOrder : nullptr, LatencyTrace(), frozenClose, childId) == 0) {
+        if (riskGate_) {
+            riskGate_->rollback(riskOrder);
+        }
+        if (frozenClose) {
+            positionLedger_->release(order);
+        }
+        return 0;
+    }
+    return order.volume;
+}
+
+void TradeService::OnAlgoParent(const trade::OrderData& parent) {
+    if (eventManager_) {
+        eventManager_->addEvent(ConvertToOrderEvent(parent));
+    }
+}
+
+bool TradeService::CancelAlgoOrder(const std::string& parentId) {
+    return algoEngine_ && algoEngine_->cancel(parentId);
+}
+
+void TradeService::BindFrozenClose(const std::string& orderId, const trade::OrderData& leg) {
+    positionLedger_->bindOrder(orderId, leg);
+    
+    // 回报可能在发送函数返回前到达，此时终结回报已错过登记
+    positionLedger_->onOrder(tradeFeed_->QueryOrder(orderId));
+}
+
 std::string TradeService::PlaceOrder(const trade::OrderData& orderData) {
     if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
         return "";
     }
     
-    return tradeFeed_->PlaceOrder(orderData);
+    RiskOrder riskOrder;
+    if (!CheckOrder(orderData, riskOrder)) {
+        return "";
+    }
+    
+    std::string orderId = tradeFeed_->PlaceOrder(orderData);
+    if (riskGate_) {
+        if (orderId.empty()) {
+            riskGate_->rollback(riskOrder);
+        } else {
+            riskGate_->commit(orderId, riskOrder);
+        }
+    }
+    return orderId;
+}
+
+ClientOrderHandle TradeService::SubmitOrder(const trade::OrderData& orderData) {
+    if (!orderGateway_ || !tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
+        return 0;
+    }
+    
+    RiskOrder riskOrder;
+    if (!CheckOrder(orderData, riskOrder)) {
+        return 0;
+    }
+    
+    // 手工订单不计入行情到报单的链路延迟
+    ClientOrderHandle handle = orderGateway_->submitOrder(orderData, riskGate_ ? &riskOrder : nullptr, LatencyTrace());
+    if (handle == 0 && riskGate_) {
+        riskGate_->rollback(riskOrder);
+    }
+    return handle;
+}
+
+bool TradeService::SubmitCancel(ClientOrderHandle handle) {
+    if (!orderGateway_ || !running_) {
+        return false;
+    }
+    
+    // 订单已发出时与同步撤单一样检查撤单限制；尚未发出的订单撤单不会到达交易所
+    std::string orderId = orderGateway_->getOrderId(handle);
+    if (!orderId.empty() && riskGate_ && riskGate_->getRateLimiter() &&
+        !riskGate_->approveCancel(tradeFeed_->QueryOrder(orderId))) {
+        return false;
+    }
+    
+    return orderGateway_->submitCancel(handle);
+}
+
+bool TradeService::CheckOrder(const trade::OrderData& orderData, RiskOrder& riskOrder) {
+    // 熔断检查，未触发时只是一次原子读取
+    if (killSwitch_.isBlocked(orderData.strategyId, orderData.symbol)) {
+        OnKillSwitchBlocked(orderData);
+        return false;
+    }
+    
+    return !riskGate_ || riskGate_->approve(orderData, riskOrder);
+}
+
+void TradeService::OnGatewayPlaced(const GatewayRequest& request, const std::string& orderId) {
+    if (orderId.empty()) {
+        if (riskGate_ && request.hasRiskOrder) {
+            riskGate_->rollback(request.riskOrder);
+        }
+        if (request.frozenClose && positionLedger_) {
+            positionLedger_->release(request.order);
+        }
+        if (request.algoChildId != 0 && algoEngine_) {
+            algoEngine_->onChildPlaced(request.algoChildId, orderId);
+        } else {
+            OnCloseNotSent(request.order);
+        }
+        
+        // 与风控拒单一致，以拒单事件通知策略
+        if (eventManager_) {
+            trade::OrderData rejected = request.order;
+            rejected.status = trade::OrderStatus::Rejected;
+            rejected.statusMsg = "Order gateway send failed";
+            eventManager_->addEvent(ConvertToOrderEvent(rejected));
+        }
+        return;
+    }
+    
+    if (riskGate_ && request.hasRiskOrder) {
+        riskGate_->commit(orderId, request.riskOrder);
+    }
+    if (request.frozenClose && positionLedger_) {
+        BindFrozenClose(orderId, request.order);
+    }
+    if (request.algoChildId != 0 && algoEngine_) {
+        // 子单回报可能先于发送完成到达
+        algoEngine_->onChildPlaced(request.algoChildId, orderId);
+        algoEngine_->onChildOrder(tradeFeed_->QueryOrder(orderId));
+    }
+    if (request.trace.has(LatencyStage::RISK_CHECK)) {
+        LatencyTracer::getInstance().recordOrder(request.trace);
+    }
 }
 
 bool TradeService::CancelOrder(const std::string& orderId) {
@@ -116,31 +447,181 @@ bool TradeService::CancelOrder(const std::string& orderId) {
         return false;
     }
     
+    // 撤单同样受交易所撤单次数和比例限制
+    if (riskGate_ && riskGate_->getRateLimiter() &&
+        !riskGate_->approveCancel(tradeFeed_->QueryOrder(orderId))) {
+        return false;
+    }
+    
     return tradeFeed_->CancelOrder(orderId);
 }
 
+bool TradeService::EngageKillSwitch(KillScope scope, const std::string& key, const std::string& reason) {
+    return killSwitch_.engage(scope, key, reason);
+}
+
+bool TradeService::ReleaseKillSwitch(KillScope scope, const std::string& key) {
+    return killSwitch_.release(scope, key);
+}
+
+KillCancelResult TradeService::SendKillCancel(const trade::OrderData& order) {
+    if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
+        return KillCancelResult::FAILED;
+    }
+    
+    // 只在撤单速率受限时等待重试；撤单次数或比例超限时交易所同样会拒绝，不再重试
+    if (riskGate_ && riskGate_->getRateLimiter()) {
+        uint32_t violations = riskGate_->getRateLimiter()->acquireCancel(
+            riskGate_->getRiskEngine()->internInstrument(order.symbol));
+        if (violations == RISK_CANCEL_RATE) {
+            return KillCancelResult::THROTTLED;
+        }
+        if (violations != RISK_OK) {
+            return KillCancelResult::FAILED;
+        }
+    }
+    
+    return tradeFeed_->CancelOrder(order.orderId) ? KillCancelResult::SENT : KillCancelResult::FAILED;
+}
+
+void TradeService::OnKillSwitchBlocked(const trade::OrderData& order) {
+    static MetricCounter& blocked = MetricsRegistry::getInstance().getCounter("kill_switch.blocked_orders");
+    blocked.add();
+    
+    // 与风控拒单一致，以拒单事件通知策略
+    if (eventManager_) {
+        trade::OrderData rejected = order;
+        rejected.status = trade::OrderStatus::Rejected;
+        rejected.statusMsg = "Kill switch engaged";
+        eventManager_->addEvent(ConvertToOrderEvent(rejected));
+    }
+}
+
+void TradeService::OnCloseNotSent(const trade::OrderData& order) {
+    if (!stopTriggers_ || order.offset == trade::OrderOffset::Open) {
+        return;
+    }
+    
+    // 平仓单平的是反方向的持仓
+    stopTriggers_->onCloseRejected(order.strategyId, order.symbol,
+                                   order.direction == trade::OrderDirection::Sell ? trade::OrderDirection::Buy
+                                                                                   : trade::OrderDirection::Sell);
+}
+
 bool TradeService::RefreshData() {
     if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
         return false;
     }
     
-    // 查询并更新持仓
-    auto positions = tradeFeed_->QueryPositions();
+    // 上一轮刷新未完成时只记下，完成后再刷新一次
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        positions_.clear();
-        for (const auto& pos : positions) {
-            std::string key = pos.symbol + ":" + (pos.direction == trade::OrderDirection::Buy ? "Long" : "Short");
-            positions_[key] = pos;
+        if (refreshInFlight_) {
+            refreshAgain_ = true;
+            return true;
         }
+        refreshInFlight_ = true;
     }
     
-    // 查询并更新账户
-    accountData_ = tradeFeed_->QueryAccount();
-    
+    StartRefresh();
     return true;
 }
 
+void TradeService::StartRefresh() {
+    refreshOutstanding_ = 2;
+    
+    // 回调在交易接口的查询线程上执行，失败时保留原缓存
+    tradeFeed_->QueryPositionsAsync([this](bool success, const std::vector<trade::PositionData>& positions) {
+        if (success) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            positions_.clear();
+            for (const auto& pos : positions) {
+                std::string key = pos.symbol + ":" + (pos.direction == trade::OrderDirection::Buy ? "Long" : "Short");
+                positions_[key] = pos;
+            }
+            if (positionLedger_) {
+                positionLedger_->load(positions);
+            }
+        }
+        // 只发布登录后的第一次查询结果，之后的持仓由成交回报增量维护
+        if (success && !positionsSeeded_.exchange(true)) {
+            PublishPositionSnapshot(positions);
+        }
+        FinishRefresh();
+    });
+    
+    tradeFeed_->QueryAccountAsync([this](bool success, const trade::AccountData& account) {
+        if (success) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            accountData_ = account;
+        }
+        FinishRefresh();
+    });
+}
+
+void TradeService::FinishRefresh() {
+    if (refreshOutstanding_.fetch_sub(1) != 1) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!refreshAgain_ || !running_) {
+            refreshInFlight_ = false;
+            refreshAgain_ = false;
+            return;
+        }
+        refreshAgain_ = false;
+    }
+    StartRefresh();
+}
+
+void TradeService::PublishPositionSnapshot(const std::vector<trade::PositionData>& positions) {
+    if (!eventManager_) {
+        return;
+    }
+    
+    // 多空两个方向合并为净持仓，开仓成本取净持仓方向按手均摊后的部分
+    struct NetPosition {
+        int longVolume = 0;
+        int shortVolume = 0;
+        double longCost = 0.0;
+        double shortCost = 0.0;
+        double longPrice = 0.0;
+        double shortPrice = 0.0;
+    };
+    std::unordered_map<std::string, NetPosition> netPositions;
+    for (const auto& pos : positions) {
+        NetPosition& net = netPositions[pos.symbol];
+        if (pos.direction == trade::OrderDirection::Buy) {
+            net.longVolume += pos.totalPosition;
+            net.longCost += pos.positionCost;
+            net.longPrice = pos.positionPrice;
+        } else {
+            net.shortVolume += pos.totalPosition;
+            net.shortCost += pos.positionCost;
+            net.shortPrice = pos.positionPrice;
+        }
+    }
+    
+    for (const auto& pair : netPositions) {
+        const NetPosition& net = pair.second;
+        bool isLong = net.longVolume >= net.shortVolume;
+        int sideVolume = isLong ? net.longVolume : net.shortVolume;
+        
+        ::PositionData data;
+        data.symbol = pair.first;
+        data.direction = isLong ? PositionDirection::LONG : PositionDirection::SHORT;
+        data.position = isLong ? net.longVolume - net.shortVolume : net.shortVolume - net.longVolume;
+        data.ydPosition = 0;
+        data.tdPosition = 0;
+        data.avgPrice = isLong ? net.longPrice : net.shortPrice;
+        data.openCost = sideVolume > 0 ? (isLong ? net.longCost : net.shortCost) * data.position / sideVolume : 0.0;
+        data.positionProfit = 0.0;
+        eventManager_->addEvent(std::make_shared<PositionEvent>(data));
+    }
+}
+
 std::vector<trade::OrderData> TradeService::QueryPendingOrders() const {
     if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
         return {};
@@ -149,6 +630,26 @@ std::vector<trade::OrderData> TradeService::QueryPendingOrders() const {
     return tradeFeed_->QueryPendingOrders();
 }
 
+std::vector<trade::OrderData> TradeService::QueryPendingOrders(KillScope scope, const std::string& key) const {
+    if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
+        return {};
+    }
+    
+    // 策略、合约范围只遍历订单存储中该范围的挂单链表
+    switch (scope) {
+        case KillScope::STRATEGY: return tradeFeed_->QueryPendingOrdersByStrategy(key);
+        case KillScope::INSTRUMENT: return tradeFeed_->QueryPendingOrdersByInstrument(key);
+        case KillScope::GLOBAL: break;
+    }
+    return tradeFeed_->QueryPendingOrders();
+}
+
+void TradeService::PurgeTerminalOrders() {
+    if (tradeFeed_) {
+        tradeFeed_->PurgeTerminalOrders();
+    }
+}
+
 trade::OrderData TradeService::QueryOrder(const std::string& orderId) const {
     if (!tradeFeed_ || !running_ || !tradeFeed_->IsLoggedIn()) {
         return {};
@@ -192,16 +693,39 @@ std::string TradeService::GetProviderName() const {
 }
 
 void TradeService::OnOrder(const trade::OrderData& data) {
-    if (!eventManager_) {
-        return;
+    // 熔断撤单进度跟踪，没有进行中的撤单时只是一次原子读取
+    killSwitch_.onOrderUpdate(data);
+    
+    // 平仓单终结时解冻未成交的持仓
+    if (positionLedger_) {
+        positionLedger_->onOrder(data);
+    }
+    
+    // 登记订单所属的持仓方向，触发后的平仓单未成时重新挂上
+    if (stopTriggers_) {
+        stopTriggers_->onOrder(data);
     }
     
     // 转换为订单事件并发布
-    auto event = ConvertToOrderEvent(data);
-    eventManager_->addEvent(event);
+    if (eventManager_) {
+        auto event = ConvertToOrderEvent(data);
+        eventManager_->addEvent(event);
+    }
+    
+    // 执行算法子单回报推进母单
+    if (algoEngine_) {
+        algoEngine_->onChildOrder(data);
+    }
 }
 
 void TradeService::OnTrade(const trade::TradeData& data) {
+    if (positionLedger_) {
+        positionLedger_->onTrade(data);
+    }
+    if (stopTriggers_) {
+        stopTriggers_->onTrade(data);
+    }
+    
     if (!eventManager_) {
         return;
     }
@@ -273,6 +797,9 @@ std::shared_ptr<OrderEvent> TradeService::ConvertToOrderEvent(const trade::Order
     eventData.orderId = data.orderId;
     eventData.symbol = data.symbol;
     eventData.strategyId = data.strategyId;
+    if (algoEngine_) {
+        eventData.parentOrderId = algoEngine_->getParentId(data.orderId);
+    }
     
     // 转换方向
     eventData.direction = (data.direction == trade::OrderDirection::Buy) ? 
@@ -8,8 +8,14 @@
 #include <atomic>
 
 #include "ITradeFeed.h"
+#include "ExecutionAlgoEngine.h"
+#include "OrderGateway.h"
+#include "PositionLedger.h"
+#include "StopTriggerEngine.h"
 #include "../Events/AllEvents.h"
 #include "../EventManager.h"
+#include "../Risk/RiskGate.h"
+#include "../Risk/KillSwitch.h"
 
 class TradeService {
 public:
@@ -22,6 +28,38 @@ public:
     // 初始化服务
     bool Init(const std::string& provider, const std::string& config);
     
+    // 设置事前风控闸门，设置后所有订单在发送前同步检查
+    void SetRiskGate(std::shared_ptr<RiskGate> riskGate);
+    
+    // 启用异步报单网关（在Start之前调用）：信号报单在调用线程上完成熔断和风控检查后入队，
+    // 由网关线程发送，交易接口的耗时不再阻塞事件分发线程
+    bool EnableOrderGateway(const OrderGatewayConfig& config);
+    
+    // 启用执行算法（在EnableOrderGateway之后、Start之前调用）：信号指定了执行算法时按母单拆成子单，
+    // 由网关线程推进算法的定时器并经网关发送子单；母单状态以订单事件通知策略，子单事件带母单编号
+    bool EnableExecutionAlgos(const ExecutionAlgoConfig& config);
+    
+    // 获取执行算法引擎，未启用时为空（行情需送入引擎）
+    std::shared_ptr<ExecutionAlgoEngine> GetExecutionAlgoEngine() const { return algoEngine_; }
+    
+    // 撤销执行算法母单
+    bool CancelAlgoOrder(const std::string& parentId);
+    
+    // 启用持仓台账（在Start之前调用）：登录后装入柜台持仓，由成交回报增量维护，
+    // 信号的平仓单在上期所、能源中心按今昨仓拆成平今、平昨两笔
+    bool EnablePositionLedger(const std::vector<std::string>& closeTodayExchanges,
+                              const std::unordered_map<std::string, std::string>& instrumentExchanges);
+    
+    // 获取持仓台账，未启用时为空
+    std::shared_ptr<PositionLedger> GetPositionLedger() const { return positionLedger_; }
+    
+    // 启用止损止盈触发（在Start之前调用）：开仓信号带的止损价、止盈价随成交挂上，
+    // 行情越过触发价时以平仓信号经信号通道发出
+    bool EnableStopTriggers();
+    
+    // 获取止损止盈触发引擎，未启用时为空（行情需送入引擎）
+    std::shared_ptr<StopTriggerEngine> GetStopTriggerEngine() const { return stopTriggers_; }
+    
     // 启动和停止服务
     bool Start();
     void Stop();
@@ -39,11 +77,33 @@ public:
     // 撤单
     bool CancelOrder(const std::string& orderId);
     
-    // 更新所有持仓和账户
+    // 经报单网关异步下单，检查通过后立即返回客户端订单句柄，未启用网关或被拒绝时返回0
+    ClientOrderHandle SubmitOrder(const trade::OrderData& orderData);
+    
+    // 经报单网关异步撤单，订单尚未发出时在发出后立即撤单
+    bool SubmitCancel(ClientOrderHandle handle);
+    
+    // 获取报单网关，未启用时为空
+    std::shared_ptr<OrderGateway> GetOrderGateway() const { return orderGateway_; }
+    
+    // 触发熔断：阻止范围内的新订单并撤掉范围内的全部挂单
+    bool EngageKillSwitch(KillScope scope, const std::string& key, const std::string& reason);
+    
+    // 解除熔断，恢复报单
+    bool ReleaseKillSwitch(KillScope scope, const std::string& key);
+    
+    // 获取熔断开关
+    KillSwitch& GetKillSwitch() { return killSwitch_; }
+    
+    // 回收交易接口本地已终结的订单（交易日切换时调用）
+    void PurgeTerminalOrders();
+    
+    // 在后台刷新持仓和账户缓存，立即返回；刷新进行中再次调用时合并为完成后的一次刷新
     bool RefreshData();
     
     // 查询接口
     std::vector<trade::OrderData> QueryPendingOrders() const;
+    std::vector<trade::OrderData> QueryPendingOrders(KillScope scope, const std::string& key) const;
     trade::OrderData QueryOrder(const std::string& orderId) const;
     std::vector<trade::PositionData> QueryPositions() const;
     trade::AccountData QueryAccount() const;
@@ -57,6 +117,9 @@ public:
     // 获取当前使用的交易接口名称
     std::string GetProviderName() const;
     
+    // 获取交易接口
+    std::shared_ptr<ITradeFeed> GetTradeFeed() const { return tradeFeed_; }
+    
 private:
     // 回调处理函数
     void OnOrder(const trade::OrderData& data);
@@ -64,6 +127,41 @@ private:
     void OnPosition(const trade::PositionData& data);
     void OnAccount(const trade::AccountData& data);
     
+    // 熔断撤单：受撤单速率限制时返回THROTTLED，由熔断开关稍后重试
+    KillCancelResult SendKillCancel(const trade::OrderData& order);
+    
+    // 订单被熔断阻止
+    void OnKillSwitchBlocked(const trade::OrderData& order);
+    
+    // 平仓单未能报出（不会有订单回报）：通知止损止盈引擎重新挂上已触发的方向
+    void OnCloseNotSent(const trade::OrderData& order);
+    
+    // 报单网关发送完成（网关线程上调用）
+    void OnGatewayPlaced(const GatewayRequest& request, const std::string& orderId);
+    
+    // 熔断和事前风控检查，通过时填写riskOrder
+    bool CheckOrder(const trade::OrderData& orderData, RiskOrder& riskOrder);
+    
+    // 检查并发送一笔信号订单，signalTrace为空时不记录链路延迟；
+    // frozenClose为持仓台账已冻结持仓的平仓单，未发出时解冻
+    bool SendSignalOrder(const trade::OrderData& orderData, const LatencyTrace* signalTrace, bool frozenClose);
+    
+    // 冻结了持仓的平仓单已发出：登记到持仓台账，发送期间已终结的订单立即解冻
+    void BindFrozenClose(const std::string& orderId, const trade::OrderData& leg);
+    
+    // 检查并经网关发送执行算法子单（网关线程上调用），返回发出的数量
+    int SendAlgoChild(uint64_t childId, const trade::OrderData& child);
+    
+    // 执行算法母单状态变化
+    void OnAlgoParent(const trade::OrderData& parent);
+    
+    // 发起一轮持仓和账户查询，两个查询都完成后结束
+    void StartRefresh();
+    void FinishRefresh();
+    
+    // 以持仓事件发布柜台持仓快照，每个合约一条净持仓，由盈亏和风控处理器在事件分发线程上装入
+    void PublishPositionSnapshot(const std::vector<trade::PositionData>& positions);
+    
     // 创建订单数据
     trade::OrderData CreateOrderFromSignal(const StrategySignalData& signalData);
     
@@ -81,6 +179,24 @@ private:
     // 交易接口提供商名称
     std::string providerName_;
     
+    // 事前风控闸门
+    std::shared_ptr<RiskGate> riskGate_;
+    
+    // 熔断开关
+    KillSwitch killSwitch_;
+    
+    // 异步报单网关
+    std::shared_ptr<OrderGateway> orderGateway_;
+    
+    // 持仓台账
+    std::shared_ptr<PositionLedger> positionLedger_;
+    
+    // 止损止盈触发引擎
+    std::shared_ptr<StopTriggerEngine> stopTriggers_;
+    
+    // 执行算法引擎
+    std::shared_ptr<ExecutionAlgoEngine> algoEngine_;
+    
     // 持仓缓存
     std::unordered_map<std::string, trade::PositionData> positions_;
     
@@ -90,6 +206,14 @@ private:
     // 互斥锁
     mutable std::mutex mutex_;
     
+    // 后台刷新状态（refreshInFlight_和refreshAgain_由mutex_保护）
+    bool refreshInFlight_;
+    bool refreshAgain_;
+    std::atomic<int> refreshOutstanding_;
+    
+    // 登录后的持仓快照是否已发布
+    std::atomic<bool> positionsSeeded_;
+    
     // 服务状态
     std::atomic<bool> running_;
 }; 
\ No newline at end of file
@@ -41,7 +41,8 @@ public:
 
     ~LockFreeQueue() {
         // 清理队列
-        while (pop());
+        T item;
+        while (pop(item));
     }
 
     // 尝试将元素推入队列
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+namespace Utils {
+
+// 单生产者单消费者无锁环形队列
+// 只允许一个线程push、一个线程pop，容量必须为2的幂
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of 2");
+
+public:
+    SpscQueue() = default;
+
+    // 禁止拷贝和赋值
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 尝试将元素推入队列（仅生产者线程调用），队列满时返回false
+    bool push(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (!hasSpace(tail)) {
+            return false;
+        }
+
+        buffer_[tail & MASK] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(T&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (!hasSpace(tail)) {
+            return false;
+        }
+
+        buffer_[tail & MASK] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 尝试从队列中弹出元素（仅消费者线程调用），队列空时返回false
+    bool pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+
+        item = std::move(buffer_[head & MASK]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 原地写入（仅生产者线程调用）：取得下一个空槽，队列满时返回nullptr；
+    // 填好后调用commitPush发布，大对象不必先在栈上构造再拷贝
+    T* beginPush() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (!hasSpace(tail)) {
+            return nullptr;
+        }
+        return &buffer_[tail & MASK];
+    }
+
+    void commitPush() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 原地读取（仅消费者线程调用）：队首元素，队列空时返回nullptr；处理完调用popFront释放槽位
+    T* front() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return nullptr;
+            }
+        }
+        return &buffer_[head & MASK];
+    }
+
+    void popFront() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 检查队列是否为空
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    // 获取队列大小（近似值，O(1)）
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    // 获取队列容量
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    bool hasSpace(size_t tail) {
+        if (tail - cachedHead_ < Capacity) {
+            return true;
+        }
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        return tail - cachedHead_ < Capacity;
+    }
+
+    // 消费者侧：读位置及缓存的写位置
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // 生产者侧：写位置及缓存的读位置
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> buffer_;
+};
+
+} // namespace Utils
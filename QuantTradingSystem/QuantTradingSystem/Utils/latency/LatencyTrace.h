@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// 行情到下单链路上的打点阶段，按链路先后顺序排列
+enum class LatencyStage : uint8_t {
+    CTP_CALLBACK,     // CTP行情回调入口
+    CONVERT,          // 行情转换为事件
+    ENQUEUE,          // 进入事件队列
+    DEQUEUE,          // 从事件队列取出
+    STRATEGY_ENTRY,   // 进入策略
+    SIGNAL,           // 策略发出信号
+    STRATEGY_EXIT,    // 策略处理完成
+    SIGNAL_ENQUEUE,   // 信号进入事件队列
+    SIGNAL_DEQUEUE,   // 信号从事件队列取出
+    RISK_CHECK,       // 完成下单前检查
+    GATEWAY_DEQUEUE,  // 报单网关取出请求
+    PLACE_ORDER,      // 报单交给交易接口
+    COUNT
+};
+
+// 单调时钟（纳秒），只用于计算时间差
+inline int64_t latencyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 链路打点记录，随事件传递，由因果相关的事件（行情->信号）继承
+struct LatencyTrace {
+    static const size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::COUNT);
+    
+    int64_t stamps[STAGE_COUNT];
+    
+    LatencyTrace() {
+        clear();
+    }
+    
+    void clear() {
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            stamps[i] = 0;
+        }
+    }
+    
+    // 在指定阶段打点（默认使用当前时间）
+    void stamp(LatencyStage stage) {
+        stamps[static_cast<size_t>(stage)] = latencyNow();
+    }
+    
+    void stamp(LatencyStage stage, int64_t timestampNs) {
+        stamps[static_cast<size_t>(stage)] = timestampNs;
+    }
+    
+    int64_t get(LatencyStage stage) const {
+        return stamps[static_cast<size_t>(stage)];
+    }
+    
+    bool has(LatencyStage stage) const {
+        return get(stage) != 0;
+    }
+};
@@ -0,0 +1,162 @@
+#include "LatencyTracer.h"
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+LatencyTracer::LatencyTracer()
+    : enabled_(true), reporterRunning_(false) {
+}
+
+LatencyTracer::~LatencyTracer() {
+    stopReporter();
+}
+
+void LatencyTracer::record(const LatencyTrace& trace, LatencyStage first, LatencyStage last) {
+    if (!isEnabled()) {
+        return;
+    }
+    
+    // 找到first之前最近的已打点阶段作为起点
+    int64_t previous = 0;
+    for (size_t i = 0; i < static_cast<size_t>(first); ++i) {
+        if (trace.stamps[i] != 0) {
+            previous = trace.stamps[i];
+        }
+    }
+    
+    for (size_t i = static_cast<size_t>(first); i <= static_cast<size_t>(last); ++i) {
+        int64_t current = trace.stamps[i];
+        if (current == 0) {
+            continue;
+        }
+        if (previous != 0) {
+            stageHistograms_[i].record(current - previous);
+        }
+        previous = current;
+    }
+}
+
+void LatencyTracer::recordOrder(const LatencyTrace& trace) {
+    if (!isEnabled()) {
+        return;
+    }
+    
+    record(trace, LatencyStage::SIGNAL, LatencyStage::PLACE_ORDER);
+    
+    int64_t start = 0;
+    for (size_t i = 0; i < LatencyTrace::STAGE_COUNT && start == 0; ++i) {
+        start = trace.stamps[i];
+    }
+    
+    if (start != 0 && trace.has(LatencyStage::PLACE_ORDER)) {
+        tickToOrder_.record(trace.get(LatencyStage::PLACE_ORDER) - start);
+    }
+}
+
+void LatencyTracer::dump(std::ostream& os) const {
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    
+    os << "==== Latency report " << std::put_time(std::localtime(&now_time_t), "%Y-%m-%d %H:%M:%S")
+       << " (ns) ====" << std::endl;
+    os << std::left << std::setw(18) << "stage"
+       << std::right << std::setw(12) << "count"
+       << std::setw(12) << "p50"
+       << std::setw(12) << "p99"
+       << std::setw(12) << "p99.9"
+       << std::setw(14) << "max" << std::endl;
+    
+    auto writeRow = [&os](const char* name, const LatencyHistogram& histogram) {
+        os << std::left << std::setw(18) << name
+           << std::right << std::setw(12) << histogram.getCount()
+           << std::setw(12) << histogram.getPercentile(50.0)
+           << std::setw(12) << histogram.getPercentile(99.0)
+           << std::setw(12) << histogram.getPercentile(99.9)
+           << std::setw(14) << histogram.getMax() << std::endl;
+    };
+    
+    for (size_t i = 0; i < LatencyTrace::STAGE_COUNT; ++i) {
+        if (stageHistograms_[i].getCount() > 0) {
+            writeRow(getStageName(static_cast<LatencyStage>(i)), stageHistograms_[i]);
+        }
+    }
+    writeRow("tick_to_order", tickToOrder_);
+}
+
+void LatencyTracer::reset() {
+    for (auto& histogram : stageHistograms_) {
+        histogram.reset();
+    }
+    tickToOrder_.reset();
+}
+
+bool LatencyTracer::startReporter(const std::string& filePath, int intervalSeconds) {
+    std::lock_guard<std::mutex> lock(reporterMutex_);
+    if (reporterRunning_ || intervalSeconds <= 0) {
+        return false;
+    }
+    
+    reportFile_ = filePath;
+    reporterRunning_ = true;
+    reporterThread_ = std::thread(&LatencyTracer::reporterLoop, this, intervalSeconds);
+    return true;
+}
+
+void LatencyTracer::stopReporter() {
+    {
+        std::lock_guard<std::mutex> lock(reporterMutex_);
+        if (!reporterRunning_) {
+            return;
+        }
+        reporterRunning_ = false;
+    }
+    
+    reporterCondition_.notify_all();
+    if (reporterThread_.joinable()) {
+        reporterThread_.join();
+    }
+    
+    // 停止时写入最终结果
+    writeReport();
+}
+
+void LatencyTracer::reporterLoop(int intervalSeconds) {
+    std::unique_lock<std::mutex> lock(reporterMutex_);
+    while (reporterRunning_) {
+        reporterCondition_.wait_for(lock, std::chrono::seconds(intervalSeconds));
+        if (!reporterRunning_) {
+            break;
+        }
+        
+        lock.unlock();
+        writeReport();
+        lock.lock();
+    }
+}
+
+void LatencyTracer::writeReport() const {
+    std::ofstream file(reportFile_, std::ios::app);
+    if (file.is_open()) {
+        dump(file);
+        file << std::endl;
+    }
+}
+
+const char* LatencyTracer::getStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::CTP_CALLBACK:   return "ctp_callback";
+        case LatencyStage::CONVERT:        return "convert";
+        case LatencyStage::ENQUEUE:        return "enqueue";
+        case LatencyStage::DEQUEUE:        return "dequeue";
+        case LatencyStage::STRATEGY_ENTRY: return "strategy_entry";
+        case LatencyStage::SIGNAL:         return "signal";
+        case LatencyStage::STRATEGY_EXIT:  return "strategy_exit";
+        case LatencyStage::SIGNAL_ENQUEUE: return "signal_enqueue";
+        case LatencyStage::SIGNAL_DEQUEUE: return "signal_dequeue";
+        case LatencyStage::RISK_CHECK:     return "risk_check";
+        case LatencyStage::GATEWAY_DEQUEUE: return "gateway_dequeue";
+        case LatencyStage::PLACE_ORDER:    return "place_order";
+        default:                           return "unknown";
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "LatencyTrace.h"
+#include "../metrics/LatencyHistogram.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// 链路延迟统计
+// 每个阶段一个直方图，记录该阶段与链路上前一个已打点阶段之间的耗时；
+// 另有行情到报单的端到端直方图。可周期性输出到文件，停止时输出最终结果。
+class LatencyTracer {
+public:
+    static LatencyTracer& getInstance() {
+        static LatencyTracer instance;
+        return instance;
+    }
+    
+    // 启用或禁用统计
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+    
+    // 记录[first, last]范围内已打点阶段的耗时
+    // 不同位置只记录各自负责的阶段，避免同一段耗时被重复统计
+    void record(const LatencyTrace& trace, LatencyStage first, LatencyStage last);
+    
+    // 记录一次完整的行情到报单链路（SIGNAL到PLACE_ORDER各阶段及端到端耗时）
+    void recordOrder(const LatencyTrace& trace);
+    
+    // 输出统计结果
+    void dump(std::ostream& os) const;
+    
+    // 清空统计数据
+    void reset();
+    
+    // 启动周期性输出线程
+    bool startReporter(const std::string& filePath, int intervalSeconds);
+    
+    // 停止输出线程并写入最终结果
+    void stopReporter();
+    
+    // 获取阶段名称
+    static const char* getStageName(LatencyStage stage);
+    
+private:
+    LatencyTracer();
+    ~LatencyTracer();
+    
+    // 禁止拷贝和赋值
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+    
+    void reporterLoop(int intervalSeconds);
+    void writeReport() const;
+    
+    std::array<LatencyHistogram, LatencyTrace::STAGE_COUNT> stageHistograms_;
+    LatencyHistogram tickToOrder_;
+    std::atomic<bool> enabled_;
+    
+    // 输出线程
+    std::string reportFile_;
+    std::thread reporterThread_;
+    bool reporterRunning_;
+    std::mutex reporterMutex_;
+    std::condition_variable reporterCondition_;
+};
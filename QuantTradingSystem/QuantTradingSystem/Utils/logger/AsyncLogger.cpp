@@ -1,19 +1,94 @@
 ﻿#include "AsyncLogger.h"
+#include "LogBinaryFormat.h"
 #include <iostream>
 #include <chrono>
+#include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
-#include <windows.h>
 
 namespace QuantTrading {
 
-AsyncLogger::AsyncLogger() 
+namespace {
+
+// 每个环一轮最多读出的记录数，避免单个线程的日志独占后台线程
+const size_t DRAIN_BATCH = 4096;
+
+// 写缓冲超过此大小时先写出
+const size_t WRITE_BUFFER_LIMIT = 256 * 1024;
+
+// 空闲时后台线程的轮询间隔
+const std::chrono::milliseconds IDLE_WAIT(1);
+
+// TSC频率的修正间隔
+const int64_t RECALIBRATE_INTERVAL_NS = 1000000000;
+
+const size_t MIN_RING_BYTES = 64 * 1024;
+
+// 丢弃提示的调用点，由后台线程记录
+LogSite dropSite(LogLevel::WARNING, __FILE__, __LINE__, "AsyncLogger");
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t epochNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+size_t roundUpPowerOf2(size_t value) {
+    size_t result = MIN_RING_BYTES;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// 线程退出时关闭本线程的环，由后台线程读空后回收
+struct ThreadRingHolder {
+    std::shared_ptr<LogRing> ring;
+
+    ~ThreadRingHolder() {
+        if (ring) {
+            ring->close();
+        }
+    }
+};
+
+thread_local ThreadRingHolder threadRingHolder;
+
+} // namespace
+
+thread_local LogRing* AsyncLogger::threadRing_ = nullptr;
+
+AsyncLogger::AsyncLogger()
     : minLevel_(LogLevel::DEBUG)
     , maxFileSize_(10 * 1024 * 1024)
     , maxFiles_(5)
+    , ringBytes_(1024 * 1024)
+    , fileFormat_(LogFileFormat::TEXT)
     , running_(false)
-    , currentFileSize_(0) {
+    , currentFileSize_(0)
+    , ringsVersion_(0)
+    , writerRingsVersion_(0)
+    , droppedTotal_(0)
+    , lastRecordNs_(0) {
+    // 粗测TSC频率，后台线程运行后按更长的区间修正
+    startTsc_ = __rdtsc();
+    startSteadyNs_ = steadyNs();
+    int64_t elapsed = 0;
+    while (elapsed < 1000000) {
+        elapsed = steadyNs() - startSteadyNs_;
+    }
+    ticksPerNs_ = static_cast<double>(__rdtsc() - startTsc_) / static_cast<double>(elapsed);
+    if (ticksPerNs_ <= 0.0) {
+        ticksPerNs_ = 1.0;
+    }
+    baseTsc_ = __rdtsc();
+    baseEpochNs_ = epochNs();
+    lastCalibrationNs_ = steadyNs();
 }
 
 AsyncLogger::~AsyncLogger() {
@@ -24,22 +99,32 @@ void AsyncLogger::init(const std::string& logDir,
                       const std::string& logPrefix,
                       LogLevel minLevel,
                       size_t maxFileSize,
-                      size_t maxFiles) {
+                      size_t maxFiles,
+                      size_t ringBytes,
+                      LogFileFormat fileFormat) {
+    if (running_) {
+        return;
+    }
+
     logDir_ = logDir;
     logPrefix_ = logPrefix;
-    minLevel_ = minLevel;
+    minLevel_.store(minLevel, std::memory_order_relaxed);
     maxFileSize_ = maxFileSize;
     maxFiles_ = maxFiles;
+    fileFormat_ = fileFormat;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        ringBytes_ = roundUpPowerOf2(ringBytes);
+    }
 
     // 创建日志目录
     std::filesystem::create_directories(logDir_);
 
-    // 生成初始日志文件名
-    currentLogFile_ = logDir_ + "/" + logPrefix_ + "_" + getCurrentTimestamp() + ".log";
-    logFile_.open(currentLogFile_, std::ios::app);
-    if (!logFile_.is_open()) {
+    // 打开初始日志文件
+    if (!openLogFile()) {
         throw std::runtime_error("Failed to open log file: " + currentLogFile_);
     }
+    writeBuffer_.reserve(WRITE_BUFFER_LIMIT + 4096);
 
     // 启动日志处理线程
     running_ = true;
@@ -49,7 +134,7 @@ void AsyncLogger::init(const std::string& logDir,
 void AsyncLogger::stop() {
     if (running_) {
         running_ = false;
-        queueCondition_.notify_one();
+        wakeCondition_.notify_one();
         if (logThread_.joinable()) {
             logThread_.join();
         }
@@ -59,67 +144,218 @@ void AsyncLogger::stop() {
     }
 }
 
-void AsyncLogger::log(LogLevel level, const std::string& message,
-                     const std::string& file, int line, const std::string& function) {
-    if (level < minLevel_) {
-        return;
+size_t AsyncLogger::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    size_t pending = 0;
+    for (const auto& ring : rings_) {
+        pending += ring->pending();
     }
+    return pending;
+}
 
-    LogMessage logMsg;
-    logMsg.level = level;
-    logMsg.timestamp = getCurrentTimestamp();
-    logMsg.message = message;
-    logMsg.file = file;
-    logMsg.line = line;
-    logMsg.function = function;
+uint64_t AsyncLogger::getDroppedCount() const {
+    return droppedTotal_.load(std::memory_order_relaxed);
+}
 
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        logQueue_.push(logMsg);
+uint32_t AsyncLogger::registerSite(LogSite& site, const char* format) {
+    std::lock_guard<std::mutex> lock(sitesMutex_);
+    uint32_t id = site.id.load(std::memory_order_relaxed);
+    if (id == 0) {
+        site.format = format;
+        sites_.push_back(&site);
+        id = static_cast<uint32_t>(sites_.size());
+        site.id.store(id, std::memory_order_release);
     }
-    queueCondition_.notify_one();
+    return id;
+}
+
+LogRing* AsyncLogger::attachThread() {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    auto ring = std::make_shared<LogRing>(ringBytes_);
+    rings_.push_back(ring);
+    ringsVersion_.fetch_add(1, std::memory_order_release);
+
+    threadRingHolder.ring = ring;
+    threadRing_ = ring.get();
+    return threadRing_;
+}
+
+char* AsyncLogger::waitForSpace(LogRing& ring, LogLevel level, size_t size) {
+    if (level >= LogLevel::ERROR) {
+        while (running_.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+            char* buffer = ring.reserve(size);
+            if (buffer) {
+                return buffer;
+            }
+        }
+    }
+    ring.drop();
+    return nullptr;
 }
 
 void AsyncLogger::processLogs() {
-    while (running_) {
-        std::unique_lock<std::mutex> lock(queueMutex_);
-        queueCondition_.wait(lock, [this] { return !logQueue_.empty() || !running_; });
-
-        while (!logQueue_.empty()) {
-            LogMessage msg = logQueue_.front();
-            logQueue_.pop();
-            lock.unlock();
-
-            // 检查并轮转日志文件
-            checkAndRotateLogFile();
-
-            // 格式化日志消息
-            std::stringstream ss;
-            ss << "[" << msg.timestamp << "] "
-               << "[" << getLevelString(msg.level) << "] "
-               << "[" << msg.file << ":" << msg.line << "] "
-               << "[" << msg.function << "] "
-               << msg.message << std::endl;
-
-            // 写入日志文件
-            logFile_ << ss.str();
-            logFile_.flush();
-            currentFileSize_ += ss.str().length();
-
-            lock.lock();
+    for (;;) {
+        bool stopping = !running_.load(std::memory_order_acquire);
+        size_t drained = drainRings();
+        if (!writeBuffer_.empty()) {
+            flushBuffer();
+        }
+
+        if (steadyNs() - lastCalibrationNs_ >= RECALIBRATE_INTERVAL_NS) {
+            recalibrate();
+        }
+
+        if (drained == 0) {
+            if (stopping) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait_for(lock, IDLE_WAIT);
         }
     }
 }
 
-std::string AsyncLogger::getLevelString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG:   return "DEBUG";
-        case LogLevel::INFO:    return "INFO";
-        case LogLevel::WARNING: return "WARNING";
-        case LogLevel::ERROR:   return "ERROR";
-        case LogLevel::FATAL:   return "FATAL";
-        default:               return "UNKNOWN";
+size_t AsyncLogger::drainRings() {
+    uint64_t version = ringsVersion_.load(std::memory_order_acquire);
+    if (version != writerRingsVersion_) {
+        std::vector<WriterRing> refreshed;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            for (const auto& ring : rings_) {
+                uint64_t reported = 0;
+                for (const auto& existing : writerRings_) {
+                    if (existing.ring == ring) {
+                        reported = existing.reportedDrops;
+                        break;
+                    }
+                }
+                refreshed.push_back(WriterRing(ring, reported));
+            }
+            writerRingsVersion_ = ringsVersion_.load(std::memory_order_relaxed);
+        }
+        writerRings_.swap(refreshed);
+    }
+
+    size_t total = 0;
+    bool retire = false;
+    for (auto& writerRing : writerRings_) {
+        LogRing& ring = *writerRing.ring;
+        bool closed = ring.isClosed();
+
+        size_t count = 0;
+        const LogRecordHeader* record;
+        while (count < DRAIN_BATCH && (record = ring.front()) != nullptr) {
+            if (record->siteId > writerSites_.size()) {
+                std::lock_guard<std::mutex> lock(sitesMutex_);
+                writerSites_ = sites_;
+            }
+            if (record->siteId <= writerSites_.size()) {
+                const char* args = reinterpret_cast<const char*>(record) + sizeof(LogRecordHeader);
+                writeRecord(record->siteId, toEpochNs(record->timestamp),
+                            args, reinterpret_cast<const char*>(record) + record->size);
+            }
+            ring.pop(record);
+            ++count;
+
+            if (writeBuffer_.size() >= WRITE_BUFFER_LIMIT) {
+                flushBuffer();
+            }
+        }
+        total += count;
+
+        uint64_t dropped = ring.dropped();
+        if (dropped != writerRing.reportedDrops) {
+            uint64_t delta = dropped - writerRing.reportedDrops;
+            writerRing.reportedDrops = dropped;
+            droppedTotal_.fetch_add(delta, std::memory_order_relaxed);
+
+            uint32_t siteId = dropSite.id.load(std::memory_order_acquire);
+            if (siteId == 0) {
+                siteId = registerSite(dropSite, "{} log records dropped, ring full");
+                std::lock_guard<std::mutex> lock(sitesMutex_);
+                writerSites_ = sites_;
+            }
+            char args[16];
+            char* end = LogArgs::encodeAll(args, delta);
+            writeRecord(siteId, toEpochNs(__rdtsc()), args, end);
+        }
+
+        // 所属线程已退出：关闭前的记录都已读出后回收
+        if (closed && ring.front() == nullptr) {
+            retire = true;
+        }
+    }
+
+    if (retire) {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<LogRing>& ring) {
+            return ring->isClosed() && ring->pending() == 0;
+        }), rings_.end());
+        ringsVersion_.fetch_add(1, std::memory_order_release);
+    }
+    return total;
+}
+
+void AsyncLogger::writeRecord(uint32_t siteId, int64_t epochNs, const char* args, const char* end) {
+    // 文件写满时先写出缓冲再轮转，二进制文件的调用点定义和时间差都以所在文件为准
+    if (currentFileSize_ + writeBuffer_.size() >= maxFileSize_) {
+        flushBuffer();
+        checkAndRotateLogFile();
+    }
+
+    const LogSite& site = *writerSites_[siteId - 1];
+    if (fileFormat_ == LogFileFormat::TEXT) {
+        message_.clear();
+        formatLogMessage(message_, site.format, args, end);
+        lineFormatter_.append(writeBuffer_, site.level, site.file, site.line, site.function, epochNs, message_);
+        return;
+    }
+
+    if (fileSites_.size() <= siteId) {
+        fileSites_.resize(siteId + 1, false);
+    }
+    if (!fileSites_[siteId]) {
+        LogBinary::writeSiteDefinition(writeBuffer_, siteId, site);
+        fileSites_[siteId] = true;
+    }
+
+    packedArgs_.clear();
+    if (!LogBinary::compactArgs(packedArgs_, args, end)) {
+        packedArgs_.clear();
     }
+    LogBinary::putVarint(writeBuffer_, siteId);
+    LogBinary::putVarint(writeBuffer_, LogBinary::zigzag(epochNs - lastRecordNs_));
+    LogBinary::putVarint(writeBuffer_, packedArgs_.size());
+    writeBuffer_.append(packedArgs_);
+    lastRecordNs_ = epochNs;
+}
+
+void AsyncLogger::flushBuffer() {
+    if (logFile_.is_open()) {
+        logFile_.write(writeBuffer_.data(), static_cast<std::streamsize>(writeBuffer_.size()));
+        logFile_.flush();
+    }
+    currentFileSize_ += writeBuffer_.size();
+    writeBuffer_.clear();
+}
+
+int64_t AsyncLogger::toEpochNs(uint64_t tsc) const {
+    int64_t ticks = static_cast<int64_t>(tsc - baseTsc_);
+    return baseEpochNs_ + static_cast<int64_t>(static_cast<double>(ticks) / ticksPerNs_);
+}
+
+void AsyncLogger::recalibrate() {
+    uint64_t tsc = __rdtsc();
+    int64_t steady = steadyNs();
+    if (steady > startSteadyNs_) {
+        ticksPerNs_ = static_cast<double>(tsc - startTsc_) / static_cast<double>(steady - startSteadyNs_);
+    }
+
+    // 以当前系统时间为新的起点，系统时钟的调整随之生效
+    baseTsc_ = tsc;
+    baseEpochNs_ = epochNs();
+    lastCalibrationNs_ = steady;
 }
 
 std::string AsyncLogger::getCurrentTimestamp() {
@@ -137,6 +373,31 @@ std::string AsyncLogger::getCurrentTimestamp() {
     return ss.str();
 }
 
+bool AsyncLogger::openLogFile() {
+    const bool binary = fileFormat_ == LogFileFormat::BINARY;
+    currentLogFile_ = logDir_ + "/" + logPrefix_ + "_" + getCurrentTimestamp() + getFileExtension();
+    logFile_.open(currentLogFile_, binary ? std::ios::app | std::ios::binary : std::ios::app);
+    currentFileSize_ = 0;
+    if (!logFile_.is_open()) {
+        return false;
+    }
+
+    // 二进制文件以文件头开始，调用点定义和时间差重新计算
+    if (binary) {
+        std::string header;
+        LogBinary::writeFileHeader(header);
+        logFile_.write(header.data(), static_cast<std::streamsize>(header.size()));
+        currentFileSize_ = header.size();
+        fileSites_.clear();
+        lastRecordNs_ = 0;
+    }
+    return true;
+}
+
+const char* AsyncLogger::getFileExtension() const {
+    return fileFormat_ == LogFileFormat::BINARY ? ".qlog" : ".log";
+}
+
 void AsyncLogger::checkAndRotateLogFile() {
     if (currentFileSize_ >= maxFileSize_) {
         // 关闭当前日志文件
@@ -145,7 +406,7 @@ void AsyncLogger::checkAndRotateLogFile() {
         // 删除最旧的日志文件（如果超过最大文件数）
         std::vector<std::string> logFiles;
         for (const auto& entry : std::filesystem::directory_iterator(logDir_)) {
-            if (entry.path().extension() == ".log") {
+            if (entry.path().extension() == getFileExtension()) {
                 logFiles.push_back(entry.path().string());
             }
         }
@@ -156,10 +417,8 @@ void AsyncLogger::checkAndRotateLogFile() {
         }
 
         // 创建新的日志文件
-        currentLogFile_ = logDir_ + "/" + logPrefix_ + "_" + getCurrentTimestamp() + ".log";
-        logFile_.open(currentLogFile_, std::ios::app);
-        currentFileSize_ = 0;
+        openLogFile();
     }
 }
 
-} // namespace QuantTrading 
\ No newline at end of file
+} // namespace QuantTrading
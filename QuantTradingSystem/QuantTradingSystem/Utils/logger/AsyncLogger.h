@@ -1,42 +1,38 @@
 ﻿#pragma once
 
+#include "LogRecord.h"
+#include "LogRing.h"
+#include "LogLineFormatter.h"
 #include <string>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
 #include <fstream>
 #include <memory>
-#include <sstream>
-#include <chrono>
-#include <iomanip>
-#include <direct.h>
-#include <io.h>
 #include <vector>
 #include <algorithm>
 
-namespace QuantTrading {
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
 
-// 日志级别枚举
-enum class LogLevel {
-    DEBUG,
-    INFO,
-    WARNING,
-    ERROR,
-    FATAL
-};
+namespace QuantTrading {
 
-// 日志消息结构
-struct LogMessage {
-    LogLevel level;
-    std::string timestamp;
-    std::string message;
-    std::string file;
-    int line;
-    std::string function;
+// 日志文件格式
+enum class LogFileFormat {
+    TEXT,      // 文本行，扩展名.log
+    BINARY     // 调用点定义加紧凑记录，扩展名.qlog，由LogDecoder工具还原为文本
 };
 
+// 异步日志
+// 调用线程只记录TSC时间戳、调用点编号和参数的原始值，写入本线程独占的无锁字节环，不加锁、不分配内存、
+// 不做格式化；后台线程轮询各线程的环，换算时间、按调用点的格式串渲染并成批写文件，每批刷新一次。
+// 环满时DEBUG到WARNING级别的记录丢弃并计数，ERROR和FATAL等待后台线程腾出空间。
+// 二进制模式下后台线程不做格式化，调用点的文件、函数和格式串在每个文件中只写一次，记录只带时间差、
+// 调用点编号和变长编码的参数，文件通常只有文本的几分之一。
 class AsyncLogger {
 public:
     static AsyncLogger& getInstance() {
@@ -45,18 +41,46 @@ public:
     }
 
     // 初始化日志系统
-    void init(const std::string& logDir = "logs", 
+    void init(const std::string& logDir = "logs",
               const std::string& logPrefix = "quant_trading",
               LogLevel minLevel = LogLevel::DEBUG,
               size_t maxFileSize = 10 * 1024 * 1024,  // 10MB
-              size_t maxFiles = 5);
+              size_t maxFiles = 5,
+              size_t ringBytes = 1024 * 1024,         // 每个线程的环容量，取整为2的幂
+              LogFileFormat fileFormat = LogFileFormat::TEXT);
 
-    // 停止日志系统
+    // 停止日志系统，写完已记录的日志后返回
     void stop();
 
-    // 日志记录接口
-    void log(LogLevel level, const std::string& message, 
-             const std::string& file, int line, const std::string& function);
+    // 级别是否输出，日志宏据此跳过参数求值
+    bool isEnabled(LogLevel level) const {
+        return level >= minLevel_.load(std::memory_order_relaxed);
+    }
+
+    // 记录日志（由日志宏调用）：首参为字符串字面量时作为调用点的格式串，{}依次替换为其余参数
+    template<size_t N, typename... Args>
+    void write(LogSite& site, const char (&format)[N], const Args&... args) {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0) {
+            id = registerSite(site, format);
+        }
+        append(site.level, id, args...);
+    }
+
+    // 记录运行时拼接的消息
+    void write(LogSite& site, const std::string& message) {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0) {
+            id = registerSite(site, "{}");
+        }
+        append(site.level, id, message);
+    }
+
+    // 获取尚未写入文件的日志条数
+    size_t getPendingCount() const;
+
+    // 获取因环满丢弃的日志条数
+    uint64_t getDroppedCount() const;
 
 private:
     AsyncLogger();
@@ -66,48 +90,144 @@ private:
     AsyncLogger(const AsyncLogger&) = delete;
     AsyncLogger& operator=(const AsyncLogger&) = delete;
 
+    template<typename... Args>
+    void append(LogLevel level, uint32_t siteId, const Args&... args) {
+        uint64_t timestamp = __rdtsc();
+        size_t size = sizeof(LogRecordHeader) + LogArgs::totalSize(args...);
+
+        LogRing* ring = threadRing_;
+        if (!ring) {
+            ring = attachThread();
+        }
+        if (size > ring->maxRecordSize()) {
+            ring->drop();
+            return;
+        }
+
+        char* buffer = ring->reserve(size);
+        if (!buffer) {
+            buffer = waitForSpace(*ring, level, size);
+            if (!buffer) {
+                return;
+            }
+        }
+
+        LogRecordHeader* header = reinterpret_cast<LogRecordHeader*>(buffer);
+        header->size = static_cast<uint32_t>(size);
+        header->siteId = siteId;
+        header->timestamp = timestamp;
+        LogArgs::encodeAll(buffer + sizeof(LogRecordHeader), args...);
+        ring->commit();
+    }
+
+    // 登记调用点，返回编号
+    uint32_t registerSite(LogSite& site, const char* format);
+
+    // 为当前线程创建并登记环
+    LogRing* attachThread();
+
+    // 环满时：ERROR及以上等待后台线程腾出空间，其余级别丢弃，返回nullptr
+    char* waitForSpace(LogRing& ring, LogLevel level, size_t size);
+
     // 日志处理线程函数
     void processLogs();
 
-    // 获取日志级别字符串
-    std::string getLevelString(LogLevel level);
+    // 读出各线程环中的记录写入写缓冲，返回读出的条数
+    size_t drainRings();
+
+    // 按文件格式把一条记录写入写缓冲
+    void writeRecord(uint32_t siteId, int64_t epochNs, const char* args, const char* end);
+
+    // 写出写缓冲并刷新
+    void flushBuffer();
+
+    // TSC换算为纪元纳秒，recalibrate按累计的TSC和时钟增量修正频率
+    int64_t toEpochNs(uint64_t tsc) const;
+    void recalibrate();
 
     // 获取当前时间戳字符串
     std::string getCurrentTimestamp();
 
+    // 打开新的日志文件，二进制格式写入文件头
+    bool openLogFile();
+    const char* getFileExtension() const;
+
     // 检查并轮转日志文件
     void checkAndRotateLogFile();
 
-    // 创建目录
-    bool createDirectory(const std::string& path);
-
-    // 获取目录中的文件列表
-    std::vector<std::string> getDirectoryFiles(const std::string& path, const std::string& extension);
-
-    // 删除文件
-    bool deleteFile(const std::string& path);
+    static thread_local LogRing* threadRing_;
 
     // 成员变量
     std::string logDir_;
     std::string logPrefix_;
-    LogLevel minLevel_;
+    std::atomic<LogLevel> minLevel_;
     size_t maxFileSize_;
     size_t maxFiles_;
+    size_t ringBytes_;
+    LogFileFormat fileFormat_;
     std::string currentLogFile_;
     std::ofstream logFile_;
-    std::queue<LogMessage> logQueue_;
-    std::mutex queueMutex_;
-    std::condition_variable queueCondition_;
     std::thread logThread_;
     std::atomic<bool> running_;
-    std::atomic<size_t> currentFileSize_;
+    size_t currentFileSize_;
+
+    // 调用点表，编号为下标加1
+    std::vector<const LogSite*> sites_;
+    std::mutex sitesMutex_;
+    std::vector<const LogSite*> writerSites_;     // 后台线程的副本
+
+    // 后台线程持有的环及已报告的丢弃数
+    struct WriterRing {
+        std::shared_ptr<LogRing> ring;
+        uint64_t reportedDrops;
+
+        WriterRing(std::shared_ptr<LogRing> ring, uint64_t reportedDrops)
+            : ring(ring), reportedDrops(reportedDrops) {}
+    };
+
+    // 各线程的环
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    mutable std::mutex ringsMutex_;
+    std::atomic<uint64_t> ringsVersion_;
+    std::vector<WriterRing> writerRings_;
+    uint64_t writerRingsVersion_;
+    std::atomic<uint64_t> droppedTotal_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    // TSC校准：频率按启动以来的TSC和单调时钟增量计算，换算起点每次修正时对齐到系统时钟
+    uint64_t startTsc_;
+    int64_t startSteadyNs_;
+    uint64_t baseTsc_;
+    int64_t baseEpochNs_;
+    double ticksPerNs_;
+    int64_t lastCalibrationNs_;
+
+    // 写缓冲和文本模式的渲染状态
+    std::string writeBuffer_;
+    std::string message_;
+    LogLineFormatter lineFormatter_;
+
+    // 二进制模式：当前文件已写出定义的调用点、参数编码缓冲和上一条记录的时间
+    std::vector<bool> fileSites_;
+    std::string packedArgs_;
+    int64_t lastRecordNs_;
 };
 
 } // namespace QuantTrading
 
-// 日志宏定义
-#define LOG_DEBUG(msg) QuantTrading::AsyncLogger::getInstance().log(QuantTrading::LogLevel::DEBUG, msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_INFO(msg) QuantTrading::AsyncLogger::getInstance().log(QuantTrading::LogLevel::INFO, msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_WARNING(msg) QuantTrading::AsyncLogger::getInstance().log(QuantTrading::LogLevel::WARNING, msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_ERROR(msg) QuantTrading::AsyncLogger::getInstance().log(QuantTrading::LogLevel::ERROR, msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_FATAL(msg) QuantTrading::AsyncLogger::getInstance().log(QuantTrading::LogLevel::FATAL, msg, __FILE__, __LINE__, __FUNCTION__) 
\ No newline at end of file
+// 日志宏：级别未启用时不对参数求值；每处调用点一个静态LogSite
+#define QUANT_LOG(level, ...) \
+    do { \
+        if (QuantTrading::AsyncLogger::getInstance().isEnabled(level)) { \
+            static QuantTrading::LogSite quantLogSite_(level, __FILE__, __LINE__, __FUNCTION__); \
+            QuantTrading::AsyncLogger::getInstance().write(quantLogSite_, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(...) QUANT_LOG(QuantTrading::LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) QUANT_LOG(QuantTrading::LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) QUANT_LOG(QuantTrading::LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) QUANT_LOG(QuantTrading::LogLevel::ERROR, __VA_ARGS__)
+#define LOG_FATAL(...) QUANT_LOG(QuantTrading::LogLevel::FATAL, __VA_ARGS__)
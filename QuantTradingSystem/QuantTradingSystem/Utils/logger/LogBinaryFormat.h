@@ -0,0 +1,186 @@
+#pragma once
+
+#include "LogRecord.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace QuantTrading {
+
+// 二进制日志文件格式
+// 文件头为8字节魔数加4字节版本号，之后是连续的条目，每个条目以变长整数的调用点编号开头：
+//   编号为0：调用点定义  varint(编号) u8(级别) varint(行号) str(文件) str(函数) str(格式串)
+//   编号非0：日志记录    varint(zigzag(与上一条记录的时间差，纳秒)) varint(参数字节数) 参数
+// 参数沿用环中的类型标记，整数改为变长编码，字符串长度改为变长整数；str为变长长度加内容。
+// 每个文件自成一体：调用点在文件中首次出现前写出定义，第一条记录的时间差相对于0即纪元纳秒。
+namespace LogBinary {
+
+const char MAGIC[8] = { 'Q', 'T', 'L', 'O', 'G', 'B', 'I', 'N' };
+const uint32_t VERSION = 1;
+const size_t FILE_HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t);
+
+inline void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline bool getVarint(const char*& p, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void putString(std::string& out, const char* data, size_t length) {
+    putVarint(out, length);
+    out.append(data, length);
+}
+
+inline bool getString(const char*& p, const char* end, std::string& value) {
+    uint64_t length;
+    if (!getVarint(p, end, length) || length > static_cast<uint64_t>(end - p)) {
+        return false;
+    }
+    value.assign(p, static_cast<size_t>(length));
+    p += length;
+    return true;
+}
+
+inline void writeFileHeader(std::string& out) {
+    out.append(MAGIC, sizeof(MAGIC));
+    uint32_t version = VERSION;
+    out.append(reinterpret_cast<const char*>(&version), sizeof(version));
+}
+
+inline bool checkFileHeader(const char* data, size_t size) {
+    uint32_t version;
+    if (size < FILE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    std::memcpy(&version, data + sizeof(MAGIC), sizeof(version));
+    return version == VERSION;
+}
+
+inline void writeSiteDefinition(std::string& out, uint32_t id, const LogSite& site) {
+    putVarint(out, 0);
+    putVarint(out, id);
+    out.push_back(static_cast<char>(site.level));
+    putVarint(out, static_cast<uint64_t>(site.line));
+    putString(out, site.file, std::strlen(site.file));
+    putString(out, site.function, std::strlen(site.function));
+    putString(out, site.format, std::strlen(site.format));
+}
+
+// 环中的参数改写为文件中的紧凑编码，参数数据不完整时返回false
+inline bool compactArgs(std::string& out, const char* p, const char* end) {
+    while (p < end) {
+        LogArgType type = static_cast<LogArgType>(*p);
+        out.push_back(*p++);
+        switch (type) {
+            case LogArgType::BOOL:
+            case LogArgType::CHAR:
+                if (p + 1 > end) return false;
+                out.push_back(*p++);
+                break;
+            case LogArgType::INT64: {
+                if (p + 8 > end) return false;
+                int64_t v;
+                std::memcpy(&v, p, 8);
+                putVarint(out, zigzag(v));
+                p += 8;
+                break;
+            }
+            case LogArgType::UINT64: {
+                if (p + 8 > end) return false;
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                putVarint(out, v);
+                p += 8;
+                break;
+            }
+            case LogArgType::DOUBLE:
+                if (p + 8 > end) return false;
+                out.append(p, 8);
+                p += 8;
+                break;
+            case LogArgType::STRING: {
+                if (p + 4 > end) return false;
+                uint32_t n;
+                std::memcpy(&n, p, 4);
+                p += 4;
+                if (n > static_cast<size_t>(end - p)) return false;
+                putString(out, p, n);
+                p += n;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+// 文件中的紧凑参数还原为环中的编码，供formatLogMessage渲染；数据损坏时返回false
+inline bool expandArgs(std::string& out, const char* p, const char* end) {
+    while (p < end) {
+        LogArgType type = static_cast<LogArgType>(*p);
+        out.push_back(*p++);
+        switch (type) {
+            case LogArgType::BOOL:
+            case LogArgType::CHAR:
+                if (p + 1 > end) return false;
+                out.push_back(*p++);
+                break;
+            case LogArgType::INT64: {
+                uint64_t raw;
+                if (!getVarint(p, end, raw)) return false;
+                int64_t v = unzigzag(raw);
+                out.append(reinterpret_cast<const char*>(&v), 8);
+                break;
+            }
+            case LogArgType::UINT64: {
+                uint64_t v;
+                if (!getVarint(p, end, v)) return false;
+                out.append(reinterpret_cast<const char*>(&v), 8);
+                break;
+            }
+            case LogArgType::DOUBLE:
+                if (p + 8 > end) return false;
+                out.append(p, 8);
+                p += 8;
+                break;
+            case LogArgType::STRING: {
+                uint64_t n;
+                if (!getVarint(p, end, n) || n > static_cast<uint64_t>(end - p)) return false;
+                uint32_t length = static_cast<uint32_t>(n);
+                out.append(reinterpret_cast<const char*>(&length), 4);
+                out.append(p, length);
+                p += length;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace LogBinary
+
+} // namespace QuantTrading
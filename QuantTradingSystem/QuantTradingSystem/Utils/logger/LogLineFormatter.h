@@ -0,0 +1,62 @@
+#pragma once
+
+#include "LogRecord.h"
+#include <charconv>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+namespace QuantTrading {
+
+// 文本日志行：[YYYYmmdd_HHMMSS_mmm] [级别] [文件:行号] [函数] 消息
+// 时间前缀按秒缓存，同一秒内的记录只拼接毫秒。文本模式的后台线程和二进制日志解码工具共用
+class LogLineFormatter {
+public:
+    LogLineFormatter() : cachedSecond_(-1) {
+        cachedPrefix_[0] = '\0';
+    }
+
+    void append(std::string& out, LogLevel level, const char* file, int line, const char* function,
+                int64_t epochNs, const std::string& message) {
+        int64_t second = epochNs / 1000000000;
+        int millisec = static_cast<int>((epochNs % 1000000000) / 1000000);
+
+        if (second != cachedSecond_) {
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm timeInfo;
+            localtime_s(&timeInfo, &time);
+            std::strftime(cachedPrefix_, sizeof(cachedPrefix_), "%Y%m%d_%H%M%S", &timeInfo);
+            cachedSecond_ = second;
+        }
+
+        char millis[3] = {
+            static_cast<char>('0' + millisec / 100),
+            static_cast<char>('0' + millisec / 10 % 10),
+            static_cast<char>('0' + millisec % 10)
+        };
+        char lineNumber[16];
+        char* lineEnd = std::to_chars(lineNumber, lineNumber + sizeof(lineNumber), line).ptr;
+
+        out.push_back('[');
+        out.append(cachedPrefix_);
+        out.push_back('_');
+        out.append(millis, 3);
+        out.append("] [");
+        out.append(getLogLevelName(level));
+        out.append("] [");
+        out.append(file);
+        out.push_back(':');
+        out.append(lineNumber, lineEnd);
+        out.append("] [");
+        out.append(function);
+        out.append("] ");
+        out.append(message);
+        out.push_back('\n');
+    }
+
+private:
+    int64_t cachedSecond_;
+    char cachedPrefix_[32];
+};
+
+} // namespace QuantTrading
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace QuantTrading {
+
+// 日志级别枚举
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR,
+    FATAL
+};
+
+// 日志级别字符串
+inline const char* getLogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:   return "DEBUG";
+        case LogLevel::INFO:    return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR:   return "ERROR";
+        case LogLevel::FATAL:   return "FATAL";
+        default:                return "UNKNOWN";
+    }
+}
+
+// 日志调用点，每个日志宏展开处一个静态实例
+// 级别、文件、行号、函数和格式串都是常量，记录中只带调用点编号；首次记录时登记并分配编号
+struct LogSite {
+    LogLevel level;
+    const char* file;
+    int line;
+    const char* function;
+    const char* format;              // 登记时写入，之后不变
+    std::atomic<uint32_t> id;        // 0为尚未登记
+
+    LogSite(LogLevel level, const char* file, int line, const char* function)
+        : level(level), file(file), line(line), function(function), format(nullptr), id(0) {}
+
+    LogSite(const LogSite&) = delete;
+    LogSite& operator=(const LogSite&) = delete;
+};
+
+// 记录头，记录在环中按8字节对齐存放
+struct LogRecordHeader {
+    uint32_t size;                   // 记录头加参数的字节数，不含对齐填充
+    uint32_t siteId;                 // 0为环尾的填充
+    uint64_t timestamp;              // 前端为TSC，写出后为纪元纳秒
+};
+
+static_assert(sizeof(LogRecordHeader) == 16, "LogRecordHeader layout");
+
+// 参数类型标记，每个参数以1字节标记开头，之后是小端的原始值；字符串为4字节长度加内容
+enum class LogArgType : uint8_t {
+    BOOL = 1,
+    CHAR,
+    INT64,
+    UINT64,
+    DOUBLE,
+    STRING
+};
+
+// 参数编码
+// 整数统一放宽为64位，浮点数放宽为double，枚举按底层整数记录；字符串拷贝内容，单个参数超长时截断
+namespace LogArgs {
+
+const size_t MAX_STRING = 16 * 1024;
+
+template<typename T>
+struct Unsupported : std::false_type {};
+
+template<typename T>
+inline size_t encodedSize(const T& value) {
+    typedef typename std::decay<T>::type D;
+    if constexpr (std::is_same<D, bool>::value || std::is_same<D, char>::value) {
+        return 2;
+    } else if constexpr (std::is_integral<D>::value || std::is_enum<D>::value || std::is_floating_point<D>::value) {
+        return 1 + 8;
+    } else if constexpr (std::is_same<D, const char*>::value || std::is_same<D, char*>::value) {
+        return 1 + 4 + std::min(value ? std::strlen(value) : 0, MAX_STRING);
+    } else if constexpr (std::is_same<D, std::string>::value || std::is_same<D, std::string_view>::value) {
+        return 1 + 4 + std::min(value.size(), MAX_STRING);
+    } else {
+        static_assert(Unsupported<D>::value, "unsupported log argument type");
+        return 0;
+    }
+}
+
+inline char* putString(char* out, const char* data, size_t length) {
+    uint32_t n = static_cast<uint32_t>(std::min(length, MAX_STRING));
+    *out++ = static_cast<char>(LogArgType::STRING);
+    std::memcpy(out, &n, 4);
+    std::memcpy(out + 4, data, n);
+    return out + 4 + n;
+}
+
+template<typename T>
+inline char* encode(char* out, const T& value) {
+    typedef typename std::decay<T>::type D;
+    if constexpr (std::is_same<D, bool>::value) {
+        out[0] = static_cast<char>(LogArgType::BOOL);
+        out[1] = value ? 1 : 0;
+        return out + 2;
+    } else if constexpr (std::is_same<D, char>::value) {
+        out[0] = static_cast<char>(LogArgType::CHAR);
+        out[1] = value;
+        return out + 2;
+    } else if constexpr (std::is_floating_point<D>::value) {
+        double v = static_cast<double>(value);
+        out[0] = static_cast<char>(LogArgType::DOUBLE);
+        std::memcpy(out + 1, &v, 8);
+        return out + 9;
+    } else if constexpr (std::is_enum<D>::value) {
+        int64_t v = static_cast<int64_t>(value);
+        out[0] = static_cast<char>(LogArgType::INT64);
+        std::memcpy(out + 1, &v, 8);
+        return out + 9;
+    } else if constexpr (std::is_integral<D>::value && std::is_signed<D>::value) {
+        int64_t v = value;
+        out[0] = static_cast<char>(LogArgType::INT64);
+        std::memcpy(out + 1, &v, 8);
+        return out + 9;
+    } else if constexpr (std::is_integral<D>::value) {
+        uint64_t v = value;
+        out[0] = static_cast<char>(LogArgType::UINT64);
+        std::memcpy(out + 1, &v, 8);
+        return out + 9;
+    } else if constexpr (std::is_same<D, const char*>::value || std::is_same<D, char*>::value) {
+        return putString(out, value ? value : "", value ? std::strlen(value) : 0);
+    } else {
+        return putString(out, value.data(), value.size());
+    }
+}
+
+inline size_t totalSize() { return 0; }
+
+template<typename T, typename... Rest>
+inline size_t totalSize(const T& first, const Rest&... rest) {
+    return encodedSize(first) + totalSize(rest...);
+}
+
+inline char* encodeAll(char* out) { return out; }
+
+template<typename T, typename... Rest>
+inline char* encodeAll(char* out, const T& first, const Rest&... rest) {
+    return encodeAll(encode(out, first), rest...);
+}
+
+// 解码一个参数追加到out，返回下一个参数的位置，数据不完整时返回nullptr
+inline const char* render(std::string& out, const char* p, const char* end) {
+    if (p >= end) return nullptr;
+    LogArgType type = static_cast<LogArgType>(*p++);
+    char buffer[32];
+    switch (type) {
+        case LogArgType::BOOL:
+            if (p + 1 > end) return nullptr;
+            out.append(*p ? "true" : "false");
+            return p + 1;
+        case LogArgType::CHAR:
+            if (p + 1 > end) return nullptr;
+            out.push_back(*p);
+            return p + 1;
+        case LogArgType::INT64: {
+            if (p + 8 > end) return nullptr;
+            int64_t v;
+            std::memcpy(&v, p, 8);
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+            return p + 8;
+        }
+        case LogArgType::UINT64: {
+            if (p + 8 > end) return nullptr;
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+            return p + 8;
+        }
+        case LogArgType::DOUBLE: {
+            if (p + 8 > end) return nullptr;
+            double v;
+            std::memcpy(&v, p, 8);
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+            return p + 8;
+        }
+        case LogArgType::STRING: {
+            if (p + 4 > end) return nullptr;
+            uint32_t n;
+            std::memcpy(&n, p, 4);
+            p += 4;
+            if (n > static_cast<size_t>(end - p)) return nullptr;
+            out.append(p, n);
+            return p + n;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace LogArgs
+
+// 按格式串渲染消息，{}依次替换为参数，{{和}}转义为花括号；多余的参数追加在末尾
+inline void formatLogMessage(std::string& out, const char* format, const char* args, const char* end) {
+    const char* p = args;
+    for (const char* f = format; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}') {
+            if (p && p < end) {
+                p = LogArgs::render(out, p, end);
+            }
+            ++f;
+        } else if ((f[0] == '{' && f[1] == '{') || (f[0] == '}' && f[1] == '}')) {
+            out.push_back(*f);
+            ++f;
+        } else {
+            out.push_back(*f);
+        }
+    }
+    while (p && p < end) {
+        out.push_back(' ');
+        p = LogArgs::render(out, p, end);
+    }
+}
+
+} // namespace QuantTrading
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "LogRecord.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace QuantTrading {
+
+// 日志记录的单生产者单消费者字节环
+// 每个写日志的线程独占一个，后台线程读取。记录按8字节对齐连续存放，环尾放不下时写一个填充记录后从头开始，
+// 读取方跳过填充。容量必须为2的幂且为8的倍数。缓冲在创建时清零，内存页在线程登记时就已分配，记录时不缺页。
+class LogRing {
+public:
+    explicit LogRing(size_t capacity)
+        : capacity_(capacity), mask_(capacity - 1), buffer_(new char[capacity]()),
+          head_(0), cachedTail_(0), consumed_(0),
+          tail_(0), cachedHead_(0), reservedTail_(0), produced_(0), dropped_(0),
+          closed_(false) {}
+
+    // 禁止拷贝和赋值
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    static size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+    // 单条记录的上限
+    size_t maxRecordSize() const { return capacity_ / 4; }
+
+    // 预留一条记录的空间（仅生产者线程调用），空间不足时返回nullptr；填好后调用commit发布
+    char* reserve(size_t size) {
+        size_t aligned = align(size);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        size_t offset = static_cast<size_t>(tail & mask_);
+        size_t contiguous = capacity_ - offset;
+        size_t needed = aligned <= contiguous ? aligned : contiguous + aligned;
+        if (!hasSpace(tail, needed)) {
+            return nullptr;
+        }
+
+        if (aligned > contiguous) {
+            LogRecordHeader* padding = reinterpret_cast<LogRecordHeader*>(buffer_.get() + offset);
+            padding->size = static_cast<uint32_t>(contiguous);
+            padding->siteId = 0;
+            tail += contiguous;
+            offset = 0;
+        }
+        reservedTail_ = tail + aligned;
+        return buffer_.get() + offset;
+    }
+
+    void commit() {
+        produced_.store(produced_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        tail_.store(reservedTail_, std::memory_order_release);
+    }
+
+    // 记一次因环满丢弃（仅生产者线程调用）
+    void drop() {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // 队首记录（仅消费者线程调用），跳过填充，环空时返回nullptr；处理完调用pop释放
+    const LogRecordHeader* front() {
+        for (;;) {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) {
+                    return nullptr;
+                }
+            }
+
+            const LogRecordHeader* record =
+                reinterpret_cast<const LogRecordHeader*>(buffer_.get() + (head & mask_));
+            if (record->siteId != 0) {
+                return record;
+            }
+            head_.store(head + record->size, std::memory_order_release);
+        }
+    }
+
+    void pop(const LogRecordHeader* record) {
+        consumed_.store(consumed_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        head_.store(head_.load(std::memory_order_relaxed) + align(record->size), std::memory_order_release);
+    }
+
+    // 尚未读取的记录数（近似值）
+    size_t pending() const {
+        uint64_t produced = produced_.load(std::memory_order_relaxed);
+        uint64_t consumed = consumed_.load(std::memory_order_relaxed);
+        return produced > consumed ? static_cast<size_t>(produced - consumed) : 0;
+    }
+
+    // 累计丢弃的记录数
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 所属线程退出后标记，读空后由消费者回收
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    bool hasSpace(uint64_t tail, size_t needed) {
+        if (tail + needed - cachedHead_ <= capacity_) {
+            return true;
+        }
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        return tail + needed - cachedHead_ <= capacity_;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<char[]> buffer_;
+
+    // 消费者侧：读位置及缓存的写位置
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_;
+    uint64_t cachedTail_;
+    std::atomic<uint64_t> consumed_;
+
+    // 生产者侧：写位置及缓存的读位置
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_;
+    uint64_t cachedHead_;
+    uint64_t reservedTail_;
+    std::atomic<uint64_t> produced_;
+    std::atomic<uint64_t> dropped_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> closed_;
+};
+
+} // namespace QuantTrading
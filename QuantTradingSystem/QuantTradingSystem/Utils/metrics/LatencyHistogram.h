@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// HDR风格的对数-线性直方图
+// 数值按最高有效位分组，每组再线性细分为SUB_BUCKET_HALF个桶，相对误差不超过 1/SUB_BUCKET_HALF。
+// record() 只做一次 relaxed fetch_add，可在多个线程上并发调用。
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 7;
+    static const size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;   // 128
+    static const size_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;             // 64
+    static const size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+    
+    LatencyHistogram() {
+        reset();
+    }
+    
+    // 禁止拷贝和赋值
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    // 记录一个数值（负数按0处理）
+    void record(int64_t value) {
+        uint64_t v = value > 0 ? static_cast<uint64_t>(value) : 0;
+        buckets_[bucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        
+        uint64_t currentMax = max_.load(std::memory_order_relaxed);
+        while (v > currentMax &&
+               !max_.compare_exchange_weak(currentMax, v, std::memory_order_relaxed)) {
+        }
+    }
+    
+    // 合并另一个直方图的数据
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+            if (n > 0) {
+                buckets_[i].fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+        count_.fetch_add(other.getCount(), std::memory_order_relaxed);
+        sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        
+        uint64_t otherMax = other.getMax();
+        uint64_t currentMax = max_.load(std::memory_order_relaxed);
+        while (otherMax > currentMax &&
+               !max_.compare_exchange_weak(currentMax, otherMax, std::memory_order_relaxed)) {
+        }
+    }
+    
+    // 清空所有数据
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+    
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+    
+    double getMean() const {
+        uint64_t n = getCount();
+        return n > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+    
+    // 获取百分位数值，percentile取值 0~100
+    uint64_t getPercentile(double percentile) const {
+        uint64_t total = getCount();
+        if (total == 0) {
+            return 0;
+        }
+        
+        uint64_t target = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+        if (target < 1) target = 1;
+        if (target > total) target = total;
+        
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                uint64_t upper = bucketUpperBound(i);
+                uint64_t currentMax = getMax();
+                return upper < currentMax ? upper : currentMax;
+            }
+        }
+        
+        return getMax();
+    }
+    
+private:
+    static int highestBit(uint64_t v) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, v);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(v);
+#endif
+    }
+    
+    static size_t bucketIndex(uint64_t v) {
+        if (v < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(v);
+        }
+        
+        int shift = highestBit(v) - SUB_BUCKET_BITS + 1;
+        size_t sub = static_cast<size_t>(v >> shift);  // [SUB_BUCKET_HALF, SUB_BUCKET_COUNT)
+        return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + (sub - SUB_BUCKET_HALF);
+    }
+    
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        
+        size_t offset = index - SUB_BUCKET_COUNT;
+        int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+        uint64_t sub = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+        return ((sub + 1) << shift) - 1;
+    }
+    
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// 指标分片数量，每个线程固定映射到一个分片
+static const size_t METRICS_SHARD_COUNT = 16;
+
+// 获取当前线程对应的分片下标（首次调用时分配，之后只是一次thread_local读取）
+inline size_t metricsShardIndex() {
+    static std::atomic<size_t> nextIndex(0);
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARD_COUNT;
+    return index;
+}
+
+// 计数器：按线程分片累加，读取时合并
+// add() 只对本线程所在缓存行做一次 relaxed fetch_add，不与其他线程争用
+class MetricCounter {
+public:
+    MetricCounter() = default;
+
+    // 禁止拷贝和赋值
+    MetricCounter(const MetricCounter&) = delete;
+    MetricCounter& operator=(const MetricCounter&) = delete;
+
+    void add(uint64_t n = 1) {
+        shards_[metricsShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() {
+        for (auto& shard : shards_) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Shard, METRICS_SHARD_COUNT> shards_;
+};
+
+// 瞬时值指标
+class MetricGauge {
+public:
+    MetricGauge() : value_(0) {}
+
+    // 禁止拷贝和赋值
+    MetricGauge(const MetricGauge&) = delete;
+    MetricGauge& operator=(const MetricGauge&) = delete;
+
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t get() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<int64_t> value_;
+};
+
+// 直方图：按线程分片，分片在该线程第一次记录时分配，读取时合并
+class MetricHistogram {
+public:
+    MetricHistogram() {
+        for (auto& shard : shards_) {
+            shard.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~MetricHistogram() {
+        for (auto& shard : shards_) {
+            delete shard.load(std::memory_order_relaxed);
+        }
+    }
+
+    // 禁止拷贝和赋值
+    MetricHistogram(const MetricHistogram&) = delete;
+    MetricHistogram& operator=(const MetricHistogram&) = delete;
+
+    void record(int64_t value) {
+        size_t index = metricsShardIndex();
+        LatencyHistogram* histogram = shards_[index].load(std::memory_order_acquire);
+        if (!histogram) {
+            histogram = allocateShard(index);
+        }
+        histogram->record(value);
+    }
+
+    // 将所有分片合并到result中
+    void snapshot(LatencyHistogram& result) const {
+        for (const auto& shard : shards_) {
+            LatencyHistogram* histogram = shard.load(std::memory_order_acquire);
+            if (histogram) {
+                result.merge(*histogram);
+            }
+        }
+    }
+
+    void reset() {
+        for (auto& shard : shards_) {
+            LatencyHistogram* histogram = shard.load(std::memory_order_acquire);
+            if (histogram) {
+                histogram->reset();
+            }
+        }
+    }
+
+private:
+    LatencyHistogram* allocateShard(size_t index) {
+        LatencyHistogram* created = new LatencyHistogram();
+        LatencyHistogram* expected = nullptr;
+        if (!shards_[index].compare_exchange_strong(expected, created, std::memory_order_acq_rel)) {
+            // 同一分片上的其他线程已经分配
+            delete created;
+            return expected;
+        }
+        return created;
+    }
+
+    std::array<std::atomic<LatencyHistogram*>, METRICS_SHARD_COUNT> shards_;
+};
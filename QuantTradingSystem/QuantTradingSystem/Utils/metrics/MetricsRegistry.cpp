@@ -0,0 +1,168 @@
+#include "MetricsRegistry.h"
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+MetricsRegistry::MetricsRegistry()
+    : lastDumpTime_(std::chrono::steady_clock::now()), reporterRunning_(false) {
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    stopReporter();
+}
+
+MetricCounter& MetricsRegistry::getCounter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& counter = counters_[name];
+    if (!counter) {
+        counter = std::make_unique<MetricCounter>();
+    }
+    return *counter;
+}
+
+MetricGauge& MetricsRegistry::getGauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& gauge = gauges_[name];
+    if (!gauge) {
+        gauge = std::make_unique<MetricGauge>();
+    }
+    return *gauge;
+}
+
+MetricHistogram& MetricsRegistry::getHistogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& histogram = histograms_[name];
+    if (!histogram) {
+        histogram = std::make_unique<MetricHistogram>();
+    }
+    return *histogram;
+}
+
+void MetricsRegistry::registerProbe(const std::string& name, std::function<int64_t()> probe) {
+    if (!probe) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    probes_[name] = probe;
+}
+
+void MetricsRegistry::unregisterProbe(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    probes_.erase(name);
+}
+
+void MetricsRegistry::dump(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+
+    auto steadyNow = std::chrono::steady_clock::now();
+    double elapsedSeconds = std::chrono::duration<double>(steadyNow - lastDumpTime_).count();
+    lastDumpTime_ = steadyNow;
+
+    os << "==== Metrics report " << std::put_time(std::localtime(&now_time_t), "%Y-%m-%d %H:%M:%S")
+       << " ====" << std::endl;
+
+    // 计数器：累计值及速率
+    os << std::left << std::setw(48) << "counter"
+       << std::right << std::setw(16) << "total"
+       << std::setw(14) << "per_sec" << std::endl;
+    for (const auto& pair : counters_) {
+        uint64_t value = pair.second->get();
+        uint64_t& last = lastCounterValues_[pair.first];
+        double rate = elapsedSeconds > 0.0 ? (value - last) / elapsedSeconds : 0.0;
+        last = value;
+
+        os << std::left << std::setw(48) << pair.first
+           << std::right << std::setw(16) << value
+           << std::setw(14) << std::fixed << std::setprecision(1) << rate << std::endl;
+    }
+
+    // 瞬时值及采样型指标
+    os << std::left << std::setw(48) << "gauge"
+       << std::right << std::setw(16) << "value" << std::endl;
+    for (const auto& pair : gauges_) {
+        os << std::left << std::setw(48) << pair.first
+           << std::right << std::setw(16) << pair.second->get() << std::endl;
+    }
+    for (const auto& pair : probes_) {
+        os << std::left << std::setw(48) << pair.first
+           << std::right << std::setw(16) << pair.second() << std::endl;
+    }
+
+    // 直方图（纳秒）
+    os << std::left << std::setw(48) << "histogram (ns)"
+       << std::right << std::setw(12) << "count"
+       << std::setw(12) << "mean"
+       << std::setw(12) << "p50"
+       << std::setw(12) << "p99"
+       << std::setw(12) << "p99.9"
+       << std::setw(14) << "max" << std::endl;
+    for (const auto& pair : histograms_) {
+        LatencyHistogram merged;
+        pair.second->snapshot(merged);
+        if (merged.getCount() == 0) {
+            continue;
+        }
+
+        os << std::left << std::setw(48) << pair.first
+           << std::right << std::setw(12) << merged.getCount()
+           << std::setw(12) << std::fixed << std::setprecision(0) << merged.getMean()
+           << std::setw(12) << merged.getPercentile(50.0)
+           << std::setw(12) << merged.getPercentile(99.0)
+           << std::setw(12) << merged.getPercentile(99.9)
+           << std::setw(14) << merged.getMax() << std::endl;
+    }
+}
+
+bool MetricsRegistry::startReporter(const std::string& filePath, int intervalSeconds) {
+    std::lock_guard<std::mutex> lock(reporterMutex_);
+    if (reporterRunning_ || intervalSeconds <= 0) {
+        return false;
+    }
+
+    reportFile_ = filePath;
+    reporterRunning_ = true;
+    reporterThread_ = std::thread(&MetricsRegistry::reporterLoop, this, intervalSeconds);
+    return true;
+}
+
+void MetricsRegistry::stopReporter() {
+    {
+        std::lock_guard<std::mutex> lock(reporterMutex_);
+        if (!reporterRunning_) {
+            return;
+        }
+        reporterRunning_ = false;
+    }
+
+    reporterCondition_.notify_all();
+    if (reporterThread_.joinable()) {
+        reporterThread_.join();
+    }
+
+    // 停止时写入最终结果
+    writeReport();
+}
+
+void MetricsRegistry::reporterLoop(int intervalSeconds) {
+    std::unique_lock<std::mutex> lock(reporterMutex_);
+    while (reporterRunning_) {
+        reporterCondition_.wait_for(lock, std::chrono::seconds(intervalSeconds));
+        if (!reporterRunning_) {
+            break;
+        }
+
+        lock.unlock();
+        writeReport();
+        lock.lock();
+    }
+}
+
+void MetricsRegistry::writeReport() {
+    std::ofstream file(reportFile_, std::ios::app);
+    if (file.is_open()) {
+        dump(file);
+        file << std::endl;
+    }
+}
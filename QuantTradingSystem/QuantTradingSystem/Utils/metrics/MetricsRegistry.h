@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Metrics.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// 指标注册中心
+// 指标按名称注册一次，调用方保存返回的引用并在热路径上直接使用，注册中心只在输出时加锁。
+// 采样型指标（如队列深度）以回调形式注册，在输出时读取。
+class MetricsRegistry {
+public:
+    static MetricsRegistry& getInstance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // 获取或创建指标，返回的引用在进程生命周期内有效
+    MetricCounter& getCounter(const std::string& name);
+    MetricGauge& getGauge(const std::string& name);
+    MetricHistogram& getHistogram(const std::string& name);
+
+    // 注册采样型指标，同名回调会被替换
+    void registerProbe(const std::string& name, std::function<int64_t()> probe);
+
+    // 注销采样型指标（回调引用的对象销毁前必须注销）
+    void unregisterProbe(const std::string& name);
+
+    // 输出所有指标，计数器同时输出自上次输出以来的速率
+    void dump(std::ostream& os);
+
+    // 启动周期性输出线程
+    bool startReporter(const std::string& filePath, int intervalSeconds);
+
+    // 停止输出线程并写入最终结果
+    void stopReporter();
+
+private:
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    // 禁止拷贝和赋值
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    void reporterLoop(int intervalSeconds);
+    void writeReport();
+
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters_;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges_;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms_;
+    std::map<std::string, std::function<int64_t()>> probes_;
+    std::mutex mutex_;
+
+    // 上次输出时的计数器值，用于计算速率
+    std::map<std::string, uint64_t> lastCounterValues_;
+    std::chrono::steady_clock::time_point lastDumpTime_;
+
+    // 输出线程
+    std::string reportFile_;
+    std::thread reporterThread_;
+    bool reporterRunning_;
+    std::mutex reporterMutex_;
+    std::condition_variable reporterCondition_;
+};
@@ -0,0 +1,42 @@
+#include "ThreadUtil.h"
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool ThreadUtil::bindCurrentThreadToCpu(int cpuId) {
+    if (cpuId < 0 || cpuId >= getCpuCount()) {
+        return false;
+    }
+    
+#ifdef _WIN32
+    DWORD_PTR mask = static_cast<DWORD_PTR>(1) << cpuId;
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuId, &cpuSet);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#endif
+}
+
+int ThreadUtil::getCpuCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+void ThreadUtil::setCurrentThreadName(const std::string& name) {
+#ifdef _WIN32
+    std::wstring wideName(name.begin(), name.end());
+    SetThreadDescription(GetCurrentThread(), wideName.c_str());
+#else
+    // Linux线程名最长15个字符
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+
+class ThreadUtil {
+public:
+    // 将当前线程绑定到指定CPU核心，cpuId < 0 时不做绑定
+    static bool bindCurrentThreadToCpu(int cpuId);
+    
+    // 获取可用的CPU核心数
+    static int getCpuCount();
+    
+    // 设置当前线程名称（便于调试和性能分析工具识别）
+    static void setCurrentThreadName(const std::string& name);
+};
@@ -0,0 +1,145 @@
+#include "TimerService.h"
+#include "../latency/LatencyTrace.h"
+#include "../metrics/MetricsRegistry.h"
+#include <algorithm>
+
+namespace {
+
+const int64_t NS_PER_MS = 1000000;
+
+} // namespace
+
+TimerService::TimerService(const TimerServiceConfig& config)
+    : config_(config),
+      wheel_(std::max<int64_t>(1, config.resolutionMs) * NS_PER_MS, config.manualClock ? 0 : latencyNow()),
+      nextExpiryNs_(TimerWheel::NO_EXPIRY),
+      manualNowNs_(0),
+      scheduled_(MetricsRegistry::getInstance().getCounter("timers.scheduled")),
+      cancelled_(MetricsRegistry::getInstance().getCounter("timers.cancelled")),
+      fired_(MetricsRegistry::getInstance().getCounter("timers.fired")),
+      fireDelay_(MetricsRegistry::getInstance().getHistogram("timers.fire_delay_ns")) {
+    owners_.push_back(std::string());
+    ownerIndex_[std::string()] = 0;
+
+    MetricsRegistry::getInstance().registerProbe("timers.pending", [this]() {
+        return static_cast<int64_t>(getPendingCount());
+    });
+}
+
+TimerService::~TimerService() {
+    MetricsRegistry::getInstance().unregisterProbe("timers.pending");
+}
+
+void TimerService::setEventSink(EventSink sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_ = sink;
+}
+
+void TimerService::setWakeup(Wakeup wakeup) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wakeup_ = wakeup;
+}
+
+TimerService::TimerId TimerService::schedule(const std::string& owner, int64_t delayMs, uint64_t tag, int64_t intervalMs) {
+    return scheduleAt(owner, now() + std::max<int64_t>(0, delayMs) * NS_PER_MS, tag, intervalMs);
+}
+
+TimerService::TimerId TimerService::scheduleAt(const std::string& owner, int64_t deadlineNs, uint64_t tag, int64_t intervalMs) {
+    TimerId id;
+    bool earlier;
+    Wakeup wakeup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 空闲期时间轮停在上次推进的位置，先对齐到当前时间，避免新定时器放进过高的层
+        if (wheel_.size() == 0) {
+            wheel_.advance(now(), expired_);
+        }
+
+        id = wheel_.schedule(deadlineNs, tag, ownerIndex(owner), intervalMs * NS_PER_MS);
+        int64_t next = wheel_.nextExpiryNs();
+        earlier = next < nextExpiryNs_.load(std::memory_order_relaxed);
+        nextExpiryNs_.store(next, std::memory_order_release);
+        wakeup = wakeup_;
+    }
+    scheduled_.add();
+
+    if (earlier && wakeup) {
+        wakeup();
+    }
+    return id;
+}
+
+bool TimerService::cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!wheel_.cancel(id)) {
+        return false;
+    }
+    // 最早到期时间只会推后，等待方最多多醒一次
+    nextExpiryNs_.store(wheel_.nextExpiryNs(), std::memory_order_release);
+    cancelled_.add();
+    return true;
+}
+
+size_t TimerService::advance(int64_t nowNs) {
+    if (config_.manualClock) {
+        int64_t previous = manualNowNs_.load(std::memory_order_relaxed);
+        while (previous < nowNs &&
+               !manualNowNs_.compare_exchange_weak(previous, nowNs, std::memory_order_acq_rel)) {
+        }
+    }
+    if (nowNs < nextExpiryNs_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    std::vector<std::shared_ptr<Event>> events;
+    EventSink sink;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        expired_.clear();
+        wheel_.advance(nowNs, expired_);
+        nextExpiryNs_.store(wheel_.nextExpiryNs(), std::memory_order_release);
+
+        events.reserve(expired_.size());
+        for (const auto& expired : expired_) {
+            TimerEventData data;
+            data.timerId = expired.id;
+            data.owner = owners_[expired.owner];
+            data.tag = expired.tag;
+            data.deadlineNs = expired.deadlineNs;
+            data.firedNs = nowNs;
+            data.periodic = expired.periodic;
+            events.push_back(std::make_shared<TimerEvent>(data));
+            fireDelay_.record(nowNs - expired.deadlineNs);
+        }
+        sink = sink_;
+    }
+
+    fired_.add(events.size());
+    if (sink) {
+        for (auto& event : events) {
+            sink(event);
+        }
+    }
+    return events.size();
+}
+
+int64_t TimerService::now() const {
+    return config_.manualClock ? manualNowNs_.load(std::memory_order_acquire) : latencyNow();
+}
+
+size_t TimerService::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wheel_.size();
+}
+
+uint32_t TimerService::ownerIndex(const std::string& owner) {
+    auto it = ownerIndex_.find(owner);
+    if (it != ownerIndex_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = static_cast<uint32_t>(owners_.size());
+    owners_.push_back(owner);
+    ownerIndex_[owner] = index;
+    return index;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "TimerWheel.h"
+#include "../metrics/Metrics.h"
+#include "../../Events/TimerEvent.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 定时器服务配置
+struct TimerServiceConfig {
+    int64_t resolutionMs;   // 时间轮刻度
+    bool manualClock;       // 手动时钟：由回放按行情时间调用advance推进，不跟随本地单调时钟
+
+    TimerServiceConfig() : resolutionMs(1), manualClock(false) {}
+};
+
+// 定时器服务
+// 在分层时间轮上登记定时器，到期时以TIMER事件送入事件队列，由事件分发线程交给登记的策略。
+// 实时运行时由事件分发线程按最早到期时间等待并推进；回放时使用手动时钟，按行情时间推进，
+// 定时器与行情保持同一时间线。登记、取消都是O(1)，可同时挂起数百万个定时器（如逐笔订单超时）。
+// 线程安全：时间轮由一把锁保护，事件在锁外发出。
+class TimerService {
+public:
+    typedef TimerWheel::TimerId TimerId;
+    typedef std::function<void(std::shared_ptr<Event>)> EventSink;
+    typedef std::function<void()> Wakeup;
+
+    explicit TimerService(const TimerServiceConfig& config = TimerServiceConfig());
+    ~TimerService();
+
+    // 禁止拷贝和赋值
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    // 设置到期事件的去向（在使用之前调用）
+    void setEventSink(EventSink sink);
+
+    // 设置唤醒回调：新定时器早于当前最早到期时间时调用，通知推进线程重新计算等待时间
+    void setWakeup(Wakeup wakeup);
+
+    // 登记定时器，delayMs后到期；intervalMs大于0时为周期定时器，需显式取消。owner为空时是系统定时器
+    TimerId schedule(const std::string& owner, int64_t delayMs, uint64_t tag, int64_t intervalMs = 0);
+
+    // 登记在服务时钟deadlineNs到期的定时器
+    TimerId scheduleAt(const std::string& owner, int64_t deadlineNs, uint64_t tag, int64_t intervalMs = 0);
+
+    // 取消定时器，已到期或已取消时返回false
+    bool cancel(TimerId id);
+
+    // 推进到nowNs并发出到期事件，返回到期数；手动时钟下nowNs即回放时间，时间不会后退
+    size_t advance(int64_t nowNs);
+
+    // 服务时钟：手动时钟为最近一次推进的时间，否则为本地单调时钟
+    int64_t now() const;
+
+    bool isManualClock() const { return config_.manualClock; }
+
+    // 最早可能有定时器到期的时间，没有定时器时为TimerWheel::NO_EXPIRY
+    int64_t nextExpiryNs() const { return nextExpiryNs_.load(std::memory_order_acquire); }
+
+    // 挂起的定时器数
+    size_t getPendingCount() const;
+
+private:
+    // 登记者编号（持有mutex_时调用）
+    uint32_t ownerIndex(const std::string& owner);
+
+    TimerServiceConfig config_;
+    EventSink sink_;
+    Wakeup wakeup_;
+
+    TimerWheel wheel_;
+    std::vector<TimerWheel::Expired> expired_;
+    std::unordered_map<std::string, uint32_t> ownerIndex_;
+    std::vector<std::string> owners_;
+    std::atomic<int64_t> nextExpiryNs_;
+    std::atomic<int64_t> manualNowNs_;
+    mutable std::mutex mutex_;
+
+    MetricCounter& scheduled_;
+    MetricCounter& cancelled_;
+    MetricCounter& fired_;
+    MetricHistogram& fireDelay_;
+};
@@ -0,0 +1,238 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(int64_t resolutionNs, int64_t startNs)
+    : resolutionNs_(std::max<int64_t>(1, resolutionNs)),
+      currentTick_(0),
+      count_(0),
+      buckets_(BUCKET_COUNT, NIL),
+      occupied_(),
+      capacity_(0),
+      freeHead_(NIL) {
+    currentTick_ = startNs > 0 ? static_cast<uint64_t>(startNs / resolutionNs_) : 0;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int64_t deadlineNs, uint64_t tag, uint32_t owner, int64_t intervalNs) {
+    uint32_t index = allocate();
+    Node& entry = node(index);
+    entry.expiryTick = std::max(tickOf(deadlineNs), currentTick_ + 1);
+    entry.intervalTicks = intervalNs > 0 ? std::max<uint64_t>(1, tickOf(intervalNs)) : 0;
+    entry.tag = tag;
+    entry.owner = owner;
+    link(index);
+    ++count_;
+    return (static_cast<TimerId>(entry.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (id == INVALID_TIMER || index >= capacity_) {
+        return false;
+    }
+
+    Node& entry = node(index);
+    if (entry.generation != generation || entry.bucket == FREE_BUCKET) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    --count_;
+    return true;
+}
+
+size_t TimerWheel::advance(int64_t nowNs, std::vector<Expired>& expired) {
+    const uint64_t target = tickOf(nowNs + 1) - 1;   // 不超过nowNs的最后一个刻度
+    size_t fired = 0;
+
+    while (count_ > 0 && currentTick_ < target) {
+        // 跳过空刻度，直接到下一个有定时器到期或需要下移的刻度
+        currentTick_ = std::min(nextTick(), target);
+
+        // 下层转完一圈时上层对应槽下移，先高层后低层
+        if ((currentTick_ & SLOT_MASK) == 0) {
+            uint64_t tick = currentTick_ >> SLOT_BITS;
+            int level = 1;
+            while (level < LEVELS - 1 && (tick & SLOT_MASK) == 0) {
+                tick >>= SLOT_BITS;
+                ++level;
+            }
+            if (level == LEVELS - 1 && (tick & SLOT_MASK) == 0) {
+                cascade(OVERFLOW_BUCKET);
+            }
+            for (; level >= 1; --level) {
+                cascade(level * SLOTS + static_cast<uint32_t>((currentTick_ >> (level * SLOT_BITS)) & SLOT_MASK));
+            }
+        }
+
+        uint32_t slot = static_cast<uint32_t>(currentTick_ & SLOT_MASK);
+        uint32_t index = buckets_[slot];
+        buckets_[slot] = NIL;
+        occupied_[0][slot / 64] &= ~(1ULL << (slot % 64));
+        while (index != NIL) {
+            Node& entry = node(index);
+            uint32_t next = entry.next;
+
+            Expired item;
+            item.id = (static_cast<TimerId>(entry.generation) << 32) | index;
+            item.tag = entry.tag;
+            item.owner = entry.owner;
+            item.deadlineNs = static_cast<int64_t>(entry.expiryTick) * resolutionNs_;
+            item.periodic = entry.intervalTicks > 0;
+            expired.push_back(item);
+            ++fired;
+
+            if (entry.intervalTicks > 0) {
+                entry.expiryTick = std::max(entry.expiryTick + entry.intervalTicks, currentTick_ + 1);
+                link(index);
+            } else {
+                release(index);
+                --count_;
+            }
+            index = next;
+        }
+    }
+
+    currentTick_ = std::max(currentTick_, target);
+    return fired;
+}
+
+int64_t TimerWheel::nextExpiryNs() const {
+    return count_ == 0 ? NO_EXPIRY : static_cast<int64_t>(nextTick()) * resolutionNs_;
+}
+
+uint64_t TimerWheel::nextTick() const {
+    uint64_t next = ~0ULL;
+
+    // 第L层的槽在其下标对应的刻度（低8L位为0）下移或到期；不晚于当前下标的槽属于下一圈
+    for (int level = 0; level < LEVELS; ++level) {
+        const int shift = level * SLOT_BITS;
+        const uint32_t current = static_cast<uint32_t>((currentTick_ >> shift) & SLOT_MASK);
+        const uint64_t roundBase = (currentTick_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+
+        uint32_t slot = findSlot(level, current + 1);
+        uint64_t tick;
+        if (slot < SLOTS) {
+            tick = roundBase + (static_cast<uint64_t>(slot) << shift);
+        } else {
+            slot = findSlot(level, 0);
+            if (slot > current) {
+                continue;
+            }
+            tick = roundBase + (1ULL << (shift + SLOT_BITS)) + (static_cast<uint64_t>(slot) << shift);
+        }
+        next = std::min(next, tick);
+    }
+
+    if (buckets_[OVERFLOW_BUCKET] != NIL) {
+        const int shift = LEVELS * SLOT_BITS;
+        next = std::min(next, ((currentTick_ >> shift) + 1) << shift);
+    }
+    return next;
+}
+
+uint32_t TimerWheel::findSlot(int level, uint32_t from) const {
+    for (uint32_t word = from / 64; word < SLOTS / 64; ++word) {
+        uint64_t bits = occupied_[level][word];
+        if (word == from / 64) {
+            bits &= ~0ULL << (from % 64);
+        }
+        if (bits != 0) {
+            uint32_t slot = word * 64;
+            while ((bits & 1) == 0) {
+                bits >>= 1;
+                ++slot;
+            }
+            return slot;
+        }
+    }
+    return SLOTS;
+}
+
+uint32_t TimerWheel::allocate() {
+    if (freeHead_ == NIL) {
+        chunks_.emplace_back(new Node[CHUNK_SIZE]);
+        uint32_t base = capacity_;
+        capacity_ += CHUNK_SIZE;
+        for (uint32_t i = CHUNK_SIZE; i-- > 0;) {
+            Node& entry = chunks_.back()[i];
+            entry.generation = 1;
+            entry.bucket = FREE_BUCKET;
+            entry.next = freeHead_;
+            freeHead_ = base + i;
+        }
+    }
+
+    uint32_t index = freeHead_;
+    freeHead_ = node(index).next;
+    return index;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& entry = node(index);
+    entry.bucket = FREE_BUCKET;
+    // 代数跳过0，编号不会等于INVALID_TIMER
+    if (++entry.generation == 0) {
+        entry.generation = 1;
+    }
+    entry.next = freeHead_;
+    freeHead_ = index;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& entry = node(index);
+    uint64_t delta = entry.expiryTick - currentTick_;
+
+    uint32_t bucket = OVERFLOW_BUCKET;
+    for (int level = 0; level < LEVELS; ++level) {
+        if (delta < (1ULL << ((level + 1) * SLOT_BITS))) {
+            uint32_t slot = static_cast<uint32_t>((entry.expiryTick >> (level * SLOT_BITS)) & SLOT_MASK);
+            occupied_[level][slot / 64] |= 1ULL << (slot % 64);
+            bucket = level * SLOTS + slot;
+            break;
+        }
+    }
+
+    entry.bucket = bucket;
+    entry.prev = NIL;
+    entry.next = buckets_[bucket];
+    if (entry.next != NIL) {
+        node(entry.next).prev = index;
+    }
+    buckets_[bucket] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& entry = node(index);
+    if (entry.prev != NIL) {
+        node(entry.prev).next = entry.next;
+    } else {
+        buckets_[entry.bucket] = entry.next;
+        if (entry.next == NIL && entry.bucket < OVERFLOW_BUCKET) {
+            uint32_t slot = entry.bucket % SLOTS;
+            occupied_[entry.bucket / SLOTS][slot / 64] &= ~(1ULL << (slot % 64));
+        }
+    }
+    if (entry.next != NIL) {
+        node(entry.next).prev = entry.prev;
+    }
+}
+
+void TimerWheel::cascade(uint32_t bucket) {
+    uint32_t index = buckets_[bucket];
+    buckets_[bucket] = NIL;
+    if (bucket < OVERFLOW_BUCKET) {
+        uint32_t slot = bucket % SLOTS;
+        occupied_[bucket / SLOTS][slot / 64] &= ~(1ULL << (slot % 64));
+    }
+    while (index != NIL) {
+        uint32_t next = node(index).next;
+        link(index);
+        index = next;
+    }
+}
+
+uint64_t TimerWheel::tickOf(int64_t ns) const {
+    // 向上取整到刻度
+    return ns <= 0 ? 0 : static_cast<uint64_t>((ns + resolutionNs_ - 1) / resolutionNs_);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// 分层哈希时间轮
+// 4层、每层256槽，刻度为resolution时覆盖2^32个刻度（1毫秒刻度约49天），更远的定时器放在溢出链表。
+// 定时器节点按块分配、地址固定，每个槽是以下标相连的侵入式双向链表：登记、取消都是O(1)，
+// 推进时按各层非空槽位图跳过空刻度，上层槽在下层转完一圈时整体下移一层。节点带代数，到期或取消后旧编号自动失效。
+// 没有定时器时advance直接跳到当前时间；回放时钟大步跳跃时也只停在有定时器到期或下移的刻度上。
+// 非线程安全，由调用方加锁或限定在单个线程上使用。
+class TimerWheel {
+public:
+    typedef uint64_t TimerId;
+    static constexpr TimerId INVALID_TIMER = 0;
+    static constexpr int64_t NO_EXPIRY = std::numeric_limits<int64_t>::max();
+
+    // 到期的定时器
+    struct Expired {
+        TimerId id;
+        uint64_t tag;         // 登记时的用户数据
+        uint32_t owner;       // 登记时的所有者编号
+        int64_t deadlineNs;   // 本次到期时间（按刻度取整）
+        bool periodic;        // 周期定时器，编号仍然有效
+    };
+
+    explicit TimerWheel(int64_t resolutionNs, int64_t startNs = 0);
+
+    // 禁止拷贝和赋值
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 登记定时器，deadlineNs不晚于当前刻度时在下一个刻度到期；intervalNs大于0时为周期定时器
+    TimerId schedule(int64_t deadlineNs, uint64_t tag, uint32_t owner = 0, int64_t intervalNs = 0);
+
+    // 取消定时器，已到期（非周期）或已取消时返回false
+    bool cancel(TimerId id);
+
+    // 推进到nowNs，到期的定时器追加到expired，周期定时器按间隔重新登记；返回到期数
+    size_t advance(int64_t nowNs, std::vector<Expired>& expired);
+
+    // 最早可能有定时器到期的刻度时间（最近的非空槽或下一次上层下移），没有定时器时返回NO_EXPIRY
+    int64_t nextExpiryNs() const;
+
+    // 当前刻度对应的时间
+    int64_t currentNs() const { return static_cast<int64_t>(currentTick_) * resolutionNs_; }
+
+    int64_t getResolutionNs() const { return resolutionNs_; }
+    size_t size() const { return count_; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t OVERFLOW_BUCKET = LEVELS * SLOTS;
+    static constexpr uint32_t BUCKET_COUNT = OVERFLOW_BUCKET + 1;
+    static constexpr uint32_t FREE_BUCKET = 0xFFFFu;
+    static constexpr uint32_t CHUNK_SIZE = 4096;
+
+    struct Node {
+        uint64_t expiryTick;
+        uint64_t intervalTicks;
+        uint64_t tag;
+        uint32_t owner;
+        uint32_t generation;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t bucket;        // 所在槽，FREE_BUCKET表示空闲
+    };
+
+    Node& node(uint32_t index) { return chunks_[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+    const Node& node(uint32_t index) const { return chunks_[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    uint32_t allocate();
+    void release(uint32_t index);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+
+    // 把槽中的定时器按当前刻度重新放入（上层下移）
+    void cascade(uint32_t bucket);
+
+    // 下一个需要处理的刻度：各层最近的非空槽（上层为其下移的刻度）与溢出链表重查时刻中最早的一个
+    uint64_t nextTick() const;
+
+    // 层内从from开始的第一个非空槽，没有时返回SLOTS
+    uint32_t findSlot(int level, uint32_t from) const;
+
+    uint64_t tickOf(int64_t ns) const;
+
+    int64_t resolutionNs_;
+    uint64_t currentTick_;
+    size_t count_;
+
+    std::vector<uint32_t> buckets_;
+    uint64_t occupied_[LEVELS][SLOTS / 64];   // 各层非空槽位图
+    std::vector<std::unique_ptr<Node[]>> chunks_;
+    uint32_t capacity_;
+    uint32_t freeHead_;
+};
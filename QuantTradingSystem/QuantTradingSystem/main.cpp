@@ -12,9 +12,19 @@
 #include "Handlers/StrategyHandler.h"
 #include "Handlers/RiskHandler.h"
 #include "Handlers/SignalHandler.h"
+#include "Handlers/PnlHandler.h"
+#include "Handlers/KillSwitchHandler.h"
+#include "Handlers/SimExchangeHandler.h"
+#include "Handlers/ExecutionAlgoHandler.h"
+#include "Handlers/StopTriggerHandler.h"
+#include "Handlers/TimerClockHandler.h"
+#include "Handlers/TradingDayHandler.h"
+#include "Risk/ScenarioRiskEngine.h"
 #include "Strategies/MovingAverageStrategy.h"
 #include "Utils/logger/AsyncLogger.h"
 #include "Utils/config/ConfigManager.h"
+#include "Utils/latency/LatencyTracer.h"
+#include "Utils/metrics/MetricsRegistry.h"
 
 // 全局变量用于信号处理
 std::atomic<bool> g_running(true);
@@ -57,6 +67,8 @@ int main() {
         std::string logLevel = configManager.getValue<std::string>("system.log_level", "INFO");
         size_t maxLogFiles = configManager.getValue<size_t>("system.max_log_files", 5);
         size_t maxLogSize = configManager.getValue<size_t>("system.max_log_size", 10 * 1024 * 1024);
+        size_t logRingBytes = configManager.getValue<size_t>("system.log_ring_bytes", 1024 * 1024);
+        std::string logFormat = configManager.getValue<std::string>("system.log_format", "text");
 
         AsyncLogger::getInstance().init(logDir, "system", 
             logLevel == "DEBUG" ? LogLevel::DEBUG :
@@ -64,30 +76,92 @@ int main() {
             logLevel == "WARNING" ? LogLevel::WARNING :
             logLevel == "ERROR" ? LogLevel::ERROR :
             LogLevel::FATAL,
-            maxLogSize, maxLogFiles);
+            maxLogSize, maxLogFiles, logRingBytes,
+            logFormat == "binary" ? LogFileFormat::BINARY : LogFileFormat::TEXT);
 
         LOG_INFO("量化交易系统启动");
         LOG_INFO("系统版本: {}", configManager.getValue<std::string>("system.version", "unknown"));
 
+        // 启动链路延迟统计
+        auto& latencyTracer = LatencyTracer::getInstance();
+        latencyTracer.setEnabled(configManager.getValue<bool>("latency.enabled", true));
+        if (latencyTracer.isEnabled()) {
+            latencyTracer.startReporter(
+                configManager.getValue<std::string>("latency.report_file", logDir + "/latency_report.txt"),
+                configManager.getValue<int>("latency.report_interval", 60));
+        }
+
+        // 启动指标输出
+        auto& metricsRegistry = MetricsRegistry::getInstance();
+        metricsRegistry.registerProbe("logger.backlog", []() {
+            return static_cast<int64_t>(AsyncLogger::getInstance().getPendingCount());
+        });
+        metricsRegistry.registerProbe("logger.dropped", []() {
+            return static_cast<int64_t>(AsyncLogger::getInstance().getDroppedCount());
+        });
+        if (configManager.getValue<bool>("metrics.enabled", true)) {
+            metricsRegistry.startReporter(
+                configManager.getValue<std::string>("metrics.report_file", logDir + "/metrics_report.txt"),
+                configManager.getValue<int>("metrics.report_interval", 10));
+        }
+
         // 设置信号处理
         std::signal(SIGINT, signalHandler);
         std::signal(SIGTERM, signalHandler);
         
         // 初始化事件管理器
         auto eventManager = std::make_shared<EventManager>();
+        
+        // 定时器服务：到期以TIMER事件交给登记的策略；manual_clock时按回放行情的时间推进
+        std::shared_ptr<TimerService> timerService;
+        if (configManager.getValue<bool>("timers.enabled", true)) {
+            TimerServiceConfig timerConfig;
+            timerConfig.resolutionMs = configManager.getValue<int64_t>("timers.resolution_ms", timerConfig.resolutionMs);
+            timerConfig.manualClock = configManager.getValue<bool>("timers.manual_clock", timerConfig.manualClock);
+            timerService = std::make_shared<TimerService>(timerConfig);
+            timerService->setEventSink([eventManager](std::shared_ptr<Event> event) {
+                eventManager->addEvent(event);
+            });
+            eventManager->setTimerService(timerService);
+            if (timerConfig.manualClock) {
+                eventManager->registerHandlerForType(EventType::MARKET_DATA,
+                                                     std::make_shared<TimerClockHandler>(timerService));
+            }
+            LOG_INFO("Timer service enabled");
+        }
+        
+        // 交易日处理器最先处理行情，新交易日的日内计数和盈亏基准在其他处理器看到该行情之前重置
+        auto tradingDayHandler = std::make_shared<TradingDayHandler>();
+        eventManager->registerHandlerForType(EventType::MARKET_DATA, tradingDayHandler);
+        
         eventManager->start();
         LOG_INFO("Event Manager started");
         
         // 初始化行情数据服务
         auto marketDataService = std::make_shared<MarketDataService>(eventManager);
-        marketDataService->init(configManager.getValue<std::string>("market_data.provider", "CTP"));
+        // 行情源由market_data.provider选择（CTP或SYNTHETIC），market_data.config为该行情源的配置文件
+        marketDataService->init(configManager.getValue<std::string>("market_data.provider", "CTP"),
+                                configManager.getValue<std::string>("market_data.config", "ctp_md.json"));
         LOG_INFO("Market Data Service initialized");
         
         // 初始化交易服务
         auto tradingService = std::make_shared<TradeService>(eventManager);
-        tradingService->init(configManager.getValue<std::string>("market_data.provider", "CTP"));
+        // 交易接口由trading.provider选择（CTP或SIM），trading.config为该交易接口的配置文件
+        tradingService->Init(configManager.getValue<std::string>("trading.provider", "CTP"),
+                             configManager.getValue<std::string>("trading.config", "ctp_td.json"));
         LOG_INFO("Trading Service initialized");
         
+        // 新交易日回收已终结的订单，本地订单存储的槽位不随运行天数累积
+        tradingDayHandler->addListener([tradingService](const std::string&) {
+            tradingService->PurgeTerminalOrders();
+        });
+        
+        // 模拟交易所以行情五档盘口作为对手盘撮合
+        if (auto simFeed = std::dynamic_pointer_cast<SimTradeFeed>(tradingService->GetTradeFeed())) {
+            eventManager->registerHandlerForType(EventType::MARKET_DATA, std::make_shared<SimExchangeHandler>(simFeed));
+            LOG_INFO("Simulated exchange registered");
+        }
+        
         // 创建行情数据缓存处理器
         auto marketDataCache = std::make_shared<MarketDataCache>();
         eventManager->registerHandlerForType(EventType::MARKET_DATA, marketDataCache);
@@ -95,21 +169,167 @@ int main() {
         
         // 创建策略管理器
         auto strategyManager = std::make_shared<StrategyManager>(eventManager);
+        strategyManager->setTimerService(timerService);
+        if (configManager.getValue<std::string>("strategy_execution.mode", "inline") == "worker_pool") {
+            strategyManager->setExecutionMode(StrategyExecutionMode::WORKER_POOL,
+                configManager.getValue<size_t>("strategy_execution.shared_workers", 1),
+                configManager.getValue<std::vector<int>>("strategy_execution.shared_cpus", {}));
+            LOG_INFO("Strategy Manager running strategies on worker pool");
+        }
         eventManager->registerHandler(strategyManager);
         LOG_INFO("Strategy Manager registered");
         
+        // 创建风控引擎，限额在启动时加载，持仓和挂单状态由回报增量维护
+        RiskLimits riskLimits;
+        riskLimits.maxPositionPerInstrument = configManager.getValue<int64_t>("trading.risk_engine.max_position_per_instrument", riskLimits.maxPositionPerInstrument);
+        riskLimits.maxTotalPosition = configManager.getValue<int64_t>("trading.risk_engine.max_total_position", riskLimits.maxTotalPosition);
+        riskLimits.maxNotionalPerInstrument = configManager.getValue<double>("trading.risk_engine.max_notional_per_instrument", riskLimits.maxNotionalPerInstrument);
+        riskLimits.maxTotalNotional = configManager.getValue<double>("trading.risk_engine.max_total_notional", riskLimits.maxTotalNotional);
+        riskLimits.maxOpenOrdersPerInstrument = configManager.getValue<int64_t>("trading.risk_engine.max_open_orders_per_instrument", riskLimits.maxOpenOrdersPerInstrument);
+        riskLimits.maxOpenOrdersPerStrategy = configManager.getValue<int64_t>("trading.risk_engine.max_open_orders_per_strategy", riskLimits.maxOpenOrdersPerStrategy);
+        riskLimits.maxPositionPerStrategy = configManager.getValue<int64_t>("trading.risk_engine.max_position_per_strategy", riskLimits.maxPositionPerStrategy);
+        auto riskEngine = std::make_shared<RiskEngine>(riskLimits);
+        
+        // 创建实时盈亏引擎，合约乘数和保证金率在启动时加载
+        auto pnlEngine = std::make_shared<PnlEngine>();
+        nlohmann::json contracts = configManager.getValue<nlohmann::json>("contracts", nlohmann::json::object());
+        pnlEngine->loadContractSpecs(contracts);
+        for (auto it = contracts.begin(); it != contracts.end(); ++it) {
+            if (it.value().is_object()) {
+                riskEngine->setContractMultiplier(it.key(), it.value().value("multiplier", 1.0));
+            }
+        }
+        strategyManager->setPnlEngine(pnlEngine);
+        
+        // 盈亏处理器先于风控管理器注册，风控规则读取到的盈亏已包含当前成交
+        auto pnlHandler = std::make_shared<PnlHandler>(pnlEngine);
+        eventManager->registerHandlerForType(EventType::MARKET_DATA, pnlHandler);
+        eventManager->registerHandlerForType(EventType::TRADE, pnlHandler);
+        eventManager->registerHandlerForType(EventType::POSITION, pnlHandler);
+        
+        double maxDailyLoss = configManager.getValue<double>("trading.risk_limit.max_daily_loss", 100000.0);
+        double maxDrawdown = configManager.getValue<double>("trading.risk_limit.max_drawdown_amount", 0.0);
+        auto lossLimitRule = std::make_shared<LossLimitRule>(
+            configManager.getValue<double>("trading.risk_limit.max_loss_per_trade", maxDailyLoss), maxDailyLoss);
+        lossLimitRule->setPnlEngine(pnlEngine, maxDrawdown);
+        
+        // 新交易日的第一笔行情上以当前盈亏为基准重新计算当日盈亏和回撤
+        tradingDayHandler->addListener([pnlEngine, lossLimitRule](const std::string&) {
+            pnlEngine->startNewDay();
+            lossLimitRule->resetDailyLoss();
+        });
+        
         // 创建风控管理器并添加风控规则
-        auto riskManager = std::make_shared<RiskManager>(eventManager);
+        auto riskManager = std::make_shared<RiskManager>(eventManager, riskEngine);
         riskManager->addRule(std::make_shared<OrderFrequencyRule>(10, 5));
         riskManager->addRule(std::make_shared<PositionLimitRule>(10, 50));
+        riskManager->addRule(lossLimitRule);
         eventManager->registerHandlerForType(EventType::ORDER, riskManager);
+        eventManager->registerHandlerForType(EventType::TRADE, riskManager);
+        eventManager->registerHandlerForType(EventType::POSITION, riskManager);
+        
+        // 启用事前风控闸门：订单在发送前同步检查，RiskManager只做事后监控
+        if (configManager.getValue<bool>("trading.risk_engine.pre_trade_gate", true)) {
+            auto riskGate = std::make_shared<RiskGate>(riskEngine, eventManager);
+            riskGate->setRateLimiter(std::make_shared<OrderRateLimiter>(OrderRateLimitConfig::fromJson(
+                configManager.getValue<nlohmann::json>("trading.rate_limits", nlohmann::json::object()))));
+            riskGate->setLossLimits(pnlEngine, maxDailyLoss, maxDrawdown);
+            std::shared_ptr<OrderRateLimiter> rateLimiter = riskGate->getRateLimiter();
+            tradingDayHandler->addListener([rateLimiter](const std::string&) {
+                rateLimiter->resetDailyCounters();
+            });
+            tradingService->SetRiskGate(riskGate);
+            riskManager->setPostTradeOnly(true);
+            LOG_INFO("Pre-trade risk gate enabled");
+        }
         LOG_INFO("Risk Manager registered with rules");
         
+        // 严重风控事件触发熔断：阻止新订单并撤掉全部挂单
+        if (configManager.getValue<bool>("trading.kill_switch.enabled", true)) {
+            auto killSwitchHandler = std::make_shared<KillSwitchHandler>(
+                tradingService, configManager.getValue<bool>("trading.kill_switch.always_global", false));
+            eventManager->registerHandlerForType(EventType::RISK_CONTROL, killSwitchHandler);
+            LOG_INFO("Kill switch armed");
+        }
+        
+        // 异步报单网关：信号在事件分发线程上完成检查后入队，由独立（可绑核）线程发送
+        if (configManager.getValue<bool>("trading.order_gateway.enabled", false)) {
+            OrderGatewayConfig gatewayConfig;
+            gatewayConfig.cpuId = configManager.getValue<int>("trading.order_gateway.cpu_id", gatewayConfig.cpuId);
+            gatewayConfig.maxBatch = configManager.getValue<size_t>("trading.order_gateway.max_batch", gatewayConfig.maxBatch);
+            gatewayConfig.busyPoll = configManager.getValue<bool>("trading.order_gateway.busy_poll", gatewayConfig.busyPoll);
+            tradingService->EnableOrderGateway(gatewayConfig);
+            LOG_INFO("Order gateway enabled");
+            
+            // 执行算法：信号指定TWAP、POV或冰山算法时拆成子单，由网关线程驱动
+            if (configManager.getValue<bool>("trading.execution_algo.enabled", false)) {
+                ExecutionAlgoConfig algoConfig;
+                algoConfig.timerResolutionMs = configManager.getValue<int64_t>(
+                    "trading.execution_algo.timer_resolution_ms", algoConfig.timerResolutionMs);
+                algoConfig.childTimeoutMs = configManager.getValue<int64_t>(
+                    "trading.execution_algo.child_timeout_ms", algoConfig.childTimeoutMs);
+                algoConfig.maxRefusedChildren = configManager.getValue<int>(
+                    "trading.execution_algo.max_refused_children", algoConfig.maxRefusedChildren);
+                if (tradingService->EnableExecutionAlgos(algoConfig)) {
+                    eventManager->registerHandlerForType(EventType::MARKET_DATA,
+                        std::make_shared<ExecutionAlgoHandler>(tradingService->GetExecutionAlgoEngine()));
+                    LOG_INFO("Execution algorithms enabled");
+                }
+            }
+        }
+        
+        // 持仓台账：按今昨仓拆分平仓单，挂单期间冻结可平数量
+        if (configManager.getValue<bool>("trading.position_ledger.enabled", false)) {
+            std::vector<std::string> closeTodayExchanges = configManager.getValue<std::vector<std::string>>(
+                "trading.position_ledger.close_today_exchanges", {"SHFE", "INE"});
+            std::unordered_map<std::string, std::string> instrumentExchanges;
+            nlohmann::json exchanges = configManager.getValue<nlohmann::json>(
+                "trading.rate_limits.instrument_exchanges", nlohmann::json::object());
+            for (auto it = exchanges.begin(); it != exchanges.end(); ++it) {
+                if (it.value().is_string()) {
+                    instrumentExchanges[it.key()] = it.value().get<std::string>();
+                }
+            }
+            tradingService->EnablePositionLedger(closeTodayExchanges, instrumentExchanges);
+            LOG_INFO("Position ledger enabled");
+        }
+        
+        // 止损止盈：开仓信号带的触发价随成交挂上，越过时发出平仓信号
+        if (configManager.getValue<bool>("trading.stop_triggers.enabled", false)) {
+            if (tradingService->EnableStopTriggers()) {
+                eventManager->registerHandlerForType(EventType::MARKET_DATA,
+                    std::make_shared<StopTriggerHandler>(tradingService->GetStopTriggerEngine()));
+                LOG_INFO("Stop triggers enabled");
+            }
+        }
+        
+        // 组合压力测试：周期性按价格冲击情景重估账户和各策略持仓
+        std::shared_ptr<ScenarioRiskEngine> scenarioRiskEngine;
+        if (configManager.getValue<bool>("trading.scenario_risk.enabled", false)) {
+            scenarioRiskEngine = std::make_shared<ScenarioRiskEngine>(
+                ScenarioRiskConfig::fromJson(
+                    configManager.getValue<nlohmann::json>("trading.scenario_risk", nlohmann::json::object())),
+                pnlEngine, riskEngine, eventManager);
+            scenarioRiskEngine->start();
+            LOG_INFO("Scenario risk revaluation started");
+        }
+        
         // 创建信号处理器
         auto signalHandler = std::make_shared<SignalHandler>(eventManager, tradingService);
         eventManager->registerHandlerForType(EventType::STRATEGY_SIGNAL, signalHandler);
         LOG_INFO("Signal Handler registered");
         
+        // 设置策略信号发送方式
+        std::string signalMode = configManager.getValue<std::string>("strategy_execution.signal_mode", "event_queue");
+        if (!strategyManager->setSignalDispatch(
+                signalMode == "direct" ? SignalDispatchMode::DIRECT :
+                signalMode == "signal_lane" ? SignalDispatchMode::SIGNAL_LANE :
+                SignalDispatchMode::EVENT_QUEUE,
+                signalHandler)) {
+            LOG_ERROR("strategy_execution.signal_mode=direct cannot be combined with worker_pool execution");
+            return 1;
+        }
+        
         // 初始化策略
         if (configManager.getValue<bool>("strategies.moving_average.enabled", false)) {
             auto maStrategy = std::make_shared<MovingAverageStrategy>();
@@ -121,7 +341,10 @@ int main() {
             LOG_INFO("Moving Average Strategy initialized");
             
             // 注册策略
-            strategyManager->registerStrategy(maStrategy);
+            StrategyExecutionProfile profile;
+            profile.dedicated = configManager.getValue<bool>("strategies.moving_average.dedicated_worker", false);
+            profile.cpuId = configManager.getValue<int>("strategies.moving_average.cpu_id", -1);
+            strategyManager->registerStrategy(maStrategy, profile);
             LOG_INFO("Strategy registered with manager");
         }
         
@@ -173,12 +396,19 @@ int main() {
         // 停止服务
         tradingService->Stop();
         marketDataService->stop();
+        if (scenarioRiskEngine) {
+            scenarioRiskEngine->stop();
+        }
         LOG_INFO("Services stopped");
         
         // 停止事件管理器
         eventManager->stop();
         LOG_INFO("Event Manager stopped");
         
+        // 输出最终的延迟统计和指标
+        latencyTracer.stopReporter();
+        metricsRegistry.stopReporter();
+        
         // 停止日志系统
         AsyncLogger::getInstance().stop();
         
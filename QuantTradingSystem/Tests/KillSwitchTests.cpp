@@ -0,0 +1,203 @@
+#include "TestHarness.h"
+#include "EventManager.h"
+#include "Handlers/KillSwitchHandler.h"
+#include "Risk/PnlEngine.h"
+#include "Risk/RiskEngine.h"
+#include "Risk/RiskGate.h"
+#include "Risk/ScenarioRiskEngine.h"
+#include "Trade/TradeService.h"
+#include "Utils/latency/LatencyTrace.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace {
+
+const char* const SYMBOL = "rb2410";
+const char* const STRATEGY = "s1";
+const double MULTIPLIER = 10.0;
+
+// 与main.cpp相同的装配：熔断处理器注册在风控事件上，事件经分发线程送达
+struct KillSwitchFixture {
+    std::shared_ptr<EventManager> eventManager;
+    std::shared_ptr<TradeService> tradeService;
+    std::shared_ptr<PnlEngine> pnlEngine;
+    std::shared_ptr<RiskEngine> riskEngine;
+
+    KillSwitchFixture()
+        : eventManager(std::make_shared<EventManager>()),
+          tradeService(std::make_shared<TradeService>(eventManager)),
+          pnlEngine(std::make_shared<PnlEngine>()),
+          riskEngine(std::make_shared<RiskEngine>()) {
+        ContractSpec spec;
+        spec.multiplier = MULTIPLIER;
+        pnlEngine->setContractSpec(SYMBOL, spec);
+        riskEngine->setContractMultiplier(SYMBOL, MULTIPLIER);
+
+        eventManager->registerHandlerForType(EventType::RISK_CONTROL,
+                                             std::make_shared<KillSwitchHandler>(tradeService));
+        eventManager->start();
+    }
+
+    ~KillSwitchFixture() {
+        eventManager->stop();
+    }
+
+    KillSwitch& killSwitch() { return tradeService->GetKillSwitch(); }
+
+    trade::OrderData order(trade::OrderDirection direction, int volume) {
+        trade::OrderData data;
+        data.symbol = SYMBOL;
+        data.strategyId = STRATEGY;
+        data.direction = direction;
+        data.price = 3400.0;
+        data.volume = volume;
+        return data;
+    }
+
+    // 策略在合约上成交一笔多头，风控引擎按策略记账
+    void fillStrategyLong(int volume, double price) {
+        OrderData data;
+        data.orderId = "fill1";
+        data.symbol = SYMBOL;
+        data.strategyId = STRATEGY;
+        data.direction = OrderDirection::BUY;
+        data.price = price;
+        data.volume = volume;
+        RiskOrder riskOrder;
+        riskEngine->makeOrder(data, riskOrder);
+        riskEngine->reserve(data.orderId, riskOrder);
+
+        TradeData trade;
+        trade.orderId = data.orderId;
+        trade.symbol = SYMBOL;
+        trade.direction = OrderDirection::BUY;
+        trade.price = price;
+        trade.volume = volume;
+        riskEngine->onTrade(trade);
+    }
+};
+
+} // namespace
+
+TEST_CASE(KillSwitch, DailyLossBreachEngagesAccountKillSwitch) {
+    KillSwitchFixture fixture;
+    int instrument = fixture.pnlEngine->internInstrument(SYMBOL);
+    fixture.pnlEngine->setPosition(SYMBOL, 1, 3500.0);
+    fixture.pnlEngine->onTick(instrument, 3400.0);
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), -1000.0, 1e-6);
+
+    RiskGate gate(fixture.riskEngine, fixture.eventManager);
+    gate.setLossLimits(fixture.pnlEngine, 500.0, 0.0);
+
+    RiskOrder riskOrder;
+    CHECK(!gate.approve(fixture.order(trade::OrderDirection::Buy, 1), riskOrder));
+    CHECK(waitUntil([&fixture]() { return fixture.killSwitch().isEngaged(); }));
+    CHECK(fixture.killSwitch().isBlocked("other", "other"));
+
+    // 超限状态持续期间不重复发布：人工解除后同一次超限不再触发熔断
+    CHECK(fixture.tradeService->ReleaseKillSwitch(KillScope::GLOBAL, ""));
+    CHECK(!gate.approve(fixture.order(trade::OrderDirection::Buy, 1), riskOrder));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!fixture.killSwitch().isEngaged());
+
+    // 恢复到限额以内后再次超限重新触发
+    fixture.pnlEngine->onTick(instrument, 3500.0);
+    CHECK(gate.approve(fixture.order(trade::OrderDirection::Buy, 1), riskOrder));
+    gate.rollback(riskOrder);
+    fixture.pnlEngine->onTick(instrument, 3400.0);
+    CHECK(!gate.approve(fixture.order(trade::OrderDirection::Buy, 1), riskOrder));
+    CHECK(waitUntil([&fixture]() { return fixture.killSwitch().isEngaged(); }));
+}
+
+TEST_CASE(KillSwitch, ScenarioBreachEngagesStrategyKillSwitch) {
+    KillSwitchFixture fixture;
+    int instrument = fixture.pnlEngine->internInstrument(SYMBOL);
+    fixture.pnlEngine->onTick(instrument, 3500.0);
+    fixture.pnlEngine->setPriceLimits(instrument, 3500.0 * 1.07, 3500.0 * 0.93);
+    fixture.fillStrategyLong(2, 3500.0);
+
+    // 跌停情景下策略亏损 2 × 10 × 245 = 4900
+    ScenarioRiskConfig config;
+    config.workerCount = 1;
+    config.maxStrategyLoss = 1000.0;
+    ScenarioRiskEngine scenarioEngine(config, fixture.pnlEngine, fixture.riskEngine, fixture.eventManager);
+    scenarioEngine.revalue();
+
+    std::vector<ScenarioBookResult> results = scenarioEngine.getResults();
+    CHECK(results.size() == 2);
+    CHECK(results.back().book == STRATEGY);
+    CHECK(results.back().worstScenario == "limit_down");
+    CHECK_NEAR(results.back().worstPnl, -4900.0, 1e-6);
+
+    CHECK(waitUntil([&fixture]() { return fixture.killSwitch().isEngaged(); }));
+    CHECK(fixture.killSwitch().isBlocked(STRATEGY, SYMBOL));
+    CHECK(!fixture.killSwitch().isBlocked("s2", SYMBOL));
+}
+
+TEST_CASE(KillSwitch, TerminalReportDuringThrottledRetry) {
+    KillSwitch killSwitch;
+    std::atomic<bool> closed(false);
+
+    trade::OrderData working;
+    working.orderId = "1";
+    working.symbol = SYMBOL;
+    working.strategyId = STRATEGY;
+    working.status = trade::OrderStatus::Accepted;
+
+    // 撤单在再次扫描之后仍受速率限制；重试发出时订单的终态回报在锁外同时到达
+    const int64_t throttledUntil = latencyNow() + 20000000;
+    killSwitch.setHooks(
+        [&closed, working](KillScope, const std::string&) {
+            std::vector<trade::OrderData> orders;
+            if (!closed.load()) {
+                orders.push_back(working);
+            }
+            return orders;
+        },
+        [&killSwitch, &closed, throttledUntil](const trade::OrderData& order) {
+            if (latencyNow() < throttledUntil) {
+                return KillCancelResult::THROTTLED;
+            }
+            trade::OrderData cancelled = order;
+            cancelled.status = trade::OrderStatus::Canceled;
+            closed.store(true);
+            killSwitch.onOrderUpdate(cancelled);
+            return KillCancelResult::SENT;
+        });
+    killSwitch.start();
+
+    CHECK(killSwitch.engage(KillScope::GLOBAL, "", "test"));
+    CHECK(killSwitch.getActiveFlattenCount() == 1);
+    CHECK(waitUntil([&killSwitch]() { return killSwitch.getActiveFlattenCount() == 0; }));
+    killSwitch.stop();
+}
+
+TEST_CASE(KillSwitch, ScopedSweepQueriesScopeOrders) {
+    KillSwitch killSwitch;
+    std::vector<std::string> queried;
+    std::vector<std::string> cancelled;
+
+    // 策略范围只读取该策略的挂单
+    killSwitch.setHooks(
+        [&queried](KillScope scope, const std::string& key) {
+            queried.push_back(std::string(scope == KillScope::STRATEGY ? "strategy:" : "other:") + key);
+            trade::OrderData order;
+            order.orderId = "1";
+            order.symbol = SYMBOL;
+            order.strategyId = key;
+            order.status = trade::OrderStatus::Accepted;
+            return std::vector<trade::OrderData>(1, order);
+        },
+        [&cancelled](const trade::OrderData& order) {
+            cancelled.push_back(order.orderId);
+            return KillCancelResult::SENT;
+        });
+
+    CHECK(killSwitch.engage(KillScope::STRATEGY, STRATEGY, "test"));
+    CHECK(queried.size() == 1);
+    CHECK(queried.front() == std::string("strategy:") + STRATEGY);
+    CHECK(cancelled.size() == 1);
+    CHECK(killSwitch.isBlocked(STRATEGY, "other"));
+    CHECK(!killSwitch.isBlocked("s2", SYMBOL));
+}
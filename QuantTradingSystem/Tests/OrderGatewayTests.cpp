@@ -0,0 +1,83 @@
+#include "TestHarness.h"
+#include "Trade/OrderGateway.h"
+#include "Trade/SimTradeFeed.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+trade::OrderData makeOrder() {
+    trade::OrderData order;
+    order.symbol = "rb2410";
+    order.strategyId = "s1";
+    order.direction = trade::OrderDirection::Buy;
+    order.offset = trade::OrderOffset::Open;
+    order.priceType = trade::OrderPriceType::Limit;
+    order.price = 3500.0;
+    order.volume = 1;
+    return order;
+}
+
+std::shared_ptr<SimTradeFeed> makeFeed() {
+    auto feed = std::make_shared<SimTradeFeed>();
+    feed->Connect();
+    feed->Login("user", "password");
+    return feed;
+}
+
+} // namespace
+
+TEST_CASE(OrderGateway, SubmitAfterStopFails) {
+    OrderGateway gateway(makeFeed(), OrderGatewayConfig());
+    std::atomic<int> placed(0);
+    gateway.setCallbacks([&placed](const GatewayRequest&, const std::string&) { placed.fetch_add(1); }, nullptr);
+
+    // 未启动和停止后都不入队
+    CHECK(gateway.submitOrder(makeOrder(), nullptr, LatencyTrace()) == 0);
+    gateway.start();
+    ClientOrderHandle handle = gateway.submitOrder(makeOrder(), nullptr, LatencyTrace());
+    CHECK(handle != 0);
+    gateway.stop();
+    CHECK(placed.load() == 1);
+    CHECK(gateway.submitOrder(makeOrder(), nullptr, LatencyTrace()) == 0);
+    CHECK(!gateway.submitCancel(handle));
+    CHECK(!gateway.submitCancel(std::string("1:1:1")));
+    CHECK(gateway.getQueueDepth() == 0);
+}
+
+TEST_CASE(OrderGateway, StopSendsEveryAcceptedOrder) {
+    OrderGateway gateway(makeFeed(), OrderGatewayConfig());
+    std::atomic<int> placed(0);
+    gateway.setCallbacks([&placed](const GatewayRequest&, const std::string&) { placed.fetch_add(1); }, nullptr);
+    gateway.start();
+
+    // 生产线程持续提交（队列会写满），停止与提交并发：入队成功的都发出，之后的全部失败，停止不会卡住
+    const int PRODUCERS = 4;
+    std::atomic<int> accepted(0);
+    std::atomic<bool> go(true);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < PRODUCERS; ++i) {
+        producers.emplace_back([&gateway, &accepted, &go]() {
+            trade::OrderData order = makeOrder();
+            while (go.load()) {
+                if (gateway.submitOrder(order, nullptr, LatencyTrace()) != 0) {
+                    accepted.fetch_add(1);
+                } else {
+                    break;
+                }
+            }
+        });
+    }
+    CHECK(waitUntil([&accepted]() { return accepted.load() > 2000; }));
+    gateway.stop();
+    go.store(false);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    CHECK(placed.load() == accepted.load());
+    CHECK(gateway.getQueueDepth() == 0);
+}
@@ -0,0 +1,86 @@
+#include "TestHarness.h"
+#include "Trade/OrderStore.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const int REF_BASE = 100;
+
+trade::OrderData makeOrder(int orderRef, const std::string& strategyId, const std::string& symbol) {
+    trade::OrderData order;
+    order.orderId = "1:1:" + std::to_string(orderRef);
+    order.strategyId = strategyId;
+    order.symbol = symbol;
+    order.direction = trade::OrderDirection::Buy;
+    order.offset = trade::OrderOffset::Open;
+    order.priceType = trade::OrderPriceType::Limit;
+    order.price = 3500.0;
+    order.volume = 1;
+    return order;
+}
+
+} // namespace
+
+TEST_CASE(OrderStore, PurgeTerminalRecyclesSlots) {
+    OrderStore store;
+    store.setOrderRefBase(REF_BASE);
+    OrderStore::Handle filled = store.create(makeOrder(REF_BASE, "s1", "rb2410"), REF_BASE);
+    OrderStore::Handle working = store.create(makeOrder(REF_BASE + 1, "s1", "rb2410"), REF_BASE + 1);
+    CHECK(store.transition(filled, trade::OrderStatus::Filled, 1));
+    CHECK(store.getOrderCount() == 2);
+
+    // 已终结的订单回收后旧句柄失效，挂单不受影响
+    store.purgeTerminal();
+    CHECK(store.getOrderCount() == 1);
+    CHECK(store.getStatus(filled) == trade::OrderStatus::Unknown);
+    CHECK(store.findByOrderRef(REF_BASE) == OrderStore::INVALID_HANDLE);
+    CHECK(store.findByOrderId("1:1:" + std::to_string(REF_BASE + 1)) == working);
+
+    // 回收的槽位被新订单复用，旧句柄仍然无效
+    OrderStore::Handle reused = store.create(makeOrder(REF_BASE + 2, "s1", "rb2410"), REF_BASE + 2);
+    CHECK(reused != OrderStore::INVALID_HANDLE);
+    CHECK(reused != filled);
+    CHECK(store.getStatus(filled) == trade::OrderStatus::Unknown);
+    CHECK(store.getWorkingCount() == 2);
+}
+
+TEST_CASE(OrderStore, OrderRefTableWrapsAround) {
+    OrderStore store;
+    store.setOrderRefBase(REF_BASE);
+    const int capacity = static_cast<int>(OrderStore::MAX_SLABS * OrderStore::SLAB_SIZE);
+
+    // 相隔一整圈的报单引用共用表项，查找时核对报单引用
+    OrderStore::Handle first = store.create(makeOrder(REF_BASE + 5, "s1", "rb2410"), REF_BASE + 5);
+    CHECK(store.findByOrderRef(REF_BASE + 5) == first);
+    OrderStore::Handle wrapped = store.create(makeOrder(REF_BASE + capacity + 5, "s1", "rb2410"),
+                                              REF_BASE + capacity + 5);
+    CHECK(wrapped != OrderStore::INVALID_HANDLE);
+    CHECK(store.findByOrderRef(REF_BASE + capacity + 5) == wrapped);
+    CHECK(store.findByOrderId("1:1:" + std::to_string(REF_BASE + capacity + 5)) == wrapped);
+    CHECK(store.findByOrderRef(REF_BASE + 5) == OrderStore::INVALID_HANDLE);
+    CHECK(store.findByOrderRef(REF_BASE - 1) == OrderStore::INVALID_HANDLE);
+}
+
+TEST_CASE(OrderStore, WorkingOrdersByScope) {
+    OrderStore store;
+    store.setOrderRefBase(REF_BASE);
+    OrderStore::Handle a = store.create(makeOrder(REF_BASE, "s1", "rb2410"), REF_BASE);
+    store.create(makeOrder(REF_BASE + 1, "s1", "cu2410"), REF_BASE + 1);
+    store.create(makeOrder(REF_BASE + 2, "s2", "rb2410"), REF_BASE + 2);
+
+    CHECK(store.getWorkingOrdersByStrategy("s1").size() == 2);
+    CHECK(store.getWorkingOrdersByStrategy("s2").size() == 1);
+    CHECK(store.getWorkingOrdersByInstrument("rb2410").size() == 2);
+    CHECK(store.getWorkingOrdersByStrategy("s3").empty());
+
+    // 终结的订单从所在的各条链表摘除
+    CHECK(store.transition(a, trade::OrderStatus::Canceled, 0));
+    std::vector<trade::OrderData> strategyOrders = store.getWorkingOrdersByStrategy("s1");
+    CHECK(strategyOrders.size() == 1);
+    CHECK(strategyOrders.front().symbol == "cu2410");
+    std::vector<trade::OrderData> instrumentOrders = store.getWorkingOrdersByInstrument("rb2410");
+    CHECK(instrumentOrders.size() == 1);
+    CHECK(instrumentOrders.front().strategyId == "s2");
+    CHECK(store.getWorkingOrders().size() == 2);
+}
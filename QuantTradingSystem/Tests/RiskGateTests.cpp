@@ -0,0 +1,203 @@
+#include "TestHarness.h"
+#include "EventManager.h"
+#include "Handlers/RiskHandler.h"
+#include "Risk/RiskEngine.h"
+#include "Risk/RiskGate.h"
+#include "Trade/SimTradeFeed.h"
+#include "Trade/TradeService.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* const SYMBOL = "rb2410";
+const char* const STRATEGY = "s1";
+const double MULTIPLIER = 10.0;
+
+std::shared_ptr<RiskEngine> makeEngine(int64_t maxPosition) {
+    RiskLimits limits;
+    limits.maxPositionPerInstrument = maxPosition;
+    auto engine = std::make_shared<RiskEngine>(limits);
+    engine->setContractMultiplier(SYMBOL, MULTIPLIER);
+    return engine;
+}
+
+trade::OrderData makeOrder(trade::OrderDirection direction, int volume) {
+    trade::OrderData data;
+    data.symbol = SYMBOL;
+    data.strategyId = STRATEGY;
+    data.direction = direction;
+    data.priceType = trade::OrderPriceType::Limit;
+    data.price = 3500.0;
+    data.volume = volume;
+    return data;
+}
+
+int64_t strategyPosition(const RiskEngine& engine) {
+    std::vector<StrategyPositionEntry> positions;
+    engine.getStrategyPositions(positions);
+    for (const auto& entry : positions) {
+        if (entry.strategyId == STRATEGY && entry.symbol == SYMBOL) {
+            return entry.netPosition;
+        }
+    }
+    return 0;
+}
+
+// 与main.cpp相同的装配：模拟交易接口的回报经事件队列送入事后风控（只更新引擎状态）
+struct SimFixture {
+    std::shared_ptr<EventManager> eventManager;
+    std::shared_ptr<TradeService> tradeService;
+    std::shared_ptr<RiskEngine> engine;
+    std::shared_ptr<RiskManager> riskManager;
+    RiskGate gate;
+
+    SimFixture()
+        : eventManager(std::make_shared<EventManager>()),
+          tradeService(std::make_shared<TradeService>(eventManager)),
+          engine(makeEngine(3)),
+          riskManager(std::make_shared<RiskManager>(eventManager, engine)),
+          gate(engine, eventManager) {
+        riskManager->setPostTradeOnly(true);
+        eventManager->registerHandlerForType(EventType::ORDER, riskManager);
+        eventManager->registerHandlerForType(EventType::TRADE, riskManager);
+        eventManager->start();
+
+        tradeService->Init("SIM", "");
+        tradeService->Start();
+        tradeService->Login("user", "password");
+
+        // 卖一档足量，限价买单到达即全部成交
+        MarketDataField quote;
+        quote.symbol = SYMBOL;
+        quote.lastPrice = 3500.0;
+        quote.upperLimit = 3800.0;
+        quote.lowerLimit = 3200.0;
+        quote.bidPrice[0] = 3499.0;
+        quote.bidVolume[0] = 100;
+        quote.askPrice[0] = 3500.0;
+        quote.askVolume[0] = 100;
+        std::static_pointer_cast<SimTradeFeed>(tradeService->GetTradeFeed())->onMarketData(quote);
+    }
+
+    ~SimFixture() {
+        tradeService->Stop();
+        eventManager->stop();
+    }
+};
+
+} // namespace
+
+TEST_CASE(RiskGate, ApprovedOrdersReserveBeforeSend) {
+    auto engine = makeEngine(3);
+    RiskGate gate(engine, nullptr);
+    int instrument = engine->findInstrument(SYMBOL);
+
+    // 同一批检查的订单互相可见，不必等到发送完成
+    RiskOrder first;
+    RiskOrder second;
+    CHECK(gate.approve(makeOrder(trade::OrderDirection::Buy, 2), first));
+    CHECK(engine->getOpenOrders(instrument) == 1);
+    CHECK(!gate.approve(makeOrder(trade::OrderDirection::Buy, 2), second));
+
+    // 发送失败释放在途挂单
+    gate.rollback(first);
+    CHECK(engine->getOpenOrders(instrument) == 0);
+    CHECK(gate.approve(makeOrder(trade::OrderDirection::Buy, 2), second));
+
+    // 发送成功后按订单编号登记，撤单回报释放
+    gate.commit("1", second);
+    CHECK(engine->getOpenOrders(instrument) == 1);
+    OrderData cancelled;
+    cancelled.orderId = "1";
+    cancelled.status = OrderStatus::CANCELLED;
+    cancelled.tradedVolume = 0;
+    engine->onOrderUpdate(cancelled);
+    CHECK(engine->getOpenOrders(instrument) == 0);
+    CHECK_NEAR(engine->getTotalNotional(), 0.0, 1e-6);
+}
+
+TEST_CASE(RiskGate, TerminalReportBeforeCommitReleasesReservation) {
+    auto engine = makeEngine(3);
+    RiskGate gate(engine, nullptr);
+    int instrument = engine->findInstrument(SYMBOL);
+
+    RiskOrder riskOrder;
+    CHECK(gate.approve(makeOrder(trade::OrderDirection::Buy, 2), riskOrder));
+
+    // 拒单回报先于发送完成到达
+    OrderData rejected;
+    rejected.orderId = "7";
+    rejected.status = OrderStatus::REJECTED;
+    rejected.tradedVolume = 0;
+    engine->onOrderUpdate(rejected);
+    CHECK(engine->getOpenOrders(instrument) == 1);
+
+    gate.commit("7", riskOrder);
+    CHECK(engine->getOpenOrders(instrument) == 0);
+    CHECK_NEAR(engine->getTotalNotional(), 0.0, 1e-6);
+    CHECK(gate.approve(makeOrder(trade::OrderDirection::Buy, 3), riskOrder));
+}
+
+TEST_CASE(RiskGate, SimFillBeforeCommitSettlesReservation) {
+    SimFixture fixture;
+    int instrument = fixture.engine->findInstrument(SYMBOL);
+    CHECK(fixture.tradeService->IsLoggedIn());
+
+    RiskOrder riskOrder;
+    trade::OrderData order = makeOrder(trade::OrderDirection::Buy, 2);
+    CHECK(fixture.gate.approve(order, riskOrder));
+    std::string orderId = fixture.tradeService->GetTradeFeed()->PlaceOrder(order);
+    CHECK(!orderId.empty());
+
+    // 成交回报在登记订单编号之前到达：持仓已计入合约，挂单仍按在途占用
+    CHECK(waitUntil([&fixture, instrument]() { return fixture.engine->getNetPosition(instrument) == 2; }));
+    CHECK(fixture.engine->getOpenOrders(instrument) == 1);
+    CHECK(strategyPosition(*fixture.engine) == 0);
+
+    fixture.gate.commit(orderId, riskOrder);
+    CHECK(fixture.engine->getOpenOrders(instrument) == 0);
+    CHECK(fixture.engine->getStrategyOpenOrders(fixture.engine->findStrategy(STRATEGY)) == 0);
+    CHECK(strategyPosition(*fixture.engine) == 2);
+    CHECK_NEAR(fixture.engine->getTotalNotional(), 2 * 3500.0 * MULTIPLIER, 1e-6);
+
+    // 挂单量已释放：持仓2手、上限3手时还能再买1手
+    RiskOrder next;
+    CHECK(fixture.gate.approve(makeOrder(trade::OrderDirection::Buy, 1), next));
+    fixture.gate.rollback(next);
+}
+
+TEST_CASE(RiskGate, ConcurrentApprovalsRespectPositionLimit) {
+    // 信号订单和算法子单在不同线程上审批，通过的订单总量不超过持仓上限
+    for (int round = 0; round < 50; ++round) {
+        auto engine = makeEngine(3);
+        RiskGate gate(engine, nullptr);
+        std::atomic<int> approved(0);
+        std::atomic<bool> go(false);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&gate, &approved, &go]() {
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                for (int n = 0; n < 4; ++n) {
+                    RiskOrder riskOrder;
+                    if (gate.approve(makeOrder(trade::OrderDirection::Buy, 1), riskOrder)) {
+                        approved.fetch_add(1);
+                    }
+                }
+            });
+        }
+        go.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(approved.load() == 3);
+        CHECK(engine->getOpenOrders(engine->findInstrument(SYMBOL)) == 3);
+    }
+}
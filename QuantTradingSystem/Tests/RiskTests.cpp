@@ -0,0 +1,146 @@
+#include "TestHarness.h"
+#include "EventManager.h"
+#include "Handlers/PnlHandler.h"
+#include "Handlers/RiskHandler.h"
+#include "Handlers/TradingDayHandler.h"
+#include "Risk/PnlEngine.h"
+#include "Risk/RiskEngine.h"
+#include <memory>
+#include <string>
+
+namespace {
+
+const char* const SYMBOL = "rb2410";
+const double MULTIPLIER = 10.0;
+
+std::shared_ptr<Event> makeTick(const std::string& tradingDay, double lastPrice) {
+    MarketDataField field;
+    field.symbol = SYMBOL;
+    field.tradingDay = tradingDay;
+    field.lastPrice = lastPrice;
+    return std::make_shared<MarketDataEvent>(field);
+}
+
+// 柜台持仓快照：只带开仓成本，均价由处理器按合约乘数折算
+std::shared_ptr<Event> makeSnapshot(PositionDirection direction, int volume, double avgPrice) {
+    PositionData data;
+    data.symbol = SYMBOL;
+    data.direction = direction;
+    data.position = volume;
+    data.ydPosition = volume;
+    data.tdPosition = 0;
+    data.avgPrice = 0.0;
+    data.openCost = avgPrice * volume * MULTIPLIER;
+    data.positionProfit = 0.0;
+    return std::make_shared<PositionEvent>(data);
+}
+
+// 与main.cpp相同的装配：交易日处理器先于盈亏处理器，持仓事件送入盈亏和风控
+struct SeedingFixture {
+    std::shared_ptr<PnlEngine> pnlEngine;
+    std::shared_ptr<RiskEngine> riskEngine;
+    TradingDayHandler tradingDayHandler;
+    PnlHandler pnlHandler;
+    RiskManager riskManager;
+
+    SeedingFixture()
+        : pnlEngine(std::make_shared<PnlEngine>()),
+          riskEngine(std::make_shared<RiskEngine>()),
+          pnlHandler(pnlEngine),
+          riskManager(nullptr, riskEngine) {
+        ContractSpec spec;
+        spec.multiplier = MULTIPLIER;
+        pnlEngine->setContractSpec(SYMBOL, spec);
+        riskEngine->setContractMultiplier(SYMBOL, MULTIPLIER);
+
+        std::shared_ptr<PnlEngine> engine = pnlEngine;
+        tradingDayHandler.addListener([engine](const std::string&) { engine->startNewDay(); });
+    }
+
+    void tick(const std::string& tradingDay, double lastPrice) {
+        auto event = makeTick(tradingDay, lastPrice);
+        tradingDayHandler.handleEvent(event);
+        pnlHandler.handleEvent(event);
+    }
+
+    void snapshot(const std::shared_ptr<Event>& event) {
+        pnlHandler.handleEvent(event);
+        riskManager.handleEvent(event);
+    }
+
+    RiskOrder order(bool buy, int64_t volume) {
+        RiskOrder riskOrder;
+        riskOrder.instrument = riskEngine->internInstrument(SYMBOL);
+        riskOrder.strategy = riskEngine->internStrategy("s1");
+        riskOrder.buy = buy;
+        riskOrder.volume = volume;
+        riskOrder.price = 3500.0;
+        return riskOrder;
+    }
+};
+
+} // namespace
+
+TEST_CASE(Risk, PositionSnapshotSeedsOvernightPosition) {
+    SeedingFixture fixture;
+    fixture.tick("20240102", 3510.0);
+    fixture.snapshot(makeSnapshot(PositionDirection::LONG, 3, 3500.0));
+
+    PositionPnl position;
+    CHECK(fixture.pnlEngine->getPosition(SYMBOL, position));
+    CHECK(position.netPosition == 3);
+    CHECK_NEAR(position.avgCost, 3500.0, 1e-9);
+
+    // 隔夜持仓相对昨结算价的变动计入当日盈亏
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), 300.0, 1e-6);
+    fixture.tick("20240102", 3490.0);
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), -300.0, 1e-6);
+    CHECK_NEAR(fixture.pnlEngine->getDrawdown(), 600.0, 1e-6);
+
+    int instrument = fixture.riskEngine->findInstrument(SYMBOL);
+    CHECK(fixture.riskEngine->getNetPosition(instrument) == 3);
+    CHECK(fixture.riskEngine->getTotalPosition() == 3);
+    CHECK_NEAR(fixture.riskEngine->getTotalNotional(), 3 * 3500.0 * MULTIPLIER, 1e-6);
+
+    // 装入的多头持仓上卖出属于减仓，不受亏损类限额约束
+    CHECK(fixture.riskEngine->isReducing(fixture.order(false, 2)));
+    CHECK(!fixture.riskEngine->isReducing(fixture.order(false, 7)));
+    CHECK(!fixture.riskEngine->isReducing(fixture.order(true, 1)));
+}
+
+TEST_CASE(Risk, PositionSnapshotSeedsShortPosition) {
+    SeedingFixture fixture;
+    fixture.snapshot(makeSnapshot(PositionDirection::SHORT, 2, 3500.0));
+    fixture.tick("20240102", 3520.0);
+
+    int instrument = fixture.riskEngine->findInstrument(SYMBOL);
+    CHECK(fixture.riskEngine->getNetPosition(instrument) == -2);
+    CHECK(fixture.riskEngine->isReducing(fixture.order(true, 2)));
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), -400.0, 1e-6);
+}
+
+TEST_CASE(Risk, TradingDayRollRebasesDailyPnl) {
+    SeedingFixture fixture;
+    fixture.tick("20240102", 3500.0);
+    fixture.snapshot(makeSnapshot(PositionDirection::LONG, 1, 3500.0));
+    fixture.tick("20240102", 3450.0);
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), -500.0, 1e-6);
+
+    // 夜盘第一笔行情带下一个交易日，当日盈亏和回撤从零开始
+    fixture.tick("20240103", 3450.0);
+    CHECK(fixture.tradingDayHandler.getTradingDay() == "20240103");
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), 0.0, 1e-6);
+    CHECK_NEAR(fixture.pnlEngine->getDrawdown(), 0.0, 1e-6);
+
+    fixture.tick("20240103", 3460.0);
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), 100.0, 1e-6);
+
+    // 带旧交易日的迟到行情不触发交易日切换
+    fixture.tick("20240102", 3470.0);
+    CHECK(fixture.tradingDayHandler.getTradingDay() == "20240103");
+    CHECK_NEAR(fixture.pnlEngine->getDailyPnl(), 200.0, 1e-6);
+
+    PositionPnl position;
+    CHECK(fixture.pnlEngine->getPosition(SYMBOL, position));
+    CHECK(position.netPosition == 1);
+}
@@ -0,0 +1,182 @@
+#include "TestHarness.h"
+#include "EventManager.h"
+#include "Handlers/SignalHandler.h"
+#include "Trade/SimTradeFeed.h"
+#include "Trade/StopTriggerEngine.h"
+#include "Trade/TradeService.h"
+#include "Utils/metrics/MetricsRegistry.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const SYMBOL = "rb2410";
+const char* const STRATEGY = "s1";
+
+StrategySignalData openLong(double stopLoss, double takeProfit) {
+    StrategySignalData signal;
+    signal.strategyId = STRATEGY;
+    signal.symbol = SYMBOL;
+    signal.signalType = SignalType::OPEN_LONG;
+    signal.price = 3500.0;
+    signal.volume = 2;
+    signal.stopLoss = stopLoss;
+    signal.takeProfit = takeProfit;
+    return signal;
+}
+
+trade::OrderData openOrder(const std::string& orderId, trade::OrderStatus status, int tradedVolume) {
+    trade::OrderData order;
+    order.orderId = orderId;
+    order.symbol = SYMBOL;
+    order.strategyId = STRATEGY;
+    order.direction = trade::OrderDirection::Buy;
+    order.offset = trade::OrderOffset::Open;
+    order.priceType = trade::OrderPriceType::Limit;
+    order.price = 3500.0;
+    order.volume = 2;
+    order.tradedVolume = tradedVolume;
+    order.status = status;
+    return order;
+}
+
+trade::TradeData fill(const std::string& orderId, int volume) {
+    trade::TradeData trade;
+    trade.orderId = orderId;
+    trade.symbol = SYMBOL;
+    trade.direction = trade::OrderDirection::Buy;
+    trade.offset = trade::OrderOffset::Open;
+    trade.price = 3500.0;
+    trade.volume = volume;
+    return trade;
+}
+
+MarketDataField tick(double price) {
+    MarketDataField data;
+    data.symbol = SYMBOL;
+    data.lastPrice = price;
+    data.bidPrice[0] = price - 1.0;
+    data.askPrice[0] = price + 1.0;
+    return data;
+}
+
+// 与main.cpp相同的装配：模拟交易接口，触发后的平仓信号经信号通道送到信号处理器
+struct StopFixture {
+    std::shared_ptr<EventManager> eventManager;
+    std::shared_ptr<TradeService> tradeService;
+
+    StopFixture()
+        : eventManager(std::make_shared<EventManager>()),
+          tradeService(std::make_shared<TradeService>(eventManager)) {
+        tradeService->Init("SIM", "");
+        tradeService->EnableStopTriggers();
+        eventManager->registerHandlerForType(EventType::STRATEGY_SIGNAL,
+                                             std::make_shared<SignalHandler>(eventManager, tradeService));
+        eventManager->start();
+        tradeService->Start();
+        tradeService->Login("user", "password");
+
+        // 卖一档足量，限价买单到达即全部成交
+        MarketDataField quote = tick(3500.0);
+        quote.askPrice[0] = 3500.0;
+        quote.askVolume[0] = 100;
+        quote.bidVolume[0] = 100;
+        quote.upperLimit = 3800.0;
+        quote.lowerLimit = 3200.0;
+        std::static_pointer_cast<SimTradeFeed>(tradeService->GetTradeFeed())->onMarketData(quote);
+    }
+
+    ~StopFixture() {
+        tradeService->Stop();
+        eventManager->stop();
+    }
+
+    StopProtection protection() const {
+        return tradeService->GetStopTriggerEngine()->getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy);
+    }
+};
+
+} // namespace
+
+TEST_CASE(StopTrigger, TradeBeforeOrderReportCountsTowardPosition) {
+    StopTriggerEngine engine;
+    std::vector<StrategySignalData> signals;
+    engine.setSignalCallback([&signals](const StrategySignalData& signal) { signals.push_back(signal); });
+    engine.onSignal(openLong(3400.0, 0.0));
+
+    // 成交回报先于订单回报到达，登记订单时计入持仓并挂上止损
+    engine.onTrade(fill("1", 2));
+    CHECK(engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy).position == 0);
+    engine.onOrder(openOrder("1", trade::OrderStatus::Filled, 2));
+    StopProtection protection = engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy);
+    CHECK(protection.position == 2);
+    CHECK(protection.armed);
+
+    engine.onMarketData(tick(3390.0));
+    CHECK(signals.size() == 1);
+    CHECK(signals.front().signalType == SignalType::CLOSE_LONG);
+    CHECK(signals.front().volume == 2);
+}
+
+TEST_CASE(StopTrigger, PartialTradesAroundOrderReportAreNotDoubleCounted) {
+    StopTriggerEngine engine;
+    engine.onSignal(openLong(3400.0, 3600.0));
+
+    engine.onTrade(fill("1", 1));
+    engine.onOrder(openOrder("1", trade::OrderStatus::PartialFilled, 1));
+    engine.onTrade(fill("1", 1));
+    engine.onOrder(openOrder("1", trade::OrderStatus::Filled, 2));
+    CHECK(engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy).position == 2);
+
+    // 不属于跟踪方向的订单丢弃暂存的成交
+    trade::OrderData manual = openOrder("2", trade::OrderStatus::Filled, 1);
+    manual.strategyId.clear();
+    engine.onTrade(fill("2", 1));
+    engine.onOrder(manual);
+    engine.onOrder(openOrder("2", trade::OrderStatus::Filled, 1));
+    CHECK(engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy).position == 2);
+}
+
+TEST_CASE(StopTrigger, RejectedCloseRearms) {
+    StopTriggerEngine engine;
+    std::vector<StrategySignalData> signals;
+    engine.setSignalCallback([&signals](const StrategySignalData& signal) { signals.push_back(signal); });
+    engine.onSignal(openLong(3400.0, 0.0));
+    engine.onOrder(openOrder("1", trade::OrderStatus::Accepted, 0));
+    engine.onTrade(fill("1", 2));
+
+    engine.onMarketData(tick(3390.0));
+    CHECK(signals.size() == 1);
+    CHECK(engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy).firing);
+
+    // 平仓信号在发出前被拒，没有订单回报：重新挂上，价格仍越过触发价时再次触发
+    engine.onCloseRejected(STRATEGY, SYMBOL, trade::OrderDirection::Buy);
+    StopProtection protection = engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy);
+    CHECK(!protection.firing);
+    CHECK(protection.armed);
+    engine.onMarketData(tick(3385.0));
+    CHECK(signals.size() == 2);
+
+    // 未触发的方向不受影响
+    engine.onCloseRejected(STRATEGY, SYMBOL, trade::OrderDirection::Sell);
+    CHECK(engine.getProtection(STRATEGY, SYMBOL, trade::OrderDirection::Buy).firing);
+}
+
+TEST_CASE(StopTrigger, KillSwitchBlockedCloseRearms) {
+    StopFixture fixture;
+    StrategySignalData signal = openLong(3400.0, 0.0);
+    CHECK(fixture.tradeService->ProcessSignal(std::make_shared<StrategySignalEvent>(signal)));
+    CHECK(waitUntil([&fixture]() { return fixture.protection().armed; }));
+    CHECK(fixture.protection().position == 2);
+
+    // 熔断阻止触发后的平仓单，不会有订单回报
+    MetricCounter& rearmed = MetricsRegistry::getInstance().getCounter("stop_trigger.rearmed");
+    const uint64_t rearmedBefore = rearmed.get();
+    CHECK(fixture.tradeService->EngageKillSwitch(KillScope::STRATEGY, STRATEGY, "test"));
+    fixture.tradeService->GetStopTriggerEngine()->onMarketData(tick(3390.0));
+    CHECK(waitUntil([&rearmed, rearmedBefore]() { return rearmed.get() > rearmedBefore; }));
+    CHECK(fixture.protection().armed);
+    CHECK(!fixture.protection().firing);
+    CHECK(fixture.protection().position == 2);
+}
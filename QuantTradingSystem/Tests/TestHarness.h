@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 单项测试
+struct TestCase {
+    std::string group;                  // 测试分组
+    std::string name;                   // 测试名称
+    std::function<void()> body;         // 测试内容
+};
+
+// 内置单元测试框架
+// 测试用TEST_CASE在静态初始化时登记，由TestMain按分组和名称依次运行；
+// 断言失败时记录文件、行号和表达式后继续执行，全部运行完后返回失败数。
+class TestRegistry {
+public:
+    static TestRegistry& getInstance() {
+        static TestRegistry instance;
+        return instance;
+    }
+
+    void add(const std::string& group, const std::string& name, std::function<void()> body) {
+        tests_.push_back(TestCase{ group, name, std::move(body) });
+    }
+
+    const std::vector<TestCase>& getTests() const { return tests_; }
+
+    // 记录一次断言失败（由断言宏调用）
+    void fail(const char* file, int line, const std::string& expression);
+
+    // 当前测试的失败数
+    int getFailures() const { return failures_; }
+    void resetFailures() { failures_ = 0; }
+
+private:
+    TestRegistry() : failures_(0) {}
+
+    std::vector<TestCase> tests_;
+    int failures_;
+};
+
+// 静态初始化时登记测试
+struct TestRegistrar {
+    TestRegistrar(const char* group, const char* name, std::function<void()> body) {
+        TestRegistry::getInstance().add(group, name, std::move(body));
+    }
+};
+
+// 等待异步条件成立（如回报线程的处理结果），超时返回false
+inline bool waitUntil(const std::function<bool()>& condition, int timeoutMs = 2000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+#define TEST_CASE(group, name) \
+    static void test_##group##_##name(); \
+    static TestRegistrar registrar_##group##_##name(#group, #name, &test_##group##_##name); \
+    static void test_##group##_##name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            TestRegistry::getInstance().fail(__FILE__, __LINE__, #expression); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        if (!(std::fabs((actual) - (expected)) <= (tolerance))) { \
+            TestRegistry::getInstance().fail(__FILE__, __LINE__, \
+                #actual " == " #expected " (actual " + std::to_string(actual) + ")"); \
+        } \
+    } while (0)
@@ -0,0 +1,54 @@
+#include "TestHarness.h"
+#include <exception>
+#include <iostream>
+#include <string>
+
+void TestRegistry::fail(const char* file, int line, const std::string& expression) {
+    ++failures_;
+    std::cerr << "  " << file << ":" << line << ": CHECK failed: " << expression << std::endl;
+}
+
+// 用法:
+//   Tests [--filter 名称片段]
+int main(int argc, char* argv[]) {
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter name]" << std::endl;
+            return 1;
+        }
+    }
+
+    TestRegistry& registry = TestRegistry::getInstance();
+    int run = 0;
+    int failed = 0;
+
+    for (const TestCase& test : registry.getTests()) {
+        std::string fullName = test.group + "." + test.name;
+        if (!filter.empty() && fullName.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        registry.resetFailures();
+        try {
+            test.body();
+        } catch (const std::exception& e) {
+            registry.fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+
+        ++run;
+        if (registry.getFailures() > 0) {
+            ++failed;
+            std::cout << "[FAIL] " << fullName << std::endl;
+        } else {
+            std::cout << "[ OK ] " << fullName << std::endl;
+        }
+    }
+
+    std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}